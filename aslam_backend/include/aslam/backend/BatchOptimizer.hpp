@@ -0,0 +1,109 @@
+#ifndef ASLAM_BACKEND_BATCH_OPTIMIZER_HPP
+#define ASLAM_BACKEND_BATCH_OPTIMIZER_HPP
+
+#include <ostream>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+
+namespace aslam {
+  namespace backend {
+    class LinearSystemSolver;
+    class TrustRegionPolicy;
+
+    struct BatchOptimizerOptions
+    {
+      /// \brief Options of the per-worker optimizers. The linear system solver and trust region policy must not be set,
+      ///        as every worker needs its own instances. Use the factories below instead.
+      Optimizer2Options optimizer;
+      std::size_t numThreads = 0; /// \brief Number of worker threads. Zero means one per hardware thread.
+      boost::function<boost::shared_ptr<LinearSystemSolver>()> linearSystemSolverFactory; /// \brief Creates the solver of each worker. Defaults to the sparse_cholesky solver if empty.
+      boost::function<boost::shared_ptr<TrustRegionPolicy>()> trustRegionPolicyFactory; /// \brief Creates the trust region policy of each worker. Defaults to levenberg_marquardt if empty.
+
+      void check() const;
+    };
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::BatchOptimizerOptions& options);
+
+    /// \brief Results of one BatchOptimizer::optimize() call
+    struct BatchOptimizerStatus
+    {
+      std::vector<SolutionReturnValue> results; /// \brief Per-problem results, in the order of the problems
+      std::vector<ConvergenceStatus> convergence; /// \brief Per-problem convergence status, FAILURE if the optimizer threw
+      std::size_t numExceptions = 0; /// \brief Number of problems whose optimization threw an exception
+      std::size_t numThreads = 0; /// \brief Number of worker threads used
+      double wallTime = 0.0; /// \brief Wall time of the whole batch [s]
+      double problemsPerSecond = 0.0; /// \brief Aggregate throughput
+
+      void reset();
+    };
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::BatchOptimizerStatus& status);
+
+    /**
+     * \class BatchOptimizer
+     *
+     * Solves many small independent problems concurrently. Each worker owns an Optimizer2 with its own linear
+     * system solver and trust region policy, which are reused for all problems the worker picks up. Problems are
+     * handed out one at a time, so uneven problem sizes balance across the workers. The problems must not share
+     * design variables or error terms.
+     */
+    class BatchOptimizer
+    {
+     public:
+      typedef boost::shared_ptr<BatchOptimizer> Ptr;
+      typedef boost::shared_ptr<const BatchOptimizer> ConstPtr;
+      typedef BatchOptimizerOptions Options;
+      typedef BatchOptimizerStatus Status;
+
+      SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+
+      /// \brief Constructor with custom options
+      BatchOptimizer(const Options& options = Options());
+      /// \brief Destructor
+      ~BatchOptimizer();
+
+      /// \brief Optimize all \p problems. Exceptions of individual problems are caught and reported in the status.
+      const Status& optimize(const std::vector< boost::shared_ptr<OptimizationProblemBase> >& problems);
+
+      /// \brief Return the status of the last batch
+      const Status& getStatus() const { return _status; }
+
+      /// \brief Const getter for the options
+      const Options& getOptions() const { return _options; }
+
+      /// \brief Set the options. The workers are recreated on the next batch.
+      void setOptions(const Options& options);
+
+      /// \brief Number of workers currently allocated
+      std::size_t numWorkers() const { return _workers.size(); }
+
+    private:
+
+      /// \brief Create the workers if the number of threads changed
+      void initializeWorkers(std::size_t numThreads);
+
+      /// \brief Worker loop, optimizes problems until none is left
+      void runWorker(std::size_t workerId, const std::vector< boost::shared_ptr<OptimizationProblemBase> >& problems);
+
+    private:
+
+      /// \brief the current set of options
+      Options _options;
+
+      /// \brief One optimizer per worker thread
+      std::vector< boost::shared_ptr<Optimizer2> > _workers;
+
+      /// \brief Index of the next problem to hand out
+      std::size_t _nextProblem = 0;
+
+      /// \brief Protects _nextProblem and the exception count
+      boost::mutex _mutex;
+
+      /// \brief Status of the last batch
+      Status _status;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#endif /* ASLAM_BACKEND_BATCH_OPTIMIZER_HPP */
@@ -3,6 +3,7 @@
 
 #include "LinearSystemSolver.hpp"
 #include <sparse_block_matrix/linear_solver.h>
+#include <sparse_block_matrix/linear_solver_pcg.h>
 #include <boost/shared_ptr.hpp>
 #include "SparseBlockMatrixWrapper.hpp"
 
@@ -20,7 +21,10 @@ namespace aslam {
     public:
       typedef sparse_block_matrix::LinearSolver<Eigen::MatrixXd> LinearSolver;
       typedef sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd> SparseBlockMatrix;
+      typedef sparse_block_matrix::LinearSolverPCG<Eigen::MatrixXd> PcgSolver;
 
+      /// \brief \p solver is one of "cholesky", "spqr" and "pcg". The latter is the iterative conjugate gradient method with a
+      ///        block-Jacobi preconditioner, which stops early according to the forcing term (see LinearSystemSolver::setForcingTerm).
       BlockCholeskyLinearSystemSolver(const std::string & solver = "cholesky", const BlockCholeskyLinearSolverOptions& options= BlockCholeskyLinearSolverOptions());
       BlockCholeskyLinearSystemSolver(const sm::PropertyTree& config);
       ~BlockCholeskyLinearSystemSolver() override;
@@ -53,6 +57,15 @@ namespace aslam {
 
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      /// \brief v^T J^T J v from the Hessian
+      bool jacobianSquaredNorm(const Eigen::VectorXd& v, double& outNorm) override;
+
+      bool isIterative() const override { return _solverType == "pcg"; }
+
+      /// \brief The relative residual of the pcg solver without a forcing term
+      double getPcgTolerance() const { return _pcgTolerance; }
+      void setPcgTolerance(double tolerance) { _pcgTolerance = tolerance; }
         
     private:
 
@@ -61,6 +74,9 @@ namespace aslam {
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
 
+      void getColumnSquaredNorms(Eigen::VectorXd& outNorms) const override;
+      void scaleColumns(const Eigen::VectorXd& scale) override;
+
 
       /// \brief The full Hessian matrix.
       SparseBlockMatrixWrapper _H;
@@ -72,6 +88,9 @@ namespace aslam {
       BlockCholeskyLinearSolverOptions _options;
 
       std::string _solverType;
+
+      /// \brief The relative residual of the pcg solver without a forcing term
+      double _pcgTolerance = 1e-10;
     };
 
   } // namespace backend
@@ -7,6 +7,7 @@
 #endif
 #include <sm/assert_macros.hpp>
 #include <Eigen/Core>
+#include <vector>
 
 namespace aslam {
   namespace backend {
@@ -41,6 +42,17 @@ namespace aslam {
        */
       cholmod_factor* analyze(cholmod_sparse* J);
 
+      /**
+       * \brief Like analyze() but with a constrained fill-reducing ordering (CAMD)
+       *
+       * @param J the sparse matrix to analyze
+       * @param constraints one constraint set per row of J, numbered 0..k-1. Rows with a
+       *                    higher set are eliminated after all rows with a lower set.
+       *
+       * @return a cholmod factor for the matrix. This must be freed using Cholmod::free()
+       */
+      cholmod_factor* analyzeConstrained(cholmod_sparse* J, std::vector<index_t>& constraints);
+
       /// \brief wraps the spqr analyze functions
 #ifndef QRSOLVER_DISABLED
       spqr_factor* analyzeQR(cholmod_sparse* J);
@@ -82,6 +94,11 @@ namespace aslam {
                            cholmod_factor* L,
                            cholmod_dense* b);
 
+      /// \brief solve a linear system with the numerical factorization in L, without refactorizing.
+      ///
+      /// The return value must be freed with Cholmod::free()
+      cholmod_dense* solve(cholmod_factor* L, cholmod_dense* b);
+
 #ifndef QRSOLVER_DISABLED
       cholmod_dense* solve(cholmod_sparse* A, spqr_factor* L, cholmod_dense* b,
                            double tol = SPQR_DEFAULT_TOL, bool norm = true,
@@ -131,6 +131,15 @@ namespace aslam {
       /// \brief left multiply the vector y = A^T x
       void leftMultiply(const Eigen::VectorXd& x, Eigen::VectorXd& outY) const override;
 
+      /// \brief the squared norms of the rows, an appended diagonal block is not included
+      void rowSquaredNorms(Eigen::VectorXd& outNorms) const;
+
+      /// \brief multiply row r with scale(r), an appended diagonal block is not scaled
+      void scaleRows(const Eigen::VectorXd& scale);
+
+      /// \brief multiply column c with scale(c), an appended diagonal block is not scaled
+      void scaleColumns(const Eigen::VectorXd& scale);
+
 
       /// \brief Initialize the matrix from a dense matrix
       void fromDense(const Eigen::MatrixXd& M) override;
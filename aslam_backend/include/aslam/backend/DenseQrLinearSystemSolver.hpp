@@ -31,6 +31,11 @@ namespace aslam {
       const Eigen::MatrixXd& getJacobian() const;
 
       std::string name() const override { return "dense_qr";};
+
+      /// \brief The column pivoting QR decomposition detects the rank
+      bool isRankRevealing() const override { return true; }
+
+      bool supportsErrorProjection() const override { return true; }
       
       /// Returns the options
       const DenseQRLinearSolverOptions& getOptions() const;
@@ -43,6 +48,9 @@ namespace aslam {
 
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      bool multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) override;
+      bool solveSystemForError(const Eigen::VectorXd& e, Eigen::VectorXd& outDx) override;
     
     private:
       /// \brief a method for a thread to evaluate Jacobians
@@ -51,6 +59,10 @@ namespace aslam {
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
 
+      void getColumnSquaredNorms(Eigen::VectorXd& outNorms) const override;
+      void scaleColumns(const Eigen::VectorXd& scale) override;
+      bool scaleRows(const Eigen::VectorXd& scale) override;
+
       /// \brief the dense Jacobian matrix
       DenseMatrix _J;
 
@@ -85,6 +85,31 @@ namespace aslam {
       /// \brief get the scaling of this design variable used in the optimization.
       double scaling() const { return _scaling; }
 
+      /// \brief The ordering group used to constrain the fill-reducing ordering.
+      int orderingGroup() const { return _orderingGroup; }
+
+      /// \brief Set the ordering group. Constrained orderings (CAMD) eliminate design variables
+      ///        with a higher group after all design variables with a lower group, so the
+      ///        newest states can be kept in the bottom-right corner of the factor.
+      void setOrderingGroup(int orderingGroup) { _orderingGroup = orderingGroup; }
+
+      /// \brief Set box bounds on the parameters, use +-infinity for unbounded coordinates. The optimizers keep the
+      ///        parameters within the bounds. Only supported for vector space design variables, i.e. the update adds
+      ///        the (scaled) perturbation to the minimalDimensions() parameters.
+      void setBounds(const Eigen::VectorXd& lowerBound, const Eigen::VectorXd& upperBound);
+
+      /// \brief Remove the box bounds.
+      void clearBounds();
+
+      /// \brief Whether this design variable has box bounds.
+      bool hasBounds() const { return _lowerBound.size() > 0; }
+
+      /// \brief The lower bounds of the parameters, empty without bounds.
+      const Eigen::VectorXd& lowerBound() const { return _lowerBound; }
+
+      /// \brief The upper bounds of the parameters, empty without bounds.
+      const Eigen::VectorXd& upperBound() const { return _upperBound; }
+
       /// \brief The column base of this block in the Jacobian matrix
       int columnBase() const { return _columnBase; }
 
@@ -157,6 +182,15 @@ namespace aslam {
       /// \brief The scaling of this design variable within the optimization.
       double _scaling;
 
+      /// \brief The group of this design variable in constrained orderings.
+      int _orderingGroup;
+
+      /// \brief The lower bounds of the parameters, empty without bounds.
+      Eigen::VectorXd _lowerBound;
+
+      /// \brief The upper bounds of the parameters, empty without bounds.
+      Eigen::VectorXd _upperBound;
+
       /// \brief Cache expressions that have to be reseted
       std::vector< boost::weak_ptr<CacheInterface> > _cacheNodes;
     };
@@ -3,6 +3,7 @@
 
 #include <aslam/backend/DesignVariable.hpp>
 #include <sm/timing/NsecTimeUtilities.hpp>
+#include <vector>
 
 namespace aslam {
   namespace backend {
@@ -14,6 +15,15 @@ namespace aslam {
         sm::timing::NsecTime t;
     };
 
+    /// \brief Put all design variables at or after time \p tNewest into ordering group 1 and
+    ///        the others into group 0, so constrained orderings eliminate the newest states last.
+    inline void setOrderingGroupsByTime(const std::vector<DesignVariableTimePair>& dvs, sm::timing::NsecTime tNewest)
+    {
+      for (const DesignVariableTimePair& dvt : dvs) {
+        dvt.dv->setOrderingGroup(dvt.t >= tNewest ? 1 : 0);
+      }
+    }
+
   } // namespace backend
 } // namespace aslam
 
@@ -22,11 +22,17 @@ namespace aslam {
             
             /// \brief should the optimizer revert on failure? You should probably return true
             bool revertOnFailure() override;
+
+            /// \brief The radius update judges the clipped step by its model reduction
+            void stepProjected(const Eigen::VectorXd& dx) override;
             
             /// \brief print the current state to a stream (no newlines).
             std::ostream & printState(std::ostream & out) const override;
           bool requiresAugmentedDiagonal() const override;
           std::string name() const override { return "dog_leg"; }
+
+          /// \brief The current trust region radius. Zero before the first step.
+          double getDelta() const { return _delta; }
         private:
             
             Eigen::VectorXd _dx;
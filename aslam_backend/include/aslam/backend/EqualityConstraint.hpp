@@ -0,0 +1,97 @@
+#ifndef ASLAM_BACKEND_EQUALITY_CONSTRAINT_HPP
+#define ASLAM_BACKEND_EQUALITY_CONSTRAINT_HPP
+
+#include <Eigen/Core>
+#include <boost/shared_ptr.hpp>
+#include "ErrorTerm.hpp"
+
+namespace aslam {
+  namespace backend {
+
+    /**
+     * \class EqualityConstraint
+     *
+     * \brief Interface of a hard equality constraint \f$ \mathbf c(\mathbf x) = \mathbf 0 \f$, enforced with the augmented Lagrangian method.
+     *
+     * Constraints are added to the optimization problem like squared error terms. With the multipliers \f$ \boldsymbol\lambda \f$
+     * and the penalty \f$ \mu \f$ a constraint contributes the squared error \f$ \mu \| \mathbf c + \boldsymbol\lambda / \mu \|^2 \f$,
+     * which is \f$ 2 \boldsymbol\lambda^T \mathbf c + \mu \| \mathbf c \|^2 \f$ up to a constant. Optimizer2 updates the multipliers
+     * and the penalty in an outer loop around the unconstrained optimization, see Optimizer2Options::maxAugmentedLagrangianIterations.
+     * In contrast to a prior with a large weight, the penalty stays moderate and the condition of the normal equations with it.
+     */
+    class EqualityConstraint {
+    public:
+      typedef boost::shared_ptr<EqualityConstraint> Ptr;
+
+      virtual ~EqualityConstraint() {}
+
+      /// \brief Evaluate the constraint \f$ \mathbf c(\mathbf x) \f$ at the current state.
+      virtual Eigen::VectorXd evaluateConstraint() = 0;
+
+      /// \brief Get the Lagrange multipliers.
+      virtual Eigen::VectorXd getMultipliers() const = 0;
+
+      /// \brief Set the Lagrange multipliers, e.g. to warm start from a previous solution.
+      virtual void setMultipliers(const Eigen::VectorXd& multipliers) = 0;
+
+      /// \brief Get the penalty weight.
+      virtual double getPenalty() const = 0;
+
+      /// \brief Set the penalty weight, must be positive.
+      virtual void setPenalty(double penalty) = 0;
+    };
+
+    /**
+     * \class EqualityConstraintFs
+     *
+     * \brief An equality constraint of fixed dimension.
+     *
+     * Derived classes implement evaluateConstraintImplementation() and evaluateJacobiansImplementation(), which provides
+     * the Jacobian of \f$ \mathbf c(\mathbf x) \f$. The error and its weight are managed by this class, do not set an
+     * inverse covariance or an M-estimator.
+     */
+    template<int DIMENSION>
+    class EqualityConstraintFs : public ErrorTermFs<DIMENSION>, public EqualityConstraint {
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+      typedef ErrorTermFs<DIMENSION> parent_t;
+      typedef typename parent_t::error_t constraint_t;
+
+      /// \brief Constructor with zero multipliers and the initial penalty weight \p penalty
+      EqualityConstraintFs(double penalty = 1.0);
+      ~EqualityConstraintFs() override;
+
+      Eigen::VectorXd evaluateConstraint() override;
+      Eigen::VectorXd getMultipliers() const override { return _multipliers; }
+      void setMultipliers(const Eigen::VectorXd& multipliers) override;
+      double getPenalty() const override { return _penalty; }
+      void setPenalty(double penalty) override;
+
+      /// \brief The constraint value of the last evaluation
+      const constraint_t& constraint() const { return _constraint; }
+
+    protected:
+      /// \brief Evaluate the constraint \f$ \mathbf c(\mathbf x) \f$
+      virtual constraint_t evaluateConstraintImplementation() = 0;
+
+    private:
+      /// \brief Evaluates \f$ \mu \| \mathbf c + \boldsymbol\lambda / \mu \|^2 \f$
+      double evaluateErrorImplementation() final;
+
+      /// \brief The constraint value of the last evaluation
+      constraint_t _constraint;
+
+      /// \brief The Lagrange multipliers
+      constraint_t _multipliers;
+
+      /// \brief The penalty weight
+      double _penalty;
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#include "implementation/EqualityConstraintImpl.hpp"
+
+#endif /* ASLAM_BACKEND_EQUALITY_CONSTRAINT_HPP */
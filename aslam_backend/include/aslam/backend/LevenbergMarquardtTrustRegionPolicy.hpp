@@ -4,6 +4,7 @@
 #include <aslam/backend/TrustRegionPolicy.hpp>
 #include <aslam/backend/LinearSystemSolver.hpp>
 #include <boost/shared_ptr.hpp>
+#include <deque>
 
 namespace sm {
 class ConstPropertyTree;
@@ -29,12 +30,38 @@ namespace aslam {
           /// \brief should the optimizer revert on failure? You should probably return true
           bool revertOnFailure() override;
 
+          /// \brief The largest cost of the last nonmonotone window accepted states
+          double acceptanceThreshold(double J) const override;
+
+          /// \brief The gain ratio of a clipped step uses the model reduction of that step
+          void stepProjected(const Eigen::VectorXd& dx) override;
+
           /// \brief print the current state to a stream (no newlines).
           std::ostream & printState(std::ostream & out) const override;
           bool requiresAugmentedDiagonal() const override;
           std::string name() const override { return "levenberg_marquardt"; }
+
+          /// \brief The current damping parameter
+          double getLambda() const { return _lambda; }
+
+          /// \brief Add the second-order geodesic acceleration a to every step v, computed from one extra error evaluation at
+          ///        x + \p h * v and solved with the same factorization. It is dropped if 2|a|/|v| > \p alpha.
+          ///        Needs a step evaluator and a solver supporting solveSystemForError(), otherwise it has no effect.
+          void setGeodesicAcceleration(bool enable, double alpha = 0.75, double h = 0.1);
+          bool getGeodesicAcceleration() const { return _geodesicAcceleration; }
+          /// \brief Number of steps of the current optimization that included the acceleration
+          std::size_t getNumAcceleratedSteps() const { return _numAcceleratedSteps; }
+
+          /// \brief Accept steps that do not exceed the largest cost of the last \p window accepted states (Grippo et al. 1986).
+          ///        A window of one is the monotone default.
+          void setNonmonotoneWindow(std::size_t window);
+          std::size_t getNonmonotoneWindow() const { return _nonmonotoneWindow; }
         private:
           double getLmRho(const Eigen::VectorXd & dx);
+          /// \brief Add the geodesic acceleration to the velocity \p inOutDx if it passes the acceptance test
+          void addGeodesicAcceleration(Eigen::VectorXd& inOutDx);
+          /// \brief Build the system and keep what the extensions need of the current state
+          void buildSystem(int nThreads);
           double _lambdaInit;
           double _gammaInit;
           double _betaInit;
@@ -46,6 +73,21 @@ namespace aslam {
           double _beta;
           int _p;
           double _mu;
+
+          bool _geodesicAcceleration = false;
+          double _geodesicAlpha = 0.75;
+          double _geodesicStep = 0.1;
+          std::size_t _numAcceleratedSteps = 0;
+          /// \brief Error vector of the state the system was built at
+          Eigen::VectorXd _e0;
+
+          std::size_t _nonmonotoneWindow = 1;
+          /// \brief Costs of the last accepted states, newest last
+          std::deque<double> _acceptedCosts;
+
+          /// \brief Whether the bounds clipped the last step and _projectedReduction holds its model reduction
+          bool _stepProjected = false;
+          double _projectedReduction = 0.0;
         };
         
     } // namespace backend
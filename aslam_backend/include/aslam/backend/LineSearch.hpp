@@ -250,6 +250,12 @@ namespace aslam {
        */
       inline void setEvaluateGradientCallback(const boost::function<void(void)>& cb);
 
+      /**
+       * Set a callback when error and gradient are evaluated together in a single pass.
+       * The error and gradient callbacks are called as well in this case.
+       */
+      inline void setEvaluateErrorAndGradientCallback(const boost::function<void(void)>& cb);
+
       /**
        * Search for a step length that satisfies strong Wolfe conditions
        * @return Successful or not
@@ -271,6 +277,18 @@ namespace aslam {
        */
       bool lineSearchWolfe12();
 
+      /**
+       * Backtracking search along the projected path P(x + s * searchDirection), where P projects the parameters of
+       * bounded design variables onto their bounds, see DesignVariable::setBounds(). Accepts the first step length,
+       * starting at the initial step length, that satisfies the sufficient decrease condition for the projected step.
+       * If a projected step is no descent step, the search restarts along the negative projected gradient, which then
+       * remains the search direction. Used instead of the Wolfe searches for problems with bounds.
+       * @param backtrackingFactor The step length is multiplied by this factor after each rejected trial step
+       * @param outStep Optionally receives the projected step that was applied
+       * @return Successful or not
+       */
+      bool lineSearchProjected(const double backtrackingFactor = 0.5, RowVectorType* outStep = nullptr);
+
       /**
        * Updates the state with a step of length s and the related error and gradient information at the new location
        * @param s step length
@@ -293,6 +311,12 @@ namespace aslam {
        */
       void updateErrorDerivative();
 
+      /**
+       * Updates the error- and gradient-related information of the class. If both are outdated,
+       * they are computed in a single pass over the cost function.
+       */
+      void updateErrorAndErrorDerivative();
+
       /**
        * Computes the derivative of the error in the search direction
        * @return derivative of the error in the search direction
@@ -329,6 +353,11 @@ namespace aslam {
        */
       bool zoom(double minStepLength, double maxStepLength, double error_lo, double error_hi, double derror_lo, double error0, double derror0);
 
+      /**
+       * Evaluates error and gradient at the current point in a single pass and issues the callbacks
+       */
+      void evaluateErrorAndGradient();
+
     private: // private members
 
       /// \brief Cost function
@@ -364,6 +393,9 @@ namespace aslam {
       /// \brief Callback  that is called when the gradient is evaluated
       boost::function<void(void)> _evalGradCallback;
 
+      /// \brief Callback  that is called when error and gradient are evaluated in a single pass
+      boost::function<void(void)> _evalErrorAndGradCallback;
+
       /// \brief the current set of options
       LineSearchOptions _options;
 
@@ -384,6 +416,10 @@ namespace aslam {
       _evalGradCallback = cb;
     }
 
+    inline void LineSearch::setEvaluateErrorAndGradientCallback(const boost::function<void(void)>& cb) {
+      _evalErrorAndGradCallback = cb;
+    }
+
 
     inline double LineSearch::getError() const {
       SM_ASSERT_FALSE(Exception, _errorOutdated, "Missing call to updateError()");
@@ -28,6 +28,10 @@ namespace aslam {
       /// \brief Evaluate the error using nThreads.
       double evaluateError(size_t nThreads, bool useMEstimator, callback::Manager * callback = nullptr);
 
+      /// \brief Evaluate the error like evaluateError() but store the error vector in \p outE. e() is left untouched,
+      ///        so trial states can be evaluated without disturbing the linear system.
+      double evaluateTrialError(size_t nThreads, bool useMEstimator, Eigen::VectorXd& outE);
+
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       void initMatrixStructure(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner);
 
@@ -72,11 +76,79 @@ namespace aslam {
       // helper function for dog leg implementation / steepest descent solution
       virtual double rhsJtJrhs() = 0;
 
+      /// \brief outJv = J * v with the Jacobian of the last buildSystem() call.
+      ///        Returns false if the solver does not keep the Jacobian.
+      virtual bool multiplyJacobian(const Eigen::VectorXd& /* v */, Eigen::VectorXd& /* outJv */) { return false; }
+
+      /// \brief outNorm = |J * v|^2 with the Jacobian of the last buildSystem() call. The default uses multiplyJacobian().
+      ///        Returns false if the solver keeps neither J nor J^T J.
+      virtual bool jacobianSquaredNorm(const Eigen::VectorXd& v, double& outNorm);
+
+      /// \brief Solve the conditioned system for the right-hand side J^T * e instead of rhs(). \p e has the layout of e().
+      ///        Returns false if the solver does not support it or the solution failed.
+      virtual bool solveSystemForError(const Eigen::VectorXd& /* e */, Eigen::VectorXd& /* outDx */) { return false; }
+
       /// \brief If enabled the system builder must not throw on constant error terms (:= not depending on any active design variable)
       bool isAcceptConstantErrorTerms() const {
         return _acceptConstantErrorTerms;
       }
       void setAcceptConstantErrorTerms(bool acceptConstantErrorTerms);
+
+      /// \brief If enabled the Jacobian columns are equilibrated to unit norm before the system is solved and the solution
+      ///        is unscaled afterwards. The scale factors are powers of two, so the norms end up in [0.5, 1) and unscaling
+      ///        restores the system exactly. With a diagonal conditioner the damping then applies to the scaled columns.
+      ///        Takes effect with the next buildSystem() call.
+      void setColumnScaling(bool columnScaling) { _columnScaling = columnScaling; }
+      bool isColumnScaling() const { return _columnScaling; }
+
+      /// \brief The column scale factors computed by the last buildSystem() call, empty if the scaling is disabled
+      const Eigen::VectorXd& getColumnScale() const { return _columnScale; }
+
+      /// \brief Set the directions along which the error is invariant (gauge freedom), one per column with JCols() rows.
+      ///        The solutions are projected onto their orthogonal complement, which yields the minimum norm solution of the
+      ///        rank-deficient system. An empty matrix clears the directions, initMatrixStructure() does as well.
+      void setGaugeDirections(const Eigen::MatrixXd& directions);
+
+      /// \brief Orthonormal basis of the gauge directions, empty if none are set
+      const Eigen::MatrixXd& getGaugeBasis() const { return _gaugeBasis; }
+
+      /// \brief Whether the factorization copes with a rank-deficient system without a diagonal conditioner
+      virtual bool isRankRevealing() const { return false; }
+
+      /// \brief Solve the reduced system of the errors projected onto the orthogonal complement of the columns of \p basis,
+      ///        which must be orthonormal with the layout of e(): (J^T P J + D) dx = J^T P e with P = I - basis basis^T.
+      ///        If the basis spans the columns of the Jacobian of other design variables, this is the Schur complement of
+      ///        their normal equations, as in the variable projection of Optimizer2. e(), multiplyJacobian(),
+      ///        jacobianSquaredNorm() and rhsJtJrhs() use P e and P J as well. Only solvers returning true from
+      ///        supportsErrorProjection() do so. An empty matrix clears the basis, initMatrixStructure() does as well.
+      void setErrorProjection(const Eigen::MatrixXd& basis);
+
+      /// \brief The orthonormal basis of the error projection, empty if none is set
+      const Eigen::MatrixXd& getErrorProjection() const { return _errorBasis; }
+
+      /// \brief Whether the solver solves the reduced system of setErrorProjection()
+      virtual bool supportsErrorProjection() const { return false; }
+
+      /// \brief If enabled the next buildSystem() call keeps the Jacobian of the previous one and only rescales its rows
+      ///        with the M-estimator weights of the current errors (iteratively reweighted least squares). rhs() is
+      ///        recomputed from e(), which must hold the errors of the current state. Solvers that do not keep the
+      ///        Jacobian, and the first call after initMatrixStructure(), evaluate the Jacobian as usual.
+      ///        Applies to the next buildSystem() call only.
+      void setReuseJacobian(bool reuseJacobian) { _reuseJacobian = reuseJacobian; }
+      bool isReuseJacobian() const { return _reuseJacobian; }
+
+      /// \brief Whether the last buildSystem() call reused the Jacobian, see setReuseJacobian()
+      bool wasJacobianReused() const { return _jacobianReused; }
+
+      /// \brief Set the forcing term \p eta in [0, 1) of an inexact Newton method: iterative solvers may stop once the residual
+      ///        of the conditioned system is at most eta times its right-hand side, both in the Euclidean norm.
+      ///        0 asks for a solution to full precision.
+      ///        Direct solvers ignore it. Usually set by the trust region policy, see TrustRegionPolicy::setForcingTerms().
+      void setForcingTerm(double eta);
+      double getForcingTerm() const { return _forcingTerm; }
+
+      /// \brief Whether the solver is iterative and makes use of the forcing term
+      virtual bool isIterative() const { return false; }
     protected:
       /// \brief initialized the matrix structure for the problem with these error terms and errors.
       virtual void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) = 0;
@@ -94,6 +166,46 @@ namespace aslam {
       /// \brief Event hook to handle new value for the acceptConstantErrorTerms property
       virtual void handleNewAcceptConstantErrorTerms();
 
+      /// \brief The squared column norms of the Jacobian of the last buildSystem() call
+      virtual void getColumnSquaredNorms(Eigen::VectorXd& outNorms) const = 0;
+
+      /// \brief Multiply the Jacobian columns with \p scale, i.e. J <- J * diag(scale). The diagonal conditioner is not part of the system.
+      virtual void scaleColumns(const Eigen::VectorXd& scale) = 0;
+
+      /// \brief Compute the column scale of the system just built. Solvers call this at the end of buildSystem().
+      void updateColumnScale();
+
+      /// \brief Multiply the Jacobian rows with \p scale, i.e. J <- diag(scale) * J, and recompute rhs() from e().
+      ///        Returns false if the solver does not keep the Jacobian.
+      virtual bool scaleRows(const Eigen::VectorXd& /* scale */) { return false; }
+
+      /// \brief Reweight the system of the last buildSystem() call if setReuseJacobian() asked for it and return true on success.
+      ///        Solvers supporting scaleRows() call this at the beginning of buildSystem() and skip the build if it succeeds.
+      bool reweightSystem(bool useMEstimator);
+
+      /// \brief Store the row weights of the system just built. Solvers supporting scaleRows() call this at the end of buildSystem().
+      void updateRowWeights(bool useMEstimator);
+
+      /// \brief Switch the system and rhs() to the column-scaled space. Solvers call this before they solve.
+      void pushColumnScaling();
+
+      /// \brief Switch back to the original space and unscale the solution \p inOutDx
+      void popColumnScaling(Eigen::VectorXd& inOutDx);
+
+      /// \brief Remove the components along the gauge directions from the solution \p inOutDx. Solvers call this after popColumnScaling().
+      void projectGauge(Eigen::VectorXd& inOutDx) const;
+
+      /// \brief Multiply the vectors in the layout of e(), the columns of \p inOutE, with P of setErrorProjection().
+      ///        Solvers supporting it call this on J v in multiplyJacobian() and rhsJtJrhs(). It has no effect while
+      ///        applyErrorProjection() runs, which multiplies with J itself.
+      void projectErrors(Eigen::Ref<Eigen::MatrixXd> inOutE) const;
+
+      /// \brief Turn the solution \p inOutDx of the system for the errors \p e into the one of the reduced system of
+      ///        setErrorProjection(). Uses the Woodbury identity with one solveSystemForError() call per column of the basis,
+      ///        solvers supporting it without solving P J directly call this at the end of solveSystem() and
+      ///        solveSystemForError(). Returns false if the reduced system could not be solved.
+      bool applyErrorProjection(const Eigen::VectorXd& e, Eigen::VectorXd& inOutDx);
+
       /// \brief the vector of error terms.
       std::vector<ErrorTerm*> _errorTerms;
 
@@ -120,6 +232,36 @@ namespace aslam {
 
       /// \brief The number of columns in the Jacobian matrix
       size_t _JCols;
+
+      /// \brief Should the Jacobian columns be equilibrated
+      bool _columnScaling = false;
+
+      /// \brief The column scale factors, empty if the scaling is disabled
+      Eigen::VectorXd _columnScale;
+
+      /// \brief The rhs() of the other space while the column scaling is pushed
+      Eigen::VectorXd _swappedRhs;
+
+      /// \brief Orthonormal basis of the gauge directions, empty if none are set
+      Eigen::MatrixXd _gaugeBasis;
+
+      /// \brief Orthonormal basis of the projected error directions, empty if none are set
+      Eigen::MatrixXd _errorBasis;
+
+      /// \brief Whether applyErrorProjection() is solving the unreduced system
+      bool _applyingErrorProjection = false;
+
+      /// \brief Should the next buildSystem() call reuse the Jacobian
+      bool _reuseJacobian = false;
+
+      /// \brief Did the last buildSystem() call reuse the Jacobian
+      bool _jacobianReused = false;
+
+      /// \brief The square root of the M-estimator weight each error term had in the Jacobian, empty if there is none to reuse
+      std::vector<double> _rowSqrtWeights;
+
+      /// \brief The relative residual tolerance of iterative solvers, 0 for full precision
+      double _forcingTerm = 0.0;
     };
 
   } // namespace backend
@@ -45,14 +45,37 @@ private:
   void evaluateJacobiansImplementation(JacobianContainer & outJ) override;
 
   // computes the minimal difference of all design variables between the linearization point at marginalization and the current guess (i.e. log(x_bar - x))
-  Eigen::VectorXd getDifferenceSinceMarginalization();
+  const Eigen::VectorXd& getDifferenceSinceMarginalization();
+
+  // analyzes the block structure of R, see ColumnSlice
+  void computeColumnSlices();
+
+  // a contiguous range of rows holding non-zero blocks of a column slice
+  struct RowRange {
+    int start;
+    int rows;
+  };
+
+  // the columns of R belonging to one design variable. As R is upper triangular
+  // (and often block sparse after marginalization) only a few row ranges are non-zero.
+  struct ColumnSlice {
+    int col;
+    int cols;
+    std::vector<RowRange> nonZeroRows;
+  };
 
   std::vector<DesignVariable*> _designVariables;
   Eigen::VectorXd _d;
-  Eigen::MatrixXd _R; // R from the QR decomposition!!!
+  Eigen::MatrixXd _R; // R from the QR decomposition!!! Column major, so the slices can be handed out without copies.
+  std::vector<ColumnSlice> _columnSlices;
   int _dimensionDesignVariables;
   // store values of design variables at time of marginalization
   std::vector<Eigen::MatrixXd> _designVariableValuesAtMarginalization;
+
+  // scratch memory reused across evaluations
+  Eigen::VectorXd _diff;
+  Eigen::VectorXd _currentError;
+  Eigen::MatrixXd _jacobian;
 };
 
 } /* namespace backend */
@@ -16,6 +16,10 @@
 #include <sm/boost/null_deleter.hpp>
 #include <boost/thread.hpp>
 
+namespace sparse_block_matrix {
+  template <typename MatrixType> class LinearSolverCholmod;
+}
+
 namespace aslam {
   namespace backend {
     /**
@@ -49,6 +53,7 @@ namespace aslam {
       SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
 
       typedef sparse_block_matrix::LinearSolver<Eigen::MatrixXd> LinearSolver;
+      typedef sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> CovarianceSolver;
 
       Optimizer(const Options& options = Options());
       virtual ~Optimizer();
@@ -111,6 +116,10 @@ namespace aslam {
       /// \brief compute only the covariance blocks associated with the block indices passed as an argument
       void computeCovarianceBlocks(const std::vector<std::pair<int, int> >& blockIndices);
 
+      /// \brief drop the cached factorization used for covariance queries.
+      ///        Call this after changing design variables outside of optimize() and before querying covariances again.
+      void invalidateCovarianceFactor();
+
       /// \brief get a particular covariance block. If the block has not been computed, this will return NULL.
       const Eigen::MatrixXd* getCovarianceBlock(int blockRow, int blockCol) const;
 
@@ -170,6 +179,9 @@ namespace aslam {
       /// \brief Returns Rho for the LM lambda update
       double getLmRho();
 
+      /// \brief Pass the ordering groups of the design variables to the Cholmod solvers.
+      void setOrderingConstraints();
+
       /// \brief Set the initial lambda by looking at the entries of the Hessian matrix.
       void setInitialLambda();
 
@@ -214,6 +226,15 @@ namespace aslam {
       boost::shared_ptr<LinearSolver> _solver;
       boost::shared_ptr<LinearSolver> _fallbackSolver;
 
+      /// \brief Solver holding the factorization of _H (without the LM lambda) for covariance queries.
+      boost::shared_ptr<CovarianceSolver> _covarianceSolver;
+
+      /// \brief True if the factorization available for covariance queries belongs to the current _H.
+      bool _covarianceFactorValid;
+
+      /// \brief True if the last successful solve of _solver factored exactly _H (plain GN without Schur complement).
+      bool _solverFactorIsH;
+
       /// \brief The current optimization problem.
       boost::shared_ptr<OptimizationProblemBase> _problem;
 
@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_OPTIMIZER_2_HPP
 
 
+#include <unordered_set>
 #include <boost/shared_ptr.hpp>
 //#include <boost/function.hpp>
 #include <sm/assert_macros.hpp>
@@ -19,6 +20,7 @@
 #include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
 #include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
 #include <aslam/backend/DogLegTrustRegionPolicy.hpp>
+#include <aslam/backend/SubspaceTrustRegionPolicy.hpp>
 #include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
 
 namespace sm {
@@ -29,12 +31,22 @@ namespace sm {
 namespace aslam {
   namespace backend {
     class LinearSystemSolver;
+    class EqualityConstraint;
 
     /**
      * \class Optimizer2
      *
      * A sparse Gauss-Newton/LM optimizer.
      *
+     * Design variables with box bounds (DesignVariable::setBounds()) are kept feasible by projecting every step onto
+     * the bounds. Bounded design variables with all parameters at an active bound, i.e. the gradient pushes them out of
+     * the box, are fixed and their columns are left out of the linear system until the gradient releases them.
+     *
+     * Problems with equality constraints (EqualityConstraint) are solved with the augmented Lagrangian method: the
+     * unconstrained optimization is repeated with updated multipliers and penalties until the constraints hold. The
+     * sparsity pattern does not change between these solves, the matrix structure and its symbolic factorization are
+     * reused. The reported error J includes the augmented Lagrangian terms of the constraints.
+     *
      * The notation in this file follows Harley and Zisserman, Appendix 6.
      *
      * Some Additions to the standard algorithm:
@@ -58,6 +70,10 @@ namespace aslam {
       typedef Optimizer2Options Options;
       struct Status : public OptimizerStatus {
         SolutionReturnValue srv;
+        std::size_t numAugmentedLagrangianIterations = 0; /// \brief Number of multiplier updates of the equality constraints
+        double constraintViolation = 0.0; /// \brief Largest absolute constraint value at the end of the optimization, zero without constraints
+        std::size_t numJacobianReuses = 0; /// \brief Number of linear systems built by reweighting the previous Jacobian, see Optimizer2Options::irlsJacobianReuse
+        std::size_t numVariableProjections = 0; /// \brief Number of updates of the linear design variables by variable projection, see Optimizer2::setLinearDesignVariables()
        private:
         void resetImplementation() override;
       };
@@ -76,6 +92,59 @@ namespace aslam {
       /// \brief Run the optimization
       SolutionReturnValue optimize();
 
+      /// \brief Switch to block-coordinate mode: each sweep of optimize() activates one group of design variables at a time
+      ///        and runs Options::blockCoordinateInnerIterations iterations on the error terms touching that group only.
+      ///        The groups must be disjoint subsets of the active design variables. The linear system structure of
+      ///        every group is built once in initialize() and reused across group switches and sweeps.
+      void setBlockCoordinateGroups(const std::vector< std::vector<DesignVariable*> >& groups);
+
+      /// \brief Leave block-coordinate mode and optimize all design variables jointly again.
+      void clearBlockCoordinateGroups();
+
+      /// \brief The design variable groups used in block-coordinate mode. Empty if the mode is disabled.
+      const std::vector< std::vector<DesignVariable*> >& getBlockCoordinateGroups() const { return _blockCoordinateGroups; }
+
+      /// \brief Solve a separable problem with variable projection. The residuals must depend linearly on the design variables
+      ///        \p linearDesignVariables, e.g. biases, gains or offsets. They are eliminated from the linear system, which only has
+      ///        the columns of the nonlinear design variables: with the orthonormal basis Q of the columns of the Jacobian
+      ///        matrix of the linear design variables, the trust region policy solves (J^T P J + D) dx = J^T P e with
+      ///        P = I - Q Q^T. This is the Schur complement of the linear block and the reduced step of Kaufman, the damping
+      ///        and the trust regions of the policies act on the nonlinear design variables only.
+      ///        Before every evaluation of the error, including the trial steps of the policies, the linear design variables
+      ///        are set to their least-squares solution for the current state of the others, which evaluates the errors and
+      ///        Jacobians of the error terms touching them and factorizes their normal equations. Q is computed from the
+      ///        Jacobian matrix of the projection of each accepted state. Meant for a few linear parameters, Q is a dense
+      ///        matrix with one row per error and sparse_cholesky solves one more system per column of Q.
+      ///        The linear system solver must support error projections, e.g. sparse_cholesky or dense_qr.
+      ///        The linear design variables must be active design variables of the problem without box bounds.
+      ///        Not supported in block-coordinate mode or with gauge directions.
+      void setLinearDesignVariables(const std::vector<DesignVariable*>& linearDesignVariables);
+
+      /// \brief Stop eliminating the linear design variables and optimize them with all others again.
+      void clearLinearDesignVariables();
+
+      /// \brief The design variables eliminated by variable projection. Empty if the mode is disabled.
+      const std::vector<DesignVariable*>& getLinearDesignVariables() const { return _linearDesignVariables; }
+
+      /// \brief Fills a matrix with the directions along which the error is invariant (gauge freedom), one per column
+      ///        and one row per minimal parameter of the design variables of the problem, in their order.
+      typedef boost::function<void(Eigen::MatrixXd& outDirections)> GaugeFunction;
+
+      /// \brief Handle the gauge freedom, e.g. a global rigid transformation, by projecting the steps onto the orthogonal
+      ///        complement of the gauge directions instead of deactivating design variables. \p gauge is called before every
+      ///        solution of the linear system, as the directions usually depend on the state. Changing the directions, e.g. to
+      ///        switch the anchor, needs no re-initialization. Ignored in block-coordinate mode.
+      void setGaugeFunction(const GaugeFunction& gauge);
+
+      /// \brief Handle the gauge freedom with constant directions, see setGaugeFunction()
+      void setGaugeDirections(const Eigen::MatrixXd& directions);
+
+      /// \brief Stop handling the gauge freedom
+      void clearGaugeDirections();
+
+      /// \brief Whether gauge directions are set
+      bool hasGaugeDirections() const { return !_gaugeFunction.empty(); }
+
       /// \brief Return the status
       const Status& getStatus() const override { return _status; }
 
@@ -148,6 +217,84 @@ namespace aslam {
 
     private:
 
+      /// \brief Cached subproblem of one design variable group in block-coordinate mode
+      struct BlockCoordinateGroup {
+        std::vector<DesignVariable*> designVariables;
+        std::vector<ErrorTerm*> errorTerms; /// \brief The squared error terms touching at least one design variable of the group
+        boost::shared_ptr<LinearSystemSolver> solver; /// \brief Solver with the matrix structure of this group
+      };
+
+      /// \brief Build the cached subproblems of the design variable groups.
+      void initializeBlockCoordinateGroups();
+
+      /// \brief Make group \p g the only active design variables and assign group-local block indices, column and row bases.
+      void activateBlockCoordinateGroup(size_t g);
+
+      /// \brief Activate the design variables of \p group only and assign group-local block indices, column and row bases.
+      ///        The design variables outside the group must be inactive.
+      static void assignGroupIndices(const BlockCoordinateGroup& group);
+
+      /// \brief Restore the activation and indices of the full problem as set up by the problem manager.
+      void restoreFullProblem();
+
+      /// \brief Build the cached subproblem of the linear design variables.
+      void initializeVariableProjection();
+
+      /// \brief Remove the linear design variables from the linear system of the optimization, if there are any.
+      void beginVariableProjection();
+
+      /// \brief Restore the linear system with the linear design variables.
+      void endVariableProjection();
+
+      /// \brief Set the linear design variables to their least-squares solution at the current state and keep the Jacobian
+      ///        matrix of their subproblem. The update is applied with DesignVariable::update() also if the solution fails,
+      ///        so a following revertLastStateUpdate() restores the state before the last step.
+      void projectLinearDesignVariables();
+
+      /// \brief Compute the orthonormal basis of the columns of the Jacobian matrix of the last projection.
+      void updateLinearErrorBasis();
+
+      /// \brief Run the optimization in block-coordinate mode
+      void optimizeBlockCoordinates();
+
+      /// \brief Run the optimization of all design variables jointly
+      void optimizeJointly();
+
+      /// \brief Run the unconstrained optimization in the configured mode
+      void optimizeUnconstrained();
+
+      /// \brief Run the augmented Lagrangian outer loop over unconstrained optimizations
+      void optimizeAugmentedLagrangian();
+
+      /// \brief The largest absolute constraint value at the current state
+      double evaluateConstraintViolation(std::vector<Eigen::VectorXd>& outConstraints);
+
+      /// \brief Fix the bounded design variables with all parameters at an active bound and rebuild the linear system
+      ///        without their columns if the set changed. Returns true if the linear system changed. Sets \p outAllFixed
+      ///        if all design variables are at an active bound, the linear system is not changed in this case.
+      bool updateActiveBounds(bool& outAllFixed);
+
+      /// \brief Deactivate the fixed and projected design variables and assign block indices and column bases to the free ones.
+      void activateFreeDesignVariables();
+
+      /// \brief Whether all design variables are in the linear system, none is fixed at a bound or projected.
+      bool isFullProblemActive() const { return _fixedDesignVariables.empty() && !_variableProjectionActive; }
+
+      /// \brief Set up the linear system on the free design variables, or on all if isFullProblemActive().
+      void initializeActiveLinearSystem();
+
+      /// \brief Release the design variables fixed at a bound and restore the linear system without them.
+      void releaseActiveBounds();
+
+      /// \brief The design variables the current state update applies to
+      const std::vector<DesignVariable*>& activeDesignVariables() const;
+
+      /// \brief Whether the joint linear system needs a diagonal conditioner, for the trust region policy or the gauge regularization
+      bool useDiagonalConditioner() const;
+
+      /// \brief Pass the gauge directions at the current state to the solver
+      void updateGaugeDirections();
+
       /// \brief Zero the Gauss-Newton matrices.
       void zeroMatrices();
 
@@ -157,9 +304,15 @@ namespace aslam {
       /// \brief Apply a state update.
       double applyStateUpdate();
 
-      /// \brief issue callback for given event
+      /// \brief Apply the state update \p dx.
+      double applyStateUpdate(const Eigen::VectorXd& dx);
+
+      /// \brief Cost after the state update \p dx, the state is reverted afterwards. Installed as step evaluator of the trust region policy.
+      double evaluateTrialStep(const Eigen::VectorXd& dx, Eigen::VectorXd* outE);
+
+      /// \brief issue callback for given event and latch its instruction
       template<typename Event>
-      void issueCallback();
+      callback::ProceedInstruction issueCallback();
 
       void optimizeImplementation() override;
 
@@ -183,6 +336,58 @@ namespace aslam {
 
       /// \brief A class that manages the optimizer callbacks
       callback::Manager _callbackManager;
+
+      /// \brief The design variable groups as set by the user
+      std::vector< std::vector<DesignVariable*> > _blockCoordinateGroups;
+
+      /// \brief The cached subproblems, one per group
+      std::vector<BlockCoordinateGroup> _groups;
+
+      /// \brief Index of the currently active group, -1 if the full problem is active
+      int _activeGroup = -1;
+
+      /// \brief The design variables eliminated by variable projection as set by the user
+      std::vector<DesignVariable*> _linearDesignVariables;
+
+      /// \brief The cached subproblem of the linear design variables, without solver if variable projection is disabled
+      BlockCoordinateGroup _linearGroup;
+
+      /// \brief Lookup of the linear design variables
+      std::unordered_set<const DesignVariable*> _linearDesignVariableSet;
+
+      /// \brief The row bases of the error terms of _linearGroup in the full problem
+      std::vector<size_t> _linearErrorTermRowBases;
+
+      /// \brief The Jacobian matrix of the subproblem of the linear design variables at the last projection
+      Eigen::MatrixXd _linearJacobian;
+
+      /// \brief Orthonormal basis of the columns of the Jacobian matrix of the linear design variables at the last accepted
+      ///        state, in the rows of the full problem
+      Eigen::MatrixXd _linearErrorBasis;
+
+      /// \brief Whether the linear design variables are removed from the linear system
+      bool _variableProjectionActive = false;
+
+      /// \brief The design variables with box bounds
+      std::vector<DesignVariable*> _boundedDesignVariables;
+
+      /// \brief The squared error terms touching each of the bounded design variables
+      std::vector< std::vector<ErrorTerm*> > _boundedErrorTerms;
+
+      /// \brief The bounded design variables fixed at an active bound, in the order of the problem
+      std::vector<DesignVariable*> _fixedDesignVariables;
+
+      /// \brief The design variables of the linear system while design variables are fixed at a bound or projected
+      std::vector<DesignVariable*> _freeDesignVariables;
+
+      /// \brief Whether the solver accepted constant error terms before design variables were fixed or projected
+      bool _solverAcceptedConstantErrorTerms = false;
+
+      /// \brief The equality constraints among the error terms of the problem
+      std::vector<EqualityConstraint*> _constraints;
+
+      /// \brief Computes the gauge directions, empty if the gauge freedom is not handled
+      GaugeFunction _gaugeFunction;
     };
 
 } // namespace backend
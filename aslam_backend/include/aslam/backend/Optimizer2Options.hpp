@@ -3,6 +3,7 @@
 
 #include <ostream>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 
 #include <aslam/backend/OptimizerBase.hpp>
 
@@ -15,7 +16,17 @@ namespace aslam {
       Optimizer2Options() :
         doSchurComplement(false),
         verbose(false),
-        linearSolverMaximumFails(0)
+        linearSolverMaximumFails(0),
+        blockCoordinateInnerIterations(3),
+        warmStartTrustRegion(false),
+        warmStartDecay(1.0),
+        maxAugmentedLagrangianIterations(20),
+        constraintTolerance(1e-6),
+        penaltyIncreaseFactor(10.0),
+        maxPenalty(1e8),
+        gaugeRegularization(1e-6),
+        irlsJacobianReuse(0),
+        maxForcingTerm(0.0)
       {
         convergenceDeltaError = 1e-3;
         convergenceDeltaX = 1e-3;
@@ -31,8 +42,46 @@ namespace aslam {
       /// \brief The number of times the linear solver may fail before the optimization is aborted. (>0 only if a fall back is available!)
       int linearSolverMaximumFails;
 
+      /// \brief The number of trust region iterations per design variable group and sweep in block-coordinate mode (see Optimizer2::setBlockCoordinateGroups).
+      int blockCoordinateInnerIterations;
+
+      /// \brief Carry the trust region state (LM lambda and mu, dogleg radius) over from one optimize() call to the next, e.g. for sliding window estimation.
+      bool warmStartTrustRegion;
+
+      /// \brief Relaxes the carried trust region state at the start of each optimize() call, in (0, 1]. See TrustRegionPolicy::setWarmStart().
+      double warmStartDecay;
+
+      /// \brief The maximum number of multiplier updates for problems with equality constraints (see EqualityConstraint). Each one is preceded by an unconstrained optimization of up to maxIterations iterations.
+      int maxAugmentedLagrangianIterations;
+
+      /// \brief The constraints are satisfied if no constraint value exceeds this tolerance in magnitude.
+      double constraintTolerance;
+
+      /// \brief The penalty weight of all constraints is multiplied by this factor if an outer iteration did not reduce the constraint violation to a quarter.
+      double penaltyIncreaseFactor;
+
+      /// \brief The penalty weight is not increased beyond this value.
+      double maxPenalty;
+
+      /// \brief Added to the diagonal of the normal equations while gauge directions are set (see Optimizer2::setGaugeDirections),
+      ///        unless the trust region policy damps the system or the solver is rank-revealing. Small compared to the diagonal.
+      double gaugeRegularization;
+
+      /// \brief The number of iterations after each Jacobian evaluation that keep the Jacobian and only update the M-estimator weights of its rows
+      ///        (iteratively reweighted least squares, see LinearSystemSolver::setReuseJacobian). 0 evaluates the Jacobian in every iteration.
+      ///        Suited for robust problems whose linearization changes slowly. The Jacobian is not reused after a rejected step.
+      int irlsJacobianReuse;
+
+      /// \brief Lets iterative linear solvers stop early with Eisenstat-Walker forcing terms up to this value, in [0, 1).
+      ///        See TrustRegionPolicy::setForcingTerms(). 0 leaves the forcing terms of the trust region policy unchanged.
+      double maxForcingTerm;
+
       boost::shared_ptr<LinearSystemSolver> linearSystemSolver;
+      /// \brief Defaults to levenberg_marquardt if empty. Alternatives are gauss_newton, dog_leg, subspace and line_search.
       boost::shared_ptr<TrustRegionPolicy> trustRegionPolicy;
+
+      /// \brief Creates the linear system solver of each design variable group in block-coordinate mode. Defaults to the sparse_cholesky solver if empty.
+      boost::function<boost::shared_ptr<LinearSystemSolver>()> blockCoordinateSolverFactory;
     };
 
     inline std::ostream& operator<<(std::ostream& out, const aslam::backend::Optimizer2Options& options)
@@ -41,6 +90,16 @@ namespace aslam {
       out << "\tdoSchurComplement: " << options.doSchurComplement << std::endl;
       out << "\tverbose: " << options.verbose << std::endl;
       out << "\tlinearSolverMaximumFails: " << options.linearSolverMaximumFails << std::endl;
+      out << "\tblockCoordinateInnerIterations: " << options.blockCoordinateInnerIterations << std::endl;
+      out << "\twarmStartTrustRegion: " << options.warmStartTrustRegion << std::endl;
+      out << "\twarmStartDecay: " << options.warmStartDecay << std::endl;
+      out << "\tmaxAugmentedLagrangianIterations: " << options.maxAugmentedLagrangianIterations << std::endl;
+      out << "\tconstraintTolerance: " << options.constraintTolerance << std::endl;
+      out << "\tpenaltyIncreaseFactor: " << options.penaltyIncreaseFactor << std::endl;
+      out << "\tmaxPenalty: " << options.maxPenalty << std::endl;
+      out << "\tgaugeRegularization: " << options.gaugeRegularization << std::endl;
+      out << "\tirlsJacobianReuse: " << options.irlsJacobianReuse << std::endl;
+      out << "\tmaxForcingTerm: " << options.maxForcingTerm << std::endl;
       return out;
     }
   } // namespace backend
@@ -9,6 +9,7 @@
 #define INCLUDE_ASLAM_BACKEND_OPTIMIZERBASE_HPP_
 
 // standard
+#include <chrono>
 #include <iostream>
 #include <limits> // signaling_NaN, max
 
@@ -38,6 +39,8 @@ enum ConvergenceStatus
   DX,             //!< DX
   DOBJECTIVE,     //!< DOBJECTIVE
   MAX_ITERATIONS, //!< MAX_ITERATIONS
+  TIME_LIMIT,     //!< TIME_LIMIT, the wall-clock budget OptimizerOptionsBase::maxTimeMs was used up
+  CALLBACK_STOP,  //!< CALLBACK_STOP, a callback returned ProceedInstruction::SUCCEED
 };
 
 /// \brief Stream operator for ConvergenceStatus
@@ -62,6 +65,7 @@ struct OptimizerOptionsBase
   int maxIterations = 100; /// \brief Stop if we reach this number of iterations without hitting any of the above stopping criteria. -1 for unlimited.
   std::size_t numThreadsJacobian = 4; /// \brief The number of threads to use for gradient/Jacobian computation
   std::size_t numThreadsError = 1; /// \brief The number of threads to use for error computation
+  double maxTimeMs = -1.0; /// \brief Wall-clock budget of one optimize() call in milliseconds. The optimizer stops before an iteration that is expected to overrun the budget. Non-positive values disable the limit.
 
   /// \brief Checks options for sanity. Throws if any options is not valid.
   virtual void check() const;
@@ -95,6 +99,7 @@ struct OptimizerStatus
   std::size_t numIterations = 0; /// \brief Number of iterations run
   std::size_t numJacobianEvaluations = 0; /// \brief Number of Jacobian/gradient evaluations performed
   std::size_t numErrorEvaluations = 0; /// \brief Number of objective/error evaluations performed
+  std::size_t numErrorAndGradientEvaluations = 0; /// \brief Number of error evaluations fused with a gradient evaluation (also counted above). Each one saved a pass over the error terms.
   double gradientNorm = std::numeric_limits<double>::signaling_NaN(); /// \brief Norm of the gradient
   double maxDeltaX = std::numeric_limits<double>::signaling_NaN(); /// \brief Maximum absolute value of change in design variables
   double error = std::numeric_limits<double>::max(); /// \brief Current error/objective value. numeric_limits<double>::max() if error is not evaluated.
@@ -174,6 +179,20 @@ class OptimizerBase
   ///        before you call this method.
   void updateConvergenceStatus();
 
+  /// \brief Remember the first instruction other than CONTINUE returned by a callback. Returns \p instruction.
+  callback::ProceedInstruction handleProceedInstruction(callback::ProceedInstruction instruction);
+
+  /// \brief Whether the optimization has to stop because a callback asked for it or because an iteration taking
+  ///        \p expectedIterationTimeMs would overrun the time budget. Sets the convergence status if so.
+  ///        Only call this at a state the optimizer may return with, i.e. after rejected steps are reverted.
+  bool stopRequested(double expectedIterationTimeMs = 0.0);
+
+  /// \brief Call at the start of every iteration. Calls stopRequested() with the longest iteration time observed so far.
+  bool stopRequestedBeforeIteration();
+
+  /// \brief Wall time since optimize() was called in milliseconds
+  double elapsedTimeMs() const;
+
   /// \brief A class that manages the optimizer callbacks
   callback::Manager _callbackManager;
 
@@ -188,6 +207,18 @@ class OptimizerBase
   /// \brief Mutable getter for the options
   inline OptimizerStatus& status();
 
+  /// \brief Start time of the current optimize() call
+  std::chrono::steady_clock::time_point _startTime;
+
+  /// \brief Instruction latched by handleProceedInstruction()
+  callback::ProceedInstruction _proceedInstruction = callback::ProceedInstruction::CONTINUE;
+
+  /// \brief Start of the current iteration relative to _startTime, negative before the first iteration
+  double _iterationStartMs = -1.0;
+
+  /// \brief Longest iteration of the current optimize() call so far
+  double _maxIterationTimeMs = 0.0;
+
 };
 
 } /* namespace aslam */
@@ -0,0 +1,133 @@
+#ifndef ASLAM_BACKEND_OPTIMIZER_LBFGS_HPP
+#define ASLAM_BACKEND_OPTIMIZER_LBFGS_HPP
+
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/LineSearch.hpp>
+
+namespace sm {
+  class PropertyTree;
+}
+
+namespace aslam {
+  namespace backend {
+
+    struct OptimizerOptionsLBFGS : public OptimizerOptionsBase
+    {
+      OptimizerOptionsLBFGS();
+      OptimizerOptionsLBFGS(const sm::PropertyTree& config);
+      LineSearchOptions linesearch; /// \brief Linesearch options
+      std::size_t historySize = 10; /// \brief Number of correction pairs (s_k, y_k) kept to approximate the inverse Hessian
+      bool useDenseJacobianContainer = true; /// \brief Whether or not to use a dense Jacobian container
+
+      void check() const override;
+
+      template<class Archive>
+      inline void serialize(Archive & ar, const unsigned int version);
+    };
+
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsLBFGS& options);
+
+    typedef OptimizerStatus OptimizerStatusLBFGS;
+
+    /**
+     * \class OptimizerLBFGS
+     *
+     * Limited-memory Broyden-Fletcher-Goldfarb-Shannon algorithm implementation for the ASLAM framework.
+     * Instead of the dense inverse Hessian approximation of OptimizerBFGS, only the last m = historySize
+     * correction pairs are stored and the search direction is computed with the two-loop recursion
+     * (Nocedal and Wright, 'Numerical Optimization', 2006, Algorithm 7.4). This requires O(mn) memory and time per iteration.
+     */
+    class OptimizerLBFGS : public OptimizerProblemManagerBase
+    {
+     public:
+      typedef boost::shared_ptr<OptimizerLBFGS> Ptr;
+      typedef boost::shared_ptr<const OptimizerLBFGS> ConstPtr;
+      typedef OptimizerOptionsLBFGS Options;
+      typedef OptimizerStatusLBFGS Status;
+
+     public:
+      /// \brief Constructor with default options
+      OptimizerLBFGS();
+      /// \brief Constructor with custom options
+      OptimizerLBFGS(const Options& options);
+      /// \brief Constructor from property tree
+      OptimizerLBFGS(const sm::PropertyTree& config);
+      /// \brief Destructor
+      ~OptimizerLBFGS() override;
+
+      /// \brief Return the status
+      const Status& getStatus() const override { return _status; }
+
+      /// \brief Get the optimizer options.
+      const Options& getOptions() const override { return _options; }
+
+      /// \brief Set the optimizer options. Changing the history size requires a call to reset().
+      void setOptions(const Options& options) { _options = options; _linesearch.options() = _options.linesearch; }
+
+      /// \brief Set the optimizer options.
+      void setOptions(const OptimizerOptionsBase& options) override { static_cast<OptimizerOptionsBase&>(_options) = options; }
+
+      /// \brief Const getter for the linesearch object
+      const LineSearch& getLineSearch() const { return _linesearch; }
+
+      /// \brief Number of correction pairs currently stored
+      std::size_t getHistoryLength() const { return _historyLength; }
+
+    private:
+
+      /// \brief Run the optimization
+      void optimizeImplementation() override;
+
+      /// \brief Reset information
+      void resetImplementation() override;
+
+      /// \brief Update the status
+      void updateStatus(bool lineSearchSuccess);
+
+      /// \brief Compute the search direction -H_k * gradient with the two-loop recursion
+      void computeSearchDirection(const RowVectorType& gradient, RowVectorType& searchDirection);
+
+      /// \brief Store the correction pair (s_k, y_k), dropping the oldest one if the history is full.
+      ///        Returns false if the pair was skipped because of a violated curvature condition.
+      bool pushCorrectionPair(const RowVectorType& sk, const RowVectorType& yk);
+
+      /// \brief Forget all correction pairs, the next search direction will be the steepest descent direction
+      void clearHistory() { _historyLength = 0; _historyStart = 0; }
+
+    private:
+
+      /// \brief the current set of options
+      Options _options;
+
+      /// \brief Column i holds the state difference s_i of correction pair i (n x m ring buffer)
+      Eigen::MatrixXd _S;
+
+      /// \brief Column i holds the gradient difference y_i of correction pair i (n x m ring buffer)
+      Eigen::MatrixXd _Y;
+
+      /// \brief 1/(y_i^T s_i) of the stored correction pairs
+      Eigen::VectorXd _rho;
+
+      /// \brief Scratch space for the coefficients of the first loop
+      Eigen::VectorXd _alpha;
+
+      /// \brief Index of the oldest correction pair in the ring buffer
+      std::size_t _historyStart = 0;
+
+      /// \brief Number of stored correction pairs
+      std::size_t _historyLength = 0;
+
+      /// \brief Line-search class
+      LineSearch _linesearch;
+
+      /// \brief Status of the optimizer
+      Status _status;
+
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#include "implementation/OptimizerLBFGSImpl.hpp"
+
+#endif /* ASLAM_BACKEND_OPTIMIZER_LBFGS_HPP */
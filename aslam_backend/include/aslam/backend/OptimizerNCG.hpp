@@ -0,0 +1,118 @@
+#ifndef ASLAM_BACKEND_OPTIMIZER_NCG_HPP
+#define ASLAM_BACKEND_OPTIMIZER_NCG_HPP
+
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/LineSearch.hpp>
+
+namespace sm {
+  class PropertyTree;
+}
+
+namespace aslam {
+  namespace backend {
+
+    struct OptimizerOptionsNCG : public OptimizerOptionsBase
+    {
+      enum Method { POLAK_RIBIERE_PLUS, HAGER_ZHANG };
+
+      OptimizerOptionsNCG();
+      OptimizerOptionsNCG(const sm::PropertyTree& config);
+      LineSearchOptions linesearch; /// \brief Linesearch options. A small c2WolfeCondition (e.g. 0.1) yields more accurate line minima, which conjugate gradient methods benefit from.
+      Method method = POLAK_RIBIERE_PLUS; /// \brief Formula for the conjugate direction update parameter beta
+      std::size_t restartInterval = 0; /// \brief Restart with the steepest descent direction after this many iterations. Zero means after numOptParameters iterations.
+      double restartThreshold = 0.2; /// \brief Powell restart if |g_{k+1}^T g_k| >= restartThreshold * |g_{k+1}|^2, i.e. successive gradients are far from orthogonal. Non-positive values disable the test.
+      bool useDenseJacobianContainer = true; /// \brief Whether or not to use a dense Jacobian container
+
+      void check() const override;
+
+      template<class Archive>
+      inline void serialize(Archive & ar, const unsigned int version);
+    };
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsNCG::Method& method);
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsNCG& options);
+
+    typedef OptimizerStatus OptimizerStatusNCG;
+
+    /**
+     * \class OptimizerNCG
+     *
+     * Nonlinear conjugate gradient implementation for the ASLAM framework. The search direction is
+     * d_{k+1} = -g_{k+1} + beta_k d_k with either the Polak-Ribiere+ or the Hager-Zhang
+     * (Hager and Zhang, 'A new conjugate gradient method with guaranteed descent and an efficient line search', 2005)
+     * formula for beta_k. Only a constant number of vectors is stored, i.e. memory is O(n).
+     */
+    class OptimizerNCG : public OptimizerProblemManagerBase
+    {
+     public:
+      typedef boost::shared_ptr<OptimizerNCG> Ptr;
+      typedef boost::shared_ptr<const OptimizerNCG> ConstPtr;
+      typedef OptimizerOptionsNCG Options;
+      typedef OptimizerStatusNCG Status;
+
+     public:
+      /// \brief Constructor with default options
+      OptimizerNCG();
+      /// \brief Constructor with custom options
+      OptimizerNCG(const Options& options);
+      /// \brief Constructor from property tree
+      OptimizerNCG(const sm::PropertyTree& config);
+      /// \brief Destructor
+      ~OptimizerNCG() override;
+
+      /// \brief Return the status
+      const Status& getStatus() const override { return _status; }
+
+      /// \brief Get the optimizer options.
+      const Options& getOptions() const override { return _options; }
+
+      /// \brief Mutable getter for the optimizer options (we explicitly allow direct modification of options).
+      Options& getOptions() { return _options; }
+
+      /// \brief Set the optimizer options.
+      void setOptions(const Options& options) { _options = options; _linesearch.options() = _options.linesearch; }
+
+      /// \brief Set the optimizer options.
+      void setOptions(const OptimizerOptionsBase& options) override { static_cast<OptimizerOptionsBase&>(_options) = options; }
+
+      /// \brief Const getter for the linesearch object
+      const LineSearch& getLineSearch() const { return _linesearch; }
+
+      /// \brief Number of restarts with the steepest descent direction since the last reset
+      std::size_t getNumRestarts() const { return _numRestarts; }
+
+    private:
+
+      /// \brief Run the optimization
+      void optimizeImplementation() override;
+
+      /// \brief Reset information
+      void resetImplementation() override;
+
+      /// \brief Update the status
+      void updateStatus(bool lineSearchSuccess);
+
+      /// \brief Compute the update parameter beta_k for the new gradient \p gfkp1, the previous gradient \p gfk and search direction \p pk
+      double computeBeta(const RowVectorType& gfkp1, const RowVectorType& gfk, const RowVectorType& pk) const;
+
+    private:
+
+      /// \brief the current set of options
+      Options _options;
+
+      /// \brief Line-search class
+      LineSearch _linesearch;
+
+      /// \brief Number of restarts
+      std::size_t _numRestarts = 0;
+
+      /// \brief Status of the optimizer
+      Status _status;
+
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#include "implementation/OptimizerNCGImpl.hpp"
+
+#endif /* ASLAM_BACKEND_OPTIMIZER_NCG_HPP */
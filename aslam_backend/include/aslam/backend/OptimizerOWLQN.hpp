@@ -0,0 +1,179 @@
+#ifndef ASLAM_BACKEND_OPTIMIZER_OWLQN_HPP
+#define ASLAM_BACKEND_OPTIMIZER_OWLQN_HPP
+
+#include <aslam/backend/util/OptimizerProblemManagerBase.hpp>
+#include <aslam/backend/LineSearch.hpp>
+
+namespace sm {
+  class PropertyTree;
+}
+
+namespace aslam {
+  namespace backend {
+
+    struct OptimizerOptionsOWLQN : public OptimizerOptionsBase
+    {
+      OptimizerOptionsOWLQN();
+      OptimizerOptionsOWLQN(const sm::PropertyTree& config);
+      LineSearchOptions linesearch; /// \brief Linesearch options. The backtracking search uses c1WolfeCondition, initialStepLength and minStepLength.
+      std::size_t historySize = 10; /// \brief Number of correction pairs (s_k, y_k) kept to approximate the inverse Hessian of the smooth part
+      double backtrackingFactor = 0.5; /// \brief The step length is multiplied by this factor until the sufficient decrease condition holds
+      bool useDenseJacobianContainer = true; /// \brief Whether or not to use a dense Jacobian container
+      boost::shared_ptr<ScalarNonSquaredErrorTerm> regularizer = NULL; /// \brief Additional L1 regularizer that is not part of the problem, see ScalarNonSquaredErrorTerm::isL1Norm()
+
+      void check() const override;
+
+      template<class Archive>
+      inline void serialize(Archive & ar, const unsigned int version);
+    };
+
+    std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsOWLQN& options);
+
+    typedef OptimizerStatus OptimizerStatusOWLQN;
+
+    /**
+     * \class OptimizerOWLQN
+     *
+     * Orthant-wise limited-memory quasi-Newton method (Andrew and Gao, 'Scalable training of L1-regularized
+     * log-linear models', 2007) for objectives f(x) + sum_i w_i |x_i| with smooth f. All non-squared error terms
+     * with ScalarNonSquaredErrorTerm::isL1Norm() and the optional regularizer form the L1 part, all other error
+     * terms the smooth part. The L1 part is handled analytically: the search direction is computed from the
+     * pseudo-gradient, and every trial step is projected onto the orthant of the current iterate, so parameters
+     * that cross zero end up exactly at zero. The L-BFGS history only models the smooth part.
+     *
+     * The design variables of the L1 terms must be vector spaces with unit scaling.
+     */
+    class OptimizerOWLQN : public OptimizerProblemManagerBase
+    {
+     public:
+      typedef boost::shared_ptr<OptimizerOWLQN> Ptr;
+      typedef boost::shared_ptr<const OptimizerOWLQN> ConstPtr;
+      typedef OptimizerOptionsOWLQN Options;
+      typedef OptimizerStatusOWLQN Status;
+
+     public:
+      /// \brief Constructor with default options
+      OptimizerOWLQN();
+      /// \brief Constructor with custom options
+      OptimizerOWLQN(const Options& options);
+      /// \brief Constructor from property tree
+      OptimizerOWLQN(const sm::PropertyTree& config);
+      /// \brief Destructor
+      ~OptimizerOWLQN() override;
+
+      /// \brief Return the status
+      const Status& getStatus() const override { return _status; }
+
+      /// \brief Get the optimizer options.
+      const Options& getOptions() const override { return _options; }
+
+      /// \brief Set the optimizer options. Changing the history size or the regularizer requires a call to reset().
+      void setOptions(const Options& options) { options.check(); _options = options; }
+
+      /// \brief Set the optimizer options.
+      void setOptions(const OptimizerOptionsBase& options) override { static_cast<OptimizerOptionsBase&>(_options) = options; }
+
+      /// \brief Number of correction pairs currently stored
+      std::size_t getHistoryLength() const { return _historyLength; }
+
+      /// \brief Number of parameters with an L1 penalty
+      std::size_t getNumL1Parameters() const { return _numL1Parameters; }
+
+      /// \brief Number of parameters with an L1 penalty that are exactly zero
+      std::size_t getNumZeroL1Parameters() const;
+
+    private:
+
+      /// \brief The parameters of one design variable with L1 weights
+      struct L1Block {
+        DesignVariable* dv;
+        std::size_t columnBase;
+        int dimension;
+      };
+
+      /// \brief Run the optimization
+      void optimizeImplementation() override;
+
+      /// \brief Reset information
+      void resetImplementation() override;
+
+      /// \brief Update the status
+      void updateStatus(bool lineSearchSuccess);
+
+      /// \brief Collect the L1 weight of every parameter from the error terms of the problem and the regularizer
+      void collectL1Terms();
+
+      /// \brief Add the weight of the L1 term \p e to the parameters of its design variables
+      void addL1Term(const ScalarNonSquaredErrorTerm& e, bool isInProblem, std::vector<bool>& isL1Block);
+
+      /// \brief Fill \p x with the parameters of the L1 coordinates, all other entries are zero
+      void getL1Parameters(ColumnVectorType& x) const;
+
+      /// \brief Evaluate the full objective and the gradient of its smooth part at the current state, \p x receives the L1 parameters
+      double evaluateErrorAndSmoothGradient(ColumnVectorType& x, RowVectorType& gradient);
+
+      /// \brief Evaluate the full objective at the current state, \p x receives the L1 parameters
+      double evaluateError(ColumnVectorType& x);
+
+      /// \brief Compute the gradient of the smooth part at the current state with L1 parameters \p x
+      void computeSmoothGradient(const ColumnVectorType& x, RowVectorType& gradient);
+
+      /// \brief The steepest descent direction of the full objective in the sense of the minimum norm subgradient
+      void computePseudoGradient(const ColumnVectorType& x, const RowVectorType& gradient, RowVectorType& pseudoGradient) const;
+
+      /// \brief Compute the search direction -H_k * gradient with the two-loop recursion
+      void computeSearchDirection(const RowVectorType& gradient, RowVectorType& searchDirection);
+
+      /// \brief Store the correction pair (s_k, y_k), dropping the oldest one if the history is full.
+      ///        Returns false if the pair was skipped because of a violated curvature condition.
+      bool pushCorrectionPair(const RowVectorType& sk, const RowVectorType& yk);
+
+      /// \brief Forget all correction pairs, the next search direction will be the steepest descent direction
+      void clearHistory() { _historyLength = 0; _historyStart = 0; }
+
+    private:
+
+      /// \brief the current set of options
+      Options _options;
+
+      /// \brief Column i holds the state difference s_i of correction pair i (n x m ring buffer)
+      Eigen::MatrixXd _S;
+
+      /// \brief Column i holds the gradient difference y_i of correction pair i (n x m ring buffer)
+      Eigen::MatrixXd _Y;
+
+      /// \brief 1/(y_i^T s_i) of the stored correction pairs
+      Eigen::VectorXd _rho;
+
+      /// \brief Scratch space for the coefficients of the first loop
+      Eigen::VectorXd _alpha;
+
+      /// \brief Index of the oldest correction pair in the ring buffer
+      std::size_t _historyStart = 0;
+
+      /// \brief Number of stored correction pairs
+      std::size_t _historyLength = 0;
+
+      /// \brief L1 weight of every parameter, including the regularizer
+      ColumnVectorType _l1Weights;
+
+      /// \brief L1 weight of every parameter from the error terms of the problem, which are part of its error and gradient
+      ColumnVectorType _l1WeightsInProblem;
+
+      /// \brief The design variables with L1 weights
+      std::vector<L1Block> _l1Blocks;
+
+      /// \brief Total dimension of \p _l1Blocks
+      std::size_t _numL1Parameters = 0;
+
+      /// \brief Status of the optimizer
+      Status _status;
+
+    };
+
+  } // namespace backend
+} // namespace aslam
+
+#include "implementation/OptimizerOWLQNImpl.hpp"
+
+#endif /* ASLAM_BACKEND_OPTIMIZER_OWLQN_HPP */
@@ -32,6 +32,8 @@ namespace aslam {
       bool useDenseJacobianContainer = true; /// \brief Whether or not to use a dense Jacobian container
       boost::shared_ptr<ScalarNonSquaredErrorTerm> regularizer = NULL; /// \brief Regularizer
       Method method = RPROP_PLUS; /// \brief the RProp method used
+      MiniBatchOptions miniBatch; /// \brief Use stochastic gradients from mini-batches of the error terms. Only sign changes of the
+                                  ///        gradient matter for Rprop, which makes it robust against the noise of the estimate.
 
       void check() const override;
 
@@ -110,6 +112,13 @@ namespace aslam {
       /// \brief error in the previous iteration (only used for IRPROP_PLUS version)
       double _prev_error = std::numeric_limits<double>::max();
 
+      /// \brief gradient at the current state, evaluated together with the error at the end of the last iteration (only used for IRPROP_PLUS version).
+      ///        Empty if it has to be recomputed.
+      RowVectorType _next_gradient;
+
+      /// \brief error at the current state belonging to _next_gradient
+      double _next_error = std::numeric_limits<double>::max();
+
       /// \brief the current set of options
       Options _options;
 
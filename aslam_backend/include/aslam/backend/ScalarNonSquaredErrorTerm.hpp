@@ -122,6 +122,10 @@ namespace aslam {
       /// \brief Get the error term dimension. For compatibility with squared error term interface.
       inline size_t dimension() const { return 1UL; }
 
+      /// \brief Whether the error is \f$ w \sum_j |x_j| \f$ over all parameters \f$ x_j \f$ of the active design variables.
+      ///        Optimizers that handle the kink at zero, e.g. OptimizerOWLQN, treat such terms analytically.
+      virtual bool isL1Norm() const { return false; }
+
     protected:
 
       /// \brief evaluate the error term and return the scalar error \f$ e \f$
@@ -23,6 +23,8 @@ namespace aslam {
 
       void buildSystem(size_t nThreads, bool useMEstimator) override;
       bool solveSystem(Eigen::VectorXd& outDx) override;
+      void setConditioner(const Eigen::VectorXd& diag) override;
+      void setConstantConditioner(double diag) override;
 
       /// Returns the options
       const SparseCholeskyLinearSolverOptions& getOptions() const;
@@ -34,11 +36,26 @@ namespace aslam {
       std::string name() const override {  return "sparse_cholesky"; };        
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
+
+      bool multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) override;
+      /// Reuses the numerical factorization of the last solveSystem() call if neither the system nor the conditioner changed since
+      bool solveSystemForError(const Eigen::VectorXd& e, Eigen::VectorXd& outDx) override;
+
+      bool supportsErrorProjection() const override { return true; }
+
+      /// The fill-reducing permutation of the symbolic factorization, entry k is the column eliminated k-th.
+      /// Empty before the first solveSystem() call.
+      std::vector<int> getFactorPermutation() const;
    
     
     private:
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
       void handleNewAcceptConstantErrorTerms() override;
+      void getColumnSquaredNorms(Eigen::VectorXd& outNorms) const override;
+      void scaleColumns(const Eigen::VectorXd& scale) override;
+      bool scaleRows(const Eigen::VectorXd& scale) override;
+      /// Derives the CAMD ordering constraints from the ordering groups of the design variables
+      void initOrderingConstraints(const std::vector<DesignVariable*>& dvs);
 
       CompressedColumnJacobianTransposeBuilder<int> _jacobianBuilder;
 
@@ -46,6 +63,10 @@ namespace aslam {
       cholmod_sparse _cholmodLhs;
       cholmod_dense  _cholmodRhs;
       cholmod_factor* _factor;
+      /// Whether _factor holds the numerical factorization of the current system and conditioner
+      bool _factorIsCurrent = false;
+      /// Constraint set of every column of the Hessian, empty if the ordering is unconstrained
+      std::vector<int> _orderingConstraints;
 
       /// Options
       SparseCholeskyLinearSolverOptions _options;
@@ -30,6 +30,9 @@ namespace aslam {
 
       std::string name() const override { return "sparse_qr"; }
 
+      /// \brief SPQR detects the numerical rank
+      bool isRankRevealing() const override { return true; }
+
       /// Returns the current Jacobian transpose
       const CompressedColumnMatrix<index_t>& getJacobianTranspose() const;
       /// Returns the current estimated numerical rank
@@ -57,9 +60,14 @@ namespace aslam {
       /// Helper Function for DogLeg implementation; returns parts required for the steepest descent solution
       double rhsJtJrhs() override;
 
+      bool multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) override;
+
     private:
       void initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner) override;
       void handleNewAcceptConstantErrorTerms() override;
+      void getColumnSquaredNorms(Eigen::VectorXd& outNorms) const override;
+      void scaleColumns(const Eigen::VectorXd& scale) override;
+      bool scaleRows(const Eigen::VectorXd& scale) override;
 
       CompressedColumnJacobianTransposeBuilder<index_t> _jacobianBuilder;
 
@@ -0,0 +1,76 @@
+#ifndef ASLAM_BACKEND_SUBSPACE_TRUST_REGION_POLICY_HPP
+#define ASLAM_BACKEND_SUBSPACE_TRUST_REGION_POLICY_HPP
+
+#include <aslam/backend/TrustRegionPolicy.hpp>
+#include <aslam/backend/LinearSystemSolver.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace aslam {
+    namespace backend {
+
+        /**
+         * \class SubspaceTrustRegionPolicy
+         *
+         * Two-dimensional subspace trust region method (Byrd, Schnabel and Shultz). Like the dog leg, every
+         * successful iteration builds the system once and solves for the Gauss-Newton step. The step is then
+         * the exact minimizer of the quadratic model within the trust region, restricted to the span of the
+         * steepest descent direction and the Gauss-Newton step, instead of a point on the dog leg path.
+         * Rejected steps only shrink the radius and re-solve the 2x2 subproblem.
+         *
+         * The reduced Hessian is computed with LinearSystemSolver::multiplyJacobian() if the solver supports it.
+         * Otherwise it is recovered from rhsJtJrhs() and the Gauss-Newton equations, which neglects the conditioner.
+         */
+        class SubspaceTrustRegionPolicy : public TrustRegionPolicy
+        {
+        public:
+            SubspaceTrustRegionPolicy();
+            ~SubspaceTrustRegionPolicy() override;
+
+            /// \brief called by the optimizer when an optimization is starting
+            void optimizationStartingImplementation(double J) override;
+
+            // Returns true if the solution was successful
+            bool solveSystemImplementation(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx) override;
+
+            /// \brief should the optimizer revert on failure? You should probably return true
+            bool revertOnFailure() override;
+
+            /// \brief The radius update judges the clipped step by its model reduction
+            void stepProjected(const Eigen::VectorXd& dx) override;
+
+            /// \brief print the current state to a stream (no newlines).
+            std::ostream & printState(std::ostream & out) const override;
+            bool requiresAugmentedDiagonal() const override;
+            std::string name() const override { return "subspace"; }
+
+            /// \brief The current trust region radius. Zero before the first step.
+            double getDelta() const { return _delta; }
+
+            /// \brief The dimension of the subspace of the last step, one if the Gauss-Newton step is parallel to the gradient.
+            int getSubspaceDimension() const { return static_cast<int>(_basis.cols()); }
+        private:
+
+            /// \brief Build the orthonormal subspace basis and the reduced model from the current system
+            bool buildSubspace(int nThreads);
+
+            /// \brief Minimize the reduced model within the radius \p delta, returns the reduced step
+            Eigen::VectorXd solveSubproblem(double delta, bool& outOnBoundary) const;
+
+            /// \brief Orthonormal basis of the subspace, one column per dimension
+            Eigen::MatrixXd _basis;
+            /// \brief Reduced Hessian _basis^T J^T J _basis
+            Eigen::MatrixXd _B;
+            /// \brief Reduced right-hand side _basis^T J^T e
+            Eigen::VectorXd _b;
+
+            Eigen::VectorXd _dx;
+            double _L0;
+            double _delta;
+            std::string _stepType;
+        };
+
+    } // namespace backend
+} // namespace aslam
+
+
+#endif /* ASLAM_BACKEND_SUBSPACE_TRUST_REGION_POLICY_HPP */
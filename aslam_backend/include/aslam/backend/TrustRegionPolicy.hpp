@@ -3,6 +3,7 @@
 
 #include <aslam/backend/LinearSystemSolver.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
 #include "Optimizer2Options.hpp"
 #include <sm/eigen/assert_macros.hpp>
 #include <aslam/Exceptions.hpp>
@@ -13,6 +14,10 @@ namespace aslam {
         class TrustRegionPolicy
         {
         public:
+            /// \brief Returns the cost after applying the step \p dx and stores the error vector in \p outE if not null,
+            ///        in the layout of LinearSystemSolver::e(). The state is restored before returning.
+            typedef boost::function<double (const Eigen::VectorXd& dx, Eigen::VectorXd* outE)> StepEvaluator;
+
             TrustRegionPolicy();
             virtual ~TrustRegionPolicy();
             
@@ -22,6 +27,10 @@ namespace aslam {
             /// \brief Returns true if the solution was successful
             virtual bool solveSystem(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx);
 
+            /// \brief Whether the last solveSystem() call built a new linear system. After a rejected step a policy may
+            ///        keep the system of the last accepted state and only change its damping.
+            bool systemBuilt() const { return _systemBuilt; }
+
             /// \brief get the linear system solver
             boost::shared_ptr<LinearSystemSolver> getSolver();
 
@@ -31,14 +40,55 @@ namespace aslam {
             /// \brief should the optimizer revert on failure? You should probably return true (the default implementation does this)
             virtual bool revertOnFailure();
 
+            /// \brief A step from a state with cost \p J is reverted if the new cost exceeds this value.
+            ///        The default is \p J itself, nonmonotone policies return more.
+            virtual double acceptanceThreshold(double J) const { return J; }
+
+            /// \brief Called by the optimizer when the bounds clipped the proposed step, \p dx is the step that is applied
+            ///        instead and the next call of solveSystem() judges. The default ignores it.
+            virtual void stepProjected(const Eigen::VectorXd& /* dx */) {}
+
             /// \brief print the current state to a stream (no newlines).
             virtual std::ostream & printState(std::ostream & out) const = 0;
             virtual std::string name() const = 0;
             virtual bool requiresAugmentedDiagonal() const = 0;
+
+            /// \brief Start each optimization from the damping state the previous one ended with instead of the initial values.
+            ///        \p decay in (0, 1] relaxes the carried damping, see the derived classes for what it is applied to.
+            void setWarmStart(bool warmStart, double decay = 1.0);
+            bool getWarmStart() const { return _warmStart; }
+            double getWarmStartDecay() const { return _warmStartDecay; }
+
+            /// \brief Forget the carried state, the next optimization starts from the initial values.
+            void resetWarmStart() { _hasState = false; }
+
+            /// \brief Set by the optimizer, lets a policy compare trial steps before proposing one
+            void setStepEvaluator(const StepEvaluator& evaluator) { _stepEvaluator = evaluator; }
+
+            /// \brief Pass Eisenstat-Walker forcing terms to iterative solvers (see LinearSystemSolver::setForcingTerm).
+            ///        With the gradient norms g_k of the systems built, eta_k = gamma (g_k / g_{k-1})^alpha, safeguarded against
+            ///        dropping faster than gamma eta_{k-1}^alpha and bounded by \p maxForcingTerm, which is also used for the first system.
+            ///        A rejected step halves the forcing term. \p maxForcingTerm = 0 disables the forcing terms.
+            void setForcingTerms(double maxForcingTerm, double gamma = 0.9, double alpha = 2.0);
+            double getMaxForcingTerm() const { return _maxForcingTerm; }
         protected:
             double get_dJ();
             bool isFirstIteration(){ return _isFirstIteration; }
 
+            /// \brief L(0) - L(dx) of the Gauss-Newton model of the current system in the units of the cost.
+            ///        Returns false if the solver cannot multiply with its Jacobian.
+            bool getModelReduction(const Eigen::VectorXd& dx, double& outReduction);
+
+            /// \brief Whether optimizationStartingImplementation() should keep the state of the last optimization
+            bool isWarmStart() const { return _warmStart && _hasState; }
+
+            /// \brief The step evaluator of the optimizer, may be empty
+            const StepEvaluator& getStepEvaluator() const { return _stepEvaluator; }
+
+            /// \brief Update the forcing term of the solver from the gradient norm of the system just built.
+            ///        Derived classes call this after each LinearSystemSolver::buildSystem() call, it also marks the system as built.
+            void updateForcingTerm();
+
             /// \brief called by the optimizer when an optimization is starting
             virtual void optimizationStartingImplementation(double J) = 0;
             
@@ -50,8 +100,24 @@ namespace aslam {
         private:
             /// \brief the linear system solver.
             double _J;
+            /// \brief The cost of the state the last step started from
             double _p_J;
+            /// \brief The cost of the last accepted state, the optimizer passes the cost of a rejected step instead
+            double _acceptedJ;
             bool _isFirstIteration;
+            bool _warmStart = false;
+            double _warmStartDecay = 1.0;
+            /// \brief Whether a previous optimization left a state to warm start from
+            bool _hasState = false;
+            StepEvaluator _stepEvaluator;
+            double _maxForcingTerm = 0.0;
+            double _forcingTermGamma = 0.9;
+            double _forcingTermAlpha = 2.0;
+            /// \brief The last forcing term and the gradient norm it was computed for, negative before the first system
+            double _forcingTerm = -1.0;
+            double _gradientNorm = -1.0;
+            bool _previousIterationFailed = false;
+            bool _systemBuilt = false;
         };
 
     } // namespace backend
@@ -51,6 +51,12 @@ namespace aslam {
       static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* c) {
         return cholmod_analyze(A, c);
       }
+      static cholmod_factor* analyze_p(cholmod_sparse* A, int* perm, int* fset, size_t fsize, cholmod_common* c) {
+        return cholmod_analyze_p(A, perm, fset, fsize, c);
+      }
+      static int camd(cholmod_sparse* A, int* fset, size_t fsize, int* cmember, int* perm, cholmod_common* c) {
+        return cholmod_camd(A, fset, fsize, cmember, perm, c);
+      }
       static int free_sparse(cholmod_sparse** A, cholmod_common* c) {
         return cholmod_free_sparse(A, c);
       }
@@ -98,6 +104,12 @@ namespace aslam {
       static cholmod_factor* analyze(cholmod_sparse* A, cholmod_common* c) {
         return cholmod_l_analyze(A, c);
       }
+      static cholmod_factor* analyze_p(cholmod_sparse* A, SuiteSparse_long* perm, SuiteSparse_long* fset, size_t fsize, cholmod_common* c) {
+        return cholmod_l_analyze_p(A, perm, fset, fsize, c);
+      }
+      static int camd(cholmod_sparse* A, SuiteSparse_long* fset, size_t fsize, SuiteSparse_long* cmember, SuiteSparse_long* perm, cholmod_common* c) {
+        return cholmod_l_camd(A, fset, fsize, cmember, perm, c);
+      }
       static int free_sparse(cholmod_sparse** A, cholmod_common* c) {
         return cholmod_l_free_sparse(A, c);
       }
@@ -218,6 +230,24 @@ namespace aslam {
       return factor;
     }
 
+    template<typename I>
+    cholmod_factor* Cholmod<I>::analyzeConstrained(cholmod_sparse* J, std::vector<index_t>& constraints)
+    {
+      SM_ASSERT_EQ(Exception, constraints.size(), J->nrow, "There must be one ordering constraint per row of J");
+      // Compute the constrained ordering of J*J' with CAMD and hand it to the symbolic analysis.
+      std::vector<index_t> permutation(J->nrow);
+      int status = CholmodIndexTraits<index_t>::camd(J, NULL, 0, &constraints[0], &permutation[0], &_cholmod);
+      SM_ASSERT_TRUE(Exception, status && _cholmod.status == CHOLMOD_OK, "The constrained ordering failed.");
+      _cholmod.nmethods = 1;
+      _cholmod.method[0].ordering = CHOLMOD_GIVEN;
+      _cholmod.supernodal = CHOLMOD_AUTO;
+      cholmod_factor* factor = NULL;
+      factor = CholmodIndexTraits<index_t>::analyze_p(J, &permutation[0], NULL, 0, &_cholmod);
+      SM_ASSERT_EQ(Exception, _cholmod.status, CHOLMOD_OK, "The symbolic Cholesky factorization failed.");
+      SM_ASSERT_FALSE(Exception, factor == NULL, "cholmod_analyze_p returned a null factor");
+      return factor;
+    }
+
 #ifndef QRSOLVER_DISABLED
     template<typename I>
     spqr_factor* Cholmod<I>::analyzeQR(cholmod_sparse* J)
@@ -398,6 +428,12 @@ namespace aslam {
       return NULL;
     }
 
+    template<typename I>
+    cholmod_dense* Cholmod<I>::solve(cholmod_factor* L, cholmod_dense* b)
+    {
+      return CholmodIndexTraits<index_t>::solve(CHOLMOD_A, L, b, &_cholmod);
+    }
+
 
 #ifndef QRSOLVER_DISABLED
     template<typename I>
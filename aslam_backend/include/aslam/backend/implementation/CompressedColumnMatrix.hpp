@@ -405,6 +405,43 @@ namespace aslam {
       }
     }
 
+    template<typename I>
+    void CompressedColumnMatrix<I>::rowSquaredNorms(Eigen::VectorXd& outNorms) const
+    {
+      size_t cols = _hasDiagonalAppended ? _cols - _rows : _cols;
+      outNorms.resize(_rows);
+      outNorms.setZero();
+      for (size_t c = 0; c < cols; ++c) {
+        for (I idx = _col_ptr[c]; idx < _col_ptr[c + 1]; ++idx) {
+          outNorms[_row_ind[idx]] += _values[idx] * _values[idx];
+        }
+      }
+    }
+
+    template<typename I>
+    void CompressedColumnMatrix<I>::scaleRows(const Eigen::VectorXd& scale)
+    {
+      size_t cols = _hasDiagonalAppended ? _cols - _rows : _cols;
+      SM_ASSERT_EQ(Exception, (size_t)scale.size(), _rows, "The scale vector is the wrong size");
+      for (size_t c = 0; c < cols; ++c) {
+        for (I idx = _col_ptr[c]; idx < _col_ptr[c + 1]; ++idx) {
+          _values[idx] *= scale[_row_ind[idx]];
+        }
+      }
+    }
+
+    template<typename I>
+    void CompressedColumnMatrix<I>::scaleColumns(const Eigen::VectorXd& scale)
+    {
+      size_t cols = _hasDiagonalAppended ? _cols - _rows : _cols;
+      SM_ASSERT_EQ(Exception, (size_t)scale.size(), cols, "The scale vector is the wrong size");
+      for (size_t c = 0; c < cols; ++c) {
+        for (I idx = _col_ptr[c]; idx < _col_ptr[c + 1]; ++idx) {
+          _values[idx] *= scale[c];
+        }
+      }
+    }
+
 
 
     template<typename I>
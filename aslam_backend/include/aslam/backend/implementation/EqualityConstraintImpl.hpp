@@ -0,0 +1,60 @@
+/*
+ * EqualityConstraintImpl.hpp
+ */
+
+#ifndef INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_EQUALITYCONSTRAINTIMPL_HPP_
+#define INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_EQUALITYCONSTRAINTIMPL_HPP_
+
+#include <cmath>
+#include <sm/assert_macros.hpp>
+
+namespace aslam {
+namespace backend {
+
+template<int C>
+EqualityConstraintFs<C>::EqualityConstraintFs(double penalty)
+{
+  _constraint.setZero();
+  _multipliers.setZero();
+  setPenalty(penalty);
+}
+
+template<int C>
+EqualityConstraintFs<C>::~EqualityConstraintFs()
+{
+}
+
+template<int C>
+Eigen::VectorXd EqualityConstraintFs<C>::evaluateConstraint()
+{
+  _constraint = evaluateConstraintImplementation();
+  return _constraint;
+}
+
+template<int C>
+void EqualityConstraintFs<C>::setMultipliers(const Eigen::VectorXd& multipliers)
+{
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, multipliers.size(), _multipliers.size(), "The number of multipliers must match the constraint dimension");
+  _multipliers = multipliers;
+}
+
+template<int C>
+void EqualityConstraintFs<C>::setPenalty(double penalty)
+{
+  SM_ASSERT_GT(aslam::InvalidArgumentException, penalty, 0.0, "The penalty weight must be positive");
+  _penalty = penalty;
+  this->setSqrtInvR(std::sqrt(penalty) * parent_t::inverse_covariance_t::Identity());
+}
+
+template<int C>
+double EqualityConstraintFs<C>::evaluateErrorImplementation()
+{
+  _constraint = evaluateConstraintImplementation();
+  this->setError(_constraint + _multipliers / _penalty);
+  return this->evaluateChiSquaredError();
+}
+
+} /* namespace aslam */
+} /* namespace backend */
+
+#endif /* INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_EQUALITYCONSTRAINTIMPL_HPP_ */
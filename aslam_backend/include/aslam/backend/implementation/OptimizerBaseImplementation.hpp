@@ -25,6 +25,7 @@ inline void OptimizerOptionsBase::serialize(Archive & ar, const unsigned int /*v
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(numThreadsJacobian);
   ar & BOOST_SERIALIZATION_NVP(numThreadsError);
+  ar & BOOST_SERIALIZATION_NVP(maxTimeMs);
 }
 
 template<class Archive>
@@ -33,6 +34,7 @@ inline void OptimizerStatus::serialize(Archive & ar, const unsigned int /*versio
   ar & BOOST_SERIALIZATION_NVP(numIterations);
   ar & BOOST_SERIALIZATION_NVP(numJacobianEvaluations);
   ar & BOOST_SERIALIZATION_NVP(numErrorEvaluations);
+  ar & BOOST_SERIALIZATION_NVP(numErrorAndGradientEvaluations);
   ar & BOOST_SERIALIZATION_NVP(gradientNorm);
   ar & BOOST_SERIALIZATION_NVP(maxDeltaX);
   ar & BOOST_SERIALIZATION_NVP(error);
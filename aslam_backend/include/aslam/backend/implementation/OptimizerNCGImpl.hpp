@@ -0,0 +1,26 @@
+/*
+ * OptimizerNCGImpl.hpp
+ */
+
+#ifndef INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_OPTIMIZERNCGIMPL_HPP_
+#define INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_OPTIMIZERNCGIMPL_HPP_
+
+#include <boost/serialization/nvp.hpp>
+
+namespace aslam {
+namespace backend {
+
+template<class Archive>
+inline void OptimizerOptionsNCG::serialize(Archive & ar, const unsigned int /*version*/) {
+  ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP(OptimizerOptionsBase);
+  ar & BOOST_SERIALIZATION_NVP(linesearch);
+  ar & BOOST_SERIALIZATION_NVP(method);
+  ar & BOOST_SERIALIZATION_NVP(restartInterval);
+  ar & BOOST_SERIALIZATION_NVP(restartThreshold);
+  ar & BOOST_SERIALIZATION_NVP(useDenseJacobianContainer);
+}
+
+} /* namespace aslam */
+} /* namespace backend */
+
+#endif /* INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_OPTIMIZERNCGIMPL_HPP_ */
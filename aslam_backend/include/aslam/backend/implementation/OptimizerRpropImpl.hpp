@@ -24,6 +24,7 @@ inline void OptimizerOptionsRprop::serialize(Archive & ar, const unsigned int /*
   ar & BOOST_SERIALIZATION_NVP(useDenseJacobianContainer);
   ar & BOOST_SERIALIZATION_NVP(regularizer);
   ar & BOOST_SERIALIZATION_NVP(method);
+  ar & BOOST_SERIALIZATION_NVP(miniBatch);
 }
 
 } /* namespace aslam */
@@ -0,0 +1,23 @@
+/*
+ * ProblemManagerImpl.hpp
+ */
+
+#ifndef INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_PROBLEMMANAGERIMPL_HPP_
+#define INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_PROBLEMMANAGERIMPL_HPP_
+
+#include <boost/serialization/nvp.hpp>
+
+namespace aslam {
+namespace backend {
+
+template<class Archive>
+inline void MiniBatchOptions::serialize(Archive & ar, const unsigned int /*version*/) {
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(growthFactor);
+  ar & BOOST_SERIALIZATION_NVP(seed);
+}
+
+} /* namespace aslam */
+} /* namespace backend */
+
+#endif /* INCLUDE_ASLAM_BACKEND_IMPLEMENTATION_PROBLEMMANAGERIMPL_HPP_ */
@@ -26,6 +26,9 @@ struct CostFunctionInterface
   virtual ~CostFunctionInterface() { }
   virtual double evaluateError() const = 0;
   virtual void computeGradient(RowVectorType& gradient) = 0;
+  /// \brief Compute the gradient and return the error at the same point. Override this
+  ///        if both can be computed in a single pass over the cost function.
+  virtual double evaluateErrorAndGradient(RowVectorType& gradient) { computeGradient(gradient); return evaluateError(); }
   virtual const std::vector<DesignVariable*>& getDesignVariables() = 0;
 };
 
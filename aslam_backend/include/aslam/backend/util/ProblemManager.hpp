@@ -8,6 +8,8 @@
 #ifndef INCLUDE_ASLAM_BACKEND_PROBLEMMANAGER_HPP_
 #define INCLUDE_ASLAM_BACKEND_PROBLEMMANAGER_HPP_
 
+#include <iostream>
+#include <random>
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
@@ -19,6 +21,10 @@
 #include "../JacobianContainerDense.hpp"
 #include "../JacobianContainerSparse.hpp"
 
+namespace sm {
+  class PropertyTree;
+}
+
 namespace aslam {
 namespace backend {
 
@@ -28,6 +34,70 @@ class ErrorTerm;
 class ScalarNonSquaredErrorTerm;
 class DesignVariable;
 
+/**
+ * \struct MiniBatchOptions
+ * Options for stochastic gradients computed from random subsets (mini-batches) of the error terms.
+ * The error terms are shuffled at the beginning of every epoch and consumed in batches. The batch size
+ * grows geometrically per epoch, so the gradient estimate becomes exact once the batch covers all error terms.
+ */
+struct MiniBatchOptions
+{
+  MiniBatchOptions();
+  MiniBatchOptions(const sm::PropertyTree& config);
+
+  std::size_t batchSize = 0; /// \brief Number of error terms per mini-batch. Zero disables mini-batches, i.e. the full gradient is used.
+  double growthFactor = 1.0; /// \brief The batch size is multiplied by this factor after every epoch until it covers all error terms
+  unsigned int seed = 0; /// \brief Seed for shuffling the error terms
+
+  /// \brief Checks options for sanity. Throws if any options is not valid.
+  void check() const;
+
+  template<class Archive>
+  inline void serialize(Archive & ar, const unsigned int version);
+};
+
+/// \brief Stream operator for MiniBatchOptions
+std::ostream& operator<<(std::ostream& out, const MiniBatchOptions& options);
+
+namespace details
+{
+  /**
+   * \struct GradientBuffer
+   * Per-thread storage for the gradient computation. Threads scatter the gradient blocks of the design
+   * variables they touch into their own full width row. Only the blocks of touched design variables are
+   * valid, so neither zeroing nor the final reduction has to visit the whole row.
+   */
+  struct GradientBuffer
+  {
+    /// \brief Prepare the buffer for a new gradient computation
+    void reset(std::size_t numDesignVariables, std::size_t numOptParameters);
+
+    /// \brief Mark the block of \p dv as touched, zeroing it on first touch
+    inline void touch(const DesignVariable& dv)
+    {
+      if (!isTouched[dv.blockIndex()]) {
+        isTouched[dv.blockIndex()] = true;
+        touched.push_back(&dv);
+        gradient.segment(dv.columnBase(), dv.minimalDimensions()).setZero();
+      }
+    }
+
+    /// \brief Add the gradient block \p grad of design variable \p dv
+    template <typename DERIVED>
+    inline void add(const DesignVariable& dv, const Eigen::MatrixBase<DERIVED>& grad)
+    {
+      touch(dv);
+      gradient.segment(dv.columnBase(), dv.minimalDimensions()) += grad;
+    }
+
+    RowVectorType gradient; /// \brief Gradient row, only valid in the blocks of touched design variables
+    std::vector<const DesignVariable*> touched; /// \brief Design variables whose blocks were written
+    std::vector<bool> isTouched; /// \brief Touched flag per design variable block index
+    Eigen::VectorXd weightedError; /// \brief Storage for the weighted error of the current squared error term
+    double error = 0.0; /// \brief Accumulated error of the processed error terms, if requested
+  };
+}
+
 /**
  * \class ProblemManager
  * Utility class to collect functionality for dealing with a problem.
@@ -106,6 +176,37 @@ class ProblemManager {
   /// \brief compute the current gradient of the objective function
   void computeGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer);
 
+  /// \brief compute the current gradient of the objective function and return the value of the objective function.
+  ///        Equivalent to computeGradient() followed by evaluateError() but walks the error terms only once.
+  double evaluateErrorAndGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer);
+
+  /// \brief Set the options for mini-batch gradients. Restarts the batch schedule.
+  void setMiniBatchOptions(const MiniBatchOptions& options);
+
+  /// \brief Get the options for mini-batch gradients
+  const MiniBatchOptions& getMiniBatchOptions() const { return _miniBatchOptions; }
+
+  /// \brief Restart the batch schedule with the initial batch size and a new shuffle of the error terms
+  void resetMiniBatches();
+
+  /// \brief Use the full gradient for all subsequent calls to computeMiniBatchGradient(), e.g. close to convergence
+  void switchToFullBatch() { _currentBatchSize = _numErrorTerms; }
+
+  /// \brief Whether computeMiniBatchGradient() currently evaluates all error terms
+  bool isFullBatch() const { return _currentBatchSize == 0 || _currentBatchSize >= _numErrorTerms; }
+
+  /// \brief Number of error terms in the next mini-batch
+  std::size_t getCurrentBatchSize() const { return isFullBatch() ? _numErrorTerms : _currentBatchSize; }
+
+  /// \brief Number of completed passes over all error terms since the last reset of the batch schedule
+  std::size_t getEpoch() const { return _epoch; }
+
+  /// \brief Compute an unbiased estimate of the gradient from the next mini-batch of error terms, i.e. the batch gradient
+  ///        scaled by numErrorTerms() / batch size. If \p computeError is set, the equally scaled error of the batch is returned.
+  ///        Equivalent to computeGradient() or evaluateErrorAndGradient() once isFullBatch() holds.
+  double computeMiniBatchGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer,
+                                  bool computeError = false);
+
   /// \brief Apply the scaling of the design variables to \p outGrad
   void applyDesignVariableScaling(RowVectorType& outGrad) const;
 
@@ -122,8 +223,15 @@ class ProblemManager {
   void setInitialized(bool isInitialized) { _isInitialized = isInitialized; }
 
  private:
-  /// \brief Evaluate the gradient of the objective function
-  void evaluateGradients(size_t threadId, size_t startIdx, size_t endIdx, RowVectorType& grad, bool useMEstimator, bool useDenseJacobianContainer);
+  /// \brief Accumulate the gradient and, if \p computeError is set, the error of the objective function
+  ///        over the error terms \p indices or all error terms if \p indices is null
+  double accumulateGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer, bool computeError,
+                            const std::vector<std::size_t>* indices = nullptr);
+
+  /// \brief Evaluate the gradient of the objective function and optionally the error per thread. Error term i is
+  ///        (*indices)[i] if \p indices is given.
+  void evaluateGradients(size_t threadId, size_t startIdx, size_t endIdx, details::GradientBuffer& buffer, bool useMEstimator, bool useDenseJacobianContainer,
+                         bool computeError, const std::vector<std::size_t>* indices);
 
   /// \brief Evaluate the objective function
   void sumErrorTerms(size_t /* threadId */, size_t startIdx, size_t endIdx, double& err) const;
@@ -155,6 +263,30 @@ class ProblemManager {
   /// \brief Whether the optimizer is correctly initialized
   bool _isInitialized = false;
 
+  /// \brief Per-thread gradient buffers, kept between gradient computations to avoid reallocation
+  std::vector<details::GradientBuffer> _gradientBuffers;
+
+  /// \brief Options for mini-batch gradients
+  MiniBatchOptions _miniBatchOptions;
+
+  /// \brief Shuffled error term indices of the current epoch
+  std::vector<std::size_t> _batchPermutation;
+
+  /// \brief Error term indices of the current mini-batch
+  std::vector<std::size_t> _batchIndices;
+
+  /// \brief Position of the next mini-batch in \p _batchPermutation
+  std::size_t _batchPosition = 0;
+
+  /// \brief Current batch size, zero if mini-batches are disabled
+  std::size_t _currentBatchSize = 0;
+
+  /// \brief Number of completed epochs
+  std::size_t _epoch = 0;
+
+  /// \brief Random number generator for shuffling
+  std::mt19937 _batchRng;
+
 };
 
 namespace details
@@ -198,6 +330,7 @@ inline boost::shared_ptr<CostFunctionInterface> getCostFunction(ProblemManager&
     ~CostFunctionPM() override { }
     double evaluateError() const override { return _pm.evaluateError(_numThreadsError); }
     void computeGradient(RowVectorType& gradient) override { _pm.computeGradient(gradient, _numThreadsJacobian, _useMEstimator, _applyDvScaling, _useDenseJacobianContainer); }
+    double evaluateErrorAndGradient(RowVectorType& gradient) override { return _pm.evaluateErrorAndGradient(gradient, _numThreadsJacobian, _useMEstimator, _applyDvScaling, _useDenseJacobianContainer); }
     const std::vector<DesignVariable*>& getDesignVariables() override { return _pm.designVariables(); };
    private:
     ProblemManager& _pm;
@@ -217,4 +350,6 @@ inline boost::shared_ptr<CostFunctionInterface> getCostFunction(ProblemManager&
 } // namespace backend
 } // namespace aslam
 
+#include "../implementation/ProblemManagerImpl.hpp"
+
 #endif /* INCLUDE_ASLAM_BACKEND_PROBLEMMANAGER_HPP_ */
@@ -10,6 +10,7 @@
 
 #include <utility>      // std::pair
 #include <vector>
+#include <cmath>
 
 #include <Eigen/Dense>
 
@@ -132,6 +133,180 @@ void applyStateUpdate(const Container& designVariables, const Vector& dx)
   }
 }
 
+/// \brief Tolerance to decide whether a parameter sits at the bound \p bound
+inline double boundTolerance(const double bound)
+{
+  return 1e-12*(1.0 + std::abs(bound));
+}
+
+/// \brief Whether any of the design variables has box bounds, see DesignVariable::setBounds()
+template <typename Container>
+bool hasBounds(const Container& designVariables)
+{
+  for (auto& dv : designVariables) {
+    if (dv->hasBounds())
+      return true;
+  }
+  return false;
+}
+
+/// \brief The parameters of the bounded design variable \p dv as vector
+inline Eigen::VectorXd getBoundedParameters(const DesignVariable& dv)
+{
+  Eigen::MatrixXd p;
+  dv.getParameters(p);
+  return Eigen::Map<Eigen::VectorXd>(p.data(), p.size());
+}
+
+/// \brief Number of parameters of \p dv at one of their bounds
+inline int numParametersAtBound(const DesignVariable& dv)
+{
+  if (!dv.hasBounds())
+    return 0;
+  const Eigen::VectorXd x = getBoundedParameters(dv);
+  int n = 0;
+  for (int i = 0; i < x.size(); ++i) {
+    if (x[i] <= dv.lowerBound()[i] + boundTolerance(dv.lowerBound()[i]) || x[i] >= dv.upperBound()[i] - boundTolerance(dv.upperBound()[i]))
+      ++n;
+  }
+  return n;
+}
+
+/// \brief Project the parameters of the bounded design variables onto their bounds. Returns whether any parameter changed.
+template <typename Container>
+bool projectOntoBounds(const Container& designVariables)
+{
+  bool changed = false;
+  Eigen::MatrixXd p;
+  for (auto& dv : designVariables) {
+    if (!dv->hasBounds())
+      continue;
+    dv->getParameters(p);
+    Eigen::Map<Eigen::VectorXd> x(p.data(), p.size());
+    const Eigen::VectorXd clipped = x.cwiseMax(dv->lowerBound()).cwiseMin(dv->upperBound());
+    if (clipped != x) {
+      x = clipped;
+      dv->setParameters(p);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+/// \brief Clip the update \p dx of design variable \p dv, in the units of the optimizer, such that the updated
+///        parameters stay within the bounds. Returns whether \p dx changed.
+template <typename DERIVED>
+bool projectStateUpdate(const DesignVariable& dv, Eigen::MatrixBase<DERIVED>& dx)
+{
+  if (!dv.hasBounds())
+    return false;
+  const Eigen::VectorXd x = getBoundedParameters(dv);
+  bool changed = false;
+  for (int i = 0; i < x.size(); ++i) {
+    const double xNew = x[i] + dv.scaling()*dx[i];
+    const double xClipped = std::min(std::max(xNew, dv.lowerBound()[i]), dv.upperBound()[i]);
+    if (xClipped != xNew) {
+      dx[i] = (xClipped - x[i])/dv.scaling();
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+/// \brief Clip the update \p dx of the design variables, laid out as in applyStateUpdate(), such that the updated
+///        parameters of bounded design variables stay within their bounds. Returns whether \p dx changed.
+template <typename Container, typename DERIVED>
+bool projectStateUpdate(const Container& designVariables, Eigen::MatrixBase<DERIVED>& dx)
+{
+  bool changed = false;
+  int startIdx = 0;
+  for (auto& dv : designVariables) {
+    const int dbd = dv->minimalDimensions();
+    if (dv->hasBounds()) {
+      auto dxS = dx.segment(startIdx, dbd);
+      if (projectStateUpdate(*dv, dxS))
+        changed = true;
+    }
+    startIdx += dbd;
+  }
+  return changed;
+}
+
+/// \brief Zero the entries of the search direction \p dx that would move parameters of \p dv out of their bounds.
+///        Returns the number of zeroed entries.
+template <typename DERIVED>
+int projectSearchDirection(const DesignVariable& dv, Eigen::MatrixBase<DERIVED>& dx)
+{
+  if (!dv.hasBounds())
+    return 0;
+  const Eigen::VectorXd x = getBoundedParameters(dv);
+  int n = 0;
+  for (int i = 0; i < x.size(); ++i) {
+    if ((dx[i] < 0.0 && x[i] <= dv.lowerBound()[i] + boundTolerance(dv.lowerBound()[i])) ||
+        (dx[i] > 0.0 && x[i] >= dv.upperBound()[i] - boundTolerance(dv.upperBound()[i]))) {
+      dx[i] = 0.0;
+      ++n;
+    }
+  }
+  return n;
+}
+
+/// \brief Zero the entries of the search direction \p dx, laid out as in applyStateUpdate(), that would move
+///        parameters of bounded design variables out of their bounds. Returns the number of zeroed entries.
+template <typename Container, typename DERIVED>
+std::size_t projectSearchDirection(const Container& designVariables, Eigen::MatrixBase<DERIVED>& dx)
+{
+  std::size_t n = 0;
+  int startIdx = 0;
+  for (auto& dv : designVariables) {
+    const int dbd = dv->minimalDimensions();
+    if (dv->hasBounds()) {
+      auto dxS = dx.segment(startIdx, dbd);
+      n += projectSearchDirection(*dv, dxS);
+    }
+    startIdx += dbd;
+  }
+  return n;
+}
+
+/// \brief Zero the entries of \p gradient that belong to parameters of \p dv at an active bound, i.e. where the
+///        steepest descent direction points out of the box. Returns the number of active bounds.
+template <typename DERIVED>
+int projectGradient(const DesignVariable& dv, Eigen::MatrixBase<DERIVED>& gradient)
+{
+  if (!dv.hasBounds())
+    return 0;
+  const Eigen::VectorXd x = getBoundedParameters(dv);
+  int n = 0;
+  for (int i = 0; i < x.size(); ++i) {
+    if ((gradient[i] > 0.0 && x[i] <= dv.lowerBound()[i] + boundTolerance(dv.lowerBound()[i])) ||
+        (gradient[i] < 0.0 && x[i] >= dv.upperBound()[i] - boundTolerance(dv.upperBound()[i]))) {
+      gradient[i] = 0.0;
+      ++n;
+    }
+  }
+  return n;
+}
+
+/// \brief Zero the entries of \p gradient, laid out as in applyStateUpdate(), that belong to parameters at an active
+///        bound. The norm of the result is the optimality measure of the bound constrained problem. Returns the number
+///        of active bounds.
+template <typename Container, typename DERIVED>
+std::size_t projectGradient(const Container& designVariables, Eigen::MatrixBase<DERIVED>& gradient)
+{
+  std::size_t n = 0;
+  int startIdx = 0;
+  for (auto& dv : designVariables) {
+    const int dbd = dv->minimalDimensions();
+    if (dv->hasBounds()) {
+      auto gS = gradient.segment(startIdx, dbd);
+      n += projectGradient(*dv, gS);
+    }
+    startIdx += dbd;
+  }
+  return n;
+}
+
 }
 }
 }
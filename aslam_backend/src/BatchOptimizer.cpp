@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <aslam/backend/BatchOptimizer.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+#include <sm/logging.hpp>
+
+namespace aslam {
+namespace backend {
+
+void BatchOptimizerOptions::check() const
+{
+  SM_ASSERT_TRUE(BatchOptimizer::Exception, optimizer.linearSystemSolver.get() == nullptr,
+                 "A linear system solver instance cannot be shared among the workers, use linearSystemSolverFactory instead");
+  SM_ASSERT_TRUE(BatchOptimizer::Exception, optimizer.trustRegionPolicy.get() == nullptr,
+                 "A trust region policy instance cannot be shared among the workers, use trustRegionPolicyFactory instead");
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::BatchOptimizerOptions& options)
+{
+  out << "BatchOptimizerOptions:" << std::endl;
+  out << "\tnumThreads: " << options.numThreads << std::endl;
+  out << "\tlinearSystemSolverFactory: " << (options.linearSystemSolverFactory ? "SET" : "DEFAULT") << std::endl;
+  out << "\ttrustRegionPolicyFactory: " << (options.trustRegionPolicyFactory ? "SET" : "DEFAULT") << std::endl;
+  out << "Optimizer2Options:" << std::endl;
+  out << options.optimizer;
+  return out;
+}
+
+void BatchOptimizerStatus::reset()
+{
+  results.clear();
+  convergence.clear();
+  numExceptions = 0;
+  numThreads = 0;
+  wallTime = 0.0;
+  problemsPerSecond = 0.0;
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::BatchOptimizerStatus& status)
+{
+  out << "BatchOptimizerStatus:" << std::endl;
+  out << "\tproblems: " << status.results.size() << std::endl;
+  out << "\tnumExceptions: " << status.numExceptions << std::endl;
+  out << "\tnumThreads: " << status.numThreads << std::endl;
+  out << "\twallTime: " << status.wallTime << std::endl;
+  out << "\tproblemsPerSecond: " << status.problemsPerSecond;
+  return out;
+}
+
+
+BatchOptimizer::BatchOptimizer(const Options& options)
+    : _options(options)
+{
+  _options.check();
+}
+
+BatchOptimizer::~BatchOptimizer()
+{
+}
+
+void BatchOptimizer::setOptions(const Options& options)
+{
+  options.check();
+  _options = options;
+  _workers.clear();
+}
+
+void BatchOptimizer::initializeWorkers(const std::size_t numThreads)
+{
+  if (_workers.size() == numThreads)
+    return;
+  _workers.clear();
+  _workers.reserve(numThreads);
+  for (std::size_t w = 0; w < numThreads; ++w) {
+    Optimizer2Options options = _options.optimizer;
+    // Setting the instances in the options keeps Optimizer2 from creating new ones on every initialization
+    options.linearSystemSolver = _options.linearSystemSolverFactory ? _options.linearSystemSolverFactory() : boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver());
+    options.trustRegionPolicy = _options.trustRegionPolicyFactory ? _options.trustRegionPolicyFactory() : boost::shared_ptr<TrustRegionPolicy>(new LevenbergMarquardtTrustRegionPolicy());
+    SM_ASSERT_TRUE(Exception, options.linearSystemSolver.get() != nullptr, "The linear system solver factory returned a null solver");
+    SM_ASSERT_TRUE(Exception, options.trustRegionPolicy.get() != nullptr, "The trust region policy factory returned a null policy");
+    _workers.emplace_back(new Optimizer2(options));
+  }
+}
+
+const BatchOptimizer::Status& BatchOptimizer::optimize(const std::vector< boost::shared_ptr<OptimizationProblemBase> >& problems)
+{
+  _status.reset();
+  _status.results.resize(problems.size());
+  _status.convergence.resize(problems.size(), ConvergenceStatus::IN_PROGRESS);
+  if (problems.empty())
+    return _status;
+
+  std::size_t numThreads = _options.numThreads > 0 ? _options.numThreads : boost::thread::hardware_concurrency();
+  numThreads = std::max<std::size_t>(1, numThreads);
+  initializeWorkers(numThreads);
+  // Never start more threads than there are problems, the surplus workers are kept for later batches
+  numThreads = std::min(numThreads, problems.size());
+  _status.numThreads = numThreads;
+  _nextProblem = 0;
+
+  const auto start = std::chrono::steady_clock::now();
+  if (numThreads == 1) {
+    runWorker(0, problems);
+  } else {
+    boost::thread_group threads;
+    for (std::size_t w = 0; w < numThreads; ++w)
+      threads.create_thread(boost::bind(&BatchOptimizer::runWorker, this, w, boost::cref(problems)));
+    threads.join_all();
+  }
+  _status.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  _status.problemsPerSecond = _status.wallTime > 0.0 ? problems.size()/_status.wallTime : 0.0;
+
+  // Release the problems, the workers only keep their solvers and policies
+  for (std::size_t w = 0; w < numThreads; ++w)
+    _workers[w]->setProblem(boost::shared_ptr<OptimizationProblemBase>());
+
+  SM_DEBUG_STREAM_NAMED("optimization", _status);
+  return _status;
+}
+
+void BatchOptimizer::runWorker(const std::size_t workerId, const std::vector< boost::shared_ptr<OptimizationProblemBase> >& problems)
+{
+  Optimizer2& optimizer = *_workers[workerId];
+  while (true) {
+    std::size_t i;
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      if (_nextProblem >= problems.size())
+        return;
+      i = _nextProblem++;
+    }
+
+    // Every problem index is handed out exactly once, so the result slots are written without locking
+    try {
+      SM_ASSERT_TRUE(Exception, problems[i].get() != nullptr, "Problem " << i << " is null");
+      optimizer.setProblem(problems[i]);
+      _status.results[i] = optimizer.optimize();
+      _status.convergence[i] = optimizer.getStatus().convergence;
+    } catch (const std::exception& e) {
+      SM_ERROR_STREAM("BatchOptimizer: Optimization of problem " << i << " failed: " << e.what());
+      _status.convergence[i] = ConvergenceStatus::FAILURE;
+      boost::mutex::scoped_lock lock(_mutex);
+      ++_status.numExceptions;
+    }
+  }
+}
+
+} // namespace backend
+} // namespace aslam
@@ -18,14 +18,7 @@ namespace aslam {
       _solverType = config.getString("solverType", "cholesky");
       // NO OPTIONS CURRENTLY IMPLEMENTED
       // USING C++11 would allow to do constructor delegation and more elegant code
-      if(_solverType == "cholesky") {
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      } else if(_solverType == "spqr") {
-        _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
-      } else {
-        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      }
+      initSolver();
     }
 
     BlockCholeskyLinearSystemSolver::~BlockCholeskyLinearSystemSolver()
@@ -35,14 +28,7 @@ namespace aslam {
 
     void BlockCholeskyLinearSystemSolver::initMatrixStructureImplementation(const std::vector<DesignVariable*>& dvs, const std::vector<ErrorTerm*>& errors, bool useDiagonalConditioner)
     {
-      if(_solverType == "cholesky") {
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      } else if(_solverType == "spqr") {
-        _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
-      } else {
-        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
-        _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      }
+      initSolver();
       _solver->init();
       _useDiagonalConditioner = useDiagonalConditioner;
       _errorTerms = errors;
@@ -71,12 +57,14 @@ namespace aslam {
       for (; it != it_end; ++it) {
         (*it)->buildHessian(_H._M, _rhs, useMEstimator);
       }
+      updateColumnScale();
     }
 
     bool BlockCholeskyLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
     {
+      pushColumnScaling();
+      const Eigen::VectorXd d = _diagonalConditioner.cwiseProduct(_diagonalConditioner);
       if (_useDiagonalConditioner) {
-        Eigen::VectorXd d = _diagonalConditioner.cwiseProduct(_diagonalConditioner);
         // Augment the diagonal
         int rowBase = 0;
         for (int i = 0; i < _H._M.bRows(); ++i) {
@@ -86,6 +74,11 @@ namespace aslam {
           rowBase += block.rows();
         }
       }
+      if (PcgSolver* pcg = dynamic_cast<PcgSolver*>(_solver.get())) {
+        // PCG compares the squared Euclidean norms of the true residual and the right-hand side, see initSolver()
+        const double eta = _forcingTerm > 0.0 ? _forcingTerm : _pcgTolerance;
+        pcg->setTolerance(eta * eta);
+      }
       // Solve the system
       outDx.resize(_H._M.rows());
       bool solutionSuccess = _solver->solve(_H._M, &outDx[0], &_rhs[0]);
@@ -94,10 +87,13 @@ namespace aslam {
         int rowBase = 0;
         for (int i = 0; i < _H._M.bRows(); ++i) {
           Eigen::MatrixXd& block = *_H._M.block(i, i, true);
-          block.diagonal() -= _diagonalConditioner.segment(rowBase, block.rows());
+          block.diagonal() -= d.segment(rowBase, block.rows());
           rowBase += block.rows();
         }
       }
+      popColumnScaling(outDx);
+      if (solutionSuccess)
+        projectGauge(outDx);
       if( ! solutionSuccess ) {
         //std::cout << "Solution failed...creating a new solver\n";
         // This seems to help when the CHOLMOD stuff gets into a bad state
@@ -113,8 +109,15 @@ namespace aslam {
         _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
       } else if(_solverType == "spqr") {
         _solver.reset(new sparse_block_matrix::LinearSolverQr<Eigen::MatrixXd>());
+      } else if(_solverType == "pcg") {
+        boost::shared_ptr<PcgSolver> pcg(new PcgSolver());
+        // The tolerance is relative to the right-hand side of each solve, see solveSystem(). It bounds the true residual
+        // in the Euclidean norm as LinearSystemSolver::setForcingTerm() requires, not the one in the preconditioner metric.
+        pcg->setAbsoluteTolerance(false);
+        pcg->setEuclideanTolerance(true);
+        _solver = pcg;
       } else {
-        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\" or \"spqr\"\nDefaulting to cholesky.\n";
+        std::cout << "Unknown block solver type " << _solverType << ". Try \"cholesky\", \"spqr\" or \"pcg\"\nDefaulting to cholesky.\n";
         _solver.reset(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
       }
 
@@ -125,8 +128,8 @@ namespace aslam {
     {
       // Not sure why I have to do this.
       //_solver->init();
+      const Eigen::VectorXd d = _diagonalConditioner.cwiseProduct(_diagonalConditioner);
       if (_useDiagonalConditioner) {
-        Eigen::VectorXd d = _diagonalConditioner.cwiseProduct(_diagonalConditioner);
         // Augment the diagonal
         int rowBase = 0;
         for (int i = 0; i < _H._M.bRows(); ++i) {
@@ -143,7 +146,7 @@ namespace aslam {
         int rowBase = 0;
         for (int i = 0; i < _H._M.bRows(); ++i) {
           Eigen::MatrixXd& block = *_H._M.block(i, i, true);
-          block.diagonal() -= _diagonalConditioner.segment(rowBase, block.rows());
+          block.diagonal() -= d.segment(rowBase, block.rows());
           rowBase += block.rows();
         }
       }
@@ -171,10 +174,41 @@ namespace aslam {
 
 
 
+    void BlockCholeskyLinearSystemSolver::getColumnSquaredNorms(Eigen::VectorXd& outNorms) const {
+        // The squared column norms of J are the diagonal of J^T J
+        outNorms.setZero(_H._M.rows());
+        for (int i = 0; i < _H._M.bRows(); ++i) {
+          const Eigen::MatrixXd* block = _H._M.block(i, i);
+          if (block)
+            outNorms.segment(_H._M.rowBaseOfBlock(i), block->rows()) = block->diagonal();
+        }
+    }
+
+    void BlockCholeskyLinearSystemSolver::scaleColumns(const Eigen::VectorXd& scale) {
+        // H = J^T J, hence both sides
+        _H._M.scale(scale, scale);
+    }
+
     double BlockCholeskyLinearSystemSolver::rhsJtJrhs() {
-        Eigen::VectorXd JtJrhs;
-        _H.rightMultiply(_rhs, JtJrhs);
-        return _rhs.dot(JtJrhs);
+        double norm;
+        jacobianSquaredNorm(_rhs, norm);
+        return norm;
+    }
+
+    bool BlockCholeskyLinearSystemSolver::jacobianSquaredNorm(const Eigen::VectorXd& v, double& outNorm) {
+        // _H stores the upper triangular blocks U, J^T J = U + U^T - D with the diagonal blocks D
+        Eigen::VectorXd Uv;
+        _H.rightMultiply(v, Uv);
+        double vDv = 0.0;
+        for (int i = 0; i < _H._M.bRows(); ++i) {
+          const Eigen::MatrixXd* block = _H._M.block(i, i);
+          if (block) {
+            const auto vi = v.segment(_H._M.rowBaseOfBlock(i), _H._M.rowsOfBlock(i));
+            vDv += vi.dot(*block * vi);
+          }
+        }
+        outNorm = 2.0 * v.dot(Uv) - vDv;
+        return true;
     }
 
 
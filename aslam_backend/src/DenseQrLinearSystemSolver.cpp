@@ -32,14 +32,29 @@ namespace aslam {
 
     void DenseQrLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
     {
+      if (reweightSystem(useMEstimator))
+        return;
       _J._M.setZero();
       setupThreadedJob(boost::bind(&DenseQrLinearSystemSolver::evaluateJacobians, this, _1, _2, _3, _4), nThreads, useMEstimator);
       _rhs = _J._M.transpose() * _e;
+      updateColumnScale();
+      updateRowWeights(useMEstimator);
     }
 
 
     bool DenseQrLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
     {
+      pushColumnScaling();
+      // With an error projection the reduced system is the one of the projected Jacobian and errors
+      const bool project = _errorBasis.cols() != 0;
+      Eigen::MatrixXd J;
+      Eigen::VectorXd e;
+      if (project) {
+        J = _J._M;
+        e = _e;
+        _J._M -= _errorBasis * (_errorBasis.transpose() * _J._M);
+        projectErrors(_e);
+      }
       if (_useDiagonalConditioner) {
         // Append the diagonal. Thanks to the ceres developers for this trick.
         _J._M.conservativeResize(_JRows + _JCols, Eigen::NoChange);
@@ -54,9 +69,29 @@ namespace aslam {
         _J._M.conservativeResize(_JRows, Eigen::NoChange);
         _e.conservativeResize(_JRows);
       }
+      if (project) {
+        _J._M.swap(J);
+        _e.swap(e);
+      }
+      popColumnScaling(outDx);
+      projectGauge(outDx);
       return true;
     }
 
+    void DenseQrLinearSystemSolver::getColumnSquaredNorms(Eigen::VectorXd& outNorms) const {
+        outNorms = _J._M.topRows(_JRows).colwise().squaredNorm().transpose();
+    }
+
+    void DenseQrLinearSystemSolver::scaleColumns(const Eigen::VectorXd& scale) {
+        _J._M.topRows(_JRows) *= scale.asDiagonal();
+    }
+
+    bool DenseQrLinearSystemSolver::scaleRows(const Eigen::VectorXd& scale) {
+        _J._M.topRows(_JRows) = scale.asDiagonal() * _J._M.topRows(_JRows);
+        _rhs = _J._M.transpose() * _e;
+        return true;
+    }
+
 
   void DenseQrLinearSystemSolver::evaluateJacobians(size_t /* threadId */, size_t startIdx, size_t endIdx, bool useMEstimator)
     {
@@ -90,11 +125,27 @@ namespace aslam {
     double DenseQrLinearSystemSolver::rhsJtJrhs() {
         Eigen::VectorXd Jrhs;
         _J.rightMultiply(_rhs, Jrhs);
+        projectErrors(Jrhs);
         return Jrhs.squaredNorm();
     }
       
       
 
+    bool DenseQrLinearSystemSolver::multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) {
+        outJv = _J._M * v;
+        projectErrors(outJv);
+        return true;
+    }
+
+    bool DenseQrLinearSystemSolver::solveSystemForError(const Eigen::VectorXd& e, Eigen::VectorXd& outDx) {
+        // The QR decomposition is not kept, solve again with the swapped in error vector
+        Eigen::VectorXd swapped = e;
+        _e.swap(swapped);
+        const bool success = solveSystem(outDx);
+        _e.swap(swapped);
+        return success;
+    }
+
     const Eigen::MatrixXd& DenseQrLinearSystemSolver::getJacobian() const
     {
      return _J._M;
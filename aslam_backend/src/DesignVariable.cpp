@@ -5,7 +5,7 @@ namespace aslam {
   namespace backend {
 
     DesignVariable::DesignVariable() :
-      _blockIndex(-1), _columnBase(-1), _isMarginalized(false), _isActive(false), _scaling(1.0)
+      _blockIndex(-1), _columnBase(-1), _isMarginalized(false), _isActive(false), _scaling(1.0), _orderingGroup(0)
     {
     }
 
@@ -38,6 +38,24 @@ namespace aslam {
       return minimalDimensionsImplementation();
     }
 
+    void DesignVariable::setBounds(const Eigen::VectorXd& lowerBound, const Eigen::VectorXd& upperBound)
+    {
+      SM_ASSERT_EQ(aslam::Exception, lowerBound.size(), upperBound.size(), "The lower and upper bounds must have the same size");
+      SM_ASSERT_EQ(aslam::Exception, (int)lowerBound.size(), minimalDimensions(), "There must be one bound per minimal dimension");
+      Eigen::MatrixXd p;
+      getParameters(p);
+      SM_ASSERT_EQ(aslam::Exception, (int)p.size(), minimalDimensions(), "Box bounds are only supported for vector space design variables");
+      SM_ASSERT_TRUE(aslam::Exception, (lowerBound.array() <= upperBound.array()).all(), "The lower bounds must not exceed the upper bounds");
+      _lowerBound = lowerBound;
+      _upperBound = upperBound;
+    }
+
+    void DesignVariable::clearBounds()
+    {
+      _lowerBound.resize(0);
+      _upperBound.resize(0);
+    }
+
     void DesignVariable::getParameters(Eigen::MatrixXd& value) const {
       getParametersImplementation(value);
     }
@@ -1,4 +1,6 @@
 #include <aslam/backend/DogLegTrustRegionPolicy.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace aslam {
     namespace backend {
@@ -16,8 +18,13 @@ namespace aslam {
             _sd_scale = 0;
             _beta = 0;
             std::string _stepType;
-            _delta  = 0;
-            _p_delta = 0;
+            if (isWarmStart() && _delta > 0) {
+                // keep the trust region of the last optimization, the decay widens it
+                _delta /= getWarmStartDecay();
+            } else {
+                _delta  = 0;
+            }
+            _p_delta = _delta;
             
         }
         
@@ -52,6 +59,8 @@ namespace aslam {
                     // if we took a GN step set the trust region to the GN Step / 2
                     if(_stepType == "GN")
                         _delta = _dx_gn_norm / 2.0;
+                    else if(_stepType == "PR") // a clipped step may be much shorter than the radius
+                        _delta = std::min(_delta, _dx.norm()) / 2.0;
                     else
                         _delta /= 2.0;
                 }
@@ -63,6 +72,7 @@ namespace aslam {
                 // update GN matrices:
                 //std::cout << "Building system\n";
                 _solver->buildSystem(nThreads, true);
+                updateForcingTerm();
                 
                 // calculate steepest descent step:
                 
@@ -141,6 +151,17 @@ namespace aslam {
         
         }
         
+        void DogLegTrustRegionPolicy::stepProjected(const Eigen::VectorXd& dx)
+        {
+            _dx = dx;
+            double reduction;
+            if (getModelReduction(dx, reduction)) {
+                // A model predicting no decrease keeps the sign of the actual one in rho
+                _L0 = std::max(reduction, std::numeric_limits<double>::min());
+                _stepType = "PR";
+            }
+        }
+
         /// \brief print the current state to a stream (no newlines).
         std::ostream & DogLegTrustRegionPolicy::printState(std::ostream & out) const
         {
@@ -20,6 +20,7 @@ namespace aslam {
         {
             Timer timeBuild("GnTrustRegionPolicy: Build linear system", false);
             _solver->buildSystem(nThreads, true);
+            updateForcingTerm();
             timeBuild.stop();
             Timer timeSolve("GnTrustRegionPolicy: Solve linear system", false);// will stop on return
             return _solver->solveSystem(outDx);
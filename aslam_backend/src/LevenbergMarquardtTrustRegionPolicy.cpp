@@ -1,4 +1,7 @@
 #include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <sm/PropertyTree.hpp>
 
 namespace aslam {
@@ -29,14 +32,39 @@ namespace aslam {
       _betaInit   = config.getDouble("betaInit", 2.0); 
       _pInit      = config.getInt("pInit", 3);
       _muInit     = config.getDouble("muInit", 2.0);
+      setGeodesicAcceleration(config.getBool("geodesicAcceleration", false), config.getDouble("geodesicAlpha", 0.75), config.getDouble("geodesicStep", 0.1));
+      setNonmonotoneWindow(config.getInt("nonmonotoneWindow", 1));
     }
     
         LevenbergMarquardtTrustRegionPolicy::~LevenbergMarquardtTrustRegionPolicy() {}
+
+    void LevenbergMarquardtTrustRegionPolicy::setGeodesicAcceleration(bool enable, double alpha, double h)
+    {
+      SM_ASSERT_GT(Exception, alpha, 0.0, "");
+      SM_ASSERT_GT(Exception, h, 0.0, "");
+      _geodesicAcceleration = enable;
+      _geodesicAlpha = alpha;
+      _geodesicStep = h;
+    }
+
+    void LevenbergMarquardtTrustRegionPolicy::setNonmonotoneWindow(std::size_t window)
+    {
+      SM_ASSERT_GE(Exception, window, 1u, "");
+      _nonmonotoneWindow = window;
+    }
         
         
         /// \brief called by the optimizer when an optimization is starting
         void LevenbergMarquardtTrustRegionPolicy::optimizationStartingImplementation(double /* J */)
         {
+          _acceptedCosts.clear();
+          _numAcceleratedSteps = 0;
+          _stepProjected = false;
+          if (isWarmStart()) {
+            // keep lambda and mu of the last optimization, the decay lowers the damping
+            _lambda = std::max(_lambda * getWarmStartDecay(), 1e-15);
+            return;
+          }
             // initialise lambda:
           _lambda = _lambdaInit;
           _gamma = _gammaInit;
@@ -47,29 +75,42 @@ namespace aslam {
         }
         
         // Returns true if the solution was successful
-    bool LevenbergMarquardtTrustRegionPolicy::solveSystemImplementation(double /* J */, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
+    bool LevenbergMarquardtTrustRegionPolicy::solveSystemImplementation(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
         {
             SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
+
+            if (isFirstIteration() || !previousIterationFailed) {
+              // J is the cost of a newly accepted state
+              _acceptedCosts.push_back(J);
+              while (_acceptedCosts.size() > _nonmonotoneWindow)
+                _acceptedCosts.pop_front();
+            }
             
             if (isFirstIteration()) {
                 // This is the first step.
-                _solver->buildSystem(nThreads, true);
+                buildSystem(nThreads);
             } else {
                 ///get Rho and update Lambda:
                 double rho = getLmRho(outDx);
+                _stepProjected = false;
               
                 if (previousIterationFailed ) {
-                  // The last step was a regression.
+                  // The last step was a regression and the optimizer reverted it. The system of the last accepted state
+                  // is still current, whatever the window, only the damping is raised. The nonmonotone reference costs
+                  // come from _acceptedCosts and need no new system.
                   _mu *= 2;
                   _lambda *= _mu;
                 } else if (rho <= 0 ) {
                   // No need to rebuild the system. Just reset the conditioner
                   _mu *= 10;
                   _lambda *= _mu;
+                  // Unless the nonmonotone acceptance kept a step that did not decrease the cost, then the state moved
+                  if (_nonmonotoneWindow > 1)
+                    buildSystem(nThreads);
                 } else {
                     // The last iteration was successful
                     // Here we need to rebuild the system
-                    _solver->buildSystem(nThreads, true);
+                    buildSystem(nThreads);
                     if (_lambda > 1e-16) {
                         double u1 = 1 / _gamma;
                         double u2 = 1 - (_beta - 1) * pow((2 * rho - 1), _p);
@@ -85,9 +126,42 @@ namespace aslam {
             }
             
             _solver->setConstantConditioner(_lambda);
-            return _solver->solveSystem(outDx);
+            const bool success = _solver->solveSystem(outDx);
+            if (success && _geodesicAcceleration && getStepEvaluator()) {
+              addGeodesicAcceleration(outDx);
+            }
+            return success;
         }
-        
+
+    void LevenbergMarquardtTrustRegionPolicy::buildSystem(int nThreads)
+    {
+      _solver->buildSystem(nThreads, true);
+      updateForcingTerm();
+      if (_geodesicAcceleration) {
+        _e0 = _solver->e();
+      }
+    }
+
+    void LevenbergMarquardtTrustRegionPolicy::addGeodesicAcceleration(Eigen::VectorXd& inOutDx)
+    {
+      // Transtrum and Sethna, 2012. The velocity v is the regular LM step.
+      const Eigen::VectorXd& v = inOutDx;
+      Eigen::VectorXd Jv, eh, a;
+      if (_e0.size() == 0 || !_solver->multiplyJacobian(v, Jv))
+        return;
+      getStepEvaluator()(_geodesicStep * v, &eh);
+      // Finite difference of the second directional derivative of the errors along v. e() holds the negated errors,
+      // so this is the negated derivative and the same right-hand side J^T * e as for the velocity yields a.
+      const Eigen::VectorXd evv = (2.0 / _geodesicStep) * ((eh - _e0) / _geodesicStep + Jv);
+      if (!evv.allFinite() || !_solver->solveSystemForError(evv, a))
+        return;
+      // Reject the correction if the quadratic model does not dominate
+      if (2.0 * a.norm() > _geodesicAlpha * v.norm())
+        return;
+      inOutDx += 0.5 * a;
+      ++_numAcceleratedSteps;
+    }
+
         /// \brief print the current state to a stream (no newlines).
         std::ostream & LevenbergMarquardtTrustRegionPolicy::printState(std::ostream & out) const
         {
@@ -100,13 +174,34 @@ namespace aslam {
         {
             return true;
         }
+
+    double LevenbergMarquardtTrustRegionPolicy::acceptanceThreshold(double J) const
+    {
+      double threshold = J;
+      for (double cost : _acceptedCosts)
+        threshold = std::max(threshold, cost);
+      return threshold;
+    }
+        
         
+    void LevenbergMarquardtTrustRegionPolicy::stepProjected(const Eigen::VectorXd& dx)
+    {
+      // The solver still holds the system the step was solved from. Without Jacobian products the damped model
+      // of getLmRho() is evaluated for the clipped step.
+      _stepProjected = getModelReduction(dx, _projectedReduction);
+    }
         
         double LevenbergMarquardtTrustRegionPolicy::getLmRho(const Eigen::VectorXd & dx)
         {
             double d1 = get_dJ();    // update cost delta
-            // L(0) - L(h):
-            double d2 = dx.transpose() * (_lambda * dx + _solver->rhs());
+            if (_stepProjected) {
+              // The clipped step is no solution of the damped system, a model predicting no decrease keeps the sign of d1
+              return d1 / std::max(_projectedReduction, std::numeric_limits<double>::min());
+            }
+            // L(0) - L(h), with column scaling the damping acts on the scaled step
+            const Eigen::VectorXd& scale = _solver->getColumnScale();
+            const double dampedNorm = scale.size() == dx.size() ? dx.cwiseQuotient(scale).squaredNorm() : dx.squaredNorm();
+            double d2 = _lambda * dampedNorm + dx.dot(_solver->rhs());
             return d1 / d2;
         }
         
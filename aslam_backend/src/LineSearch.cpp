@@ -464,16 +464,20 @@ void LineSearch::initialize(boost::optional<const RowVectorType&> searchDirectio
   _errorOutdated = _derrorOutdated = true;
   _errorOld = std::numeric_limits<double>::signaling_NaN();
 
-  if (error)
-    _error = error.get();
-  else
-    this->updateError();
-  _errorOutdated = false;
+  if (!error && !gradient) {
+    this->evaluateErrorAndGradient();
+  } else {
+    if (error)
+      _error = error.get();
+    else
+      this->updateError();
 
-  if (gradient)
-    _gradient = gradient.get();
-  else
-    this->updateGradient();
+    if (gradient)
+      _gradient = gradient.get();
+    else
+      this->updateGradient();
+  }
+  _errorOutdated = false;
 
   if (searchDirection)
     this->setSearchDirection(searchDirection.get());
@@ -545,6 +549,28 @@ void LineSearch::updateErrorDerivative() {
   _derrorOutdated = false;
 }
 
+void LineSearch::updateErrorAndErrorDerivative() {
+  if (_errorOutdated && _derrorOutdated) {
+    const double errorOld = _error;
+    const double dErrorOld = _derror;
+    this->evaluateErrorAndGradient();
+    _derror = computeErrorDerivative();
+    SM_VERBOSE_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: update error " << errorOld << " -> " << _error << " (" << _error - errorOld << ")");
+    SM_VERBOSE_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: update error derivative "<< dErrorOld << " -> " << _derror << " (" << _derror - dErrorOld << ")");
+    _errorOutdated = _derrorOutdated = false;
+  } else {
+    this->updateError();
+    this->updateErrorDerivative();
+  }
+}
+
+void LineSearch::evaluateErrorAndGradient() {
+  _error = _costFunction->evaluateErrorAndGradient(_gradient);
+  if (_evalErrorCallback) _evalErrorCallback();
+  if (_evalGradCallback) _evalGradCallback();
+  if (_evalErrorAndGradCallback) _evalErrorAndGradCallback();
+}
+
 bool LineSearch::zoom(double minStepSize, double maxStepSize, double error_lo, double error_hi, double derror_lo, double error0, double derror0) {
 
   size_t i = 0;
@@ -692,8 +718,7 @@ bool LineSearch::lineSearchWolfe1() {
       case Dcsrch::RUNNING:
         stepLength = stp;
         this->applyStateUpdate(stp);
-        this->updateError();
-        this->updateErrorDerivative();
+        this->updateErrorAndErrorDerivative();
         break;
       case Dcsrch::CONVERGED:
         SM_FINE_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: wolfe1 -- converged, final step length " << stp <<
@@ -848,5 +873,91 @@ bool LineSearch::lineSearchWolfe12() {
   return true;
 }
 
+bool LineSearch::lineSearchProjected(const double backtrackingFactor /*= 0.5*/, RowVectorType* outStep /*= nullptr*/) {
+
+  SM_ASSERT_GT(Exception, backtrackingFactor, 0.0, "");
+  SM_ASSERT_LT(Exception, backtrackingFactor, 1.0, "");
+  // Check that the error and gradient information is up to date and not NaN
+  SM_ASSERT_FALSE(Exception, isnan(getError()), "");
+  SM_ASSERT_FALSE(Exception, isnan(getErrorDerivative()), "");
+
+  if (outStep)
+    *outStep = RowVectorType::Zero(_searchDirection.size());
+
+  if (_derror == 0.0) {
+    SM_FINE_STREAM_NAMED("optimization.linesearch", "LineSearch: Error derivative is zero, seems like the system is at its optimum.");
+    return true;
+  }
+
+  const double error0 = _error;
+  const double derror0 = _derror;
+  const RowVectorType gradient0 = _gradient;
+  const RowVectorType searchDirection0 = _searchDirection;
+  _errorOld = _error;
+
+  const auto& dvs = _costFunction->getDesignVariables();
+  utils::DesignVariableState dvstate(dvs);
+  RowVectorType step;
+  bool stationary = false;
+  bool projectedGradient = false;
+  const double s0 = min(_options.initialStepLength, _options.maxStepLength);
+  for (double s = s0; s >= _options.minStepLength; s *= backtrackingFactor) {
+
+    // The state is always updated from the start point, the projection is not linear in s
+    step = s*_searchDirection;
+    utils::projectStateUpdate(dvs, step);
+
+    // The projection can turn a descent direction into an ascent step. Restart along the projected steepest descent
+    // direction then, whose projected steps are descent steps unless it vanishes.
+    if ((gradient0*step.transpose())(0,0) >= 0.0) {
+      if (projectedGradient)
+        break;
+      SM_FINE_STREAM_NAMED("optimization.linesearch", "LineSearch: projected -- no descent step for step length " << s <<
+                           ", falling back to the projected gradient");
+      RowVectorType g = gradient0;
+      utils::projectGradient(dvs, g);
+      if (g.isZero(0.0)) {
+        stationary = true;
+        break;
+      }
+      _searchDirection = -g;
+      projectedGradient = true;
+      s = s0/backtrackingFactor;
+      continue;
+    }
+
+    utils::applyStateUpdate(dvs, step);
+    _stepLength = s;
+    _errorOutdated = _derrorOutdated = true;
+    this->updateError();
+
+    const double ftest = error0 + _options.c1WolfeCondition*(gradient0*step.transpose())(0,0);
+    if (_error <= ftest) {
+      this->updateErrorDerivative();
+      if (outStep)
+        *outStep = step;
+      SM_FINE_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: projected -- converged, final step length " << s <<
+                           ", final error " << _error);
+      return true;
+    }
+    SM_ALL_STREAM_NAMED("optimization.linesearch", setprecision(20) << "LineSearch: projected -- sufficient decrease condition not satisfied: " << _error << " <= " << ftest);
+    dvstate.restore();
+  }
+
+  // Back to the information of step length zero
+  _stepLength = 0.0;
+  _error = error0;
+  _derror = derror0;
+  _gradient = gradient0;
+  _searchDirection = searchDirection0;
+  _errorOutdated = _derrorOutdated = false;
+  if (stationary) {
+    SM_FINE_STREAM_NAMED("optimization.linesearch", "LineSearch: projected -- the projected gradient vanishes, seems like the system is at its optimum.");
+    return true;
+  }
+  SM_ERROR_STREAM("LineSearch: projected -- no step length with sufficient decrease found above " << _options.minStepLength);
+  return false;
+}
+
 } // namespace backend
 } // namespace aslam
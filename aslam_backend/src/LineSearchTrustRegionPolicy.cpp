@@ -22,6 +22,7 @@ bool LineSearchTrustRegionPolicy::solveSystemImplementation(double /* J */, bool
   if(isFirstIteration() || !previousIterationFailed) {
     Timer timeBuild("LsGnTrustRegionPolicy: Build linear system", false);
     _solver->buildSystem(nThreads, true);
+    updateForcingTerm();
     timeBuild.stop();
     Timer timeSolve("LsGnTrustRegionPolicy: Solve linear system", false);
     success = _solver->solveSystem(outDx);
@@ -1,6 +1,8 @@
 #include <aslam/backend/LinearSystemSolver.hpp>
 #include <boost/thread.hpp>
 #include <boost/ref.hpp>
+#include <cmath>
+#include <Eigen/QR>
 
 #include <aslam/backend/ErrorTerm.hpp>
 #include <aslam/backend/OptimizerCallbackManager.hpp>
@@ -89,6 +91,7 @@ namespace aslam {
       _threadLocalErrors.clear();
       _threadLocalErrors.resize(nThreads, 0.0);
       setupThreadedJob(boost::bind(&LinearSystemSolver::evaluateErrors, this, _1, _2, _3, _4), nThreads, useMEstimator);
+      projectErrors(_e);
       // Gather the squared error results from the multiple threads.
       if(callback) callback->issueCallback(callback::event::RESIDUALS_UPDATED{0, 0});
       double error = 0.0;
@@ -97,6 +100,22 @@ namespace aslam {
       return error;
     }
 
+    double LinearSystemSolver::evaluateTrialError(size_t nThreads, bool useMEstimator, Eigen::VectorXd& outE)
+    {
+      // Evaluate into a swapped in vector of the same size
+      outE.resize(_e.size());
+      _e.swap(outE);
+      double error;
+      try {
+        error = evaluateError(nThreads, useMEstimator);
+      } catch (...) {
+        _e.swap(outE);
+        throw;
+      }
+      _e.swap(outE);
+      return error;
+    }
+
     const Eigen::VectorXd& LinearSystemSolver::e() const
     {
       return _e;
@@ -135,11 +154,18 @@ namespace aslam {
       for (; dit != dvs.end(); ++dit) {
         _JCols += (*dit)->minimalDimensions();
       }
-      // \todo Verify that this is similar to the "reserve()" feature in a standard vector.
-      _e.resize(_JRows + _JCols);
-      _e.conservativeResize(_JRows);
+      // A new column layout of the same error terms, e.g. after fixing design variables at their bounds, keeps the errors
+      if ((size_t)_e.size() != _JRows) {
+        // \todo Verify that this is similar to the "reserve()" feature in a standard vector.
+        _e.resize(_JRows + _JCols);
+        _e.conservativeResize(_JRows);
+      }
       _rhs.resize(_JCols);
       _diagonalConditioner = Eigen::VectorXd::Zero(_JCols);
+      _gaugeBasis.resize(0, 0);
+      _errorBasis.resize(0, 0);
+      _rowSqrtWeights.clear();
+      _jacobianReused = false;
       initMatrixStructureImplementation(dvs, errors, useDiagonalConditioner);
     }
 
@@ -165,5 +191,168 @@ namespace aslam {
     void LinearSystemSolver::handleNewAcceptConstantErrorTerms() {
     }
 
+    void LinearSystemSolver::updateColumnScale()
+    {
+      if (!_columnScaling) {
+        _columnScale.resize(0);
+        return;
+      }
+      getColumnSquaredNorms(_columnScale);
+      SM_ASSERT_EQ(Exception, (size_t)_columnScale.size(), _JCols, "");
+      for (int i = 0; i < _columnScale.size(); ++i) {
+        // Empty columns are left alone. The scale is the power of two bringing the column norm into [0.5, 1), such
+        // scaling is exact and popColumnScaling() restores the system bit for bit however often it is solved.
+        if (_columnScale[i] > 0.0) {
+          int exponent;
+          std::frexp(std::sqrt(_columnScale[i]), &exponent);
+          _columnScale[i] = std::ldexp(1.0, -exponent);
+        } else {
+          _columnScale[i] = 1.0;
+        }
+      }
+    }
+
+    void LinearSystemSolver::updateRowWeights(bool useMEstimator)
+    {
+      _jacobianReused = false;
+      _rowSqrtWeights.resize(_errorTerms.size());
+      for (size_t i = 0; i < _errorTerms.size(); ++i) {
+        // The weight of the last error evaluation is the one ErrorTerm::getWeightedJacobians() applied
+        _rowSqrtWeights[i] = useMEstimator ? std::sqrt(_errorTerms[i]->getCurrentMEstimatorWeight()) : 1.0;
+      }
+    }
+
+    bool LinearSystemSolver::reweightSystem(bool useMEstimator)
+    {
+      const bool reuseJacobian = _reuseJacobian;
+      _reuseJacobian = false;
+      if (!reuseJacobian || _rowSqrtWeights.size() != _errorTerms.size())
+        return false;
+      Eigen::VectorXd scale(_JRows);
+      std::vector<double> sqrtWeights(_errorTerms.size());
+      for (size_t i = 0; i < _errorTerms.size(); ++i) {
+        const ErrorTerm& e = *_errorTerms[i];
+        sqrtWeights[i] = useMEstimator ? std::sqrt(e.getCurrentMEstimatorWeight()) : 1.0;
+        // Rows with zero weight can't be restored by scaling
+        if (_rowSqrtWeights[i] <= 0.0)
+          return false;
+        scale.segment(e.rowBase(), e.dimension()).setConstant(sqrtWeights[i] / _rowSqrtWeights[i]);
+      }
+      if (!scaleRows(scale))
+        return false;
+      _rowSqrtWeights.swap(sqrtWeights);
+      _jacobianReused = true;
+      updateColumnScale();
+      return true;
+    }
+
+    bool LinearSystemSolver::jacobianSquaredNorm(const Eigen::VectorXd& v, double& outNorm)
+    {
+      Eigen::VectorXd Jv;
+      if (!multiplyJacobian(v, Jv))
+        return false;
+      outNorm = Jv.squaredNorm();
+      return true;
+    }
+
+    void LinearSystemSolver::pushColumnScaling()
+    {
+      if (_columnScale.size() == 0)
+        return;
+      scaleColumns(_columnScale);
+      _swappedRhs = _columnScale.cwiseProduct(_rhs);
+      _rhs.swap(_swappedRhs);
+    }
+
+    void LinearSystemSolver::popColumnScaling(Eigen::VectorXd& inOutDx)
+    {
+      if (_columnScale.size() == 0)
+        return;
+      scaleColumns(_columnScale.cwiseInverse());
+      _rhs.swap(_swappedRhs);
+      if (inOutDx.size() == _columnScale.size())
+        inOutDx = inOutDx.cwiseProduct(_columnScale);
+    }
+
+    void LinearSystemSolver::setGaugeDirections(const Eigen::MatrixXd& directions)
+    {
+      if (directions.size() == 0) {
+        _gaugeBasis.resize(0, 0);
+        return;
+      }
+      SM_ASSERT_EQ(Exception, (size_t)directions.rows(), _JCols, "The gauge directions must have one row per column of the Jacobian matrix");
+      // Dependent directions are dropped
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(directions);
+      _gaugeBasis = qr.householderQ() * Eigen::MatrixXd::Identity(directions.rows(), qr.rank());
+    }
+
+    void LinearSystemSolver::setForcingTerm(double eta)
+    {
+      SM_ASSERT_GE(Exception, eta, 0.0, "The forcing term must not be negative");
+      SM_ASSERT_LT(Exception, eta, 1.0, "The forcing term must be less than one");
+      _forcingTerm = eta;
+    }
+
+    void LinearSystemSolver::projectGauge(Eigen::VectorXd& inOutDx) const
+    {
+      if (_gaugeBasis.cols() == 0 || inOutDx.size() != _gaugeBasis.rows())
+        return;
+      inOutDx -= _gaugeBasis * (_gaugeBasis.transpose() * inOutDx);
+    }
+
+    void LinearSystemSolver::setErrorProjection(const Eigen::MatrixXd& basis)
+    {
+      if (basis.size() == 0) {
+        _errorBasis.resize(0, 0);
+        return;
+      }
+      SM_ASSERT_TRUE(Exception, supportsErrorProjection(), "The " << name() << " solver does not support error projections");
+      SM_ASSERT_EQ(Exception, (size_t)basis.rows(), _JRows, "The error projection basis must have one row per row of the Jacobian matrix");
+      _errorBasis = basis;
+      // The next system is built from the projected errors
+      projectErrors(_e);
+    }
+
+    void LinearSystemSolver::projectErrors(Eigen::Ref<Eigen::MatrixXd> inOutE) const
+    {
+      if (_errorBasis.cols() == 0 || _applyingErrorProjection || inOutE.rows() != _errorBasis.rows())
+        return;
+      inOutE -= _errorBasis * (_errorBasis.transpose() * inOutE);
+    }
+
+    bool LinearSystemSolver::applyErrorProjection(const Eigen::VectorXd& e, Eigen::VectorXd& inOutDx)
+    {
+      if (_errorBasis.cols() == 0 || _applyingErrorProjection)
+        return true;
+      // With A = J^T J + D, W = J^T Q and the solutions Y = A^-1 W, the Woodbury identity gives the reduced solution
+      // (A - W W^T)^-1 J^T P e = x + Y (I - Q^T J Y)^-1 Q^T J x with x = A^-1 J^T P e = inOutDx - Y Q^T e.
+      const int k = _errorBasis.cols();
+      Eigen::MatrixXd Y(inOutDx.size(), k);
+      Eigen::MatrixXd M = Eigen::MatrixXd::Identity(k, k);
+      Eigen::VectorXd x, y, Jv;
+      _applyingErrorProjection = true;
+      try {
+        for (int c = 0; c < k; ++c) {
+          if (!solveSystemForError(_errorBasis.col(c), y) || !multiplyJacobian(y, Jv)) {
+            _applyingErrorProjection = false;
+            return false;
+          }
+          Y.col(c) = y;
+          M.col(c) -= _errorBasis.transpose() * Jv;
+        }
+        x = inOutDx - Y * (_errorBasis.transpose() * e);
+        if (!multiplyJacobian(x, Jv)) {
+          _applyingErrorProjection = false;
+          return false;
+        }
+      } catch (...) {
+        _applyingErrorProjection = false;
+        throw;
+      }
+      _applyingErrorProjection = false;
+      inOutDx = x + Y * M.fullPivLu().solve(_errorBasis.transpose() * Jv);
+      return inOutDx.allFinite();
+    }
+
   } // namespace backend
 }  // namespace aslam
@@ -19,6 +19,7 @@ MarginalizationPriorErrorTerm::MarginalizationPriorErrorTerm(const std::vector<a
 : aslam::backend::ErrorTermDs(R.rows()), _designVariables(designVariables), _d(d), _R(R), _dimensionDesignVariables(R.cols())
 {
 	SM_ASSERT_GT(aslam::InvalidArgumentException, designVariables.size(), 0, "The prior error term doesn't make much sense with zero design variables.");
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, _d.rows(), _R.rows(), "Dimension of R and the d mismatch!");
   // PTF: Hrm...here is a big weakness of the current optimizer code. We should have
   //      different base classes for different uncertainty types (scalar, diagonal, matrix, none)
   //      to avoid big matrix multiplications during optimization.
@@ -35,61 +36,114 @@ MarginalizationPriorErrorTerm::MarginalizationPriorErrorTerm(const std::vector<a
   }
   setDesignVariables(designVariables);
 
+  computeColumnSlices();
+  _diff.resize(_dimensionDesignVariables);
+  _currentError.resize(_dimensionErrorTerm);
 }
 
 MarginalizationPriorErrorTerm::~MarginalizationPriorErrorTerm() {
   // TODO Auto-generated destructor stub
 }
 
+void MarginalizationPriorErrorTerm::computeColumnSlices()
+{
+  // If R is square, the rows are blocked the same way as the columns. Otherwise
+  // we only exploit the row extent of each slice.
+  std::vector<RowRange> rowBlocks;
+  const bool square = _R.rows() == _R.cols();
+  int col = 0;
+  for(vector<aslam::backend::DesignVariable*>::iterator it = _designVariables.begin(); it != _designVariables.end(); ++it)
+  {
+    RowRange block = { col, (*it)->minimalDimensions() };
+    if (square)
+      rowBlocks.push_back(block);
+    col += block.rows;
+  }
+  SM_ASSERT_EQ(aslam::InvalidArgumentException, col, _R.cols(), "Dimension of R and the design variables mismatch!");
+  if (!square) {
+    RowRange block = { 0, static_cast<int>(_R.rows()) };
+    rowBlocks.push_back(block);
+  }
+
+  _columnSlices.clear();
+  col = 0;
+  for(vector<aslam::backend::DesignVariable*>::iterator it = _designVariables.begin(); it != _designVariables.end(); ++it)
+  {
+    ColumnSlice slice;
+    slice.col = col;
+    slice.cols = (*it)->minimalDimensions();
+    for (std::vector<RowRange>::const_iterator rb = rowBlocks.begin(); rb != rowBlocks.end(); ++rb)
+    {
+      if (_R.block(rb->start, slice.col, rb->rows, slice.cols).isZero(0.0))
+        continue;
+      // merge adjacent non-zero blocks into one range
+      if (!slice.nonZeroRows.empty() && slice.nonZeroRows.back().start + slice.nonZeroRows.back().rows == rb->start)
+        slice.nonZeroRows.back().rows += rb->rows;
+      else
+        slice.nonZeroRows.push_back(*rb);
+    }
+    _columnSlices.push_back(slice);
+    col += slice.cols;
+  }
+}
+
 double MarginalizationPriorErrorTerm::evaluateErrorImplementation()
 {
-  Eigen::VectorXd diff = getDifferenceSinceMarginalization();
-  SM_ASSERT_EQ(aslam::Exception, diff.rows(), _R.cols(), "Dimension of R and the minimal difference vector mismatch!");
-  SM_ASSERT_EQ(aslam::Exception, _d.rows(), _R.rows(), "Dimension of R and the d mismatch!");
-  Eigen::VectorXd currentError(_dimensionErrorTerm);
-  currentError.setZero();
-  currentError = -(_d - _R*diff);
-  setError(currentError);
+  const Eigen::VectorXd& diff = getDifferenceSinceMarginalization();
+  // e = -(d - R*diff), only touching the non-zero blocks of R
+  _currentError = -_d;
+  for (std::vector<ColumnSlice>::const_iterator slice = _columnSlices.begin(); slice != _columnSlices.end(); ++slice)
+  {
+    for (std::vector<RowRange>::const_iterator range = slice->nonZeroRows.begin(); range != slice->nonZeroRows.end(); ++range)
+    {
+      _currentError.segment(range->start, range->rows).noalias() +=
+          _R.block(range->start, slice->col, range->rows, slice->cols) * diff.segment(slice->col, slice->cols);
+    }
+  }
+  setError(_currentError);
   return evaluateChiSquaredError();
 
 }
 
 // Computes the difference vector of all design variables between the linearization point at marginalization and the current guess, on the tangent space (i.e. log(x_bar - x))
-Eigen::VectorXd MarginalizationPriorErrorTerm::getDifferenceSinceMarginalization()
+const Eigen::VectorXd& MarginalizationPriorErrorTerm::getDifferenceSinceMarginalization()
 {
-  Eigen::VectorXd diff = Eigen::VectorXd(_dimensionDesignVariables);
-  diff.setZero();
-  int index = 0;
-  std::vector<Eigen::MatrixXd>::iterator it_marg = _designVariableValuesAtMarginalization.begin();
-  std::vector<aslam::backend::DesignVariable*>::iterator it_current = _designVariables.begin();
-  for(;it_current != _designVariables.end(); ++it_current, ++it_marg)
+  Eigen::VectorXd diffVector;
+  std::vector<Eigen::MatrixXd>::const_iterator it_marg = _designVariableValuesAtMarginalization.begin();
+  std::vector<ColumnSlice>::const_iterator slice = _columnSlices.begin();
+  for(std::vector<aslam::backend::DesignVariable*>::const_iterator it_current = _designVariables.begin(); it_current != _designVariables.end(); ++it_current, ++it_marg, ++slice)
   {
-	  // retrieve current value (xbar) and value at marginalization(xHat)
-      Eigen::MatrixXd xHat = *it_marg;
+      // retrieve current value (xbar) and value at marginalization(xHat)
       //get minimal difference in tangent space
-      Eigen::VectorXd diffVector;
-      (*it_current)->minimalDifference(xHat, diffVector);
-      //int base = index;
-      int dim = diffVector.rows();
-      diff.segment(index, dim) = diffVector;
-      index += dim;
+      (*it_current)->minimalDifference(*it_marg, diffVector);
+      SM_ASSERT_EQ(aslam::Exception, diffVector.rows(), slice->cols, "Dimension of R and the minimal difference vector mismatch!");
+      _diff.segment(slice->col, slice->cols) = diffVector;
   }
-  return diff;
+  return _diff;
 }
 
 void MarginalizationPriorErrorTerm::evaluateJacobiansImplementation(JacobianContainer & outJ)
 {
-  int colIndex = 0;
-  std::vector<Eigen::MatrixXd>::iterator it_marg = _designVariableValuesAtMarginalization.begin();
-  for(vector<aslam::backend::DesignVariable*>::iterator it = _designVariables.begin(); it != _designVariables.end(); ++it, ++it_marg)
+  std::vector<Eigen::MatrixXd>::const_iterator it_marg = _designVariableValuesAtMarginalization.begin();
+  std::vector<ColumnSlice>::const_iterator slice = _columnSlices.begin();
+  Eigen::MatrixXd M;
+  Eigen::VectorXd diff;
+  for(vector<aslam::backend::DesignVariable*>::iterator it = _designVariables.begin(); it != _designVariables.end(); ++it, ++it_marg, ++slice)
   {
-    int dimDesignVariable = (*it)->minimalDimensions();
-    Eigen::MatrixXd M;
-    Eigen::VectorXd diff;
     (*it)->minimalDifferenceAndJacobian(*it_marg, diff, M);
-    SM_ASSERT_EQ(aslam::Exception, M.rows(), dimDesignVariable, "Minimal difference jacobian and design variable dimension mismatch!");
-    outJ.add(*it, _R.block(0, colIndex, _dimensionErrorTerm, dimDesignVariable)*M);
-    colIndex += dimDesignVariable;
+    SM_ASSERT_EQ(aslam::Exception, M.rows(), slice->cols, "Minimal difference jacobian and design variable dimension mismatch!");
+    if (M.isIdentity(0.0)) {
+      // the column slice of R is the Jacobian, hand it out without a copy. Exact compare, a nearly identical M still has to be applied.
+      outJ.add(*it, _R.middleCols(slice->col, slice->cols));
+    } else {
+      _jacobian.setZero(_dimensionErrorTerm, M.cols());
+      for (std::vector<RowRange>::const_iterator range = slice->nonZeroRows.begin(); range != slice->nonZeroRows.end(); ++range)
+      {
+        _jacobian.middleRows(range->start, range->rows).noalias() =
+            _R.block(range->start, slice->col, range->rows, slice->cols) * M;
+      }
+      outJ.add(*it, _jacobian);
+    }
   }
 
 }
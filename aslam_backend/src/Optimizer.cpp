@@ -19,6 +19,9 @@ namespace aslam {
 
 
     Optimizer::Optimizer(const Options& options) :
+      _covarianceSolver(new CovarianceSolver()),
+      _covarianceFactorValid(false),
+      _solverFactorIsH(false),
       _options(options)
     {
       initializeLinearSolver();
@@ -117,6 +120,10 @@ namespace aslam {
       _b.resize(_A.rows());
       _invVi.resize(numSparseDesignVariables());
       _dx.resize(_H.rowBaseOfBlock(_marginalizedStartingBlock));
+      // The structure of _H may have changed, so the symbolic factorization has to go as well.
+      _covarianceSolver->init();
+      invalidateCovarianceFactor();
+      setOrderingConstraints();
       initMx.stop();
       _options.verbose && std::cout << "Optimization problem initialized with " << _designVariables.size() << " design variables and " << _errorTerms.size() << " error terms\n";
       _options.verbose && std::cout << "The dense part of the state is " << _H.rowBaseOfBlock(_marginalizedStartingBlock) << " parameters and the sparse part is " << _H.cols() - _H.rowBaseOfBlock(_marginalizedStartingBlock) << " parameters\n";
@@ -124,6 +131,27 @@ namespace aslam {
 
 
 
+    void Optimizer::setOrderingConstraints()
+    {
+      // Constrain the block ordering (CAMD) only if the user assigned ordering groups.
+      std::vector<int> groups(_designVariables.size());
+      bool constrained = false;
+      for (size_t i = 0; i < _designVariables.size(); ++i) {
+        groups[i] = _designVariables[i]->orderingGroup();
+        constrained = constrained || groups[i] != groups[0];
+      }
+      if (!constrained)
+        groups.clear();
+      _covarianceSolver->setBlockOrderingConstraints(groups);
+      boost::shared_ptr<CovarianceSolver> solver = boost::dynamic_pointer_cast<CovarianceSolver>(_solver);
+      if (solver) {
+        // The solver only sees the non-marginalized blocks.
+        groups.resize(std::min<size_t>(groups.size(), _marginalizedStartingBlock));
+        solver->setBlockOrderingConstraints(groups);
+      }
+    }
+
+
     double Optimizer::getLmRho()
     {
       double d1 = _p_J - _J;    // update cost delta
@@ -524,6 +552,8 @@ namespace aslam {
         timeSolve.start();
         bool solutionSuccess = _solver->solve(_A, &_dx[0], &_b[0]);
         timeSolve.stop();
+        // Without LM damping and marginalization _A equals _H, so the solver's factor can answer covariance queries.
+        _solverFactorIsH = solutionSuccess && !_options.doLevenbergMarquardt && numSparseDesignVariables() == 0;
         if (!solutionSuccess) {
           // \todo do something better
           //SM_ASSERT_TRUE(Exception, solutionSuccess, "The linear solution failed");
@@ -685,6 +715,7 @@ namespace aslam {
     {
       // Do some initialization
       zeroMatrices();
+      invalidateCovarianceFactor();
       std::set<ErrorTerm*>::iterator it, it_end;
       it = _errorTerms.begin();
       it_end = _errorTerms.end();
@@ -758,11 +789,27 @@ namespace aslam {
       computeCovarianceBlocks(blockIndices);
     }
 
+    void Optimizer::invalidateCovarianceFactor()
+    {
+      _covarianceFactorValid = false;
+      _solverFactorIsH = false;
+    }
+
     void Optimizer::computeCovarianceBlocks(const std::vector<std::pair<int, int> > & blockIndices)
     {
-      /// \todo Figure out properly why I have to create a new linear solver here.
-      boost::shared_ptr<sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> > solver(new sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd>());
-      bool success = solver->solvePattern(_invH, blockIndices, _H);
+      // Reuse the factor of the last Gauss-Newton solve if it was computed on exactly _H.
+      if (_solverFactorIsH) {
+        boost::shared_ptr<CovarianceSolver> solver = boost::dynamic_pointer_cast<CovarianceSolver>(_solver);
+        if (solver && solver->solvePatternFromFactor(_invH, blockIndices, _H))
+          return;
+        _solverFactorIsH = false;
+      }
+      // Otherwise factor _H once (no lambda augmentation) and keep the factor until _H changes.
+      if (!_covarianceFactorValid) {
+        _covarianceFactorValid = _covarianceSolver->factorize(_H);
+        SM_ASSERT_TRUE(Exception, _covarianceFactorValid, "Unable to factorize the Hessian to retrieve the covariance");
+      }
+      bool success = _covarianceSolver->solvePatternFromFactor(_invH, blockIndices, _H);
       SM_ASSERT_TRUE(Exception, success, "Unable to retrieve covariance");
     }
 
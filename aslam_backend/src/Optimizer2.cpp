@@ -1,7 +1,11 @@
 #include <aslam/backend/Optimizer2.hpp>
 // std::partial_sum
 #include <numeric>
+#include <algorithm>
+#include <unordered_map>
+#include <limits>
 #include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/EqualityConstraint.hpp>
 // M.inverse()
 #include <Eigen/Dense>
 #include <sm/eigen/assert_macros.hpp>
@@ -15,6 +19,7 @@
 #include <aslam/backend/BlockCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
 #include <aslam/backend/DenseQrLinearSystemSolver.hpp>
+#include <aslam/backend/util/utils.hpp>
 #include <sm/PropertyTree.hpp>
 
 
@@ -37,6 +42,10 @@ namespace aslam {
 
         void Optimizer2::Status::resetImplementation() {
           srv = SolutionReturnValue();
+          numAugmentedLagrangianIterations = 0;
+          constraintViolation = 0.0;
+          numJacobianReuses = 0;
+          numVariableProjections = 0;
         }
 
         Optimizer2::Optimizer2(const Options& options) :
@@ -56,6 +65,16 @@ namespace aslam {
           options.linearSolverMaximumFails = config.getInt("linearSolverMaximumFails", options.linearSolverMaximumFails);
           options.numThreadsJacobian = getDeprecatedPropertyIfItExists(config, "nThreads", "numThreadsJacobian", (int)options.numThreadsJacobian, static_cast<int(sm::ConstPropertyTree::*)(const std::string&, int) const>(&sm::ConstPropertyTree::getInt));
           options.numThreadsError = config.getInt("numThreadsError", options.numThreadsError);
+          options.maxTimeMs = config.getDouble("maxTimeMs", options.maxTimeMs);
+          options.warmStartTrustRegion = config.getBool("warmStartTrustRegion", options.warmStartTrustRegion);
+          options.warmStartDecay = config.getDouble("warmStartDecay", options.warmStartDecay);
+          options.maxAugmentedLagrangianIterations = config.getInt("maxAugmentedLagrangianIterations", options.maxAugmentedLagrangianIterations);
+          options.constraintTolerance = config.getDouble("constraintTolerance", options.constraintTolerance);
+          options.penaltyIncreaseFactor = config.getDouble("penaltyIncreaseFactor", options.penaltyIncreaseFactor);
+          options.maxPenalty = config.getDouble("maxPenalty", options.maxPenalty);
+          options.gaugeRegularization = config.getDouble("gaugeRegularization", options.gaugeRegularization);
+          options.irlsJacobianReuse = config.getInt("irlsJacobianReuse", options.irlsJacobianReuse);
+          options.maxForcingTerm = config.getDouble("maxForcingTerm", options.maxForcingTerm);
           options.linearSystemSolver = linearSystemSolver;
           options.trustRegionPolicy = trustRegionPolicy;
           _options = options;
@@ -71,8 +90,11 @@ namespace aslam {
         void Optimizer2::initializeTrustRegionPolicy()
         {
           if( !_options.trustRegionPolicy ) {
-            _options.verbose && std::cout << "No trust region policy set in the options. Defaulting to levenberg_marquardt\n";
-            _trustRegionPolicy.reset( new LevenbergMarquardtTrustRegionPolicy() );
+            // Keep the default policy across initializations, it may carry a warm start state
+            if( !_trustRegionPolicy ) {
+              _options.verbose && std::cout << "No trust region policy set in the options. Defaulting to levenberg_marquardt\n";
+              _trustRegionPolicy.reset( new LevenbergMarquardtTrustRegionPolicy() );
+            }
           } else {
             _trustRegionPolicy = _options.trustRegionPolicy;
           }
@@ -84,6 +106,10 @@ namespace aslam {
             _trustRegionPolicy.reset( new DogLegTrustRegionPolicy() );
           }
 
+          _trustRegionPolicy->setWarmStart(_options.warmStartTrustRegion, _options.warmStartDecay);
+          if (_options.maxForcingTerm > 0.0)
+            _trustRegionPolicy->setForcingTerms(_options.maxForcingTerm);
+
           _options.verbose && std::cout << "Using the " << _trustRegionPolicy->name() << " trust region policy\n";
 
         }
@@ -108,13 +134,480 @@ namespace aslam {
             initializeTrustRegionPolicy();
 
             Timer initMx("Optimizer2: Initialize---Matrices");
-            // Set up the block matrix structure.
-            _solver->initMatrixStructure(getDesignVariables(), problemManager().getErrorTerms(), _trustRegionPolicy->requiresAugmentedDiagonal());
+            if (_blockCoordinateGroups.empty()) {
+              _groups.clear();
+              // Set up the block matrix structure.
+              _solver->initMatrixStructure(getDesignVariables(), problemManager().getErrorTerms(), useDiagonalConditioner());
+            } else {
+              // The full system is never solved in block-coordinate mode, only the structure of the groups is needed.
+              initializeBlockCoordinateGroups();
+            }
             initMx.stop();
+
+            // Collect the bounded design variables and the error terms needed for their gradient
+            _fixedDesignVariables.clear();
+            _freeDesignVariables.clear();
+            _boundedDesignVariables.clear();
+            _boundedErrorTerms.clear();
+            std::unordered_map<const DesignVariable*, size_t> boundedIndex;
+            for (DesignVariable* dv : getDesignVariables()) {
+              if (dv->hasBounds()) {
+                boundedIndex.emplace(dv, _boundedDesignVariables.size());
+                _boundedDesignVariables.push_back(dv);
+              }
+            }
+            if (!_boundedDesignVariables.empty()) {
+              _boundedErrorTerms.resize(_boundedDesignVariables.size());
+              for (ErrorTerm* e : problemManager().getErrorTerms()) {
+                for (size_t i = 0; i < e->numDesignVariables(); ++i) {
+                  auto it = boundedIndex.find(e->designVariable(i));
+                  if (it == boundedIndex.end())
+                    continue;
+                  std::vector<ErrorTerm*>& errorTerms = _boundedErrorTerms[it->second];
+                  if (errorTerms.empty() || errorTerms.back() != e)
+                    errorTerms.push_back(e);
+                }
+              }
+            }
+            // The multipliers and penalties of the equality constraints are updated by the augmented Lagrangian outer loop
+            _constraints.clear();
+            for (ErrorTerm* e : problemManager().getErrorTerms()) {
+              EqualityConstraint* constraint = dynamic_cast<EqualityConstraint*>(e);
+              if (constraint != nullptr) {
+                SM_ASSERT_TRUE(Exception, e->getMEstimatorPolicy<NoMEstimator>().get() != nullptr, "Equality constraints must not have an M-estimator");
+                _constraints.push_back(constraint);
+              }
+            }
+            initializeVariableProjection();
             _options.verbose && std::cout << "Optimization problem initialized with " << problemManager().numDesignVariables() << " design variables and " << problemManager().getErrorTerms().size() << " error terms\n";
             _options.verbose && std::cout << "The Jacobian matrix is " << problemManager().getTotalDimSquaredErrorTerms() << " x " << problemManager().numOptParameters() << std::endl;
         }
 
+        void Optimizer2::setBlockCoordinateGroups(const std::vector< std::vector<DesignVariable*> >& groups)
+        {
+          for (size_t g = 0; g < groups.size(); ++g) {
+            SM_ASSERT_FALSE(Exception, groups[g].empty(), "Block-coordinate group " << g << " has no design variables");
+          }
+          _blockCoordinateGroups = groups;
+          // The group structure is built on the next initialization
+          problemManager().signalProblemChanged();
+        }
+
+        void Optimizer2::clearBlockCoordinateGroups()
+        {
+          setBlockCoordinateGroups(std::vector< std::vector<DesignVariable*> >());
+        }
+
+        void Optimizer2::setLinearDesignVariables(const std::vector<DesignVariable*>& linearDesignVariables)
+        {
+          _linearDesignVariables = linearDesignVariables;
+          // The subproblem is built on the next initialization
+          problemManager().signalProblemChanged();
+        }
+
+        void Optimizer2::clearLinearDesignVariables()
+        {
+          setLinearDesignVariables(std::vector<DesignVariable*>());
+        }
+
+        void Optimizer2::setGaugeFunction(const GaugeFunction& gauge)
+        {
+          // Only switching the gauge handling on or off may change the matrix structure, new directions do not
+          const bool changed = _gaugeFunction.empty() != gauge.empty();
+          _gaugeFunction = gauge;
+          if (changed)
+            problemManager().signalProblemChanged();
+        }
+
+        void Optimizer2::setGaugeDirections(const Eigen::MatrixXd& directions)
+        {
+          setGaugeFunction([directions](Eigen::MatrixXd& outDirections) { outDirections = directions; });
+        }
+
+        void Optimizer2::clearGaugeDirections()
+        {
+          setGaugeFunction(GaugeFunction());
+        }
+
+        bool Optimizer2::useDiagonalConditioner() const
+        {
+          return _trustRegionPolicy->requiresAugmentedDiagonal() || (!_gaugeFunction.empty() && !_solver->isRankRevealing());
+        }
+
+        void Optimizer2::updateGaugeDirections()
+        {
+          Eigen::MatrixXd directions;
+          _gaugeFunction(directions);
+          SM_ASSERT_EQ(Exception, (size_t)directions.rows(), problemManager().numOptParameters(), "The gauge directions need one row per minimal parameter of the design variables");
+          if (!_fixedDesignVariables.empty()) {
+            // Keep the rows of the free design variables
+            Eigen::MatrixXd freeDirections(_solver->JCols(), directions.cols());
+            int row = 0, freeRow = 0;
+            size_t f = 0;
+            for (DesignVariable* dv : getDesignVariables()) {
+              const int dim = dv->minimalDimensions();
+              if (f < _fixedDesignVariables.size() && _fixedDesignVariables[f] == dv) {
+                ++f;
+              } else {
+                freeDirections.middleRows(freeRow, dim) = directions.middleRows(row, dim);
+                freeRow += dim;
+              }
+              row += dim;
+            }
+            directions.swap(freeDirections);
+          }
+          _solver->setGaugeDirections(directions);
+          // The Cholesky factorizations fail on the singular system without damping
+          if (!_trustRegionPolicy->requiresAugmentedDiagonal() && !_solver->isRankRevealing()) {
+            SM_ASSERT_GT(Exception, _options.gaugeRegularization, 0.0, "");
+            _solver->setConstantConditioner(std::sqrt(_options.gaugeRegularization));
+          }
+        }
+
+        void Optimizer2::initializeBlockCoordinateGroups()
+        {
+          const std::vector<DesignVariable*>& dvs = getDesignVariables();
+          std::unordered_map<const DesignVariable*, size_t> groupOf;
+          for (size_t g = 0; g < _blockCoordinateGroups.size(); ++g) {
+            for (DesignVariable* dv : _blockCoordinateGroups[g]) {
+              SM_ASSERT_TRUE(Exception, dv != nullptr, "Null design variable in block-coordinate group " << g);
+              const int bi = dv->blockIndex();
+              SM_ASSERT_TRUE(Exception, bi >= 0 && size_t(bi) < dvs.size() && dvs[bi] == dv,
+                             "A design variable of block-coordinate group " << g << " is not an active design variable of the problem");
+              SM_ASSERT_TRUE(Exception, groupOf.emplace(dv, g).second, "A design variable is part of more than one block-coordinate group");
+            }
+          }
+
+          _groups.clear();
+          _groups.resize(_blockCoordinateGroups.size());
+          for (size_t g = 0; g < _groups.size(); ++g) {
+            _groups[g].designVariables = _blockCoordinateGroups[g];
+          }
+          // Error terms coupling several groups take part in the subproblem of each of them
+          for (ErrorTerm* e : problemManager().getErrorTerms()) {
+            for (size_t i = 0; i < e->numDesignVariables(); ++i) {
+              auto it = groupOf.find(e->designVariable(i));
+              if (it == groupOf.end())
+                continue;
+              std::vector<ErrorTerm*>& errorTerms = _groups[it->second].errorTerms;
+              if (errorTerms.empty() || errorTerms.back() != e)
+                errorTerms.push_back(e);
+            }
+          }
+
+          try {
+            for (size_t g = 0; g < _groups.size(); ++g) {
+              BlockCoordinateGroup& group = _groups[g];
+              SM_ASSERT_FALSE(Exception, group.errorTerms.empty(), "No error term touches block-coordinate group " << g);
+              group.solver = _options.blockCoordinateSolverFactory ? _options.blockCoordinateSolverFactory() : boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver());
+              SM_ASSERT_TRUE(Exception, group.solver.get() != NULL, "The block-coordinate solver factory returned a null solver");
+              // \todo remove this check when the sparse qr solver supports an augmented diagonal
+              SM_ASSERT_FALSE(Exception, group.solver->name() == "sparse_qr" && _trustRegionPolicy->requiresAugmentedDiagonal(),
+                              "The sparse_qr solver is not compatible with the " << _trustRegionPolicy->name() << " trust region policy");
+              activateBlockCoordinateGroup(g);
+              group.solver->initMatrixStructure(group.designVariables, group.errorTerms, _trustRegionPolicy->requiresAugmentedDiagonal());
+            }
+          } catch (...) {
+            restoreFullProblem();
+            throw;
+          }
+          restoreFullProblem();
+          _options.verbose && std::cout << "Block-coordinate mode with " << _groups.size() << " design variable groups\n";
+        }
+
+        void Optimizer2::activateBlockCoordinateGroup(size_t g)
+        {
+          SM_ASSERT_LT_DBG(Exception, g, _groups.size(), "index out of bounds");
+          if (_activeGroup < 0) {
+            for (DesignVariable* dv : getDesignVariables())
+              dv->setActive(false);
+          } else {
+            for (DesignVariable* dv : _groups[_activeGroup].designVariables)
+              dv->setActive(false);
+          }
+          assignGroupIndices(_groups[g]);
+          _activeGroup = g;
+        }
+
+        void Optimizer2::assignGroupIndices(const BlockCoordinateGroup& group)
+        {
+          // Same assignment as in the problem manager, restricted to the group
+          int columnBase = 0;
+          for (size_t i = 0; i < group.designVariables.size(); ++i) {
+            DesignVariable* dv = group.designVariables[i];
+            dv->setActive(true);
+            dv->setBlockIndex(i);
+            dv->setColumnBase(columnBase);
+            columnBase += dv->minimalDimensions();
+          }
+          size_t rowBase = 0;
+          for (ErrorTerm* e : group.errorTerms) {
+            e->setRowBase(rowBase);
+            rowBase += e->dimension();
+          }
+        }
+
+        void Optimizer2::restoreFullProblem()
+        {
+          const std::vector<DesignVariable*>& dvs = getDesignVariables();
+          int columnBase = 0;
+          for (size_t i = 0; i < dvs.size(); ++i) {
+            dvs[i]->setActive(true);
+            dvs[i]->setBlockIndex(i);
+            dvs[i]->setColumnBase(columnBase);
+            columnBase += dvs[i]->minimalDimensions();
+          }
+          size_t rowBase = 0;
+          for (ErrorTerm* e : problemManager().getErrorTerms()) {
+            e->setRowBase(rowBase);
+            rowBase += e->dimension();
+          }
+          _activeGroup = -1;
+        }
+
+        void Optimizer2::initializeVariableProjection()
+        {
+          _linearGroup = BlockCoordinateGroup();
+          _linearDesignVariableSet.clear();
+          _linearErrorTermRowBases.clear();
+          _linearJacobian.resize(0, 0);
+          _linearErrorBasis.resize(0, 0);
+          _variableProjectionActive = false;
+          if (_linearDesignVariables.empty())
+            return;
+          SM_ASSERT_TRUE(Exception, _blockCoordinateGroups.empty(), "Variable projection is not supported in block-coordinate mode");
+          SM_ASSERT_TRUE(Exception, _gaugeFunction.empty(), "Variable projection is not supported with gauge directions");
+          SM_ASSERT_TRUE(Exception, _solver->supportsErrorProjection(), "The " << _solver->name() << " solver does not support variable projection");
+
+          const std::vector<DesignVariable*>& dvs = getDesignVariables();
+          for (DesignVariable* dv : _linearDesignVariables) {
+            SM_ASSERT_TRUE(Exception, dv != nullptr, "Null linear design variable");
+            const int bi = dv->blockIndex();
+            SM_ASSERT_TRUE(Exception, bi >= 0 && size_t(bi) < dvs.size() && dvs[bi] == dv, "A linear design variable is not an active design variable of the problem");
+            SM_ASSERT_FALSE(Exception, dv->hasBounds(), "Linear design variables must not have box bounds");
+            SM_ASSERT_TRUE(Exception, _linearDesignVariableSet.insert(dv).second, "A design variable is listed twice as linear design variable");
+          }
+          SM_ASSERT_LT(Exception, _linearDesignVariables.size(), dvs.size(), "Variable projection needs at least one nonlinear design variable");
+
+          _linearGroup.designVariables = _linearDesignVariables;
+          for (ErrorTerm* e : problemManager().getErrorTerms()) {
+            for (size_t i = 0; i < e->numDesignVariables(); ++i) {
+              if (_linearDesignVariableSet.count(e->designVariable(i))) {
+                _linearGroup.errorTerms.push_back(e);
+                break;
+              }
+            }
+          }
+          SM_ASSERT_FALSE(Exception, _linearGroup.errorTerms.empty(), "No error term touches the linear design variables");
+
+          // The residuals are linear in the group, the Gauss-Newton step of the subproblem is its least-squares solution
+          _linearGroup.solver.reset(new SparseCholeskyLinearSystemSolver());
+          for (DesignVariable* dv : dvs)
+            dv->setActive(false);
+          try {
+            assignGroupIndices(_linearGroup);
+            _linearGroup.solver->initMatrixStructure(_linearGroup.designVariables, _linearGroup.errorTerms, false);
+          } catch (...) {
+            restoreFullProblem();
+            throw;
+          }
+          restoreFullProblem();
+          for (ErrorTerm* e : _linearGroup.errorTerms)
+            _linearErrorTermRowBases.push_back(e->rowBase());
+          _options.verbose && std::cout << "Variable projection of " << _linearDesignVariables.size() << " linear design variables\n";
+        }
+
+        void Optimizer2::beginVariableProjection()
+        {
+          if (!_linearGroup.solver || _variableProjectionActive)
+            return;
+          if (isFullProblemActive())
+            _solverAcceptedConstantErrorTerms = _solver->isAcceptConstantErrorTerms();
+          _variableProjectionActive = true;
+          initializeActiveLinearSystem();
+          _options.verbose && std::cout << "Projected " << _linearDesignVariables.size() << " linear design variables, the Jacobian matrix has "
+              << _solver->JCols() << " columns\n";
+        }
+
+        void Optimizer2::endVariableProjection()
+        {
+          if (!_variableProjectionActive)
+            return;
+          _variableProjectionActive = false;
+          _linearErrorBasis.resize(0, 0);
+          initializeActiveLinearSystem();
+        }
+
+        void Optimizer2::projectLinearDesignVariables()
+        {
+          if (!_variableProjectionActive)
+            return;
+          for (DesignVariable* dv : activeDesignVariables())
+            dv->setActive(false);
+          LinearSystemSolver& solver = *_linearGroup.solver;
+          bool success = false;
+          Eigen::VectorXd da;
+          try {
+            assignGroupIndices(_linearGroup);
+            solver.evaluateError(_options.numThreadsError, true);
+            solver.buildSystem(_options.numThreadsJacobian, true);
+            // The residuals are linear in the group, its Jacobian matrix does not change with the update below
+            _linearJacobian.resize(solver.JRows(), solver.JCols());
+            Eigen::VectorXd unit = Eigen::VectorXd::Zero(solver.JCols()), Jv;
+            for (size_t c = 0; c < solver.JCols(); ++c) {
+              unit[c] = 1.0;
+              SM_ASSERT_TRUE(Exception, solver.multiplyJacobian(unit, Jv), "The " << solver.name() << " solver cannot multiply with its Jacobian matrix");
+              _linearJacobian.col(c) = Jv;
+              unit[c] = 0.0;
+            }
+            success = solver.solveSystem(da);
+          } catch (...) {
+            restoreFullProblem();
+            activateFreeDesignVariables();
+            throw;
+          }
+          restoreFullProblem();
+          activateFreeDesignVariables();
+          // Linear design variables are vector spaces, the update moves them onto the least-squares solution.
+          // If the subproblem is singular they keep their values, the zero update still makes them revertible.
+          if (success) {
+            _status.numVariableProjections++;
+          } else {
+            _options.verbose && std::cout << "[WARNING] The least-squares solution of the linear design variables failed\n";
+            da.setZero(solver.JCols());
+          }
+          int startIdx = 0;
+          for (DesignVariable* dv : _linearGroup.designVariables) {
+            const int dim = dv->minimalDimensions();
+            Eigen::VectorXd daS = da.segment(startIdx, dim);
+            daS *= dv->scaling();
+            dv->update(&daS[0], dim);
+            startIdx += dim;
+          }
+        }
+
+        void Optimizer2::updateLinearErrorBasis()
+        {
+          // Map the basis of the column space from the rows of the subproblem to the rows of the full problem
+          const Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(_linearJacobian);
+          const Eigen::MatrixXd Q = qr.householderQ() * Eigen::MatrixXd::Identity(_linearJacobian.rows(), qr.rank());
+          _linearErrorBasis = Eigen::MatrixXd::Zero(_solver->JRows(), Q.cols());
+          int row = 0;
+          for (size_t i = 0; i < _linearGroup.errorTerms.size(); ++i) {
+            const int dim = _linearGroup.errorTerms[i]->dimension();
+            _linearErrorBasis.middleRows(_linearErrorTermRowBases[i], dim) = Q.middleRows(row, dim);
+            row += dim;
+          }
+        }
+
+        const std::vector<DesignVariable*>& Optimizer2::activeDesignVariables() const
+        {
+          if (_activeGroup >= 0)
+            return _groups[_activeGroup].designVariables;
+          return isFullProblemActive() ? getDesignVariables() : _freeDesignVariables;
+        }
+
+        bool Optimizer2::updateActiveBounds(bool& outAllFixed)
+        {
+          outAllFixed = false;
+          // Only design variables with all parameters at a bound are candidates, the gradient decides whether the bounds are active
+          std::vector<DesignVariable*> candidates;
+          std::vector<ErrorTerm*> errorTerms;
+          for (size_t i = 0; i < _boundedDesignVariables.size(); ++i) {
+            DesignVariable* dv = _boundedDesignVariables[i];
+            if (utils::numParametersAtBound(*dv) == dv->minimalDimensions()) {
+              candidates.push_back(dv);
+              errorTerms.insert(errorTerms.end(), _boundedErrorTerms[i].begin(), _boundedErrorTerms[i].end());
+            }
+          }
+
+          std::vector<DesignVariable*> fixed;
+          if (!candidates.empty()) {
+            // The gradient of fixed design variables needs them active, with the column layout of the full problem
+            if (!isFullProblemActive())
+              restoreFullProblem();
+            std::sort(errorTerms.begin(), errorTerms.end());
+            errorTerms.erase(std::unique(errorTerms.begin(), errorTerms.end()), errorTerms.end());
+            RowVectorType gradient = RowVectorType::Zero(1, problemManager().numOptParameters());
+            for (ErrorTerm* e : errorTerms)
+              problemManager().addGradientForErrorTerm(gradient, e, true /* useMEstimator */, false /* useDenseJacobianContainer */);
+            for (DesignVariable* dv : candidates) {
+              auto g = gradient.segment(dv->columnBase(), dv->minimalDimensions());
+              if (utils::projectGradient(*dv, g) == dv->minimalDimensions())
+                fixed.push_back(dv);
+            }
+          }
+
+          // Linear design variables have no bounds, with variable projection they are not part of the linear system
+          const size_t numSystemDesignVariables = getDesignVariables().size() - (_variableProjectionActive ? _linearDesignVariables.size() : 0);
+          outAllFixed = fixed.size() == numSystemDesignVariables;
+          if (fixed == _fixedDesignVariables || outAllFixed) {
+            if (!candidates.empty() && !isFullProblemActive())
+              activateFreeDesignVariables();
+            return false;
+          }
+          if (fixed.empty()) {
+            releaseActiveBounds();
+            _options.verbose && std::cout << "Released all design variables from their bounds\n";
+            return true;
+          }
+
+          if (isFullProblemActive())
+            _solverAcceptedConstantErrorTerms = _solver->isAcceptConstantErrorTerms();
+          _fixedDesignVariables.swap(fixed);
+          initializeActiveLinearSystem();
+          _options.verbose && std::cout << "Fixed " << _fixedDesignVariables.size() << " design variables at active bounds, the Jacobian matrix has "
+              << _solver->JCols() << " columns\n";
+          return true;
+        }
+
+        void Optimizer2::activateFreeDesignVariables()
+        {
+          // Same assignment as in the problem manager, skipping the fixed and projected design variables
+          _freeDesignVariables.clear();
+          int columnBase = 0;
+          size_t f = 0;
+          for (DesignVariable* dv : getDesignVariables()) {
+            if (f < _fixedDesignVariables.size() && _fixedDesignVariables[f] == dv) {
+              dv->setActive(false);
+              ++f;
+              continue;
+            }
+            if (_variableProjectionActive && _linearDesignVariableSet.count(dv)) {
+              dv->setActive(false);
+              continue;
+            }
+            dv->setActive(true);
+            dv->setBlockIndex(_freeDesignVariables.size());
+            dv->setColumnBase(columnBase);
+            columnBase += dv->minimalDimensions();
+            _freeDesignVariables.push_back(dv);
+          }
+        }
+
+        void Optimizer2::initializeActiveLinearSystem()
+        {
+          if (isFullProblemActive()) {
+            _freeDesignVariables.clear();
+            restoreFullProblem();
+            _solver->setAcceptConstantErrorTerms(_solverAcceptedConstantErrorTerms);
+            _solver->initMatrixStructure(getDesignVariables(), problemManager().getErrorTerms(), useDiagonalConditioner());
+            return;
+          }
+          activateFreeDesignVariables();
+          // Error terms of fixed or projected design variables only are constant, keeping them keeps J the error of the full problem
+          _solver->setAcceptConstantErrorTerms(true);
+          _solver->initMatrixStructure(_freeDesignVariables, problemManager().getErrorTerms(), useDiagonalConditioner());
+        }
+
+        void Optimizer2::releaseActiveBounds()
+        {
+          if (_fixedDesignVariables.empty())
+            return;
+          _fixedDesignVariables.clear();
+          initializeActiveLinearSystem();
+        }
+
 
         /*
         // returns true of stop!
@@ -150,6 +643,102 @@ namespace aslam {
       }
 
         void Optimizer2::optimizeImplementation()
+        {
+            // Start from a feasible state
+            if (utils::projectOntoBounds(getDesignVariables())) {
+              _options.verbose && std::cout << "Projected the initial state onto the bounds of the design variables\n";
+            }
+
+            if (_constraints.empty()) {
+              optimizeUnconstrained();
+            } else {
+              optimizeAugmentedLagrangian();
+            }
+        }
+
+        void Optimizer2::optimizeUnconstrained()
+        {
+            if (!_groups.empty()) {
+              optimizeBlockCoordinates();
+              return;
+            }
+
+            try {
+              beginVariableProjection();
+              optimizeJointly();
+            } catch (...) {
+              endVariableProjection();
+              releaseActiveBounds();
+              throw;
+            }
+            endVariableProjection();
+            releaseActiveBounds();
+        }
+
+        void Optimizer2::optimizeAugmentedLagrangian()
+        {
+            SM_ASSERT_GT(Exception, _options.maxAugmentedLagrangianIterations, 0, "");
+            SM_ASSERT_GE(Exception, _options.constraintTolerance, 0.0, "");
+            SM_ASSERT_GE(Exception, _options.penaltyIncreaseFactor, 1.0, "");
+            SM_ASSERT_GT(Exception, _options.maxPenalty, 0.0, "");
+
+            SolutionReturnValue & srv = _status.srv;
+            int iterations = srv.iterations;
+            int failedIterations = srv.failedIterations;
+            double JStart = 0.0;
+            double previousViolation = std::numeric_limits<double>::infinity();
+            std::vector<Eigen::VectorXd> constraints;
+            for (int k = 0; ; ++k) {
+                // Every unconstrained optimization gets the full iteration budget
+                srv.iterations = 0;
+                srv.failedIterations = 0;
+                optimizeUnconstrained();
+                iterations += srv.iterations;
+                failedIterations += srv.failedIterations;
+                if (k == 0)
+                    JStart = srv.JStart;
+
+                _status.constraintViolation = evaluateConstraintViolation(constraints);
+                _options.verbose && std::cout << "[AL " << k << "]: J: " << _status.error << ", constraint violation: " << _status.constraintViolation << std::endl;
+                if (_status.constraintViolation <= _options.constraintTolerance || _status.convergence == FAILURE ||
+                    _status.convergence == TIME_LIMIT || _status.convergence == CALLBACK_STOP)
+                    break;
+                if (k + 1 >= _options.maxAugmentedLagrangianIterations) {
+                    _status.convergence = MAX_ITERATIONS;
+                    break;
+                }
+
+                // First order multiplier update. The penalty only grows if the multipliers alone do not reduce the violation fast enough.
+                const bool increasePenalty = _status.constraintViolation > 0.25 * previousViolation;
+                for (size_t i = 0; i < _constraints.size(); ++i) {
+                    EqualityConstraint* constraint = _constraints[i];
+                    const double penalty = constraint->getPenalty();
+                    constraint->setMultipliers(constraint->getMultipliers() + penalty * constraints[i]);
+                    if (increasePenalty && penalty < _options.maxPenalty)
+                        constraint->setPenalty(std::min(penalty * _options.penaltyIncreaseFactor, _options.maxPenalty));
+                }
+                previousViolation = _status.constraintViolation;
+                _status.numAugmentedLagrangianIterations++;
+            }
+            srv.iterations = iterations;
+            srv.failedIterations = failedIterations;
+            srv.JStart = JStart;
+            _status.numIterations = srv.iterations;
+        }
+
+        double Optimizer2::evaluateConstraintViolation(std::vector<Eigen::VectorXd>& outConstraints)
+        {
+            outConstraints.resize(_constraints.size());
+            double violation = 0.0;
+            for (size_t i = 0; i < _constraints.size(); ++i) {
+                outConstraints[i] = _constraints[i]->evaluateConstraint();
+                if (outConstraints[i].size() > 0)
+                    violation = std::max(violation, outConstraints[i].lpNorm<Eigen::Infinity>());
+            }
+            return violation;
+        }
+
+        void Optimizer2::optimizeJointly()
         {
             Timer timeErr("Optimizer2: evaluate error", true);
             Timer timeSchur("Optimizer2: Schur complement", true);
@@ -163,6 +752,7 @@ namespace aslam {
 
             // This sets _J
             timeErr.start();
+            projectLinearDesignVariables();
             evaluateError(true);
             timeErr.stop();
             _p_J = _status.error;
@@ -176,9 +766,16 @@ namespace aslam {
             deltaJ = _options.convergenceDeltaError + 1.0;
             bool previousIterationFailed = false;
             bool linearSolverFailure = false;
+            bool stopped = false;
+            // Whether the error projection of the linear system is the one of the current state
+            bool errorProjectionCurrent = false;
+            // The number of consecutive systems built from the last evaluated Jacobian. The solver may still hold the Jacobian
+            // of an earlier optimization or inner solve, the first system is always built from a fresh one.
+            int numJacobianReuses = _options.irlsJacobianReuse;
 
             SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
             _trustRegionPolicy->setSolver(_solver);
+            _trustRegionPolicy->setStepEvaluator([this](const Eigen::VectorXd& dx, Eigen::VectorXd* outE) { return evaluateTrialStep(dx, outE); });
             _trustRegionPolicy->optimizationStarting(_status.error);
 
             issueCallback<callback::event::OPTIMIZATION_INITIALIZED>();
@@ -190,12 +787,59 @@ namespace aslam {
                      fabs(deltaJ) > _options.convergenceDeltaError) ||
                     linearSolverFailure)) {
 
+                // Rejected steps are reverted at this point, i.e. the state is the best accepted one
+                if (stopRequestedBeforeIteration()) {
+                    stopped = true;
+                    break;
+                }
+
+                // The active bounds only change with the state
+                if (!_boundedDesignVariables.empty() && !previousIterationFailed) {
+                    bool allFixed = false;
+                    if (updateActiveBounds(allFixed)) {
+                        // The linear system changed its size, restart the trust region policy on it
+                        _trustRegionPolicy->optimizationStarting(_status.error);
+                    }
+                    if (allFixed) {
+                        // No parameter can move without leaving its bounds, this is a stationary point
+                        _options.verbose && std::cout << "All design variables are at active bounds\n";
+                        deltaX = 0.0;
+                        break;
+                    }
+                }
+
                 timeSolve.start();
+                if (!_gaugeFunction.empty())
+                    updateGaugeDirections();
+                if (_variableProjectionActive) {
+                    // The last projection was the one of the accepted state. A new matrix structure clears the error projection.
+                    if (!errorProjectionCurrent)
+                        updateLinearErrorBasis();
+                    _solver->setErrorProjection(_linearErrorBasis);
+                    errorProjectionCurrent = true;
+                }
+                // The error vector and the M-estimator weights are up to date unless the last step was reverted
+                const bool reuseJacobian = !previousIterationFailed && numJacobianReuses < _options.irlsJacobianReuse;
+                _solver->setReuseJacobian(reuseJacobian);
                 bool solutionSuccess = _trustRegionPolicy->solveSystem(_status.error, previousIterationFailed, _options.numThreadsError, _dx);
-                _status.numJacobianEvaluations++;
-                SM_ASSERT_EQ(Exception, problemManager().numOptParameters(), size_t(_dx.size()), "_trustRegionPolicy->solveSystem yielded dx with wrong size!");
+                _solver->setReuseJacobian(false);
+                // After a rejected step the policy may keep the old system and evaluate no Jacobian
+                if (_trustRegionPolicy->systemBuilt()) {
+                    if (reuseJacobian && _solver->wasJacobianReused()) {
+                        numJacobianReuses++;
+                        _status.numJacobianReuses++;
+                    } else {
+                        _status.numJacobianEvaluations++;
+                        numJacobianReuses = 0;
+                    }
+                }
+                SM_ASSERT_EQ(Exception, _solver->JCols(), size_t(_dx.size()), "_trustRegionPolicy->solveSystem yielded dx with wrong size!");
                 timeSolve.stop();
-                issueCallback<callback::event::LINEAR_SYSTEM_SOLVED>();
+                // A stop requested here discards the step before it is applied
+                if (issueCallback<callback::event::LINEAR_SYSTEM_SOLVED>() != callback::ProceedInstruction::CONTINUE && stopRequested()) {
+                    stopped = true;
+                    break;
+                }
 
                 if (!solutionSuccess) {
                     _options.verbose && std::cout << "[WARNING] System solution failed\n";
@@ -205,18 +849,25 @@ namespace aslam {
                 } else {
                     /// Apply the state update. _A, _b, _dx, and _H are passed in implicitly.
                     timeBackSub.start();
+                    // The policy judges the step by the model reduction of the step that is actually applied
+                    if (!_boundedDesignVariables.empty() && utils::projectStateUpdate(activeDesignVariables(), _dx))
+                        _trustRegionPolicy->stepProjected(_dx);
                     deltaX = applyStateUpdate();
                     timeBackSub.stop();
                     issueCallback<callback::event::DESIGN_VARIABLES_UPDATED>();
                     // This sets _J
                     timeErr.start();
+                    projectLinearDesignVariables();
+                    // The errors are projected with the basis of the new state once it is accepted
+                    if (_variableProjectionActive)
+                        _solver->setErrorProjection(Eigen::MatrixXd());
                     evaluateError(true);
                     timeErr.stop();
                     deltaJ = _p_J - _status.error;
                     // This was a regression.
                     if( _trustRegionPolicy->revertOnFailure() )
                     {
-                        if(deltaJ < 0.0)
+                        if(_status.error > _trustRegionPolicy->acceptanceThreshold(_p_J))
                         {
                             _options.verbose && std::cout << "Last step was a regression. Reverting\n";
                             revertLastStateUpdate();
@@ -227,11 +878,13 @@ namespace aslam {
                         {
                             _p_J = _status.error;
                             previousIterationFailed = false;
+                            errorProjectionCurrent = false;
                         }
                     }
                     else
                     {
                         _p_J = _status.error;
+                        errorProjectionCurrent = false;
                     }
                     srv.iterations++;
                     _status.numIterations = srv.iterations;
@@ -247,7 +900,138 @@ namespace aslam {
             srv.linearSolverFailure = linearSolverFailure;
 
             //TODO make _status.convergence a set!
-            if(srv.iterations >= _options.maxIterations){
+            if (stopped) {
+              // convergence set by stopRequested()
+            } else if(srv.iterations >= _options.maxIterations){
+              _status.convergence = MAX_ITERATIONS;
+            } else if(linearSolverFailure || srv.failedIterations >= _options.maxIterations){
+              _status.convergence = FAILURE;
+            } else if (deltaX <= _options.convergenceDeltaX) {
+              _status.convergence = DX;
+            } else if (fabs(deltaJ) <= _options.convergenceDeltaError) {
+              _status.convergence = DOBJECTIVE;
+            }
+        }
+
+        void Optimizer2::optimizeBlockCoordinates()
+        {
+            Timer timeErr("Optimizer2: evaluate error", true);
+            Timer timeSolve("Optimizer2: Build and solve linear system", true);
+            SolutionReturnValue & srv = _status.srv;
+            _status.numIterations = srv.iterations;
+
+            timeErr.start();
+            evaluateError(true);
+            timeErr.stop();
+            _p_J = _status.error;
+            srv.JStart = _p_J;
+            _options.verbose && std::cout << "[" << srv.iterations << ".0]: J: " << _status.error << std::endl;
+            double & deltaX = _status.maxDeltaX;
+            deltaX = _options.convergenceDeltaX + 1.0;
+            double & deltaJ = _status.deltaError;
+            deltaJ = _options.convergenceDeltaError + 1.0;
+            bool linearSolverFailure = false;
+            bool stopped = false;
+
+            issueCallback<callback::event::OPTIMIZATION_INITIALIZED>();
+
+            try {
+              // Each sweep visits every group once
+              while (srv.iterations <  _options.maxIterations &&
+                     srv.failedIterations < _options.maxIterations &&
+                     ((deltaX > _options.convergenceDeltaX &&
+                       fabs(deltaJ) > _options.convergenceDeltaError) ||
+                      linearSolverFailure)) {
+
+                deltaX = 0.0;
+                linearSolverFailure = false;
+                for (size_t g = 0; g < _groups.size(); ++g) {
+                  BlockCoordinateGroup& group = _groups[g];
+                  activateBlockCoordinateGroup(g);
+                  _trustRegionPolicy->setSolver(group.solver);
+                  _trustRegionPolicy->setStepEvaluator([this](const Eigen::VectorXd& dx, Eigen::VectorXd* outE) { return evaluateTrialStep(dx, outE); });
+
+                  // The error terms of the other groups are constant, hence the decrease of the group error is the decrease of the full objective
+                  timeErr.start();
+                  double groupJ = group.solver->evaluateError(_options.numThreadsError, true, &_callbackManager);
+                  _status.numErrorEvaluations++;
+                  timeErr.stop();
+                  _trustRegionPolicy->optimizationStarting(groupJ);
+                  bool previousIterationFailed = false;
+
+                  for (int k = 0; k < _options.blockCoordinateInnerIterations && !stopped; ++k) {
+                    if (stopRequestedBeforeIteration()) {
+                      stopped = true;
+                      break;
+                    }
+                    timeSolve.start();
+                    const bool solutionSuccess = _trustRegionPolicy->solveSystem(groupJ, previousIterationFailed, _options.numThreadsError, _dx);
+                    if (_trustRegionPolicy->systemBuilt())
+                      _status.numJacobianEvaluations++;
+                    SM_ASSERT_EQ(Exception, group.solver->JCols(), size_t(_dx.size()), "_trustRegionPolicy->solveSystem yielded dx with wrong size!");
+                    timeSolve.stop();
+                    if (issueCallback<callback::event::LINEAR_SYSTEM_SOLVED>() != callback::ProceedInstruction::CONTINUE && stopRequested()) {
+                      stopped = true;
+                      break;
+                    }
+
+                    if (!solutionSuccess) {
+                      _options.verbose && std::cout << "[WARNING] System solution failed for group " << g << "\n";
+                      previousIterationFailed = true;
+                      linearSolverFailure = true;
+                      srv.failedIterations++;
+                      continue;
+                    }
+
+                    const double groupDeltaX = applyStateUpdate();
+                    issueCallback<callback::event::DESIGN_VARIABLES_UPDATED>();
+                    timeErr.start();
+                    const double newGroupJ = group.solver->evaluateError(_options.numThreadsError, true, &_callbackManager);
+                    _status.numErrorEvaluations++;
+                    timeErr.stop();
+                    if (_trustRegionPolicy->revertOnFailure() && newGroupJ > _trustRegionPolicy->acceptanceThreshold(groupJ)) {
+                      _options.verbose && std::cout << "Last step of group " << g << " was a regression. Reverting\n";
+                      revertLastStateUpdate();
+                      srv.failedIterations++;
+                      previousIterationFailed = true;
+                    } else {
+                      groupJ = newGroupJ;
+                      deltaX = std::max(deltaX, groupDeltaX);
+                      previousIterationFailed = false;
+                    }
+                  }
+                  if (stopped)
+                    break;
+                }
+                restoreFullProblem();
+
+                timeErr.start();
+                evaluateError(true);
+                timeErr.stop();
+                deltaJ = _p_J - _status.error;
+                _p_J = _status.error;
+                srv.iterations++;
+                _status.numIterations = srv.iterations;
+
+                _options.verbose && std::cout << "[" << srv.iterations << "]: J: " << _status.error << ", dJ: " << deltaJ << ", deltaX: " << deltaX << std::endl;
+                if (stopped)
+                  break;
+              }
+            } catch (...) {
+              restoreFullProblem();
+              _trustRegionPolicy->setSolver(_solver);
+              throw;
+            }
+            _trustRegionPolicy->setSolver(_solver);
+
+            srv.JFinal = _status.error = _p_J;
+            srv.dXFinal = deltaX;
+            srv.dJFinal = deltaJ;
+            srv.linearSolverFailure = linearSolverFailure;
+
+            if (stopped) {
+              // convergence set by stopRequested()
+            } else if(srv.iterations >= _options.maxIterations){
               _status.convergence = MAX_ITERATIONS;
             } else if(linearSolverFailure || srv.failedIterations >= _options.maxIterations){
               _status.convergence = FAILURE;
@@ -274,39 +1058,71 @@ namespace aslam {
 
 
             double Optimizer2::applyStateUpdate()
+            {
+                return applyStateUpdate(_dx);
+            }
+
+            double Optimizer2::applyStateUpdate(const Eigen::VectorXd& dx)
             {
                 // Apply the update to the dense state.
                 int startIdx = 0;
-                for (DesignVariable* d : getDesignVariables()) {
+                // Track the maximum delta of the update that is actually applied
+                // \todo: should this be some other metric?
+                double deltaX = 0.0;
+                for (DesignVariable* d : activeDesignVariables()) {
                     const int dbd = d->minimalDimensions();
-                    Eigen::VectorXd dxS = _dx.segment(startIdx, dbd);
+                    Eigen::VectorXd dxS = dx.segment(startIdx, dbd);
+                    // The projected step keeps bounded design variables feasible
+                    utils::projectStateUpdate(*d, dxS);
+                    if (dbd > 0)
+                        deltaX = std::max(deltaX, dxS.cwiseAbs().maxCoeff());
                     dxS *= d->scaling();
                     d->update(&dxS[0], dbd);
                     startIdx += dbd;
                 }
-                // Track the maximum delta
-                // \todo: should this be some other metric?
-                double deltaX = _dx.array().abs().maxCoeff();
                 return deltaX;
             }
 
+            double Optimizer2::evaluateTrialStep(const Eigen::VectorXd& dx, Eigen::VectorXd* outE)
+            {
+                // The design variables keep a single reverted state, which is the current one again after the revert
+                applyStateUpdate(dx);
+                projectLinearDesignVariables();
+                // No callbacks, the trial state is never visible to the user. The error vector of the linear system is kept.
+                Eigen::VectorXd e;
+                const double J = _trustRegionPolicy->getSolver()->evaluateTrialError(_options.numThreadsError, true, outE ? *outE : e);
+                revertLastStateUpdate();
+                _status.numErrorEvaluations++;
+                return J;
+            }
+
 
 
 
 
             void Optimizer2::revertLastStateUpdate()
             {
-                for (DesignVariable * d : getDesignVariables()) {
+                for (DesignVariable * d : activeDesignVariables()) {
                     d->revertUpdate();
                 }
+                // Every evaluated step moves the projected design variables, see projectLinearDesignVariables()
+                if (_variableProjectionActive) {
+                    for (DesignVariable * d : _linearGroup.designVariables)
+                        d->revertUpdate();
+                }
             }
 
             double Optimizer2::evaluateError(bool useMEstimator)
             {
-              SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
-              _status.error = _solver->evaluateError(_options.numThreadsError, useMEstimator, &_callbackManager);
+              if (_groups.empty()) {
+                SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
+                _status.error = _solver->evaluateError(_options.numThreadsError, useMEstimator, &_callbackManager);
+              } else {
+                // The full linear system is not set up in block-coordinate mode
+                _status.error = problemManager().evaluateError(_options.numThreadsError);
+              }
               _status.numErrorEvaluations++;
-              _callbackManager.issueCallback(callback::event::COST_UPDATED{_status.error, _p_J});
+              handleProceedInstruction(_callbackManager.issueCallback(callback::event::COST_UPDATED{_status.error, _p_J}));
               return _status.error;
             }
 
@@ -392,9 +1208,8 @@ namespace aslam {
         }
 
         template <typename Event>
-        void Optimizer2::issueCallback(){
-          //TODO (HannesSommer) use ProceedInstruction value in the Optimizer
-          _callbackManager.issueCallback(Event{_status.error, 0});
+        callback::ProceedInstruction Optimizer2::issueCallback(){
+          return handleProceedInstruction(_callbackManager.issueCallback(Event{_status.error, 0}));
         }
 
         } // namespace backend
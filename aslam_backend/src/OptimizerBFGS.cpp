@@ -5,6 +5,7 @@
 #include <Eigen/Dense>
 #include <sm/eigen/assert_macros.hpp>
 #include <aslam/backend/sparse_matrix_functions.hpp>
+#include <aslam/backend/util/utils.hpp>
 #include <sm/PropertyTree.hpp>
 #include <sm/logging.hpp>
 
@@ -55,6 +56,7 @@ OptimizerBFGS::OptimizerBFGS(const OptimizerOptionsBFGS& options)
   _options.check();
   _linesearch.setEvaluateErrorCallback( [&]() { _status.numErrorEvaluations++; } );
   _linesearch.setEvaluateGradientCallback( [&]() { _status.numJacobianEvaluations++; });
+  _linesearch.setEvaluateErrorAndGradientCallback( [&]() { _status.numErrorAndGradientEvaluations++; });
 }
 
 OptimizerBFGS::OptimizerBFGS()
@@ -83,10 +85,18 @@ void OptimizerBFGS::optimizeImplementation()
 
   using namespace Eigen;
 
+  // With bounds, the search direction is computed from the projected gradient and the line search follows the projected path
+  const bool bounded = utils::hasBounds(getDesignVariables());
+  if (bounded && utils::projectOntoBounds(getDesignVariables()))
+    _linesearch.initialize();
+
   const MatrixXd I = MatrixXd::Identity(problemManager().numOptParameters(), problemManager().numOptParameters());
-  RowVectorType gfk, gfkp1;
+  RowVectorType gfk, gfkp1, gpk, sk;
   gfk = _linesearch.getGradient();
-  _status.gradientNorm = gfk.norm();
+  gpk = gfk;
+  if (bounded)
+    utils::projectGradient(getDesignVariables(), gpk);
+  _status.gradientNorm = gpk.norm();
   _status.error = _linesearch.getError();
   SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << "OptimizerBFGS: Start optimization at state " <<
                        problemManager().getFlattenedDesignVariableParameters().transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) <<
@@ -99,7 +109,10 @@ void OptimizerBFGS::optimizeImplementation()
     std::size_t cnt = 0;
     for (cnt = 0; _options.maxIterations == -1 || cnt < static_cast<size_t>(_options.maxIterations); ++cnt, ++_status.numIterations) {
 
-      _callbackManager.issueCallback( callback::event::ITERATION_START{} );
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_START{} ));
+      // Every state after a line search is accepted, so we may stop here
+      if (stopRequestedBeforeIteration())
+        break;
 
       // compute search direction
       // Note: this could fail due to numerical issues making the inverse Hessian approximation negative definite
@@ -109,7 +122,9 @@ void OptimizerBFGS::optimizeImplementation()
       RowVectorType pk;
       for(std::size_t j=0; j<2; ++j) {
         try {
-          pk = -_Bk*gfk.transpose();
+          pk = -_Bk*gpk.transpose();
+          if (bounded)
+            utils::projectSearchDirection(getDesignVariables(), pk);
           _linesearch.setSearchDirection(pk);
           break;
         } catch (const std::exception& e) {
@@ -127,12 +142,15 @@ void OptimizerBFGS::optimizeImplementation()
       const Eigen::VectorXd dv = problemManager().getFlattenedDesignVariableParameters();
 
       // perform line search
-      bool lsSuccess = _linesearch.lineSearchWolfe12();
-      _callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} );
+      bool lsSuccess = bounded ? _linesearch.lineSearchProjected(0.5, &sk) : _linesearch.lineSearchWolfe12();
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} ));
 
       const double alpha_k = _linesearch.getCurrentStepLength();
       gfkp1 = _linesearch.getGradient();
-      _status.gradientNorm = gfkp1.norm();
+      gpk = gfkp1;
+      if (bounded)
+        utils::projectGradient(getDesignVariables(), gpk);
+      _status.gradientNorm = gpk.norm();
       _status.deltaError = _linesearch.getError() - _status.error;
       _status.error = _linesearch.getError();
       _status.maxDeltaX = (problemManager().getFlattenedDesignVariableParameters() - dv).cwiseAbs().maxCoeff();
@@ -147,10 +165,18 @@ void OptimizerBFGS::optimizeImplementation()
       // Update Hessian
       timeUpdateHessian.start();
 
-      RowVectorType sk = alpha_k * pk;
+      if (!bounded)
+        sk = alpha_k * pk;
       RowVectorType yk = gfkp1 - gfk;
       gfk = gfkp1;
 
+      // Projected steps may violate the curvature condition, the approximation is kept positive definite by skipping them
+      if (bounded && (yk*sk.transpose())(0,0) <= 0.0) {
+        timeUpdateHessian.stop();
+        handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
+        continue;
+      }
+
       double rhok = 1./(yk*sk.transpose());
       if (std::isinf(rhok)) {
         rhok = 1000.0;
@@ -163,7 +189,7 @@ void OptimizerBFGS::optimizeImplementation()
 
       timeUpdateHessian.stop();
 
-      _callbackManager.issueCallback( callback::event::ITERATION_END{} );
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
     }
   }
 
@@ -5,6 +5,8 @@
  *      Author: sculrich
  */
 
+#include <algorithm>
+
 // Schweizer Messer
 #include <sm/PropertyTree.hpp>
 
@@ -30,6 +32,7 @@ OptimizerOptionsBase::OptimizerOptionsBase(const sm::PropertyTree& config) {
   maxIterations = config.getInt("maxIterations", maxIterations);
   numThreadsJacobian = config.getInt("numThreadsJacobian", numThreadsJacobian);
   numThreadsError = config.getInt("numThreadsError", numThreadsError);
+  maxTimeMs = config.getDouble("maxTimeMs", maxTimeMs);
 
   this->check();
 }
@@ -52,6 +55,7 @@ std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptio
   out << "\tmaxIterations: " << options.maxIterations << std::endl;
   out << "\tnumThreadsJacobian: " << options.numThreadsJacobian << std::endl;
   out << "\tnumThreadsError: " << options.numThreadsError << std::endl;
+  out << "\tmaxTimeMs: " << options.maxTimeMs << std::endl;
   return out;
 }
 
@@ -93,6 +97,12 @@ std::ostream& operator<<(std::ostream& out, const ConvergenceStatus& convergence
     case ConvergenceStatus::MAX_ITERATIONS:
       out << "MAX_ITERATIONS";
       break;
+    case ConvergenceStatus::TIME_LIMIT:
+      out << "TIME_LIMIT";
+      break;
+    case ConvergenceStatus::CALLBACK_STOP:
+      out << "CALLBACK_STOP";
+      break;
   }
   return out;
 }
@@ -107,7 +117,8 @@ std::ostream& operator<<(std::ostream& out, const OptimizerStatus& ret)
   out << "\tdobjective: " << ret.deltaError << std::endl;
   out << "\tmax dx: " << ret.maxDeltaX << std::endl;
   out << "\tevals objective: " << ret.numErrorEvaluations << std::endl;
-  out << "\tevals derivative: " << ret.numJacobianEvaluations;
+  out << "\tevals derivative: " << ret.numJacobianEvaluations << std::endl;
+  out << "\tevals fused (saved passes): " << ret.numErrorAndGradientEvaluations;
   return out;
 }
 
@@ -121,6 +132,11 @@ OptimizerBase::~OptimizerBase()
 
 void OptimizerBase::optimize()
 {
+  // The time budget includes a potential initialization
+  _startTime = std::chrono::steady_clock::now();
+  _proceedInstruction = callback::ProceedInstruction::CONTINUE;
+  _iterationStartMs = -1.0;
+  _maxIterationTimeMs = 0.0;
   if (!this->isInitialized())
     this->initialize();
   this->optimizeImplementation();
@@ -157,5 +173,47 @@ void OptimizerBase::updateConvergenceStatus()
   }
 }
 
+callback::ProceedInstruction OptimizerBase::handleProceedInstruction(const callback::ProceedInstruction instruction)
+{
+  if (_proceedInstruction == callback::ProceedInstruction::CONTINUE)
+    _proceedInstruction = instruction;
+  return instruction;
+}
+
+bool OptimizerBase::stopRequested(const double expectedIterationTimeMs /*= 0.0*/)
+{
+  switch (_proceedInstruction)
+  {
+    case callback::ProceedInstruction::FAIL:
+      status().convergence = FAILURE;
+      return true;
+    case callback::ProceedInstruction::SUCCEED:
+      status().convergence = CALLBACK_STOP;
+      return true;
+    case callback::ProceedInstruction::CONTINUE:
+      break;
+  }
+  const double budget = getOptions().maxTimeMs;
+  if (budget > 0.0 && elapsedTimeMs() + expectedIterationTimeMs > budget) {
+    status().convergence = TIME_LIMIT;
+    return true;
+  }
+  return false;
+}
+
+bool OptimizerBase::stopRequestedBeforeIteration()
+{
+  const double nowMs = elapsedTimeMs();
+  if (_iterationStartMs >= 0.0)
+    _maxIterationTimeMs = std::max(_maxIterationTimeMs, nowMs - _iterationStartMs);
+  _iterationStartMs = nowMs;
+  return stopRequested(_maxIterationTimeMs);
+}
+
+double OptimizerBase::elapsedTimeMs() const
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _startTime).count();
+}
+
 } /* namespace aslam */
 } /* namespace backend */
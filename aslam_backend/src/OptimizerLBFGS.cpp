@@ -0,0 +1,257 @@
+#include <iomanip>
+#include <aslam/backend/OptimizerLBFGS.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/util/utils.hpp>
+#include <Eigen/Dense>
+#include <sm/PropertyTree.hpp>
+#include <sm/logging.hpp>
+
+namespace aslam {
+namespace backend {
+
+OptimizerOptionsLBFGS::OptimizerOptionsLBFGS()
+    : OptimizerOptionsBase(), linesearch()
+{
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+}
+
+OptimizerOptionsLBFGS::OptimizerOptionsLBFGS(const sm::PropertyTree& config)
+    : OptimizerOptionsBase(config), linesearch(sm::PropertyTree(config, "linesearch"))
+{
+  historySize = config.getInt("historySize", historySize);
+  useDenseJacobianContainer = config.getBool("useDenseJacobianContainer", useDenseJacobianContainer);
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+}
+
+void OptimizerOptionsLBFGS::check() const
+{
+  OptimizerOptionsBase::check();
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsLBFGS& options)
+{
+  out << static_cast<OptimizerOptionsBase>(options) << std::endl;
+  out << options.linesearch << std::endl;
+  out << "OptimizerOptionsLBFGS:" << std::endl;
+  out << "\thistorySize: " << options.historySize << std::endl;
+  out << "\tuseDenseJacobianContainer: " << (options.useDenseJacobianContainer ? "TRUE" : "FALSE");
+  return out;
+}
+
+
+OptimizerLBFGS::OptimizerLBFGS(const OptimizerOptionsLBFGS& options)
+    : _options(options),
+      _linesearch(getCostFunction<false,true,false,true,true>(problemManager(), false, _options.useDenseJacobianContainer, false, _options.numThreadsJacobian, _options.numThreadsError), _options.linesearch)
+{
+  _options.check();
+  _linesearch.setEvaluateErrorCallback( [&]() { _status.numErrorEvaluations++; } );
+  _linesearch.setEvaluateGradientCallback( [&]() { _status.numJacobianEvaluations++; });
+  _linesearch.setEvaluateErrorAndGradientCallback( [&]() { _status.numErrorAndGradientEvaluations++; });
+}
+
+OptimizerLBFGS::OptimizerLBFGS()
+    : OptimizerLBFGS::OptimizerLBFGS(OptimizerOptionsLBFGS())
+{
+}
+
+OptimizerLBFGS::OptimizerLBFGS(const sm::PropertyTree& config)
+    : OptimizerLBFGS::OptimizerLBFGS(OptimizerOptionsLBFGS(config))
+{
+}
+
+OptimizerLBFGS::~OptimizerLBFGS()
+{
+}
+
+void OptimizerLBFGS::resetImplementation() {
+  const std::size_t n = problemManager().numOptParameters();
+  _S.resize(n, _options.historySize);
+  _Y.resize(n, _options.historySize);
+  _rho.resize(_options.historySize);
+  _alpha.resize(_options.historySize);
+  clearHistory();
+  _linesearch.initialize();
+}
+
+void OptimizerLBFGS::computeSearchDirection(const RowVectorType& gradient, RowVectorType& searchDirection)
+{
+  const std::size_t m = _S.cols();
+  RowVectorType& q = searchDirection; // work in place
+  q = gradient;
+
+  // first loop: newest to oldest correction pair
+  for (std::size_t k = _historyLength; k-- > 0; ) {
+    const std::size_t i = (_historyStart + k) % m;
+    _alpha[i] = _rho[i] * _S.col(i).dot(q);
+    q.noalias() -= _alpha[i] * _Y.col(i).transpose();
+  }
+
+  // initial inverse Hessian approximation H0 = gamma * I, scaled with the newest correction pair
+  if (_historyLength > 0) {
+    const std::size_t newest = (_historyStart + _historyLength - 1) % m;
+    q *= 1.0 / (_rho[newest] * _Y.col(newest).squaredNorm());
+  }
+
+  // second loop: oldest to newest correction pair
+  for (std::size_t k = 0; k < _historyLength; ++k) {
+    const std::size_t i = (_historyStart + k) % m;
+    const double beta = _rho[i] * _Y.col(i).dot(q);
+    q.noalias() += (_alpha[i] - beta) * _S.col(i).transpose();
+  }
+
+  q = -q;
+}
+
+bool OptimizerLBFGS::pushCorrectionPair(const RowVectorType& sk, const RowVectorType& yk)
+{
+  // Skip the update if the curvature condition is violated, otherwise the inverse Hessian approximation
+  // would lose positive definiteness. The Wolfe line search usually guarantees y_k^T s_k > 0.
+  const double ys = yk.dot(sk);
+  if (!(ys > std::numeric_limits<double>::epsilon() * yk.squaredNorm())) {
+    SM_DEBUG_STREAM_NAMED("optimization", "OptimizerLBFGS: Skipping correction pair with y^T s = " << ys);
+    return false;
+  }
+
+  const std::size_t m = _S.cols();
+  std::size_t i;
+  if (_historyLength < m) {
+    i = (_historyStart + _historyLength) % m;
+    ++_historyLength;
+  } else { // overwrite the oldest pair
+    i = _historyStart;
+    _historyStart = (_historyStart + 1) % m;
+  }
+  _S.col(i) = sk.transpose();
+  _Y.col(i) = yk.transpose();
+  _rho[i] = 1./ys;
+  return true;
+}
+
+void OptimizerLBFGS::optimizeImplementation()
+{
+  Timer timeSearchDirection("OptimizerLBFGS: Compute---Search direction", true);
+
+  using namespace Eigen;
+
+  // With bounds, the search direction is computed from the projected gradient and the line search follows the projected path
+  const bool bounded = utils::hasBounds(getDesignVariables());
+  if (bounded && utils::projectOntoBounds(getDesignVariables()))
+    _linesearch.initialize();
+
+  RowVectorType gfk, gfkp1, pk, sk, gpk;
+  gfk = _linesearch.getGradient();
+  gpk = gfk;
+  if (bounded)
+    utils::projectGradient(getDesignVariables(), gpk);
+  _status.gradientNorm = gpk.norm();
+  _status.error = _linesearch.getError();
+  SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << "OptimizerLBFGS: Start optimization at state " <<
+                       problemManager().getFlattenedDesignVariableParameters().transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) <<
+                        " with gradient " << gfk.transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) << " (norm: " <<
+                        _status.gradientNorm << ") and error " << _status.error);
+  this->updateStatus(true);
+
+  if (!_status.success()) {
+
+    std::size_t cnt = 0;
+    for (cnt = 0; _options.maxIterations == -1 || cnt < static_cast<size_t>(_options.maxIterations); ++cnt, ++_status.numIterations) {
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_START{} ));
+      // Every state after a line search is accepted, so we may stop here
+      if (stopRequestedBeforeIteration())
+        break;
+
+      // compute search direction
+      // Note: Numerical issues may still result in an ascent direction. The line search detects that and we
+      // fall back to the steepest descent direction by dropping the history. If that fails too, the exception is re-thrown.
+      timeSearchDirection.start();
+      computeSearchDirection(gpk, pk);
+      if (bounded)
+        utils::projectSearchDirection(getDesignVariables(), pk);
+      timeSearchDirection.stop();
+      for(std::size_t j=0; j<2; ++j) {
+        try {
+          _linesearch.setSearchDirection(pk);
+          break;
+        } catch (const std::exception& e) {
+          if (j == 0) {
+            SM_WARN("L-BFGS search direction is not a descent direction, dropping the history. "
+                "Check your problem setup anyways and potentially re-scale your parameters.");
+            clearHistory();
+            pk = -gpk;
+          } else {
+            throw;
+          }
+        }
+      }
+
+      // store last design variables
+      const Eigen::VectorXd dv = problemManager().getFlattenedDesignVariableParameters();
+
+      // perform line search
+      bool lsSuccess = bounded ? _linesearch.lineSearchProjected(0.5, &sk) : _linesearch.lineSearchWolfe12();
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} ));
+
+      const double alpha_k = _linesearch.getCurrentStepLength();
+      gfkp1 = _linesearch.getGradient();
+      gpk = gfkp1;
+      if (bounded)
+        utils::projectGradient(getDesignVariables(), gpk);
+      _status.gradientNorm = gpk.norm();
+      _status.deltaError = _linesearch.getError() - _status.error;
+      _status.error = _linesearch.getError();
+      _status.maxDeltaX = (problemManager().getFlattenedDesignVariableParameters() - dv).cwiseAbs().maxCoeff();
+
+      this->updateStatus(lsSuccess);
+      if (_status.success() || _status.failure())
+        break;
+
+      SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << _status << std::endl <<
+                           "\tsteplength: " << alpha_k << std::endl << "\thistory: " << _historyLength);
+
+      // Update history
+      if (!bounded)
+        sk = alpha_k * pk;
+      pushCorrectionPair(sk, gfkp1 - gfk);
+      gfk = gfkp1;
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
+    }
+  }
+
+  if (!_status.failure())
+    SM_DEBUG_STREAM_NAMED("optimization", _status);
+  else
+    SM_ERROR_STREAM(_status);
+
+}
+
+void OptimizerLBFGS::updateStatus(const bool lineSearchSuccess)
+{
+
+  // Test failure criteria
+  if (!lineSearchSuccess) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    return;
+  }
+
+  if (!std::isfinite(_status.error)) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    SM_WARN("OptimizerLBFGS: We correctly found +-inf as optimal value, or something went wrong?");
+    return;
+  }
+
+  // Test success criteria
+  _status.convergence = ConvergenceStatus::IN_PROGRESS; // if none of the success criteria succeed, we are not converged yet
+  this->updateConvergenceStatus();
+
+}
+
+} // namespace backend
+} // namespace aslam
@@ -0,0 +1,244 @@
+#include <iomanip>
+#include <aslam/backend/OptimizerNCG.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <Eigen/Dense>
+#include <sm/PropertyTree.hpp>
+#include <sm/logging.hpp>
+
+namespace aslam {
+namespace backend {
+
+OptimizerOptionsNCG::OptimizerOptionsNCG()
+    : OptimizerOptionsBase(), linesearch()
+{
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+}
+
+OptimizerOptionsNCG::OptimizerOptionsNCG(const sm::PropertyTree& config)
+    : OptimizerOptionsBase(config), linesearch(sm::PropertyTree(config, "linesearch"))
+{
+  const std::string methodStr = config.getString("method", "POLAK_RIBIERE_PLUS");
+  if (methodStr == "POLAK_RIBIERE_PLUS")
+    method = POLAK_RIBIERE_PLUS;
+  else if (methodStr == "HAGER_ZHANG")
+    method = HAGER_ZHANG;
+  else
+    SM_THROW(Exception, "Unknown conjugate gradient method " << methodStr << ", valid are POLAK_RIBIERE_PLUS and HAGER_ZHANG");
+  restartInterval = config.getInt("restartInterval", restartInterval);
+  restartThreshold = config.getDouble("restartThreshold", restartThreshold);
+  useDenseJacobianContainer = config.getBool("useDenseJacobianContainer", useDenseJacobianContainer);
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+  SM_ASSERT_TRUE(Exception, std::isfinite(restartThreshold), "");
+}
+
+void OptimizerOptionsNCG::check() const
+{
+  OptimizerOptionsBase::check();
+  linesearch.check();
+  SM_ASSERT_TRUE(Exception, std::isfinite(restartThreshold), "");
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsNCG::Method& method)
+{
+  switch(method)
+  {
+    case OptimizerOptionsNCG::Method::POLAK_RIBIERE_PLUS:
+      out << "POLAK_RIBIERE_PLUS";
+      break;
+    case OptimizerOptionsNCG::Method::HAGER_ZHANG:
+      out << "HAGER_ZHANG";
+      break;
+  }
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsNCG& options)
+{
+  out << static_cast<OptimizerOptionsBase>(options) << std::endl;
+  out << options.linesearch << std::endl;
+  out << "OptimizerOptionsNCG:" << std::endl;
+  out << "\tmethod: " << options.method << std::endl;
+  out << "\trestartInterval: " << options.restartInterval << std::endl;
+  out << "\trestartThreshold: " << options.restartThreshold << std::endl;
+  out << "\tuseDenseJacobianContainer: " << (options.useDenseJacobianContainer ? "TRUE" : "FALSE");
+  return out;
+}
+
+
+OptimizerNCG::OptimizerNCG(const OptimizerOptionsNCG& options)
+    : _options(options),
+      _linesearch(getCostFunction<false,true,false,true,true>(problemManager(), false, _options.useDenseJacobianContainer, false, _options.numThreadsJacobian, _options.numThreadsError), _options.linesearch)
+{
+  _options.check();
+  _linesearch.setEvaluateErrorCallback( [&]() { _status.numErrorEvaluations++; } );
+  _linesearch.setEvaluateGradientCallback( [&]() { _status.numJacobianEvaluations++; });
+  _linesearch.setEvaluateErrorAndGradientCallback( [&]() { _status.numErrorAndGradientEvaluations++; });
+}
+
+OptimizerNCG::OptimizerNCG()
+    : OptimizerNCG::OptimizerNCG(OptimizerOptionsNCG())
+{
+}
+
+OptimizerNCG::OptimizerNCG(const sm::PropertyTree& config)
+    : OptimizerNCG::OptimizerNCG(OptimizerOptionsNCG(config))
+{
+}
+
+OptimizerNCG::~OptimizerNCG()
+{
+}
+
+void OptimizerNCG::resetImplementation() {
+  _numRestarts = 0;
+  _linesearch.initialize();
+}
+
+double OptimizerNCG::computeBeta(const RowVectorType& gfkp1, const RowVectorType& gfk, const RowVectorType& pk) const
+{
+  switch (_options.method)
+  {
+    case OptimizerOptionsNCG::Method::POLAK_RIBIERE_PLUS:
+    {
+      // Truncating at zero restarts with the steepest descent direction whenever beta would become negative
+      const double gg = gfk.squaredNorm();
+      if (gg == 0.0)
+        return 0.0;
+      return std::max(0.0, gfkp1.dot(gfkp1 - gfk)/gg);
+    }
+    case OptimizerOptionsNCG::Method::HAGER_ZHANG:
+    {
+      const RowVectorType yk = gfkp1 - gfk;
+      const double dy = pk.dot(yk);
+      if (!(dy > 0.0)) // the Wolfe conditions guarantee positive curvature along pk
+        return 0.0;
+      const double beta = (yk - (2.0*yk.squaredNorm()/dy)*pk).dot(gfkp1)/dy;
+      // lower bound eta_k of the truncated variant (Hager and Zhang, 2005, eq. 1.6) with eta = 0.01
+      const double eta = -1.0/(pk.norm()*std::min(0.01, gfk.norm()));
+      return std::max(beta, eta);
+    }
+  }
+  return 0.0;
+}
+
+void OptimizerNCG::optimizeImplementation()
+{
+  Timer timeSearchDirection("OptimizerNCG: Compute---Search direction", true);
+
+  using namespace Eigen;
+
+  RowVectorType gfk, gfkp1, pk;
+  gfk = _linesearch.getGradient();
+  _status.gradientNorm = gfk.norm();
+  _status.error = _linesearch.getError();
+  SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << "OptimizerNCG: Start optimization at state " <<
+                       problemManager().getFlattenedDesignVariableParameters().transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) <<
+                        " with gradient " << gfk.transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) << " (norm: " <<
+                        _status.gradientNorm << ") and error " << _status.error);
+  this->updateStatus(true);
+
+  if (!_status.success()) {
+
+    const std::size_t restartInterval = _options.restartInterval > 0 ? _options.restartInterval : problemManager().numOptParameters();
+    std::size_t numIterationsSinceRestart = 0;
+    pk = -gfk;
+
+    std::size_t cnt = 0;
+    for (cnt = 0; _options.maxIterations == -1 || cnt < static_cast<size_t>(_options.maxIterations); ++cnt, ++_status.numIterations) {
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_START{} ));
+      // Every state after a line search is accepted, so we may stop here
+      if (stopRequestedBeforeIteration())
+        break;
+
+      // Note: Inexact line searches may result in an ascent direction for the Polak-Ribiere+ method. The line search
+      // detects that and we restart with the steepest descent direction. If that fails too, the exception is re-thrown.
+      for(std::size_t j=0; j<2; ++j) {
+        try {
+          _linesearch.setSearchDirection(pk);
+          break;
+        } catch (const std::exception& e) {
+          if (j == 0) {
+            SM_DEBUG_STREAM_NAMED("optimization", "OptimizerNCG: Search direction is not a descent direction, restarting.");
+            pk = -gfk;
+            numIterationsSinceRestart = 0;
+            ++_numRestarts;
+          } else {
+            throw;
+          }
+        }
+      }
+
+      // store last design variables
+      const Eigen::VectorXd dv = problemManager().getFlattenedDesignVariableParameters();
+
+      // perform line search
+      bool lsSuccess = _linesearch.lineSearchWolfe12();
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} ));
+
+      const double alpha_k = _linesearch.getCurrentStepLength();
+      gfkp1 = _linesearch.getGradient();
+      _status.gradientNorm = gfkp1.norm();
+      _status.deltaError = _linesearch.getError() - _status.error;
+      _status.error = _linesearch.getError();
+      _status.maxDeltaX = (problemManager().getFlattenedDesignVariableParameters() - dv).cwiseAbs().maxCoeff();
+
+      this->updateStatus(lsSuccess);
+      if (_status.success() || _status.failure())
+        break;
+
+      SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << _status << std::endl <<
+                           "\tsteplength: " << alpha_k << std::endl << "\trestarts: " << _numRestarts);
+
+      // Update the search direction, restart periodically or if successive gradients lost orthogonality (Powell)
+      timeSearchDirection.start();
+      const bool restart = ++numIterationsSinceRestart >= restartInterval ||
+          (_options.restartThreshold > 0.0 && std::abs(gfkp1.dot(gfk)) >= _options.restartThreshold*gfkp1.squaredNorm());
+      if (restart) {
+        pk = -gfkp1;
+        numIterationsSinceRestart = 0;
+        ++_numRestarts;
+      } else {
+        const double beta = computeBeta(gfkp1, gfk, pk);
+        pk *= beta;
+        pk -= gfkp1;
+      }
+      gfk = gfkp1;
+      timeSearchDirection.stop();
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
+    }
+  }
+
+  if (!_status.failure())
+    SM_DEBUG_STREAM_NAMED("optimization", _status);
+  else
+    SM_ERROR_STREAM(_status);
+
+}
+
+void OptimizerNCG::updateStatus(const bool lineSearchSuccess)
+{
+
+  // Test failure criteria
+  if (!lineSearchSuccess) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    return;
+  }
+
+  if (!std::isfinite(_status.error)) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    SM_WARN("OptimizerNCG: We correctly found +-inf as optimal value, or something went wrong?");
+    return;
+  }
+
+  // Test success criteria
+  _status.convergence = ConvergenceStatus::IN_PROGRESS; // if none of the success criteria succeed, we are not converged yet
+  this->updateConvergenceStatus();
+
+}
+
+} // namespace backend
+} // namespace aslam
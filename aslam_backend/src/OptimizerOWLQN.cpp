@@ -0,0 +1,382 @@
+#include <iomanip>
+#include <aslam/backend/OptimizerOWLQN.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/ScalarNonSquaredErrorTerm.hpp>
+#include <aslam/backend/OptimizationProblemBase.hpp>
+#include <Eigen/Dense>
+#include <sm/PropertyTree.hpp>
+#include <sm/logging.hpp>
+
+namespace aslam {
+namespace backend {
+
+OptimizerOptionsOWLQN::OptimizerOptionsOWLQN()
+    : OptimizerOptionsBase(), linesearch()
+{
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+}
+
+OptimizerOptionsOWLQN::OptimizerOptionsOWLQN(const sm::PropertyTree& config)
+    : OptimizerOptionsBase(config), linesearch(sm::PropertyTree(config, "linesearch"))
+{
+  historySize = config.getInt("historySize", historySize);
+  backtrackingFactor = config.getDouble("backtrackingFactor", backtrackingFactor);
+  useDenseJacobianContainer = config.getBool("useDenseJacobianContainer", useDenseJacobianContainer);
+  // base options checked by OptimizerOptionsBase
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+  SM_ASSERT_GT(Exception, backtrackingFactor, 0.0, "");
+  SM_ASSERT_LT(Exception, backtrackingFactor, 1.0, "");
+}
+
+void OptimizerOptionsOWLQN::check() const
+{
+  OptimizerOptionsBase::check();
+  linesearch.check();
+  SM_ASSERT_GT(Exception, historySize, 0, "");
+  SM_ASSERT_GT(Exception, backtrackingFactor, 0.0, "");
+  SM_ASSERT_LT(Exception, backtrackingFactor, 1.0, "");
+  SM_ASSERT_TRUE(Exception, !regularizer || regularizer->isL1Norm(), "OptimizerOWLQN only supports L1 regularizers");
+}
+
+std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptionsOWLQN& options)
+{
+  out << static_cast<OptimizerOptionsBase>(options) << std::endl;
+  out << options.linesearch << std::endl;
+  out << "OptimizerOptionsOWLQN:" << std::endl;
+  out << "\thistorySize: " << options.historySize << std::endl;
+  out << "\tbacktrackingFactor: " << options.backtrackingFactor << std::endl;
+  out << "\tuseDenseJacobianContainer: " << (options.useDenseJacobianContainer ? "TRUE" : "FALSE") << std::endl;
+  out << "\thasRegularizer: " << ((options.regularizer != nullptr) ? "TRUE" : "FALSE");
+  return out;
+}
+
+
+OptimizerOWLQN::OptimizerOWLQN(const OptimizerOptionsOWLQN& options)
+    : _options(options)
+{
+  _options.check();
+}
+
+OptimizerOWLQN::OptimizerOWLQN()
+    : OptimizerOWLQN::OptimizerOWLQN(OptimizerOptionsOWLQN())
+{
+}
+
+OptimizerOWLQN::OptimizerOWLQN(const sm::PropertyTree& config)
+    : OptimizerOWLQN::OptimizerOWLQN(OptimizerOptionsOWLQN(config))
+{
+}
+
+OptimizerOWLQN::~OptimizerOWLQN()
+{
+}
+
+void OptimizerOWLQN::resetImplementation() {
+  const std::size_t n = problemManager().numOptParameters();
+  _S.resize(n, _options.historySize);
+  _Y.resize(n, _options.historySize);
+  _rho.resize(_options.historySize);
+  _alpha.resize(_options.historySize);
+  clearHistory();
+  collectL1Terms();
+}
+
+void OptimizerOWLQN::collectL1Terms()
+{
+  const std::size_t n = problemManager().numOptParameters();
+  _l1Weights.setZero(n);
+  _l1WeightsInProblem.setZero(n);
+  _l1Blocks.clear();
+  _numL1Parameters = 0;
+
+  std::vector<bool> isL1Block(problemManager().numDesignVariables(), false);
+  boost::shared_ptr<OptimizationProblemBase> problem = problemManager().getProblem();
+  for (std::size_t i = 0; i < problem->numNonSquaredErrorTerms(); ++i) {
+    const ScalarNonSquaredErrorTerm* e = problem->nonSquaredErrorTerm(i);
+    if (e->isL1Norm())
+      addL1Term(*e, true, isL1Block);
+  }
+  if (_options.regularizer) {
+    SM_ASSERT_TRUE(Exception, _options.regularizer->isL1Norm(), "OptimizerOWLQN only supports L1 regularizers");
+    addL1Term(*_options.regularizer, false, isL1Block);
+  }
+  SM_DEBUG_STREAM_NAMED("optimization", "OptimizerOWLQN: " << _numL1Parameters << " of " << n << " parameters have an L1 weight");
+}
+
+void OptimizerOWLQN::addL1Term(const ScalarNonSquaredErrorTerm& e, const bool isInProblem, std::vector<bool>& isL1Block)
+{
+  const double w = e.getWeight();
+  SM_ASSERT_GE(Exception, w, 0.0, "L1 weights must not be negative");
+  Eigen::MatrixXd p;
+  for (DesignVariable* dv : e.designVariables()) {
+    if (!dv->isActive())
+      continue;
+    SM_ASSERT_LT(Exception, static_cast<std::size_t>(dv->blockIndex()), isL1Block.size(), "The design variables of L1 terms must be part of the problem");
+    SM_ASSERT_TRUE(Exception, problemManager().designVariable(dv->blockIndex()) == dv, "The design variables of L1 terms must be part of the problem");
+    const int dim = dv->minimalDimensions();
+    dv->getParameters(p);
+    SM_ASSERT_EQ(Exception, p.size(), dim, "The design variables of L1 terms must be vector spaces");
+    SM_ASSERT_EQ(Exception, dv->scaling(), 1.0, "The design variables of L1 terms must not be scaled");
+
+    const std::size_t c = dv->columnBase();
+    _l1Weights.segment(c, dim).array() += w;
+    if (isInProblem)
+      _l1WeightsInProblem.segment(c, dim).array() += w;
+    if (!isL1Block[dv->blockIndex()]) {
+      isL1Block[dv->blockIndex()] = true;
+      _l1Blocks.push_back(L1Block{dv, c, dim});
+      _numL1Parameters += dim;
+    }
+  }
+}
+
+void OptimizerOWLQN::getL1Parameters(ColumnVectorType& x) const
+{
+  x.setZero(problemManager().numOptParameters());
+  Eigen::MatrixXd p;
+  for (const L1Block& b : _l1Blocks) {
+    b.dv->getParameters(p);
+    x.segment(b.columnBase, b.dimension) = Eigen::Map<const Eigen::VectorXd>(p.data(), b.dimension);
+  }
+}
+
+std::size_t OptimizerOWLQN::getNumZeroL1Parameters() const
+{
+  ColumnVectorType x;
+  getL1Parameters(x);
+  std::size_t numZero = 0;
+  for (const L1Block& b : _l1Blocks)
+    numZero += (x.segment(b.columnBase, b.dimension).array() == 0.0).count();
+  return numZero;
+}
+
+double OptimizerOWLQN::evaluateErrorAndSmoothGradient(ColumnVectorType& x, RowVectorType& gradient)
+{
+  const double error = problemManager().evaluateErrorAndGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer);
+  _status.numErrorEvaluations++;
+  _status.numJacobianEvaluations++;
+  _status.numErrorAndGradientEvaluations++;
+  getL1Parameters(x);
+  // The L1 terms of the problem contribute w * sign(x), which is exactly their gradient away from zero
+  gradient -= _l1WeightsInProblem.cwiseProduct(x.cwiseSign()).transpose();
+  return error + (_l1Weights - _l1WeightsInProblem).dot(x.cwiseAbs());
+}
+
+double OptimizerOWLQN::evaluateError(ColumnVectorType& x)
+{
+  const double error = problemManager().evaluateError(_options.numThreadsError);
+  _status.numErrorEvaluations++;
+  getL1Parameters(x);
+  return error + (_l1Weights - _l1WeightsInProblem).dot(x.cwiseAbs());
+}
+
+void OptimizerOWLQN::computeSmoothGradient(const ColumnVectorType& x, RowVectorType& gradient)
+{
+  problemManager().computeGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer);
+  _status.numJacobianEvaluations++;
+  gradient -= _l1WeightsInProblem.cwiseProduct(x.cwiseSign()).transpose();
+}
+
+void OptimizerOWLQN::computePseudoGradient(const ColumnVectorType& x, const RowVectorType& gradient, RowVectorType& pseudoGradient) const
+{
+  pseudoGradient = gradient;
+  for (const L1Block& b : _l1Blocks) {
+    for (std::size_t c = b.columnBase; c < b.columnBase + b.dimension; ++c) {
+      const double w = _l1Weights[c];
+      if (x[c] > 0.0) {
+        pseudoGradient[c] += w;
+      } else if (x[c] < 0.0) {
+        pseudoGradient[c] -= w;
+      } else if (gradient[c] + w < 0.0) { // at zero, the right derivative is negative
+        pseudoGradient[c] += w;
+      } else if (gradient[c] - w > 0.0) { // at zero, the left derivative is positive
+        pseudoGradient[c] -= w;
+      } else {
+        pseudoGradient[c] = 0.0;
+      }
+    }
+  }
+}
+
+void OptimizerOWLQN::computeSearchDirection(const RowVectorType& gradient, RowVectorType& searchDirection)
+{
+  const std::size_t m = _S.cols();
+  RowVectorType& q = searchDirection; // work in place
+  q = gradient;
+
+  // first loop: newest to oldest correction pair
+  for (std::size_t k = _historyLength; k-- > 0; ) {
+    const std::size_t i = (_historyStart + k) % m;
+    _alpha[i] = _rho[i] * _S.col(i).dot(q);
+    q.noalias() -= _alpha[i] * _Y.col(i).transpose();
+  }
+
+  // initial inverse Hessian approximation H0 = gamma * I, scaled with the newest correction pair
+  if (_historyLength > 0) {
+    const std::size_t newest = (_historyStart + _historyLength - 1) % m;
+    q *= 1.0 / (_rho[newest] * _Y.col(newest).squaredNorm());
+  }
+
+  // second loop: oldest to newest correction pair
+  for (std::size_t k = 0; k < _historyLength; ++k) {
+    const std::size_t i = (_historyStart + k) % m;
+    const double beta = _rho[i] * _Y.col(i).dot(q);
+    q.noalias() += (_alpha[i] - beta) * _S.col(i).transpose();
+  }
+
+  q = -q;
+}
+
+bool OptimizerOWLQN::pushCorrectionPair(const RowVectorType& sk, const RowVectorType& yk)
+{
+  // Skip the update if the curvature condition is violated, the backtracking search does not enforce it
+  const double ys = yk.dot(sk);
+  if (!(ys > std::numeric_limits<double>::epsilon() * yk.squaredNorm())) {
+    SM_DEBUG_STREAM_NAMED("optimization", "OptimizerOWLQN: Skipping correction pair with y^T s = " << ys);
+    return false;
+  }
+
+  const std::size_t m = _S.cols();
+  std::size_t i;
+  if (_historyLength < m) {
+    i = (_historyStart + _historyLength) % m;
+    ++_historyLength;
+  } else { // overwrite the oldest pair
+    i = _historyStart;
+    _historyStart = (_historyStart + 1) % m;
+  }
+  _S.col(i) = sk.transpose();
+  _Y.col(i) = yk.transpose();
+  _rho[i] = 1./ys;
+  return true;
+}
+
+void OptimizerOWLQN::optimizeImplementation()
+{
+  Timer timeSearchDirection("OptimizerOWLQN: Compute---Search direction", true);
+  Timer timeLineSearch("OptimizerOWLQN: Compute---Line search", true);
+
+  using namespace Eigen;
+
+  ColumnVectorType x, xNew, dx;
+  RowVectorType g, gNew, pg, pgNew, pk;
+  double error = evaluateErrorAndSmoothGradient(x, g);
+  computePseudoGradient(x, g, pg);
+  _status.gradientNorm = pg.norm();
+  _status.error = error;
+  SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << "OptimizerOWLQN: Start optimization at state " <<
+                       problemManager().getFlattenedDesignVariableParameters().transpose().format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) <<
+                        " with pseudo-gradient " << pg.format(IOFormat(15, DontAlignCols, ", ", ", ", "", "", "[", "]")) << " (norm: " <<
+                        _status.gradientNorm << ") and error " << _status.error);
+  this->updateStatus(true);
+
+  if (!_status.success()) {
+
+    std::size_t cnt = 0;
+    for (cnt = 0; _options.maxIterations == -1 || cnt < static_cast<size_t>(_options.maxIterations); ++cnt, ++_status.numIterations) {
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_START{} ));
+      // Every state after a line search is accepted, so we may stop here
+      if (stopRequestedBeforeIteration())
+        break;
+
+      // compute search direction from the pseudo-gradient and keep only the components that agree in sign with
+      // the steepest descent direction. If nothing is left, restart with the steepest descent direction.
+      timeSearchDirection.start();
+      computeSearchDirection(pg, pk);
+      pk = (pk.array() * pg.array() < 0.0).select(pk, 0.0);
+      if (!(pk.dot(pg) < 0.0)) {
+        SM_DEBUG_STREAM_NAMED("optimization", "OptimizerOWLQN: Search direction is not a descent direction, dropping the history.");
+        clearHistory();
+        pk = -pg;
+      }
+      timeSearchDirection.stop();
+
+      // Backtracking along the projected path. Parameters with an L1 weight must not leave the orthant of the
+      // current iterate, or the one of the steepest descent direction if they are zero. Those crossing zero are set to zero.
+      timeLineSearch.start();
+      double stepLength = _options.linesearch.initialStepLength;
+      if (_historyLength == 0) // the steepest descent direction carries no scale information
+        stepLength = std::min(stepLength, 1.0/pg.norm());
+      bool lsSuccess = false;
+      double errorNew = error;
+      for (; stepLength >= _options.linesearch.minStepLength; stepLength *= _options.backtrackingFactor) {
+        dx = stepLength * pk.transpose();
+        for (const L1Block& b : _l1Blocks) {
+          for (std::size_t c = b.columnBase; c < b.columnBase + b.dimension; ++c) {
+            const double orthant = x[c] != 0.0 ? x[c] : -pg[c];
+            if ((x[c] + dx[c]) * orthant <= 0.0)
+              dx[c] = -x[c];
+          }
+        }
+        problemManager().applyStateUpdate(dx);
+        errorNew = evaluateError(xNew);
+        if (errorNew <= error + _options.linesearch.c1WolfeCondition * pg.dot(dx)) {
+          lsSuccess = true;
+          break;
+        }
+        problemManager().revertLastStateUpdate();
+      }
+      timeLineSearch.stop();
+
+      if (lsSuccess) {
+        handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} ));
+        computeSmoothGradient(xNew, gNew);
+        computePseudoGradient(xNew, gNew, pgNew);
+        _status.gradientNorm = pgNew.norm();
+        _status.deltaError = errorNew - error;
+        _status.error = errorNew;
+        _status.maxDeltaX = dx.cwiseAbs().maxCoeff();
+      }
+
+      this->updateStatus(lsSuccess);
+      if (_status.success() || _status.failure())
+        break;
+
+      SM_FINE_STREAM_NAMED("optimization", std::setprecision(20) << _status << std::endl <<
+                           "\tsteplength: " << stepLength << std::endl << "\thistory: " << _historyLength);
+
+      // Update history, the pairs only model the smooth part
+      pushCorrectionPair(dx.transpose(), gNew - g);
+      x.swap(xNew);
+      g.swap(gNew);
+      pg.swap(pgNew);
+      error = errorNew;
+
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
+    }
+  }
+
+  if (!_status.failure())
+    SM_DEBUG_STREAM_NAMED("optimization", _status);
+  else
+    SM_ERROR_STREAM(_status);
+
+}
+
+void OptimizerOWLQN::updateStatus(const bool lineSearchSuccess)
+{
+
+  // Test failure criteria
+  if (!lineSearchSuccess) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    return;
+  }
+
+  if (!std::isfinite(_status.error)) {
+    _status.convergence = ConvergenceStatus::FAILURE;
+    SM_WARN("OptimizerOWLQN: We correctly found +-inf as optimal value, or something went wrong?");
+    return;
+  }
+
+  // Test success criteria
+  _status.convergence = ConvergenceStatus::IN_PROGRESS; // if none of the success criteria succeed, we are not converged yet
+  this->updateConvergenceStatus();
+
+}
+
+} // namespace backend
+} // namespace aslam
@@ -4,6 +4,7 @@
 #include <Eigen/Dense>
 #include <sm/eigen/assert_macros.hpp>
 #include <aslam/backend/sparse_matrix_functions.hpp>
+#include <aslam/backend/util/utils.hpp>
 #include <sm/PropertyTree.hpp>
 #include <sm/logging.hpp>
 
@@ -16,7 +17,7 @@ OptimizerOptionsRprop::OptimizerOptionsRprop()
 }
 
 OptimizerOptionsRprop::OptimizerOptionsRprop(const sm::PropertyTree& config)
-    : OptimizerOptionsBase(config)
+    : OptimizerOptionsBase(config), miniBatch(sm::PropertyTree(config, "miniBatch"))
 {
   etaMinus = config.getDouble("etaMinus", etaMinus);
   etaPlus = config.getDouble("etaPlus", etaPlus);
@@ -33,6 +34,7 @@ void OptimizerOptionsRprop::check() const
   SM_ASSERT_GT( Exception, initialDelta, 0.0, "");
   SM_ASSERT_GT( Exception, minDelta, 0.0, "");
   SM_ASSERT_GT( Exception, maxDelta, minDelta, "");
+  miniBatch.check();
   OptimizerOptionsBase::check();
 }
 
@@ -67,7 +69,8 @@ std::ostream& operator<<(std::ostream& out, const aslam::backend::OptimizerOptio
   out << "\tmaxDelta: " << options.maxDelta << std::endl;
   out << "\tmethod: " << options.method << std::endl;
   out << "\tuseDenseJacobianContainer: " << (options.useDenseJacobianContainer ? "TRUE" : "FALSE") << std::endl;
-  out << "\thasRegularizer: " << ((options.regularizer != nullptr) ? "TRUE" : "FALSE");
+  out << "\thasRegularizer: " << ((options.regularizer != nullptr) ? "TRUE" : "FALSE") << std::endl;
+  out << options.miniBatch;
   return out;
 }
 
@@ -98,6 +101,8 @@ void OptimizerRprop::resetImplementation() {
   _prev_gradient = ColumnVectorType::Constant(problemManager().numOptParameters(), 0.0);
   _prev_error = std::numeric_limits<double>::max();
   _delta = ColumnVectorType::Constant(problemManager().numOptParameters(), _options.initialDelta);
+  _next_gradient.resize(0);
+  problemManager().setMiniBatchOptions(_options.miniBatch);
 }
 
 void OptimizerRprop::optimizeImplementation()
@@ -111,15 +116,47 @@ void OptimizerRprop::optimizeImplementation()
 
   using namespace Eigen;
 
+  // The state may have been modified since the last call
+  _next_gradient.resize(0);
+
+  // With bounds, the gradient entries of active bounds are dropped and the steps are projected onto the bounds
+  const bool bounded = utils::hasBounds(getDesignVariables());
+  if (bounded)
+    utils::projectOntoBounds(getDesignVariables());
+
   for ( ; _options.maxIterations == -1 || _status.numIterations < static_cast<size_t>(_options.maxIterations); ++_status.numIterations) {
 
-    _callbackManager.issueCallback( callback::event::ITERATION_START{} );
+    handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_START{} ));
+    if (stopRequestedBeforeIteration())
+      break;
 
     _status.convergence = ConvergenceStatus::IN_PROGRESS;
 
     RowVectorType gradient;
+    double error = std::numeric_limits<double>::max();
+    const bool fullBatch = problemManager().isFullBatch();
     timeGrad.start();
-    problemManager().computeGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+    if (!fullBatch) { // stochastic gradient, for IRPROP_PLUS together with the error estimate of the same batch
+      error = problemManager().computeMiniBatchGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */,
+                                                        _options.useDenseJacobianContainer, _options.method == OptimizerOptionsRprop::IRPROP_PLUS);
+      _status.numJacobianEvaluations++;
+      if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS) {
+        _status.numErrorEvaluations++;
+        _status.numErrorAndGradientEvaluations++;
+      }
+    } else if (_next_gradient.size() > 0) { // already evaluated together with the error at the end of the last iteration
+      gradient.swap(_next_gradient);
+      _next_gradient.resize(0);
+      error = _next_error;
+    } else if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS) { // we need the error as well, evaluate both in one pass
+      error = problemManager().evaluateErrorAndGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+      _status.numErrorEvaluations++;
+      _status.numJacobianEvaluations++;
+      _status.numErrorAndGradientEvaluations++;
+    } else {
+      problemManager().computeGradient(gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+      _status.numJacobianEvaluations++;
+    }
 
     // optionally add regularizer
     if (_options.regularizer) {
@@ -128,7 +165,8 @@ void OptimizerRprop::optimizeImplementation()
       SM_FINER_STREAM_NAMED("optimization", "RPROP: Regularization term gradient: " << jc.asDenseMatrix());
       gradient += jc.asDenseMatrix();
     }
-    _status.numJacobianEvaluations++;
+    if (bounded)
+      utils::projectGradient(getDesignVariables(), gradient);
     timeGrad.stop();
 
     SM_ASSERT_TRUE_DBG(Exception, gradient.allFinite (), "Gradient " << gradient.format(IOFormat(2, DontAlignCols, ", ", ", ", "", "", "[", "]")) << " is not finite");
@@ -136,6 +174,15 @@ void OptimizerRprop::optimizeImplementation()
     timeStep.start();
     _status.gradientNorm = gradient.norm();
 
+    // The norm of a gradient estimate is no convergence criterion. Close to convergence, continue with the full gradient.
+    if (!fullBatch && _status.gradientNorm < _options.convergenceGradientNorm) {
+      SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Mini-batch gradient norm " << _status.gradientNorm <<
+                            " is smaller than convergenceGradientNorm option -> switching to full gradient");
+      problemManager().switchToFullBatch();
+      handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
+      continue;
+    }
+
     if (_status.gradientNorm < _options.convergenceGradientNorm) {
       _status.convergence = ConvergenceStatus::GRADIENT_NORM;
       SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Current gradient norm " << _status.gradientNorm <<
@@ -146,8 +193,7 @@ void OptimizerRprop::optimizeImplementation()
     // Compute error for iPRop+
     bool errorIncreased = false;
     if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS) {
-      _status.error = problemManager().evaluateError(_options.numThreadsError);
-      _status.numErrorEvaluations++;
+      _status.error = error;
       errorIncreased = (_status.error - _prev_error) > 0.0;
       _prev_error = _status.error;
     }
@@ -233,11 +279,17 @@ void OptimizerRprop::optimizeImplementation()
 
     timeStep.stop();
 
-    _callbackManager.issueCallback( callback::event::DESIGN_VARIABLE_UPDATE_COMPUTED{} );
+    // A callback may still veto the update
+    if (handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLE_UPDATE_COMPUTED{} )) != callback::ProceedInstruction::CONTINUE) {
+      stopRequested();
+      break;
+    }
     timeUpdate.start();
+    if (bounded)
+      utils::projectStateUpdate(getDesignVariables(), _dx);
     problemManager().applyStateUpdate(_dx);
     timeUpdate.stop();
-    _callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} );
+    handleProceedInstruction(_callbackManager.issueCallback( callback::event::DESIGN_VARIABLES_UPDATED{} ));
 
     _status.maxDeltaX = _dx.cwiseAbs().maxCoeff();
     if (_status.maxDeltaX < _options.convergenceDeltaX) {
@@ -247,8 +299,13 @@ void OptimizerRprop::optimizeImplementation()
       break;
     }
 
-    if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS) {
-      _status.deltaError = problemManager().evaluateError(_options.numThreadsError) - _status.error;
+    if (_options.method == OptimizerOptionsRprop::IRPROP_PLUS && problemManager().isFullBatch()) {
+      // The next iteration needs the gradient at the new state anyways, so get it in the same pass
+      _next_error = problemManager().evaluateErrorAndGradient(_next_gradient, _options.numThreadsJacobian, false /*useMEstimator*/, false /*use scaling */, _options.useDenseJacobianContainer /*useDenseJacobianContainer*/);
+      _status.numErrorEvaluations++;
+      _status.numJacobianEvaluations++;
+      _status.numErrorAndGradientEvaluations++;
+      _status.deltaError = _next_error - _status.error;
       if (fabs(_status.deltaError) < _options.convergenceDeltaError) {
         _status.convergence = ConvergenceStatus::DOBJECTIVE;
         SM_DEBUG_STREAM_NAMED("optimization", "RPROP: Change in error " << _status.deltaError <<
@@ -262,7 +319,7 @@ void OptimizerRprop::optimizeImplementation()
                          "\tdx: " << _dx.transpose() << std::endl <<
                          "\tdelta: " << _delta.transpose());
 
-    _callbackManager.issueCallback( callback::event::ITERATION_END{} );
+    handleProceedInstruction(_callbackManager.issueCallback( callback::event::ITERATION_END{} ));
 
   }
 
@@ -1,5 +1,7 @@
 #include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/DesignVariable.hpp>
 #include <sm/PropertyTree.hpp>
+#include <algorithm>
 
 namespace aslam {
   namespace backend {
@@ -22,8 +24,10 @@ namespace aslam {
         _cholmod.free(_factor);
         _factor = NULL;
       }
+      _factorIsCurrent = false;
       // std::cout << "init structure\n";
       _useDiagonalConditioner = useDiagonalConditioner;
+      initOrderingConstraints(dvs);
       _jacobianBuilder.initMatrixStructure(dvs, errors);
       CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
       if (_useDiagonalConditioner) {
@@ -43,15 +47,54 @@ namespace aslam {
     void SparseCholeskyLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
     {
       //std::cout << "build system\n";
+      if (reweightSystem(useMEstimator))
+        return;
       _jacobianBuilder.buildSystem(nThreads, useMEstimator);
       CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
       J_transpose.rightMultiply(_e, _rhs);
+      _factorIsCurrent = false;
+      updateColumnScale();
+      updateRowWeights(useMEstimator);
       // std::cout << "build system complete\n";
     }
 
+    void SparseCholeskyLinearSystemSolver::setConditioner(const Eigen::VectorXd& diag)
+    {
+      LinearSystemSolver::setConditioner(diag);
+      _factorIsCurrent = false;
+    }
+
+    void SparseCholeskyLinearSystemSolver::setConstantConditioner(double diag)
+    {
+      LinearSystemSolver::setConstantConditioner(diag);
+      _factorIsCurrent = false;
+    }
+
+    void SparseCholeskyLinearSystemSolver::initOrderingConstraints(const std::vector<DesignVariable*>& dvs)
+    {
+      // Number the ordering groups of the design variables 0..k-1 as CAMD expects.
+      std::vector<int> groups;
+      for (const DesignVariable* dv : dvs)
+        groups.push_back(dv->orderingGroup());
+      std::sort(groups.begin(), groups.end());
+      groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+      _orderingConstraints.clear();
+      if (groups.size() <= 1)
+        return;
+      int cols = 0;
+      for (const DesignVariable* dv : dvs)
+        cols += dv->minimalDimensions();
+      _orderingConstraints.resize(cols);
+      for (const DesignVariable* dv : dvs) {
+        const int group = std::lower_bound(groups.begin(), groups.end(), dv->orderingGroup()) - groups.begin();
+        std::fill_n(_orderingConstraints.begin() + dv->columnBase(), dv->minimalDimensions(), group);
+      }
+    }
+
     bool SparseCholeskyLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
     {
       CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
+      pushColumnScaling();
       if (_useDiagonalConditioner) {
         J_transpose.pushDiagonalBlock(_diagonalConditioner);
       }
@@ -61,7 +104,7 @@ namespace aslam {
       if (!_factor) {
         // std::cout << "\tAnalyze system\n";
         // Now do the symbolic analysis with cholmod.
-        _factor = _cholmod.analyze(&_cholmodLhs);
+        _factor = _orderingConstraints.empty() ? _cholmod.analyze(&_cholmodLhs) : _cholmod.analyzeConstrained(&_cholmodLhs, _orderingConstraints);
         //  std::cout << "\tanalyze system complete\n";
       }
       // Now we can solve the system.
@@ -70,8 +113,10 @@ namespace aslam {
       if (_useDiagonalConditioner) {
         J_transpose.popDiagonalBlock();
       }
+      _factorIsCurrent = sol != NULL;
       if (!sol) {
         std::cout << "Solution failed\n";
+        popColumnScaling(outDx);
         return false;
       }
       try {
@@ -85,11 +130,15 @@ namespace aslam {
         // avoid leaking memory but still do error checking.
         // look at me! I done good.
         _cholmod.free(sol);
+        popColumnScaling(outDx);
         throw;
       }
       _cholmod.free(sol);
+      popColumnScaling(outDx);
+      projectGauge(outDx);
       //std::cout << "solve system complete\n";
-      return true;
+      // The factorization of the unreduced system is reused for the error projection
+      return applyErrorProjection(_e, outDx);
     }
 
     const SparseCholeskyLinearSolverOptions&
@@ -111,9 +160,77 @@ namespace aslam {
         CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
         Eigen::VectorXd Jrhs;
         J_transpose.leftMultiply(_rhs, Jrhs);
+        projectErrors(Jrhs);
         return Jrhs.squaredNorm();
     }
       
+    bool SparseCholeskyLinearSystemSolver::multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) {
+        _jacobianBuilder.J_transpose().leftMultiply(v, outJv);
+        projectErrors(outJv);
+        return true;
+    }
+
+    bool SparseCholeskyLinearSystemSolver::solveSystemForError(const Eigen::VectorXd& e, Eigen::VectorXd& outDx) {
+        Eigen::VectorXd rhs;
+        _jacobianBuilder.J_transpose().rightMultiply(e, rhs);
+        if (!_factorIsCurrent) {
+          // Factorize through the regular path with the swapped in right-hand side and errors
+          Eigen::VectorXd swapped = e;
+          _rhs.swap(rhs);
+          _e.swap(swapped);
+          bool success;
+          try {
+            success = solveSystem(outDx);
+          } catch (...) {
+            _rhs.swap(rhs);
+            _e.swap(swapped);
+            throw;
+          }
+          _rhs.swap(rhs);
+          _e.swap(swapped);
+          return success;
+        }
+        // The factorization is the one of the column-scaled system
+        if (_columnScale.size() != 0)
+          rhs = rhs.cwiseProduct(_columnScale);
+        cholmod_dense cholmodRhs;
+        _cholmod.view(rhs, &cholmodRhs);
+        cholmod_dense* sol = _cholmod.solve(_factor, &cholmodRhs);
+        if (!sol)
+          return false;
+        outDx.resize(rhs.size());
+        memcpy((void*)&outDx[0], sol->x, sizeof(double)*sol->nrow);
+        _cholmod.free(sol);
+        if (_columnScale.size() != 0)
+          outDx = outDx.cwiseProduct(_columnScale);
+        projectGauge(outDx);
+        return applyErrorProjection(e, outDx);
+    }
+
+    std::vector<int> SparseCholeskyLinearSystemSolver::getFactorPermutation() const {
+        if (!_factor)
+          return std::vector<int>();
+        const int* perm = static_cast<const int*>(_factor->Perm);
+        return std::vector<int>(perm, perm + _factor->n);
+    }
+
+    void SparseCholeskyLinearSystemSolver::getColumnSquaredNorms(Eigen::VectorXd& outNorms) const {
+        _jacobianBuilder.J_transpose().rowSquaredNorms(outNorms);
+    }
+
+    void SparseCholeskyLinearSystemSolver::scaleColumns(const Eigen::VectorXd& scale) {
+        _jacobianBuilder.J_transpose().scaleRows(scale);
+    }
+
+    bool SparseCholeskyLinearSystemSolver::scaleRows(const Eigen::VectorXd& scale) {
+        // The rows of J are the columns of J^T
+        CompressedColumnMatrix<int>& J_transpose = _jacobianBuilder.J_transpose();
+        J_transpose.scaleColumns(scale);
+        J_transpose.rightMultiply(_e, _rhs);
+        _factorIsCurrent = false;
+        return true;
+    }
+
     void SparseCholeskyLinearSystemSolver::handleNewAcceptConstantErrorTerms() {
       _jacobianBuilder.J_transpose().setAcceptConstantErrorTerms(isAcceptConstantErrorTerms());
     }
@@ -54,16 +54,21 @@ namespace aslam {
     void SparseQrLinearSystemSolver::buildSystem(size_t nThreads, bool useMEstimator)
     {
       //std::cout << "build system\n";
+      if (reweightSystem(useMEstimator))
+        return;
       _jacobianBuilder.buildSystem(nThreads, useMEstimator);
       CompressedColumnMatrix<SuiteSparse_long>& J_transpose = _jacobianBuilder.J_transpose();
       J_transpose.rightMultiply(_e, _rhs);
       //std::cout << "build system complete\n";
       _R.clear();
+      updateColumnScale();
+      updateRowWeights(useMEstimator);
     }
 
     bool SparseQrLinearSystemSolver::solveSystem(Eigen::VectorXd& outDx)
     {
       CompressedColumnMatrix<SuiteSparse_long>& J_transpose = _jacobianBuilder.J_transpose();
+      pushColumnScaling();
       if (_useDiagonalConditioner) {
         J_transpose.pushDiagonalBlock(_diagonalConditioner);
       }
@@ -85,6 +90,7 @@ namespace aslam {
       }
       if (!sol) {
         std::cout << "Solution failed\n";
+        popColumnScaling(outDx);
         return false;
       }
       try {
@@ -98,9 +104,12 @@ namespace aslam {
         // avoid leaking memory but still do error checking.
         // look at me! I done good.
         _cholmod.free(sol);
+        popColumnScaling(outDx);
         throw;
       }
       _cholmod.free(sol);
+      popColumnScaling(outDx);
+      projectGauge(outDx);
       if (_options.verbose)
         std::cout << "numerical rank: " << _factor->rank << std::endl;
       // std::cout << "solve system complete\n";
@@ -189,7 +198,29 @@ namespace aslam {
         J_transpose.leftMultiply(_rhs, Jrhs);
         return Jrhs.squaredNorm();
     }
+
+    bool SparseQrLinearSystemSolver::multiplyJacobian(const Eigen::VectorXd& v, Eigen::VectorXd& outJv) {
+        _jacobianBuilder.J_transpose().leftMultiply(v, outJv);
+        return true;
+    }
       
+    void SparseQrLinearSystemSolver::getColumnSquaredNorms(Eigen::VectorXd& outNorms) const {
+        _jacobianBuilder.J_transpose().rowSquaredNorms(outNorms);
+    }
+
+    void SparseQrLinearSystemSolver::scaleColumns(const Eigen::VectorXd& scale) {
+        _jacobianBuilder.J_transpose().scaleRows(scale);
+    }
+
+    bool SparseQrLinearSystemSolver::scaleRows(const Eigen::VectorXd& scale) {
+        // The rows of J are the columns of J^T
+        CompressedColumnMatrix<SuiteSparse_long>& J_transpose = _jacobianBuilder.J_transpose();
+        J_transpose.scaleColumns(scale);
+        J_transpose.rightMultiply(_e, _rhs);
+        _R.clear();
+        return true;
+    }
+
     void SparseQrLinearSystemSolver::handleNewAcceptConstantErrorTerms() {
       _jacobianBuilder.J_transpose().setAcceptConstantErrorTerms(isAcceptConstantErrorTerms());
     }
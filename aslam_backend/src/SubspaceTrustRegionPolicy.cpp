@@ -0,0 +1,226 @@
+#include <aslam/backend/SubspaceTrustRegionPolicy.hpp>
+#include <cmath>
+#include <limits>
+#include <Eigen/Eigenvalues>
+
+namespace aslam {
+    namespace backend {
+
+        SubspaceTrustRegionPolicy::SubspaceTrustRegionPolicy() : _L0(0), _delta(0) {}
+        SubspaceTrustRegionPolicy::~SubspaceTrustRegionPolicy() {}
+
+
+        /// \brief called by the optimizer when an optimization is starting
+        void SubspaceTrustRegionPolicy::optimizationStartingImplementation(double /* J */)
+        {
+            _L0 = 0;
+            _stepType.clear();
+            if (isWarmStart() && _delta > 0) {
+                // keep the trust region of the last optimization, the decay widens it
+                _delta /= getWarmStartDecay();
+            } else {
+                _delta = 0;
+            }
+        }
+
+        // Returns true if the solution was successful
+        bool SubspaceTrustRegionPolicy::solveSystemImplementation(double /* J */, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
+        {
+            SM_ASSERT_TRUE(Exception, _solver.get() != NULL, "The solver is null");
+
+            ///////////////
+            ///Update Delta, same rules as the dog leg
+            if( ! isFirstIteration() && _L0 > 0 )
+            {
+                const double rho = get_dJ() / _L0;
+                if( rho > 0.75 ) // step succeeded
+                {
+                    _delta = std::max(_delta, 3 * _dx.norm());
+                }
+                else if (rho > 0 && rho < 0.25) // step almost failed
+                {
+                    _delta /= 2.0;
+                }
+                else if (rho <= 0)  // step failed
+                {
+                    // an interior step may be much shorter than the radius
+                    _delta = std::min(_delta, _dx.norm()) / 2.0;
+                }
+            }
+
+            // successful step: rebuild the system and the subspace.
+            // After a failed step only the radius changed, the subproblem is re-solved on the old subspace.
+            if(!previousIterationFailed || _basis.rows() == 0) {
+                if(!buildSubspace(nThreads))
+                    return false;
+            }
+
+            if(_basis.cols() == 0) {
+                // zero gradient, we are at a stationary point
+                _dx = Eigen::VectorXd::Zero(_basis.rows());
+                _L0 = 0;
+                _stepType = "ZERO";
+                outDx = _dx;
+                return true;
+            }
+
+            bool onBoundary = false;
+            Eigen::VectorXd y = solveSubproblem(_delta, onBoundary);
+            if(_delta == 0) {
+                // The first step is the unconstrained minimizer, which has the length of the Gauss-Newton step
+                _delta = y.norm();
+            }
+
+            _dx = _basis * y;
+            // L(0) - L(dx) of the quadratic model, in the units of J
+            _L0 = 2.0 * _b.dot(y) - y.dot(_B * y);
+            _stepType = onBoundary ? "TR" : "GN";
+
+            outDx = _dx;
+            return true;
+        }
+
+        bool SubspaceTrustRegionPolicy::buildSubspace(int nThreads)
+        {
+            _solver->buildSystem(nThreads, true);
+            updateForcingTerm();
+            const Eigen::VectorXd& g = _solver->rhs();
+            const double gnorm = g.norm();
+            if(gnorm == 0.0) {
+                _basis.resize(g.size(), 0);
+                _B.resize(0, 0);
+                _b.resize(0);
+                return true;
+            }
+
+            Eigen::VectorXd dxGn;
+            if(!_solver->solveSystem(dxGn))
+                return false;
+
+            // Gram-Schmidt on (g, dxGn), twice for the second vector to stay orthogonal
+            const Eigen::VectorXd v1 = g / gnorm;
+            const double r12 = v1.dot(dxGn);
+            Eigen::VectorXd r = dxGn - r12 * v1;
+            r -= v1.dot(r) * v1;
+            const double r22 = r.norm();
+            const bool twoDimensional = r22 > 1e-8 * dxGn.norm() && std::isfinite(r22);
+
+            _basis.resize(g.size(), twoDimensional ? 2 : 1);
+            _basis.col(0) = v1;
+            if(twoDimensional)
+                _basis.col(1) = r / r22;
+
+            Eigen::VectorXd Jv;
+            if(_solver->multiplyJacobian(_basis.col(0), Jv)) {
+                Eigen::MatrixXd JV(Jv.size(), _basis.cols());
+                JV.col(0) = Jv;
+                for(int c = 1; c < _basis.cols(); ++c) {
+                    _solver->multiplyJacobian(_basis.col(c), Jv);
+                    JV.col(c) = Jv;
+                }
+                _B = JV.transpose() * JV;
+            } else {
+                // In the basis W = (g, dxGn) = V R, J^T J dxGn = g gives W^T J^T J W without touching J again
+                const double gHg = _solver->rhsJtJrhs();
+                if(twoDimensional) {
+                    Eigen::Matrix2d HW;
+                    HW << gHg, gnorm * gnorm,
+                          gnorm * gnorm, dxGn.dot(g);
+                    Eigen::Matrix2d R;
+                    R << gnorm, r12,
+                         0.0, r22;
+                    const Eigen::Matrix2d Rinv = R.inverse();
+                    _B = Rinv.transpose() * HW * Rinv;
+                } else {
+                    _B = Eigen::MatrixXd::Constant(1, 1, gHg / (gnorm * gnorm));
+                }
+            }
+            _B = 0.5 * (_B + _B.transpose()).eval();
+            _b = _basis.transpose() * g;
+            return true;
+        }
+
+        Eigen::VectorXd SubspaceTrustRegionPolicy::solveSubproblem(double delta, bool& outOnBoundary) const
+        {
+            Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> es(_B);
+            const Eigen::VectorXd& d = es.eigenvalues(); // ascending
+            const Eigen::MatrixXd& Q = es.eigenvectors();
+            const Eigen::VectorXd c = Q.transpose() * _b;
+            const double eps = std::numeric_limits<double>::epsilon() * std::max(1.0, d.cwiseAbs().maxCoeff());
+
+            outOnBoundary = false;
+            if(d[0] > eps) {
+                const Eigen::VectorXd y = Q * c.cwiseQuotient(d);
+                if(delta == 0 || y.norm() <= delta)
+                    return y;
+            } else if(delta == 0) {
+                // No positive curvature along the subspace, start with the radius of the Cauchy step
+                const double bBb = _b.dot(_B * _b);
+                delta = bBb > 0 ? std::pow(_b.norm(), 3) / bBb : _b.norm();
+            }
+            outOnBoundary = true;
+
+            // Find lambda >= max(0, -d_min) with ||(B + lambda I)^-1 b|| = delta, ||.|| decreases in lambda
+            const double lambdaLow = std::max(0.0, -d[0]);
+            auto stepFor = [&](double lambda) {
+                Eigen::VectorXd z(c.size());
+                for(int i = 0; i < c.size(); ++i) {
+                    const double di = d[i] + lambda;
+                    z[i] = di > eps ? c[i] / di : 0.0;
+                }
+                return z;
+            };
+
+            // Hard case: the gradient has no component along the most negative curvature direction
+            if(d[0] <= eps && std::abs(c[0]) <= 1e-12 * c.norm()) {
+                Eigen::VectorXd z = stepFor(lambdaLow);
+                const double zz = z.squaredNorm();
+                if(zz < delta * delta) {
+                    z[0] = std::sqrt(delta * delta - zz);
+                    return Q * z;
+                }
+            }
+
+            double lo = lambdaLow;
+            double hi = lambdaLow + c.norm() / delta;
+            for(int it = 0; it < 100 && hi - lo > 1e-15 * std::max(1.0, hi); ++it) {
+                const double mid = 0.5 * (lo + hi);
+                if(stepFor(mid).norm() > delta)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            // hi always satisfies the constraint
+            return Q * stepFor(hi);
+        }
+
+        void SubspaceTrustRegionPolicy::stepProjected(const Eigen::VectorXd& dx)
+        {
+            _dx = dx;
+            double reduction;
+            if (getModelReduction(dx, reduction)) {
+                // A model predicting no decrease keeps the sign of the actual one in rho
+                _L0 = std::max(reduction, std::numeric_limits<double>::min());
+                _stepType = "PR";
+            }
+        }
+
+        /// \brief print the current state to a stream (no newlines).
+        std::ostream & SubspaceTrustRegionPolicy::printState(std::ostream & out) const
+        {
+            out << "Subspace - delta:" << _delta << ", " << _stepType << ", dim:" << _basis.cols();
+            return out;
+        }
+
+
+        bool SubspaceTrustRegionPolicy::revertOnFailure()
+        {
+            return true;
+        }
+
+        bool SubspaceTrustRegionPolicy::requiresAugmentedDiagonal() const {
+            return false;
+        }
+
+    } // namespace backend
+} // namespace aslam
@@ -1,4 +1,6 @@
 #include <aslam/backend/TrustRegionPolicy.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace aslam {
     namespace backend {
@@ -24,27 +26,93 @@ namespace aslam {
             return true;
         }
 
+        void TrustRegionPolicy::setWarmStart(bool warmStart, double decay)
+        {
+            SM_ASSERT_GT(Exception, decay, 0.0, "");
+            SM_ASSERT_LE(Exception, decay, 1.0, "");
+            _warmStart = warmStart;
+            _warmStartDecay = decay;
+        }
+
+        void TrustRegionPolicy::setForcingTerms(double maxForcingTerm, double gamma, double alpha)
+        {
+            SM_ASSERT_GE(Exception, maxForcingTerm, 0.0, "");
+            SM_ASSERT_LT(Exception, maxForcingTerm, 1.0, "");
+            SM_ASSERT_GT(Exception, gamma, 0.0, "");
+            SM_ASSERT_LE(Exception, gamma, 1.0, "");
+            SM_ASSERT_GT(Exception, alpha, 1.0, "");
+            SM_ASSERT_LE(Exception, alpha, 2.0, "");
+            _maxForcingTerm = maxForcingTerm;
+            _forcingTermGamma = gamma;
+            _forcingTermAlpha = alpha;
+            if (_maxForcingTerm == 0.0 && _solver)
+                _solver->setForcingTerm(0.0);
+        }
+
+        bool TrustRegionPolicy::getModelReduction(const Eigen::VectorXd& dx, double& outReduction)
+        {
+            // rhs = J^T e holds the negated errors: |e - J dx|^2 = |e|^2 - 2 dx^T rhs + |J dx|^2
+            double JdxNorm;
+            if (!_solver->jacobianSquaredNorm(dx, JdxNorm))
+                return false;
+            outReduction = 2.0 * dx.dot(_solver->rhs()) - JdxNorm;
+            return true;
+        }
+
+        void TrustRegionPolicy::updateForcingTerm()
+        {
+            _systemBuilt = true;
+            if (_maxForcingTerm <= 0.0)
+                return;
+            const double gradientNorm = _solver->rhs().norm();
+            if (_forcingTerm < 0.0 || _gradientNorm <= 0.0) {
+                _forcingTerm = _maxForcingTerm;
+            } else if (!_previousIterationFailed) {
+                double eta = _forcingTermGamma * std::pow(gradientNorm / _gradientNorm, _forcingTermAlpha);
+                // Keep the forcing terms from dropping faster than the gradient norm does
+                const double safeguard = _forcingTermGamma * std::pow(_forcingTerm, _forcingTermAlpha);
+                if (safeguard > 0.1)
+                    eta = std::max(eta, safeguard);
+                _forcingTerm = std::min(eta, _maxForcingTerm);
+            } // else it was reduced in solveSystem()
+            _gradientNorm = gradientNorm;
+            _solver->setForcingTerm(_forcingTerm);
+        }
+
             
         /// \brief called by the optimizer when an optimization is starting
         void TrustRegionPolicy::optimizationStarting(double J)
         {
             _J = J;
             _p_J = J;
+            _acceptedJ = J;
             _isFirstIteration=true;
+            _forcingTerm = -1.0;
+            _gradientNorm = -1.0;
             optimizationStartingImplementation(J);
         }
             
         // Returns true if the solution was successful
     bool TrustRegionPolicy::solveSystem(double J, bool previousIterationFailed, int nThreads, Eigen::VectorXd& outDx)
         {
+            // A rejected step was reverted, the last step started from the last accepted state either way
+            _p_J = _acceptedJ;
+            _J = J;
             if(!previousIterationFailed)
             {
-                _p_J = _J;
+                _acceptedJ = J;
+            }
+            _previousIterationFailed = previousIterationFailed;
+            if (previousIterationFailed && _maxForcingTerm > 0.0 && _forcingTerm > 0.0) {
+                // A more accurate step may succeed where the last one failed
+                _forcingTerm *= 0.5;
+                _solver->setForcingTerm(_forcingTerm);
             }
-            _J = J;
 
+            _systemBuilt = false;
             const bool success = solveSystemImplementation(J, previousIterationFailed, nThreads, outDx);
             _isFirstIteration = false;
+            _hasState = true;
             return success;
         }
 
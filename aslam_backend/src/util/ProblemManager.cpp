@@ -8,11 +8,94 @@
 #include <aslam/backend/util/ThreadedRangeProcessor.hpp>
 
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <sm/PropertyTree.hpp>
 #include <sm/logging.hpp>
 
 namespace aslam {
 namespace backend {
 
+MiniBatchOptions::MiniBatchOptions()
+{
+  check();
+}
+
+MiniBatchOptions::MiniBatchOptions(const sm::PropertyTree& config)
+{
+  batchSize = config.getInt("batchSize", batchSize);
+  growthFactor = config.getDouble("growthFactor", growthFactor);
+  seed = config.getInt("seed", seed);
+  check();
+}
+
+void MiniBatchOptions::check() const
+{
+  SM_ASSERT_GE(Exception, growthFactor, 1.0, "The batch size must not shrink");
+}
+
+std::ostream& operator<<(std::ostream& out, const MiniBatchOptions& options)
+{
+  out << "MiniBatchOptions:" << std::endl;
+  out << "\tbatchSize: " << options.batchSize << std::endl;
+  out << "\tgrowthFactor: " << options.growthFactor << std::endl;
+  out << "\tseed: " << options.seed;
+  return out;
+}
+
+namespace {
+
+/**
+ * \class JacobianContainerGradientScatter
+ * \brief Single row Jacobian container that scatters the blocks of the added Jacobians into a details::GradientBuffer
+ */
+class JacobianContainerGradientScatter : public JacobianContainer {
+ public:
+  SM_DEFINE_EXCEPTION(Exception, aslam::Exception);
+  static constexpr const int RowsAtCompileTime = 1;
+
+  JacobianContainerGradientScatter(details::GradientBuffer& buffer) : JacobianContainer(1), _buffer(buffer) { }
+  ~JacobianContainerGradientScatter() override { }
+
+  void add(DesignVariable* designVariable, const Eigen::Ref<const Eigen::MatrixXd>& Jacobian) override {
+    internal::JacobianContainerImplHelper::addImpl(*this, designVariable, Jacobian);
+  }
+  void add(DesignVariable* designVariable) override {
+    internal::JacobianContainerImplHelper::addImpl(*this, designVariable);
+  }
+
+  bool isFinite(const DesignVariable& dv) const override {
+    return _buffer.gradient.segment(dv.columnBase(), dv.minimalDimensions()).allFinite();
+  }
+
+  Eigen::MatrixXd asDenseMatrix() const override { return _buffer.gradient; }
+
+ private:
+  template <typename MATRIX>
+  EIGEN_ALWAYS_INLINE void addJacobian(DesignVariable* dv, const MATRIX& jacobian) {
+    SM_ASSERT_EQ_DBG(Exception, jacobian.rows(), 1, "");
+    _buffer.add(*dv, jacobian);
+  }
+
+  friend class internal::JacobianContainerImplHelper;
+
+ private:
+  details::GradientBuffer& _buffer;
+};
+
+} // namespace
+
+void details::GradientBuffer::reset(std::size_t numDesignVariables, std::size_t numOptParameters)
+{
+  if (static_cast<std::size_t>(gradient.cols()) != numOptParameters)
+    gradient.resize(1, numOptParameters);
+  isTouched.assign(numDesignVariables, false);
+  touched.clear();
+  error = 0.0;
+}
+
 ProblemManager::ProblemManager()
 {
 
@@ -86,6 +169,8 @@ void ProblemManager::initialize()
   initEt.stop();
   SM_ASSERT_FALSE(Exception, _errorTermsNS.empty() && _errorTermsS.empty(), "It is illegal to run the optimizer with no error terms.");
 
+  resetMiniBatches();
+
   _isInitialized = true;
 
   SM_FINEST_STREAM_NAMED("optimization",
@@ -119,17 +204,108 @@ void ProblemManager::checkProblemSetup() const
  */
 void ProblemManager::computeGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer)
 {
-  SM_ASSERT_GT(Exception, nThreads, 0, "");
   Timer t("ProblemManager: Compute gradient", false);
-  std::vector<RowVectorType> gradients(nThreads, RowVectorType::Zero(1, _numOptParameters)); // compute gradients separately in different threads and add in the end
-  boost::function<void(size_t, size_t, size_t, RowVectorType&)> job(boost::bind(&ProblemManager::evaluateGradients, this, _1, _2, _3, _4, useMEstimator, useDenseJacobianContainer));
-  util::runThreadedFunction(job, _numErrorTerms, gradients);
-  // Add up the gradients
-  outGrad = gradients[0];
-  for (std::size_t i = 1; i<gradients.size(); i++)
-    outGrad += gradients[i];
+  accumulateGradient(outGrad, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer, false);
+}
+
+/**
+ * Computes the gradient and the value of the scalar objective function in one pass over the error terms
+ * @param[out] outGrad The gradient
+ * @param nThreads How many threads to use
+ * @param useMEstimator Whether to use an MEstimator for the gradient
+ * @return The error, same as evaluateError()
+ */
+double ProblemManager::evaluateErrorAndGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer)
+{
+  Timer t("ProblemManager: Compute error and gradient", false);
+  return accumulateGradient(outGrad, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer, true);
+}
+
+/**
+ * Each thread scatters the gradient blocks of its error terms into its own buffer. Only the blocks of the design
+ * variables a thread actually touched are reduced into the output, which keeps the cost of zeroing and adding up
+ * the per-thread results proportional to the number of touched parameters instead of nThreads x numOptParameters.
+ */
+double ProblemManager::accumulateGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer,
+                                          bool computeError, const std::vector<std::size_t>* indices /*= nullptr*/)
+{
+  SM_ASSERT_GT(Exception, nThreads, 0, "");
+  _gradientBuffers.resize(nThreads);
+  for (auto& buffer : _gradientBuffers)
+    buffer.reset(_designVariables.size(), _numOptParameters);
+  boost::function<void(size_t, size_t, size_t, details::GradientBuffer&)> job(boost::bind(&ProblemManager::evaluateGradients, this, _1, _2, _3, _4, useMEstimator,
+                                                                                         useDenseJacobianContainer, computeError, indices));
+  util::runThreadedFunction(job, indices ? indices->size() : _numErrorTerms, _gradientBuffers);
+  // Add up the touched blocks of the gradients and the errors
+  outGrad = RowVectorType::Zero(1, _numOptParameters);
+  double error = 0.0;
+  for (const auto& buffer : _gradientBuffers) {
+    for (const DesignVariable* dv : buffer.touched)
+      outGrad.segment(dv->columnBase(), dv->minimalDimensions()) += buffer.gradient.segment(dv->columnBase(), dv->minimalDimensions());
+    error += buffer.error;
+  }
   if (applyDvScaling)
     applyDesignVariableScaling(outGrad);
+  return error;
+}
+
+/**
+ * Computes an unbiased estimate of the gradient of the scalar objective function from the next mini-batch
+ * @param[out] outGrad The gradient estimate
+ * @param nThreads How many threads to use
+ * @param useMEstimator Whether to use an MEstimator
+ * @param computeError Whether to estimate the error as well
+ * @return The error estimate if \p computeError is set, zero otherwise
+ */
+double ProblemManager::computeMiniBatchGradient(RowVectorType& outGrad, size_t nThreads, bool useMEstimator, bool applyDvScaling, bool useDenseJacobianContainer,
+                                                bool computeError /*= false*/)
+{
+  if (isFullBatch())
+    return accumulateGradient(outGrad, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer, computeError);
+
+  Timer t("ProblemManager: Compute mini-batch gradient", false);
+
+  // Start a new epoch if the remaining error terms do not fill a batch
+  if (_batchPosition + _currentBatchSize > _batchPermutation.size()) {
+    ++_epoch;
+    _currentBatchSize = static_cast<std::size_t>(std::ceil(_currentBatchSize*_miniBatchOptions.growthFactor));
+    std::shuffle(_batchPermutation.begin(), _batchPermutation.end(), _batchRng);
+    _batchPosition = 0;
+    SM_FINE_STREAM_NAMED("optimization", "ProblemManager: Starting epoch " << _epoch << " with batch size " << getCurrentBatchSize());
+    if (isFullBatch())
+      return accumulateGradient(outGrad, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer, computeError);
+  }
+
+  _batchIndices.assign(_batchPermutation.begin() + _batchPosition, _batchPermutation.begin() + _batchPosition + _currentBatchSize);
+  _batchPosition += _currentBatchSize;
+  // Processing the batch in index order keeps the memory access pattern of the full gradient computation
+  std::sort(_batchIndices.begin(), _batchIndices.end());
+
+  double error = accumulateGradient(outGrad, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer, computeError, &_batchIndices);
+  const double scale = static_cast<double>(_numErrorTerms)/_batchIndices.size();
+  outGrad *= scale;
+  error *= scale;
+  return error;
+}
+
+void ProblemManager::setMiniBatchOptions(const MiniBatchOptions& options)
+{
+  options.check();
+  _miniBatchOptions = options;
+  resetMiniBatches();
+}
+
+void ProblemManager::resetMiniBatches()
+{
+  _batchRng.seed(_miniBatchOptions.seed);
+  _currentBatchSize = _miniBatchOptions.batchSize;
+  _epoch = 0;
+  _batchPosition = 0;
+  _batchIndices.clear();
+  _batchPermutation.resize(_numErrorTerms);
+  std::iota(_batchPermutation.begin(), _batchPermutation.end(), 0);
+  if (!isFullBatch())
+    std::shuffle(_batchPermutation.begin(), _batchPermutation.end(), _batchRng);
 }
 
 void ProblemManager::applyDesignVariableScaling(RowVectorType& outGrad) const {
@@ -144,10 +320,9 @@ void ProblemManager::addGradientForErrorTerm(RowVectorType& J, ErrorTerm* e, boo
   ev *= 2.0;
 
   if (useDenseJacobianContainer) {
-    Eigen::MatrixXd J2 = Eigen::MatrixXd::Zero(e->dimension(), J.cols());
-    JacobianContainerDense<Eigen::MatrixXd&, Eigen::Dynamic> jc(J2);
-    e->getWeightedJacobians(jc, useMEstimator);
-    J += ev.transpose() * J2;
+    // Apply ev^T as the outermost chain rule factor, which accumulates the gradient row without the dim x n Jacobian
+    JacobianContainerDense<RowVectorType&, 1> jc(J);
+    e->getWeightedJacobians(jc.apply(ev.transpose()), useMEstimator);
   } else {
     JacobianContainerSparse<Eigen::Dynamic> jc(e->dimension());
     e->getWeightedJacobians(jc, useMEstimator);
@@ -264,35 +439,54 @@ void ProblemManager::sumErrorTerms(size_t /* threadId */, size_t startIdx, size_
  * @param startIdx First error term index (including)
  * @param endIdx Last error term index (excluding)
  * @param useMEstimator Whether or not to use an MEstimator
- * @param J The gradient for the specified error terms
+ * @param buffer The buffer the gradient blocks and, if \p computeError is set, the error of the specified error terms are added to
+ * @param computeError Whether or not to accumulate the error as well
+ * @param indices If not null, the indices of the error terms to process are taken from this vector
  */
-void ProblemManager::evaluateGradients(size_t /* threadId */, size_t startIdx, size_t endIdx, RowVectorType& J, bool useMEstimator, bool useDenseJacobianContainer)
+void ProblemManager::evaluateGradients(size_t /* threadId */, size_t startIdx, size_t endIdx, details::GradientBuffer& buffer, bool useMEstimator,
+                                       bool useDenseJacobianContainer, bool computeError, const std::vector<std::size_t>* indices)
 {
-  SM_ASSERT_LE_DBG(Exception, endIdx, _numErrorTerms, "");
+  SM_ASSERT_LE_DBG(Exception, endIdx, indices ? indices->size() : _numErrorTerms, "");
 
-  size_t cnt = startIdx;
+  // The scatter container writes directly into the touched blocks of the buffer, no per error term allocation needed
+  JacobianContainerGradientScatter jcScatter(buffer);
+  JacobianContainerSparse<1> jcNS(1);
 
-  // process non-squared error terms
-  if (useDenseJacobianContainer)
+  for (size_t cnt = startIdx; cnt < endIdx; ++cnt)
   {
-    JacobianContainerDense<RowVectorType&, 1> jc(J);
-    for (; cnt < endIdx && cnt < _errorTermsNS.size(); ++cnt)
-      addGradientForErrorTerm(jc, _errorTermsNS[cnt], useMEstimator);
-  }
-  else
-  {
-    JacobianContainerSparse<1> jc(1);
-    for (; cnt < endIdx && cnt < _errorTermsNS.size(); ++cnt)
+    const size_t idx = indices ? (*indices)[cnt] : cnt;
+
+    if (idx < _errorTermsNS.size()) // non-squared error term
     {
-      jc.clear();
-      addGradientForErrorTerm(jc, J, _errorTermsNS[cnt], useMEstimator);
+      ScalarNonSquaredErrorTerm* e = _errorTermsNS[idx];
+      if (computeError)
+        buffer.error += e->evaluateError();
+      if (useDenseJacobianContainer) {
+        e->evaluateJacobians(jcScatter, useMEstimator);
+      } else {
+        jcNS.clear();
+        e->evaluateJacobians(jcNS, useMEstimator);
+        for (const auto& dvJacPair : jcNS) // iterate over design variables of this error term
+          buffer.add(*dvJacPair.first, dvJacPair.second);
+      }
+    }
+    else // squared error term
+    {
+      ErrorTerm* e = _errorTermsS[idx - _errorTermsNS.size()];
+      e->updateRawSquaredError();
+      if (computeError)
+        buffer.error += e->getSquaredError();
+      e->getWeightedError(buffer.weightedError, useMEstimator);
+      buffer.weightedError *= 2.0;
+      if (useDenseJacobianContainer) {
+        e->getWeightedJacobians(jcScatter.apply(buffer.weightedError.transpose()), useMEstimator);
+      } else {
+        JacobianContainerSparse<Eigen::Dynamic> jc(e->dimension());
+        e->getWeightedJacobians(jc, useMEstimator);
+        for (const auto& dvJacPair : jc) // iterate over design variables of this error term
+          buffer.add(*dvJacPair.first, buffer.weightedError.transpose()*dvJacPair.second);
+      }
     }
-  }
-
-  // process squared error terms
-  for (; cnt < endIdx; ++cnt)
-  {
-    addGradientForErrorTerm(J, _errorTermsS[cnt - _errorTermsNS.size()], useMEstimator, useDenseJacobianContainer);
   }
 
 }
@@ -1,5 +1,8 @@
 #include <sm/eigen/gtest.hpp>
 #include <aslam/backend/Optimizer.hpp>
+#include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/OptimizerBFGS.hpp>
+#include <aslam/backend/OptimizerRprop.hpp>
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -110,5 +113,77 @@ TEST(CallbackTestSuite, testCallback)
   }
 }
 
+TEST(CallbackTestSuite, testProceedInstruction)
+{
+  try {
+    using namespace aslam::backend;
+    using namespace callback;
+
+    { // Optimizer2: stop after the first accepted update
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(0, 4, 12);
+      Optimizer2Options options;
+      options.maxIterations = 20;
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      optimizer.callback().add<event::DESIGN_VARIABLES_UPDATED>([]() { return ProceedInstruction::SUCCEED; });
+      auto ret = optimizer.optimize();
+      EXPECT_EQ(ConvergenceStatus::CALLBACK_STOP, optimizer.getStatus().convergence);
+      EXPECT_TRUE(optimizer.getStatus().success());
+      EXPECT_EQ(1, ret.iterations);
+      EXPECT_LE(ret.JFinal, ret.JStart);
+    }
+
+    { // Optimizer2: a failure requested after solving the linear system discards the step
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(0, 4, 12);
+      Optimizer2 optimizer;
+      optimizer.setProblem(problem);
+      int countDesignUpdate = 0;
+      optimizer.callback().add<event::LINEAR_SYSTEM_SOLVED>([]() { return ProceedInstruction::FAIL; });
+      optimizer.callback().add<event::DESIGN_VARIABLES_UPDATED>([&]() { countDesignUpdate++; });
+      auto ret = optimizer.optimize();
+      EXPECT_EQ(ConvergenceStatus::FAILURE, optimizer.getStatus().convergence);
+      EXPECT_EQ(0, countDesignUpdate);
+      EXPECT_EQ(0, ret.iterations);
+      EXPECT_DOUBLE_EQ(ret.JStart, ret.JFinal);
+    }
 
+    { // Optimizer2: an exhausted time budget stops before the first iteration
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(0, 4, 12);
+      Optimizer2Options options;
+      options.maxTimeMs = 1e-9;
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      auto ret = optimizer.optimize();
+      EXPECT_EQ(ConvergenceStatus::TIME_LIMIT, optimizer.getStatus().convergence);
+      EXPECT_EQ(0, ret.iterations);
+    }
+
+    { // First-order optimizers
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(0, 4, 12);
+      OptimizerBFGS bfgs;
+      bfgs.setProblem(problem);
+      bfgs.callback().add<event::ITERATION_END>([]() { return ProceedInstruction::SUCCEED; });
+      bfgs.optimize();
+      EXPECT_EQ(ConvergenceStatus::CALLBACK_STOP, bfgs.getStatus().convergence);
+      EXPECT_EQ(1u, bfgs.getStatus().numIterations);
 
+      OptimizerRprop rprop;
+      rprop.setProblem(problem);
+      int countIterations = 0;
+      rprop.callback().add<event::ITERATION_START>([&]() { return ++countIterations > 3 ? ProceedInstruction::FAIL : ProceedInstruction::CONTINUE; });
+      rprop.optimize();
+      EXPECT_EQ(ConvergenceStatus::FAILURE, rprop.getStatus().convergence);
+      EXPECT_EQ(3u, rprop.getStatus().numIterations);
+
+      OptimizerRprop::Options rpropOptions;
+      rpropOptions.maxTimeMs = 1e-9;
+      OptimizerRprop rpropTimed(rpropOptions);
+      rpropTimed.setProblem(problem);
+      rpropTimed.optimize();
+      EXPECT_EQ(ConvergenceStatus::TIME_LIMIT, rpropTimed.getStatus().convergence);
+      EXPECT_EQ(0u, rpropTimed.getStatus().numIterations);
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -2,6 +2,8 @@
 
 #include <sm/eigen/gtest.hpp>
 #include "SampleDvAndError.hpp"
+#include <aslam/backend/MarginalizationPriorErrorTerm.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
 
 TEST(ErrorTermTestSuite, testMEstimatorGetter) {
   using aslam::backend::FixedWeightMEstimator;
@@ -173,3 +175,111 @@ TEST(ErrorTermTestSuite, testNonSquaredErrorTerm) {
 
 
 
+
+namespace {
+
+/// A 2d point with a minimal difference to the point at marginalization that is either the plain difference
+/// (identity Jacobian), a nonlinear one or the plain difference with a Jacobian that is only close to the identity
+class MarginalizedPoint2d : public Point2d {
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  enum Difference { LINEAR, NONLINEAR, NEARLY_LINEAR };
+
+  MarginalizedPoint2d(const Eigen::Vector2d& v, Difference difference) : Point2d(v), _difference(difference) {}
+
+protected:
+  void minimalDifferenceImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference) const override {
+    Eigen::MatrixXd M;
+    minimalDifferenceAndJacobianImplementation(xHat, outDifference, M);
+  }
+
+  void minimalDifferenceAndJacobianImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference, Eigen::MatrixXd& outJacobian) const override {
+    const Eigen::Vector2d delta = _v - xHat.col(0);
+    outJacobian = Eigen::MatrixXd::Identity(2, 2);
+    switch (_difference) {
+      case LINEAR:
+        outDifference = delta;
+        break;
+      case NONLINEAR:
+        outDifference = delta.array().sin();
+        outJacobian.diagonal() = delta.array().cos();
+        break;
+      case NEARLY_LINEAR:
+        outDifference = delta;
+        outJacobian(0, 1) = 1e-12;
+        break;
+    }
+  }
+
+private:
+  Difference _difference;
+};
+
+} // namespace
+
+TEST(ErrorTermTestSuite, testMarginalizationPriorMatchesDenseEvaluation) {
+  using namespace aslam::backend;
+  try {
+    std::vector<MarginalizedPoint2d> points;
+    points.reserve(4);
+    points.emplace_back(Eigen::Vector2d::Random(), MarginalizedPoint2d::LINEAR);
+    points.emplace_back(Eigen::Vector2d::Random(), MarginalizedPoint2d::NONLINEAR);
+    points.emplace_back(Eigen::Vector2d::Random(), MarginalizedPoint2d::NEARLY_LINEAR);
+    points.emplace_back(Eigen::Vector2d::Random(), MarginalizedPoint2d::LINEAR);
+    std::vector<DesignVariable*> dvs;
+    int columnBase = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+      points[i].setActive(true);
+      points[i].setBlockIndex(i);
+      points[i].setColumnBase(columnBase);
+      columnBase += points[i].minimalDimensions();
+      dvs.push_back(&points[i]);
+    }
+
+    // Upper triangular with zero blocks as left by the marginalization, including an all zero column slice
+    Eigen::MatrixXd R = Eigen::MatrixXd::Random(columnBase, columnBase).triangularView<Eigen::Upper>();
+    R.block(0, 4, 2, 2).setZero();
+    R.block(0, 6, 4, 2).setZero();
+    R.block(2, 2, 2, 2).setZero();
+    const Eigen::VectorXd d = Eigen::VectorXd::Random(columnBase);
+    std::vector<Eigen::MatrixXd> xHat;
+    for (auto& p : points) {
+      Eigen::MatrixXd v;
+      p.getParameters(v);
+      xHat.push_back(v);
+    }
+    MarginalizationPriorErrorTerm e(dvs, d, R);
+
+    // Move away from the linearization point
+    for (auto& p : points) {
+      Eigen::Vector2d dx = Eigen::Vector2d::Random();
+      p.update(dx.data(), 2);
+    }
+
+    // The dense formulas of e = -(d - R*diff) and J = R * M
+    Eigen::VectorXd diff(columnBase);
+    Eigen::MatrixXd expectedJ(columnBase, columnBase);
+    for (size_t i = 0; i < points.size(); ++i) {
+      Eigen::VectorXd diffI;
+      Eigen::MatrixXd M;
+      points[i].minimalDifferenceAndJacobian(xHat[i], diffI, M);
+      diff.segment(2 * i, 2) = diffI;
+      expectedJ.middleCols(2 * i, 2) = R.middleCols(2 * i, 2) * M;
+    }
+    const Eigen::VectorXd expectedError = -(d - R * diff);
+
+    e.evaluateError();
+    ASSERT_DOUBLE_MX_EQ(expectedError, e.vsError(), 1e-10, "Checking the error");
+    JacobianContainerSparse<> jc(e.dimension());
+    e.evaluateJacobians(jc);
+    const Eigen::MatrixXd J = jc.asDenseMatrix();
+    ASSERT_DOUBLE_MX_EQ(expectedJ, J, 1e-10, "Checking the Jacobian");
+    // The nearly identical minimal difference Jacobian is applied, not replaced by the identity
+    ASSERT_NE(0.0, R(2, 4));
+    EXPECT_NE(R(2, 5), J(2, 5));
+    EXPECT_EQ(R(2, 4) * 1e-12 + R(2, 5), J(2, 5));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
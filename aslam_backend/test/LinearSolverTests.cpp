@@ -1,6 +1,8 @@
 #include <sm/eigen/gtest.hpp>
 
 #include <numeric>
+#include <algorithm>
+#include <cmath>
 
 #include "SampleDvAndError.hpp"
 
@@ -114,6 +116,272 @@ TEST(LinearSolverTestSuite, testSparseCholesky)
   }
 }
 
+TEST(LinearSolverTestSuite, testSparseCholeskyOrderingGroups)
+{
+  using namespace aslam::backend;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  const int D = 8;
+  const int E = 30;
+  try {
+    buildSystem(D, E, dvs, errs);
+    // Interleave the groups, the unconstrained ordering would mix them. Group numbers need not be contiguous.
+    const int groups[D] = { 7, 2, 7, 2, 4, 2, 7, 4 };
+    std::vector<int> columnGroup;
+    for (int i = 0; i < D; ++i) {
+      dvs[i]->setOrderingGroup(groups[i]);
+      columnGroup.insert(columnGroup.end(), dvs[i]->minimalDimensions(), groups[i]);
+    }
+    SparseCholeskyLinearSystemSolver S;
+    S.initMatrixStructure(dvs, errs, false);
+    EXPECT_TRUE(S.getFactorPermutation().empty());
+    S.evaluateError(1, false);
+    S.buildSystem(1, false);
+    Eigen::VectorXd dx;
+    ASSERT_TRUE(S.solveSystem(dx));
+
+    const std::vector<int> permutation = S.getFactorPermutation();
+    ASSERT_EQ(columnGroup.size(), permutation.size());
+    std::vector<int> sorted = permutation;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t k = 0; k < sorted.size(); ++k)
+      ASSERT_EQ((int)k, sorted[k]) << "Not a permutation";
+    // Every column of a lower group is eliminated before all columns of higher groups
+    for (size_t k = 1; k < permutation.size(); ++k)
+      EXPECT_LE(columnGroup[permutation[k - 1]], columnGroup[permutation[k]]) << "at position " << k;
+
+    // The constrained ordering does not change the solution
+    BlockCholeskyLinearSystemSolver B;
+    B.initMatrixStructure(dvs, errs, false);
+    B.evaluateError(1, false);
+    B.buildSystem(1, false);
+    Eigen::VectorXd dxB;
+    ASSERT_TRUE(B.solveSystem(dxB));
+    ASSERT_DOUBLE_MX_EQ(dxB, dx, 1e-6, "Checking the solutions");
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
+/// Multiply the Jacobian column of the first coordinate of \p dv with \p factor and keep the errors
+void scaleJacobianColumn(const std::vector<ErrorTerm*>& errs, const DesignVariable* dv, double factor)
+{
+  // All sample errors are _p - sum_k J_k v_k
+  auto scale = [dv, factor](const Point2d* p, int rows, double* J, double* pv) {
+    if (p != dv)
+      return;
+    for (int r = 0; r < rows; ++r) {
+      pv[r] += (factor - 1.0) * J[r] * p->_v[0];
+      J[r] *= factor;
+    }
+  };
+  for (ErrorTerm* e : errs) {
+    if (LinearErr* e1 = dynamic_cast<LinearErr*>(e)) {
+      scale(e1->_p2d, 2, e1->_J.data(), e1->_p.data());
+    } else if (LinearErr2* e2 = dynamic_cast<LinearErr2*>(e)) {
+      scale(e2->_p2d1, 2, e2->_J1.data(), e2->_p.data());
+      scale(e2->_p2d2, 2, e2->_J2.data(), e2->_p.data());
+    } else if (LinearErr3* e3 = dynamic_cast<LinearErr3*>(e)) {
+      scale(e3->_p2d1, 4, e3->_J1.data(), e3->_p.data());
+      scale(e3->_p2d2, 4, e3->_J2.data(), e3->_p.data());
+      scale(e3->_p3, 4, e3->_J3.data(), e3->_p.data());
+    }
+  }
+}
+
+/// The column scaling must neither change the undamped solution nor the system
+template<typename S_TYPE>
+void testColumnScaling(int D, int E)
+{
+  SCOPED_TRACE(typeid(S_TYPE).name());
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  try {
+    buildSystem(D, E, dvs, errs);
+    S_TYPE S;
+    S.initMatrixStructure(dvs, errs, false);
+    S.evaluateError(1, false);
+    S.buildSystem(1, false);
+    EXPECT_EQ(0, S.getColumnScale().size());
+    Eigen::VectorXd dx, dxScaled, dxScaled2;
+    ASSERT_TRUE(S.solveSystem(dx));
+
+    S.setColumnScaling(true);
+    S.buildSystem(1, false);
+    ASSERT_EQ(S.JCols(), (size_t)S.getColumnScale().size());
+    for (int i = 0; i < S.getColumnScale().size(); ++i) {
+      int exponent;
+      EXPECT_EQ(0.5, std::frexp(S.getColumnScale()[i], &exponent)) << "The scale factors are powers of two";
+    }
+    const Eigen::VectorXd rhs = S.rhs();
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(S.JCols());
+    Eigen::VectorXd Jv, Jv2;
+    const bool multipliesJacobian = S.multiplyJacobian(v, Jv);
+    ASSERT_TRUE(S.solveSystem(dxScaled));
+    ASSERT_DOUBLE_MX_EQ(dx, dxScaled, 1e-6, "Checking the scaled solution");
+    // Unscaling restores the system exactly, repeated solves must not drift
+    for (int k = 0; k < 20; ++k) {
+      ASSERT_TRUE(S.solveSystem(dxScaled2));
+      EXPECT_TRUE(dxScaled == dxScaled2) << "Solve " << k;
+    }
+    EXPECT_TRUE(rhs == S.rhs());
+    if (multipliesJacobian) {
+      ASSERT_TRUE(S.multiplyJacobian(v, Jv2));
+      EXPECT_TRUE(Jv == Jv2);
+    }
+
+    // The damping acts on the scaled columns, i.e. it is the conditioner divided by the scale in the original space
+    S_TYPE damped, reference;
+    damped.initMatrixStructure(dvs, errs, true);
+    reference.initMatrixStructure(dvs, errs, true);
+    damped.setColumnScaling(true);
+    damped.setConstantConditioner(0.5);
+    for (S_TYPE* s : {&damped, &reference}) {
+      s->evaluateError(1, false);
+      s->buildSystem(1, false);
+    }
+    reference.setConditioner(Eigen::VectorXd::Constant(reference.JCols(), 0.5).cwiseQuotient(damped.getColumnScale()));
+    Eigen::VectorXd dxDamped, dxReference;
+    ASSERT_TRUE(damped.solveSystem(dxDamped));
+    ASSERT_TRUE(reference.solveSystem(dxReference));
+    ASSERT_DOUBLE_MX_EQ(dxReference, dxDamped, 1e-6, "Checking the damped solution");
+    EXPECT_GT((dxDamped - dx).norm(), 1e-3 * dx.norm());
+
+    // Blow up one column by 1e8, the equilibrated solution only changes by that factor
+    const double factor = 1e8;
+    scaleJacobianColumn(errs, dvs[0], factor);
+    S_TYPE ill;
+    ill.initMatrixStructure(dvs, errs, false);
+    ill.setColumnScaling(true);
+    ill.evaluateError(1, false);
+    ill.buildSystem(1, false);
+    EXPECT_GT(ill.getColumnScale().maxCoeff() / ill.getColumnScale().minCoeff(), 1e7);
+    Eigen::VectorXd dxIll;
+    ASSERT_TRUE(ill.solveSystem(dxIll));
+    dxIll[dvs[0]->columnBase()] *= factor;
+    ASSERT_DOUBLE_MX_EQ(dx, dxIll, 1e-4, "Checking the ill-conditioned solution");
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
+TEST(LinearSolverTestSuite, testColumnScaling)
+{
+  const int D = 4;
+  const int E = 20;
+  testColumnScaling<SparseCholeskyLinearSystemSolver>(D, E);
+  testColumnScaling<SparseQrLinearSystemSolver>(D, E);
+  testColumnScaling<BlockCholeskyLinearSystemSolver>(D, E);
+  testColumnScaling<DenseQrLinearSystemSolver>(D, E);
+}
+
+TEST(LinearSolverTestSuite, testPcgForcingTerm)
+{
+  const int D = 4;
+  const int E = 20;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  try {
+    buildSystem(D, E, dvs, errs);
+    BlockCholeskyLinearSystemSolver cholesky, pcg("pcg");
+    EXPECT_FALSE(cholesky.isIterative());
+    EXPECT_TRUE(pcg.isIterative());
+    Eigen::VectorXd dxCholesky, dxPcg, dxInexact;
+    for (BlockCholeskyLinearSystemSolver* S : {&cholesky, &pcg}) {
+      S->initMatrixStructure(dvs, errs, true);
+      S->setConstantConditioner(0.1);
+      S->evaluateError(1, false);
+      S->buildSystem(1, false);
+    }
+    ASSERT_TRUE(cholesky.solveSystem(dxCholesky));
+    // Without a forcing term the solution is exact
+    ASSERT_TRUE(pcg.solveSystem(dxPcg));
+    ASSERT_DOUBLE_MX_EQ(dxCholesky, dxPcg, 1e-6, "Checking the pcg solution");
+
+    // A loose forcing term yields a descent direction with a larger residual
+    pcg.setForcingTerm(0.5);
+    ASSERT_TRUE(pcg.solveSystem(dxInexact));
+    EXPECT_GT(dxInexact.dot(pcg.rhs()), 0.0);
+    EXPECT_GT((dxInexact - dxCholesky).norm(), 0.0);
+    EXPECT_ANY_THROW(pcg.setForcingTerm(1.0));
+    EXPECT_ANY_THROW(pcg.setForcingTerm(-0.1));
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
+TEST(LinearSolverTestSuite, testPcgForcingTermEuclideanResidual)
+{
+  const int D = 4;
+  const int E = 20;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  try {
+    buildSystem(D, E, dvs, errs);
+    BlockCholeskyLinearSystemSolver cholesky, pcg("pcg");
+    Eigen::VectorXd dxCholesky, dx;
+    for (BlockCholeskyLinearSystemSolver* S : {&cholesky, &pcg}) {
+      S->initMatrixStructure(dvs, errs, true);
+      S->setConstantConditioner(0.1);
+      S->evaluateError(1, false);
+      S->buildSystem(1, false);
+    }
+    ASSERT_TRUE(cholesky.solveSystem(dxCholesky));
+
+    // The Hessian stores the upper triangular blocks, the conditioned system adds the squared conditioner
+    Eigen::MatrixXd U;
+    pcg.Hessian()->toDenseInto(U);
+    const Eigen::MatrixXd A = Eigen::MatrixXd(U.selfadjointView<Eigen::Upper>()) + 0.01 * Eigen::MatrixXd::Identity(U.rows(), U.cols());
+    const Eigen::VectorXd& b = pcg.rhs();
+    ASSERT_LT((b - A * dxCholesky).norm(), 1e-8 * b.norm()) << "The dense system is the one solved";
+
+    for (double eta : {0.5, 0.1, 1e-3}) {
+      pcg.setForcingTerm(eta);
+      ASSERT_TRUE(pcg.solveSystem(dx));
+      EXPECT_LE((b - A * dx).norm(), eta * b.norm()) << "eta = " << eta;
+    }
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
+TEST(LinearSolverTestSuite, testBlockCholeskyJacobianSquaredNorm)
+{
+  const int D = 4;
+  const int E = 20;
+  std::vector<DesignVariable*> dvs;
+  std::vector<ErrorTerm*> errs;
+  try {
+    buildSystem(D, E, dvs, errs);
+    BlockCholeskyLinearSystemSolver block;
+    SparseCholeskyLinearSystemSolver sparse;
+    block.initMatrixStructure(dvs, errs, false);
+    block.evaluateError(1, false);
+    block.buildSystem(1, false);
+    sparse.initMatrixStructure(dvs, errs, false);
+    sparse.evaluateError(1, false);
+    sparse.buildSystem(1, false);
+    // The Hessian of the block solver only stores the upper triangular blocks, the Jacobian has off-diagonal blocks
+    const Eigen::VectorXd v = Eigen::VectorXd::Random(block.rhs().size());
+    double norm, expected;
+    ASSERT_TRUE(block.jacobianSquaredNorm(v, norm));
+    ASSERT_TRUE(sparse.jacobianSquaredNorm(v, expected));
+    EXPECT_NEAR(expected, norm, 1e-9 * expected);
+    deleteSystem(dvs, errs);
+  } catch (const std::exception& e) {
+    deleteSystem(dvs, errs);
+    FAIL() << e.what();
+  }
+}
+
 TEST(LinearSolverTestSuite, testSparseQR)
 {
   using namespace aslam::backend;
@@ -210,6 +210,68 @@ public:
 
 };
 
+/// \brief The Rosenbrock function as least squares problem, \f$ \mathbf e = (10 (v_1 - v_0^2), 1 - v_0) \f$.
+///        The minimum at (1, 1) lies at the end of a long curved valley.
+class RosenbrockErr : public aslam::backend::ErrorTermFs<2> {
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef aslam::backend::ErrorTermFs<2> parent_t;
+
+  Point2d* _p2d;
+
+  RosenbrockErr(Point2d* p2d) : _p2d(p2d) {
+    parent_t::setDesignVariables(_p2d);
+    setInvR(Eigen::Matrix2d::Identity());
+  }
+  ~RosenbrockErr() override {}
+
+  /// \brief evaluate the error term
+  double evaluateErrorImplementation() override {
+    const Eigen::Vector2d& v = _p2d->_v;
+    setError(Eigen::Vector2d(10.0*(v[1] - v[0]*v[0]), 1.0 - v[0]));
+    return evaluateChiSquaredError();
+  }
+
+  /// \brief evaluate the jacobian
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    Eigen::Matrix2d J;
+    J << -20.0*_p2d->_v[0], 10.0,
+         -1.0, 0.0;
+    outJ.add(_p2d, J);
+  }
+
+};
+
+/// \brief A prior on a point, \f$ \mathbf e = \mathbf v - \mathbf c \f$
+class PriorErr : public aslam::backend::ErrorTermFs<2> {
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  typedef aslam::backend::ErrorTermFs<2> parent_t;
+
+  Point2d* _p2d;
+  Eigen::Vector2d _c;
+
+  PriorErr(Point2d* p2d, const Eigen::Vector2d& c) : _p2d(p2d), _c(c) {
+    parent_t::setDesignVariables(_p2d);
+    setInvR(Eigen::Matrix2d::Identity());
+  }
+  ~PriorErr() override {}
+
+  /// \brief evaluate the error term
+  double evaluateErrorImplementation() override {
+    setError(_p2d->_v - _c);
+    return evaluateChiSquaredError();
+  }
+
+  /// \brief evaluate the jacobian
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p2d, Eigen::Matrix2d::Identity());
+  }
+
+};
+
 
 /// \brief Encodes the error \f$ (\mathbf p - \mathbf g \mathbf v^T)^2\f$
 class TestNonSquaredError : public aslam::backend::ScalarNonSquaredErrorTerm {
@@ -307,5 +369,34 @@ inline boost::shared_ptr<aslam::backend::OptimizationProblem> buildProblem(int s
   return problem;
 }
 
+/// \brief Priors on points with box bounds [0, 1]^2. Some prior means lie outside of the box, in one or both
+///        coordinates, the last point is unbounded. \p outExpected receives the constrained minimum of each point.
+inline boost::shared_ptr<aslam::backend::OptimizationProblem> buildBoxBoundedProblem(std::vector< boost::shared_ptr<Point2d> >& outPoints,
+                                                                                       std::vector<Eigen::Vector2d>& outExpected)
+{
+  using namespace aslam::backend;
+  const std::vector<Eigen::Vector2d> c = { Eigen::Vector2d(2.0, 3.0), Eigen::Vector2d(-1.0, -0.5), Eigen::Vector2d(0.5, 2.0),
+                                           Eigen::Vector2d(0.3, 0.7), Eigen::Vector2d(1.5, -2.0), Eigen::Vector2d(5.0, 5.0) };
+  boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+  outPoints.clear();
+  outExpected.clear();
+  for (std::size_t p = 0; p < c.size(); ++p) {
+    // the third point starts outside of the box
+    outPoints.emplace_back(new Point2d(p == 2 ? Eigen::Vector2d(2.0, 0.5) : Eigen::Vector2d::Constant(0.5)));
+    outPoints.back()->setBlockIndex(p);
+    outPoints.back()->setActive(true);
+    if (p + 1 < c.size()) {
+      outPoints.back()->setBounds(Eigen::Vector2d::Zero(), Eigen::Vector2d::Ones());
+      outExpected.push_back(c[p].cwiseMax(0.0).cwiseMin(1.0));
+    } else {
+      outExpected.push_back(c[p]);
+    }
+    problem->addDesignVariable(outPoints.back());
+    problem->addErrorTerm(boost::shared_ptr<ErrorTerm>(new PriorErr(outPoints.back().get(), c[p])));
+  }
+  outPoints[3]->setScaling(2.0);
+  return problem;
+}
+
 
 #endif /* _SAMPLEDVANDERROR_H_ */
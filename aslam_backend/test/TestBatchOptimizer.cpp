@@ -0,0 +1,92 @@
+#include <boost/shared_ptr.hpp>
+#include <sm/eigen/gtest.hpp>
+
+#include <aslam/backend/BatchOptimizer.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/SparseCholeskyLinearSystemSolver.hpp>
+#include <aslam/backend/BlockCholeskyLinearSystemSolver.hpp>
+
+#include "SampleDvAndError.hpp"
+
+TEST(BatchOptimizerTestSuite, testBatchMatchesSequential)
+{
+  using namespace aslam::backend;
+  const int P = 40;
+  const int D = 4;
+  const int E = 12;
+  try {
+    Optimizer2Options options;
+    options.verbose = false;
+    options.maxIterations = 20;
+
+    // Reference: one optimizer per problem, sequentially
+    std::vector<SolutionReturnValue> reference;
+    for (int p = 0; p < P; ++p) {
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(buildProblem(p, D, E));
+      reference.push_back(optimizer.optimize());
+    }
+
+    for (std::size_t numThreads : {1, 4}) {
+      std::vector< boost::shared_ptr<OptimizationProblemBase> > problems;
+      for (int p = 0; p < P; ++p)
+        problems.push_back(buildProblem(p, D, E));
+
+      BatchOptimizerOptions batchOptions;
+      batchOptions.optimizer = options;
+      batchOptions.numThreads = numThreads;
+      BatchOptimizer batch(batchOptions);
+      const BatchOptimizer::Status& status = batch.optimize(problems);
+
+      SCOPED_TRACE(::testing::Message() << "numThreads: " << numThreads);
+      EXPECT_EQ(numThreads, batch.numWorkers());
+      EXPECT_EQ(numThreads, status.numThreads);
+      EXPECT_EQ(0u, status.numExceptions);
+      EXPECT_GT(status.problemsPerSecond, 0.0);
+      ASSERT_EQ(std::size_t(P), status.results.size());
+      for (int p = 0; p < P; ++p) {
+        EXPECT_NE(ConvergenceStatus::FAILURE, status.convergence[p]);
+        EXPECT_EQ(reference[p].iterations, status.results[p].iterations);
+        EXPECT_NEAR(reference[p].JFinal, status.results[p].JFinal, 1e-9 * (1.0 + reference[p].JFinal));
+      }
+
+      // The workers and their solvers are reused for the next batch
+      for (int p = 0; p < P; ++p)
+        problems[p] = buildProblem(p, D, E);
+      batch.optimize(problems);
+      EXPECT_EQ(numThreads, batch.numWorkers());
+      for (int p = 0; p < P; ++p) {
+        EXPECT_NEAR(reference[p].JFinal, status.results[p].JFinal, 1e-9 * (1.0 + reference[p].JFinal));
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(BatchOptimizerTestSuite, testBatchOptions)
+{
+  using namespace aslam::backend;
+  BatchOptimizerOptions options;
+  options.optimizer.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+  EXPECT_ANY_THROW(BatchOptimizer batch(options));
+  options.optimizer.linearSystemSolver.reset();
+  options.linearSystemSolverFactory = []() { return boost::shared_ptr<LinearSystemSolver>(new BlockCholeskyLinearSystemSolver()); };
+  options.numThreads = 2;
+  BatchOptimizer batch(options);
+
+  // Failing problems are reported without aborting the batch
+  std::vector< boost::shared_ptr<OptimizationProblemBase> > problems;
+  problems.push_back(buildProblem(0, 4, 12));
+  problems.push_back(boost::shared_ptr<OptimizationProblemBase>());
+  problems.push_back(buildProblem(1, 4, 12));
+  const BatchOptimizer::Status& status = batch.optimize(problems);
+  EXPECT_EQ(1u, status.numExceptions);
+  EXPECT_EQ(ConvergenceStatus::FAILURE, status.convergence[1]);
+  EXPECT_NE(ConvergenceStatus::FAILURE, status.convergence[0]);
+  EXPECT_NE(ConvergenceStatus::FAILURE, status.convergence[2]);
+  EXPECT_LT(status.results[0].JFinal, status.results[0].JStart);
+
+  EXPECT_TRUE(batch.optimize({}).results.empty());
+}
@@ -154,3 +154,47 @@ TEST(LineSearchTestSuite, testLineSearch)
     FAIL() << e.what();
   }
 }
+
+TEST(LineSearchTestSuite, testLineSearchProjectedFallback)
+{
+  try {
+    using namespace aslam::backend;
+
+    // The first parameter sits at its lower bound, the search direction is a descent direction only by its first
+    // component, which the projection clips. Every projected step along it increases the error.
+    Point2d dv(Eigen::Vector2d(0.0, 0.5));
+    dv.setBlockIndex(0);
+    dv.setActive(true);
+    dv.setBounds(Eigen::Vector2d::Zero(), Eigen::Vector2d::Ones());
+    PriorErr errorTerm(&dv, Eigen::Vector2d(-1.0, 1.0));
+
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    problem_ptr->addDesignVariable(&dv, false);
+    problem_ptr->addErrorTerm(&errorTerm, false);
+
+    ProblemManager pm;
+    pm.setProblem(problem_ptr);
+    pm.checkProblemSetup();
+    pm.initialize();
+
+    auto costFunction = getCostFunction(pm, false, true, true, 1, 1);
+    LineSearch ls(costFunction);
+    RowVectorType searchDirection(2);
+    searchDirection << -1.0, -0.5;
+    ls.initialize(searchDirection);
+    const double error0 = ls.getError();
+    EXPECT_LT(ls.getErrorDerivative(), 0.0);
+
+    // The search falls back to the projected gradient, which only moves the second parameter up
+    RowVectorType step;
+    EXPECT_TRUE(ls.lineSearchProjected(0.5, &step));
+    EXPECT_LT(ls.getError(), error0);
+    EXPECT_DOUBLE_EQ(0.0, step[0]);
+    EXPECT_GT(step[1], 0.0);
+    EXPECT_DOUBLE_EQ(0.0, dv._v[0]);
+    EXPECT_GT(dv._v[1], 0.5);
+    EXPECT_LE(dv._v[1], 1.0);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
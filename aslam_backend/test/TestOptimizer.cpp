@@ -246,3 +246,62 @@ TEST(OptimizerTestSuite, testOptimizerNormalized)
 }
 
 
+
+TEST(OptimizerTestSuite, testCovarianceBetweenOptimizations)
+{
+  try {
+    using namespace aslam::backend;
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    OptimizationProblem& problem = *problem_ptr;
+    const int P = 4;
+    std::vector< boost::shared_ptr<Point2d> > p2d;
+    std::vector<Eigen::Vector2d> initial;
+    for (int p = 0; p < P; ++p) {
+      initial.push_back(Eigen::Vector2d::Random());
+      boost::shared_ptr<Point2d> point(new Point2d(initial.back()));
+      p2d.push_back(point);
+      problem.addDesignVariable(point);
+      point->setActive(true);
+    }
+    problem.addErrorTerm(boost::shared_ptr<PriorErr>(new PriorErr(p2d[0].get(), Eigen::Vector2d::Zero())));
+    for (int p = 1; p < P; ++p)
+      problem.addErrorTerm(boost::shared_ptr<LinearErr2>(new LinearErr2(p2d[p - 1].get(), p2d[p].get())));
+    problem.addErrorTerm(boost::shared_ptr<RosenbrockErr>(new RosenbrockErr(p2d[P - 1].get())));
+
+    OptimizerOptions options;
+    options.verbose = false;
+    options.linearSolver = "cholmod";
+    options.doSchurComplement = false;
+    options.doLevenbergMarquardt = false;
+    options.maxIterations = 2;
+
+    // The covariances are recovered from the factor of the last solve, the next optimization must not be affected
+    Optimizer optimizer(options);
+    optimizer.setProblem(problem_ptr);
+    optimizer.optimize();
+    optimizer.computeCovariances();
+    Eigen::MatrixXd invH = Eigen::MatrixXd(optimizer.H().toDense().selfadjointView<Eigen::Upper>()).inverse();
+    for (int r = 0; r < P; ++r) {
+      for (int c = r; c < P; ++c) {
+        const Eigen::MatrixXd* block = optimizer.getCovarianceBlock(p2d[r]->blockIndex(), p2d[c]->blockIndex());
+        ASSERT_TRUE(block != nullptr);
+        sm::eigen::assertNear(*block, invH.block<2, 2>(2 * p2d[r]->blockIndex(), 2 * p2d[c]->blockIndex()), 1e-8, SM_SOURCE_FILE_POS, "Covariance block");
+      }
+    }
+    optimizer.optimize();
+    std::vector<Eigen::Vector2d> withCovariance;
+    for (int p = 0; p < P; ++p)
+      withCovariance.push_back(p2d[p]->_v);
+
+    for (int p = 0; p < P; ++p)
+      p2d[p]->_v = p2d[p]->_p_v = initial[p];
+    Optimizer fresh(options);
+    fresh.setProblem(problem_ptr);
+    fresh.optimize();
+    fresh.optimize();
+    for (int p = 0; p < P; ++p)
+      sm::eigen::assertNear(withCovariance[p], p2d[p]->_v, 1e-10, SM_SOURCE_FILE_POS, "Optimizing after computing the covariances gives the state of an optimization without");
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
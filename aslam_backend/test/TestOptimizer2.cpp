@@ -1,6 +1,8 @@
 #include <boost/shared_ptr.hpp>
 #include <sm/eigen/gtest.hpp>
 #include <sm/random.hpp>
+#include <limits>
+#include <algorithm>
 
 #include <aslam/backend/Optimizer2.hpp>
 #include <aslam/backend/OptimizationProblem.hpp>
@@ -13,8 +15,91 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <aslam/backend/test/ErrorTermTester.hpp>
 
+#include <aslam/backend/EqualityConstraint.hpp>
 #include "SampleDvAndError.hpp"
 
+namespace {
+
+/// \brief The unit norm constraint \f$ \mathbf v^T \mathbf v - 1 = 0 \f$
+class UnitNormConstraint : public aslam::backend::EqualityConstraintFs<1> {
+public:
+  UnitNormConstraint(Point2d* p2d) : _p2d(p2d) {
+    setDesignVariables(p2d);
+  }
+private:
+  constraint_t evaluateConstraintImplementation() override {
+    return constraint_t::Constant(_p2d->_v.squaredNorm() - 1.0);
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p2d, Eigen::RowVector2d(2.0*_p2d->_v.transpose()));
+  }
+  Point2d* _p2d;
+};
+
+/// \brief The linear constraint \f$ v_0 + v_1 - 1 = 0 \f$
+class LinearConstraint : public aslam::backend::EqualityConstraintFs<1> {
+public:
+  LinearConstraint(Point2d* p2d) : _p2d(p2d) {
+    setDesignVariables(p2d);
+  }
+private:
+  constraint_t evaluateConstraintImplementation() override {
+    return constraint_t::Constant(_p2d->_v.sum() - 1.0);
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p2d, Eigen::RowVector2d::Ones());
+  }
+  Point2d* _p2d;
+};
+
+/// \brief A relative measurement between two points, \f$ \mathbf e = \mathbf v_1 - \mathbf v_0 - \mathbf m \f$. Invariant to translations.
+class RelativeErr : public aslam::backend::ErrorTermFs<2> {
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  RelativeErr(Point2d* p0, Point2d* p1, const Eigen::Vector2d& m) : _p0(p0), _p1(p1), _m(m) {
+    setDesignVariables(p0, p1);
+    setInvR(Eigen::Matrix2d::Identity());
+  }
+private:
+  double evaluateErrorImplementation() override {
+    setError(_p1->_v - _p0->_v - _m);
+    return evaluateChiSquaredError();
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p0, -Eigen::Matrix2d::Identity());
+    outJ.add(_p1, Eigen::Matrix2d::Identity());
+  }
+  Point2d* _p0;
+  Point2d* _p1;
+  Eigen::Vector2d _m;
+};
+
+/// \brief Exponential decay \f$ e = a_0 + a_1 \exp(-k t) - y \f$, separable into the linear \f$ \mathbf a \f$ and the nonlinear \f$ k \f$
+class ExpDecayErr : public aslam::backend::ErrorTermFs<1> {
+public:
+  ExpDecayErr(Point2d* a, Scalar* k, double t, double y) : _a(a), _k(k), _t(t), _y(y) {
+    setDesignVariables(a, k);
+    setInvR(Eigen::Matrix<double, 1, 1>::Identity());
+  }
+private:
+  double evaluateErrorImplementation() override {
+    setError(error_t::Constant(_a->_v[0] + _a->_v[1]*std::exp(-_k->_v[0]*_t) - _y));
+    return evaluateChiSquaredError();
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    const double decay = std::exp(-_k->_v[0]*_t);
+    outJ.add(_a, Eigen::RowVector2d(1.0, decay));
+    outJ.add(_k, Eigen::Matrix<double, 1, 1>::Constant(-_a->_v[1]*_t*decay));
+  }
+  Point2d* _a;
+  Scalar* _k;
+  double _t;
+  double _y;
+};
+
+} // namespace
+
 TEST(Optimizer2TestSuite, compareAllCombinationsOfSolversAndTrustRegionPolicies)
 {
   using namespace aslam::backend;
@@ -32,6 +117,7 @@ TEST(Optimizer2TestSuite, compareAllCombinationsOfSolversAndTrustRegionPolicies)
 
     std::vector<boost::shared_ptr<TrustRegionPolicy>> policies;
     policies.emplace_back(new DogLegTrustRegionPolicy());
+    policies.emplace_back(new SubspaceTrustRegionPolicy());
     policies.emplace_back(new GaussNewtonTrustRegionPolicy());
     policies.emplace_back(new LineSearchTrustRegionPolicy());
 
@@ -74,3 +160,750 @@ TEST(Optimizer2TestSuite, compareAllCombinationsOfSolversAndTrustRegionPolicies)
     FAIL() << e.what();
   }
 }
+
+TEST(Optimizer2TestSuite, testBlockCoordinateDescent)
+{
+  using namespace aslam::backend;
+  const int D = 6;
+  const int E = 30;
+  const int seed = 2;
+  try {
+    // Baseline: joint Gauss-Newton solve of the linear problem
+    boost::shared_ptr<OptimizationProblem> pb = buildProblem(seed, D, E);
+    Optimizer2Options options;
+    options.verbose = false;
+    options.trustRegionPolicy.reset(new GaussNewtonTrustRegionPolicy());
+    options.convergenceDeltaX = 1e-10;
+    options.convergenceDeltaError = 1e-14;
+    options.maxIterations = 500;
+    Optimizer2 baseline(options);
+    baseline.setProblem(pb);
+    baseline.optimize();
+
+    boost::shared_ptr<OptimizationProblem> pi = buildProblem(seed, D, E);
+    std::vector< std::vector<DesignVariable*> > groups(3);
+    for (int i = 0; i < D; ++i)
+      groups[i % groups.size()].push_back(pi->designVariable(i));
+
+    Optimizer2 optimizer(options);
+    optimizer.setProblem(pi);
+
+    // Groups must be disjoint
+    std::vector< std::vector<DesignVariable*> > overlapping = groups;
+    overlapping[1].push_back(groups[0].front());
+    optimizer.setBlockCoordinateGroups(overlapping);
+    EXPECT_ANY_THROW(optimizer.initialize());
+
+    optimizer.setBlockCoordinateGroups(groups);
+    EXPECT_FALSE(optimizer.isInitialized());
+    optimizer.initialize();
+    const double J0 = optimizer.evaluateError(false);
+    optimizer.optimize();
+    const Optimizer2::Status& status = optimizer.getStatus();
+    EXPECT_TRUE(optimizer.isInitialized());
+    EXPECT_GT(status.numIterations, 0);
+    EXPECT_LT(status.error, J0);
+    EXPECT_NEAR(baseline.getStatus().error, status.error, 1e-6 * (1.0 + baseline.getStatus().error));
+    for (size_t i = 0; i < pb->numDesignVariables(); ++i) {
+      sm::eigen::assertNear(static_cast<Point2d*>(pb->designVariable(i))->_v, static_cast<Point2d*>(pi->designVariable(i))->_v, 1e-4, SM_SOURCE_FILE_POS);
+    }
+
+    // The activation and indices of the full problem are restored after each sweep
+    int columnBase = 0;
+    for (size_t i = 0; i < pi->numDesignVariables(); ++i) {
+      DesignVariable* dv = pi->designVariable(i);
+      EXPECT_TRUE(dv->isActive());
+      EXPECT_EQ(int(i), dv->blockIndex());
+      EXPECT_EQ(columnBase, dv->columnBase());
+      columnBase += dv->minimalDimensions();
+    }
+    size_t rowBase = 0;
+    for (size_t j = 0; j < pi->numErrorTerms(); ++j) {
+      EXPECT_EQ(rowBase, pi->errorTerm(j)->rowBase());
+      rowBase += pi->errorTerm(j)->dimension();
+    }
+
+    // Back to joint optimization
+    optimizer.clearBlockCoordinateGroups();
+    EXPECT_TRUE(optimizer.getBlockCoordinateGroups().empty());
+    optimizer.optimize();
+    EXPECT_NEAR(baseline.getStatus().error, optimizer.getStatus().error, 1e-6 * (1.0 + baseline.getStatus().error));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testWarmStartTrustRegion)
+{
+  using namespace aslam::backend;
+  try {
+    const double decay = 0.5;
+    for (bool warmStart : {false, true}) {
+      SCOPED_TRACE(::testing::Message() << "warmStart: " << warmStart);
+      boost::shared_ptr<LevenbergMarquardtTrustRegionPolicy> lm(new LevenbergMarquardtTrustRegionPolicy(1e-3));
+      boost::shared_ptr<DogLegTrustRegionPolicy> dl(new DogLegTrustRegionPolicy());
+      for (boost::shared_ptr<TrustRegionPolicy> policy : std::vector< boost::shared_ptr<TrustRegionPolicy> >{lm, dl}) {
+        Optimizer2Options options;
+        options.maxIterations = 3;
+        options.trustRegionPolicy = policy;
+        options.warmStartTrustRegion = warmStart;
+        options.warmStartDecay = decay;
+        Optimizer2 optimizer(options);
+        optimizer.setProblem(buildProblem(3, 4, 12));
+        optimizer.optimize();
+        EXPECT_EQ(warmStart, policy->getWarmStart());
+        const double lambda = lm->getLambda();
+        const double delta = dl->getDelta();
+
+        // Without iterations, the state after the next optimizationStarting() call is visible
+        optimizer.options().maxIterations = 0;
+        optimizer.optimize();
+        if (policy == lm) {
+          EXPECT_DOUBLE_EQ(warmStart ? lambda * decay : 1e-3, lm->getLambda());
+        } else {
+          EXPECT_GT(delta, 0.0);
+          EXPECT_DOUBLE_EQ(warmStart ? delta / decay : 0.0, dl->getDelta());
+        }
+
+        // The state survives re-initialization for a new problem, unless reset explicitly
+        optimizer.setProblem(buildProblem(4, 4, 12));
+        optimizer.optimize();
+        if (policy == lm) {
+          EXPECT_DOUBLE_EQ(warmStart ? lambda * decay * decay : 1e-3, lm->getLambda());
+          lm->resetWarmStart();
+          optimizer.optimize();
+          EXPECT_DOUBLE_EQ(1e-3, lm->getLambda());
+        }
+      }
+    }
+
+    Optimizer2Options invalid;
+    invalid.warmStartDecay = 0.0;
+    EXPECT_ANY_THROW(Optimizer2 optimizer2(invalid));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testGeodesicAccelerationAndNonmonotoneAcceptance)
+{
+  using namespace aslam::backend;
+  try {
+    boost::shared_ptr<Point2d> point(new Point2d(Eigen::Vector2d(-1.2, 1.0)));
+    point->setActive(true);
+    point->setBlockIndex(0);
+    boost::shared_ptr<RosenbrockErr> err(new RosenbrockErr(point.get()));
+    {
+      SCOPED_TRACE("");
+      testErrorTerm(err);
+    }
+    boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+    problem->addDesignVariable(point);
+    problem->addErrorTerm(err);
+
+    // Iterations to convergence, indexed by acceleration, nonmonotone window and solver
+    int iterations[2][2][2];
+    for (bool acceleration : {false, true}) {
+      for (std::size_t window : {1, 5}) {
+        SCOPED_TRACE(::testing::Message() << "acceleration: " << acceleration << ", window: " << window);
+        boost::shared_ptr<LevenbergMarquardtTrustRegionPolicy> lm(new LevenbergMarquardtTrustRegionPolicy());
+        lm->setGeodesicAcceleration(acceleration);
+        lm->setNonmonotoneWindow(window);
+        EXPECT_DOUBLE_EQ(2.0, lm->acceptanceThreshold(2.0));
+        const std::vector< boost::shared_ptr<LinearSystemSolver> > solvers{
+            boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<LinearSystemSolver>(new DenseQrLinearSystemSolver())};
+        for (std::size_t s = 0; s < solvers.size(); ++s) {
+          const boost::shared_ptr<LinearSystemSolver>& solver = solvers[s];
+          SCOPED_TRACE(solver->name());
+          point->_v << -1.2, 1.0;
+          Optimizer2Options options;
+          options.maxIterations = 500;
+          options.convergenceDeltaX = 1e-10;
+          options.convergenceDeltaError = 1e-16;
+          options.linearSystemSolver = solver;
+          options.trustRegionPolicy = lm;
+          Optimizer2 optimizer(options);
+          optimizer.setProblem(problem);
+          const SolutionReturnValue srv = optimizer.optimize();
+          iterations[acceleration][window > 1][s] = srv.iterations;
+          // A rejected step only raises the damping, the Jacobian is evaluated once up front and after each accepted step
+          EXPECT_LE(optimizer.getStatus().numJacobianEvaluations, std::size_t(srv.iterations - srv.failedIterations + 1));
+          EXPECT_NEAR(1.0, point->_v[0], 1e-4);
+          EXPECT_NEAR(1.0, point->_v[1], 1e-4);
+          EXPECT_LT(srv.JFinal, 1e-8);
+          if (acceleration) {
+            EXPECT_GT(lm->getNumAcceleratedSteps(), 0u);
+          } else {
+            EXPECT_EQ(0u, lm->getNumAcceleratedSteps());
+          }
+        }
+      }
+    }
+    // The acceleration follows the curved valley, the nonmonotone acceptance keeps steps climbing its walls
+    for (std::size_t s = 0; s < 2; ++s) {
+      SCOPED_TRACE(s);
+      EXPECT_LT(iterations[true][false][s], iterations[false][false][s]);
+      EXPECT_LT(iterations[true][true][s], iterations[false][true][s]);
+      EXPECT_LE(iterations[false][true][s], iterations[false][false][s]);
+      EXPECT_LE(iterations[true][true][s], iterations[true][false][s]);
+    }
+
+    LevenbergMarquardtTrustRegionPolicy lm;
+    EXPECT_ANY_THROW(lm.setNonmonotoneWindow(0));
+    EXPECT_ANY_THROW(lm.setGeodesicAcceleration(true, 0.0));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testSubspaceTrustRegion)
+{
+  using namespace aslam::backend;
+  try {
+    // Three independent Rosenbrock valleys share the trust region
+    const std::vector<Eigen::Vector2d> starts{Eigen::Vector2d(-1.2, 1.0), Eigen::Vector2d(0.5, 2.0), Eigen::Vector2d(-2.0, -2.0)};
+    std::vector< boost::shared_ptr<Point2d> > points;
+    boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+    for (std::size_t i = 0; i < starts.size(); ++i) {
+      points.emplace_back(new Point2d(starts[i]));
+      points.back()->setActive(true);
+      points.back()->setBlockIndex(i);
+      problem->addDesignVariable(points.back());
+      problem->addErrorTerm(boost::shared_ptr<RosenbrockErr>(new RosenbrockErr(points.back().get())));
+    }
+
+    // The sparse Cholesky solver provides Jacobian products, the block Cholesky solver takes the fallback
+    for (boost::shared_ptr<LinearSystemSolver> solver : std::vector< boost::shared_ptr<LinearSystemSolver> >{
+        boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<LinearSystemSolver>(new BlockCholeskyLinearSystemSolver())}) {
+      std::vector<SolutionReturnValue> results;
+      for (boost::shared_ptr<TrustRegionPolicy> policy : std::vector< boost::shared_ptr<TrustRegionPolicy> >{
+          boost::shared_ptr<TrustRegionPolicy>(new DogLegTrustRegionPolicy()), boost::shared_ptr<TrustRegionPolicy>(new SubspaceTrustRegionPolicy())}) {
+        SCOPED_TRACE(::testing::Message() << solver->name() << ", " << policy->name());
+        for (std::size_t i = 0; i < starts.size(); ++i)
+          points[i]->_v = starts[i];
+        Optimizer2Options options;
+        options.maxIterations = 500;
+        options.convergenceDeltaX = 1e-10;
+        options.convergenceDeltaError = 1e-16;
+        options.linearSystemSolver = solver;
+        options.trustRegionPolicy = policy;
+        Optimizer2 optimizer(options);
+        optimizer.setProblem(problem);
+        results.push_back(optimizer.optimize());
+        for (const boost::shared_ptr<Point2d>& point : points) {
+          EXPECT_NEAR(1.0, point->_v[0], 1e-4);
+          EXPECT_NEAR(1.0, point->_v[1], 1e-4);
+        }
+        EXPECT_LT(results.back().JFinal, 1e-8);
+      }
+      // The exact subproblem solution in span(g, dxGn) beats the dog leg path
+      SCOPED_TRACE(solver->name());
+      EXPECT_LT(results[1].iterations, results[0].iterations);
+      EXPECT_LE(results[1].failedIterations, results[0].failedIterations);
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testBoxBounds)
+{
+  using namespace aslam::backend;
+  try {
+    for (boost::shared_ptr<LinearSystemSolver> solver : std::vector< boost::shared_ptr<LinearSystemSolver> >{
+        boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<LinearSystemSolver>(new BlockCholeskyLinearSystemSolver()),
+        boost::shared_ptr<LinearSystemSolver>(new DenseQrLinearSystemSolver())}) {
+      for (boost::shared_ptr<TrustRegionPolicy> policy : std::vector< boost::shared_ptr<TrustRegionPolicy> >{
+          boost::shared_ptr<TrustRegionPolicy>(new LevenbergMarquardtTrustRegionPolicy()), boost::shared_ptr<TrustRegionPolicy>(new DogLegTrustRegionPolicy())}) {
+        SCOPED_TRACE(::testing::Message() << solver->name() << ", " << policy->name());
+        std::vector< boost::shared_ptr<Point2d> > points;
+        std::vector<Eigen::Vector2d> expected;
+        boost::shared_ptr<OptimizationProblem> problem = buildBoxBoundedProblem(points, expected);
+
+        Optimizer2Options options;
+        options.maxIterations = 100;
+        options.convergenceDeltaX = 1e-12;
+        options.convergenceDeltaError = 0.0;
+        options.linearSystemSolver = solver;
+        options.trustRegionPolicy = policy;
+        Optimizer2 optimizer(options);
+        optimizer.setProblem(problem);
+        std::size_t minCols = std::numeric_limits<std::size_t>::max();
+        optimizer.callback().add<callback::event::LINEAR_SYSTEM_SOLVED>([&]() { minCols = std::min(minCols, optimizer.getBaseSolver()->JCols()); });
+        optimizer.optimize();
+
+        // The three points with both coordinates at a bound drop out of the linear system
+        EXPECT_EQ(2u*(points.size() - 3), minCols);
+        EXPECT_EQ(2u*points.size(), optimizer.getBaseSolver()->JCols());
+        for (std::size_t p = 0; p < points.size(); ++p) {
+          EXPECT_TRUE(points[p]->isActive()) << "point " << p;
+          EXPECT_NEAR(expected[p][0], points[p]->_v[0], 1e-8) << "point " << p;
+          EXPECT_NEAR(expected[p][1], points[p]->_v[1], 1e-8) << "point " << p;
+          EXPECT_TRUE((points[p]->_v.array() >= 0.0).all() || !points[p]->hasBounds()) << "point " << p;
+          EXPECT_TRUE((points[p]->_v.array() <= 1.0).all() || !points[p]->hasBounds()) << "point " << p;
+        }
+      }
+    }
+
+    Point2d point(Eigen::Vector2d::Zero());
+    EXPECT_ANY_THROW(point.setBounds(Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones()));
+    EXPECT_ANY_THROW(point.setBounds(Eigen::Vector2d::Ones(), Eigen::Vector2d::Zero()));
+    EXPECT_NO_THROW(point.setBounds(Eigen::Vector2d::Zero(), Eigen::Vector2d::Ones()));
+    EXPECT_TRUE(point.hasBounds());
+    point.clearBounds();
+    EXPECT_FALSE(point.hasBounds());
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testEqualityConstraints)
+{
+  using namespace aslam::backend;
+  try {
+    for (boost::shared_ptr<LinearSystemSolver> solver : std::vector< boost::shared_ptr<LinearSystemSolver> >{
+        boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<LinearSystemSolver>(new DenseQrLinearSystemSolver())}) {
+      SCOPED_TRACE(solver->name());
+      // Priors pull the points away from the constraints
+      const Eigen::Vector2d c0(2.0, 1.0), c1(1.0, 2.0);
+      boost::shared_ptr<Point2d> p0(new Point2d(Eigen::Vector2d(1.0, 0.0))), p1(new Point2d(Eigen::Vector2d::Zero()));
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      int blockIndex = 0;
+      for (const boost::shared_ptr<Point2d>& p : {p0, p1}) {
+        p->setActive(true);
+        p->setBlockIndex(blockIndex++);
+        problem->addDesignVariable(p);
+      }
+      problem->addErrorTerm(boost::shared_ptr<ErrorTerm>(new PriorErr(p0.get(), c0)));
+      problem->addErrorTerm(boost::shared_ptr<ErrorTerm>(new PriorErr(p1.get(), c1)));
+      boost::shared_ptr<UnitNormConstraint> unitNorm(new UnitNormConstraint(p0.get()));
+      boost::shared_ptr<LinearConstraint> linear(new LinearConstraint(p1.get()));
+      problem->addErrorTerm(unitNorm);
+      problem->addErrorTerm(linear);
+      SCOPED_TRACE("");
+      testErrorTerm(unitNorm);
+
+      Optimizer2Options options;
+      options.maxIterations = 50;
+      options.convergenceDeltaX = 1e-10;
+      options.convergenceDeltaError = 1e-14;
+      options.constraintTolerance = 1e-9;
+      options.linearSystemSolver = solver;
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      optimizer.optimize();
+      const Optimizer2::Status& status = optimizer.getStatus();
+      EXPECT_TRUE(status.success());
+      EXPECT_GT(status.numAugmentedLagrangianIterations, 0u);
+      EXPECT_LE(status.constraintViolation, options.constraintTolerance);
+      EXPECT_LE(unitNorm->getPenalty(), options.maxPenalty);
+
+      // The projections of the prior means onto the constraints, with the multipliers of the KKT conditions
+      // 2 (v - c) + 2 lambda dc/dv = 0 of the objective (v - c)^2
+      sm::eigen::assertNear(p0->_v, c0.normalized(), 1e-7, SM_SOURCE_FILE_POS);
+      sm::eigen::assertNear(p1->_v, Eigen::Vector2d(0.0, 1.0), 1e-7, SM_SOURCE_FILE_POS);
+      EXPECT_NEAR(0.5*(std::sqrt(5.0) - 1.0), unitNorm->getMultipliers()[0], 1e-5);
+      EXPECT_NEAR(1.0, linear->getMultipliers()[0], 1e-5);
+    }
+
+    Point2d point(Eigen::Vector2d::Zero());
+    LinearConstraint constraint(&point);
+    EXPECT_ANY_THROW(constraint.setPenalty(0.0));
+    EXPECT_ANY_THROW(constraint.setMultipliers(Eigen::Vector2d::Zero()));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testGaugeDirections)
+{
+  using namespace aslam::backend;
+  try {
+    // A loop of inconsistent relative measurements, the solution is only defined up to a translation
+    const int P = 5;
+    std::vector<Eigen::Vector2d> initial, measurements;
+    for (int p = 0; p < P; ++p) {
+      initial.push_back(Eigen::Vector2d(std::cos(0.3*p), 0.5*std::sin(1.7*p)));
+      measurements.push_back(Eigen::Vector2d(std::cos(2.0*M_PI*(p + 1)/P) - std::cos(2.0*M_PI*p/P), std::sin(2.0*M_PI*(p + 1)/P) - std::sin(2.0*M_PI*p/P)) +
+                             0.05*Eigen::Vector2d(std::sin(3.1*p), std::cos(1.3*p)));
+    }
+    auto buildProblem = [&](std::vector< boost::shared_ptr<Point2d> >& points) {
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      points.clear();
+      for (int p = 0; p < P; ++p) {
+        points.emplace_back(new Point2d(initial[p]));
+        points.back()->setActive(true);
+        points.back()->setBlockIndex(p);
+        problem->addDesignVariable(points.back());
+      }
+      for (int p = 0; p < P; ++p)
+        problem->addErrorTerm(boost::shared_ptr<ErrorTerm>(new RelativeErr(points[p].get(), points[(p + 1) % P].get(), measurements[p])));
+      return problem;
+    };
+
+    // Reference: the classic gauge fixing by deactivating the first point
+    std::vector< boost::shared_ptr<Point2d> > reference;
+    boost::shared_ptr<OptimizationProblem> referenceProblem = buildProblem(reference);
+    reference[0]->setActive(false);
+    Optimizer2Options referenceOptions;
+    referenceOptions.maxIterations = 50;
+    referenceOptions.convergenceDeltaX = 1e-12;
+    referenceOptions.convergenceDeltaError = 1e-16;
+    Optimizer2 referenceOptimizer(referenceOptions);
+    referenceOptimizer.setProblem(referenceProblem);
+    const SolutionReturnValue referenceSrv = referenceOptimizer.optimize();
+
+    // The translation directions of all points
+    Eigen::MatrixXd translations(2*P, 2);
+    for (int p = 0; p < P; ++p)
+      translations.middleRows(2*p, 2).setIdentity();
+
+    std::vector< std::pair< boost::shared_ptr<LinearSystemSolver>, boost::shared_ptr<TrustRegionPolicy> > > setups = {
+      { boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<TrustRegionPolicy>(new GaussNewtonTrustRegionPolicy()) },
+      { boost::shared_ptr<LinearSystemSolver>(new SparseCholeskyLinearSystemSolver()), boost::shared_ptr<TrustRegionPolicy>(new LevenbergMarquardtTrustRegionPolicy()) },
+      { boost::shared_ptr<LinearSystemSolver>(new BlockCholeskyLinearSystemSolver()), boost::shared_ptr<TrustRegionPolicy>(new DogLegTrustRegionPolicy()) },
+      { boost::shared_ptr<LinearSystemSolver>(new DenseQrLinearSystemSolver()), boost::shared_ptr<TrustRegionPolicy>(new GaussNewtonTrustRegionPolicy()) }
+    };
+    for (auto& setup : setups) {
+      SCOPED_TRACE(::testing::Message() << setup.first->name() << ", " << setup.second->name());
+      std::vector< boost::shared_ptr<Point2d> > points;
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(points);
+      Optimizer2Options options = referenceOptions;
+      options.linearSystemSolver = setup.first;
+      options.trustRegionPolicy = setup.second;
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      optimizer.setGaugeDirections(translations);
+      EXPECT_TRUE(optimizer.hasGaugeDirections());
+      optimizer.initialize();
+      // New directions spanning the same space need no re-initialization
+      optimizer.setGaugeDirections(Eigen::MatrixXd(translations * (Eigen::Matrix2d() << 1.0, 2.0, -1.0, 1.0).finished()));
+      EXPECT_TRUE(optimizer.isInitialized());
+      const SolutionReturnValue srv = optimizer.optimize();
+      EXPECT_FALSE(srv.linearSolverFailure);
+      EXPECT_NEAR(referenceSrv.JFinal, srv.JFinal, 1e-10);
+
+      // The minimum norm steps never move the centroid, the shape is the one of the reference solution
+      Eigen::Vector2d centroid = Eigen::Vector2d::Zero(), initialCentroid = Eigen::Vector2d::Zero();
+      for (int p = 0; p < P; ++p) {
+        centroid += points[p]->_v / P;
+        initialCentroid += initial[p] / P;
+      }
+      sm::eigen::assertNear(initialCentroid, centroid, 1e-10, SM_SOURCE_FILE_POS);
+      for (int p = 1; p < P; ++p) {
+        sm::eigen::assertNear(reference[p]->_v - reference[0]->_v, points[p]->_v - points[0]->_v, 1e-8, SM_SOURCE_FILE_POS);
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testIrlsJacobianReuse)
+{
+  using namespace aslam::backend;
+  try {
+    const int P = 3;
+    const int M = 8;
+    // Robust averaging of measurements with outliers. The Jacobian is constant, reweighting it must reproduce the evaluated one.
+    auto buildProblem = [&](std::vector< boost::shared_ptr<Point2d> >& points) {
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      boost::shared_ptr<MEstimator> mEstimator(new CauchyMEstimator(0.1));
+      for (int p = 0; p < P; ++p) {
+        points.emplace_back(new Point2d(Eigen::Vector2d::Zero()));
+        points.back()->setBlockIndex(p);
+        points.back()->setActive(true);
+        problem->addDesignVariable(points.back());
+        for (int m = 0; m < M; ++m) {
+          Eigen::Vector2d c(p + 0.1*std::sin(3.0*m + p), 1.0 - 0.1*std::cos(2.0*m));
+          if (m % 4 == 3)
+            c += Eigen::Vector2d(5.0, -3.0 - m); // outliers
+          boost::shared_ptr<PriorErr> err(new PriorErr(points.back().get(), c));
+          err->setMEstimatorPolicy(mEstimator);
+          problem->addErrorTerm(err);
+        }
+      }
+      return problem;
+    };
+
+    typedef std::pair< boost::function<LinearSystemSolver*()>, boost::function<TrustRegionPolicy*()> > Setup;
+    std::vector<Setup> setups = {
+      Setup([]() { return new SparseCholeskyLinearSystemSolver(); }, []() { return new LevenbergMarquardtTrustRegionPolicy(); }),
+      Setup([]() { return new SparseCholeskyLinearSystemSolver(); }, []() { return new GaussNewtonTrustRegionPolicy(); }),
+      Setup([]() { return new SparseQrLinearSystemSolver(); }, []() { return new GaussNewtonTrustRegionPolicy(); }),
+      Setup([]() { return new DenseQrLinearSystemSolver(); }, []() { return new DogLegTrustRegionPolicy(); }),
+      Setup([]() { return new BlockCholeskyLinearSystemSolver(); }, []() { return new LevenbergMarquardtTrustRegionPolicy(); })
+    };
+    for (auto& setup : setups) {
+      std::vector< boost::shared_ptr<Point2d> > points[2];
+      Optimizer2::Status status[2];
+      for (int irls = 0; irls < 2; ++irls) {
+        boost::shared_ptr<OptimizationProblem> problem = buildProblem(points[irls]);
+        Optimizer2Options options;
+        options.maxIterations = 50;
+        options.convergenceDeltaX = 1e-10;
+        options.convergenceDeltaError = 0.0;
+        options.irlsJacobianReuse = irls*3;
+        options.linearSystemSolver.reset(setup.first());
+        options.trustRegionPolicy.reset(setup.second());
+        Optimizer2 optimizer(options);
+        optimizer.setProblem(problem);
+        optimizer.optimize();
+        status[irls] = optimizer.getStatus();
+      }
+      const boost::shared_ptr<LinearSystemSolver> solver(setup.first());
+      const boost::shared_ptr<TrustRegionPolicy> policy(setup.second());
+      SCOPED_TRACE(::testing::Message() << solver->name() << ", " << policy->name());
+      EXPECT_GT(status[1].convergence, ConvergenceStatus::FAILURE);
+      EXPECT_EQ(status[0].numIterations, status[1].numIterations);
+      EXPECT_EQ(0u, status[0].numJacobianReuses);
+      if (solver->name().compare(0, 6, "block_") == 0) {
+        // Does not keep the Jacobian
+        EXPECT_EQ(0u, status[1].numJacobianReuses);
+      } else {
+        EXPECT_GT(status[1].numJacobianReuses, 0u);
+        EXPECT_LT(status[1].numJacobianEvaluations, status[0].numJacobianEvaluations);
+      }
+      for (int p = 0; p < P; ++p) {
+        sm::eigen::assertNear(points[0][p]->_v, points[1][p]->_v, 1e-8, SM_SOURCE_FILE_POS);
+        // The outliers are down-weighted
+        EXPECT_NEAR(1.0, points[1][p]->_v[1], 0.2) << "point " << p;
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testIrlsJacobianReuseRestart)
+{
+  using namespace aslam::backend;
+  try {
+    // The Jacobian of the Rosenbrock error depends on the state. A second optimization of the same optimizer, started
+    // from a changed state, must not reweight the Jacobian the first one ended with.
+    const Eigen::Vector2d start(-1.2, 1.0);
+    std::vector< boost::shared_ptr<Point2d> > points;
+    Optimizer2::Status status[2];
+    for (int run = 0; run < 2; ++run) {
+      points.emplace_back(new Point2d(start));
+      points.back()->setActive(true);
+      points.back()->setBlockIndex(0);
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      problem->addDesignVariable(points.back());
+      problem->addErrorTerm(boost::shared_ptr<RosenbrockErr>(new RosenbrockErr(points.back().get())));
+      Optimizer2Options options;
+      options.maxIterations = 500;
+      options.convergenceDeltaX = 1e-10;
+      options.convergenceDeltaError = 0.0;
+      options.irlsJacobianReuse = 2;
+      options.linearSystemSolver.reset(new SparseCholeskyLinearSystemSolver());
+      options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      if (run == 1) {
+        optimizer.optimize();
+        points.back()->_v = start;
+      }
+      optimizer.optimize();
+      status[run] = optimizer.getStatus();
+    }
+    EXPECT_GT(status[0].numJacobianReuses, 0u);
+    EXPECT_EQ(status[0].numIterations, status[1].numIterations);
+    EXPECT_EQ(status[0].numJacobianEvaluations, status[1].numJacobianEvaluations);
+    EXPECT_EQ(status[0].numJacobianReuses, status[1].numJacobianReuses);
+    sm::eigen::assertNear(points[0]->_v, points[1]->_v, 1e-12, SM_SOURCE_FILE_POS);
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testForcingTerms)
+{
+  using namespace aslam::backend;
+  const int D = 6;
+  const int E = 30;
+  const int seed = 3;
+  try {
+    Optimizer2Options options;
+    options.maxIterations = 100;
+    options.convergenceDeltaX = 1e-10;
+    options.convergenceDeltaError = 0.0;
+    options.linearSystemSolver.reset(new BlockCholeskyLinearSystemSolver());
+    options.trustRegionPolicy.reset(new LevenbergMarquardtTrustRegionPolicy());
+    Optimizer2 reference(options);
+    reference.setProblem(buildProblem(seed, D, E));
+    const SolutionReturnValue referenceSrv = reference.optimize();
+
+    for (boost::shared_ptr<TrustRegionPolicy> policy : std::vector< boost::shared_ptr<TrustRegionPolicy> >{
+        boost::shared_ptr<TrustRegionPolicy>(new LevenbergMarquardtTrustRegionPolicy()), boost::shared_ptr<TrustRegionPolicy>(new GaussNewtonTrustRegionPolicy())}) {
+      SCOPED_TRACE(policy->name());
+      options.linearSystemSolver.reset(new BlockCholeskyLinearSystemSolver("pcg"));
+      options.trustRegionPolicy = policy;
+      options.maxForcingTerm = 0.5;
+      Optimizer2 optimizer(options);
+      EXPECT_DOUBLE_EQ(0.5, policy->getMaxForcingTerm());
+      optimizer.setProblem(buildProblem(seed, D, E));
+      std::vector<double> forcingTerms;
+      optimizer.callback().add<callback::event::LINEAR_SYSTEM_SOLVED>([&]() { forcingTerms.push_back(optimizer.getBaseSolver()->getForcingTerm()); });
+      const SolutionReturnValue srv = optimizer.optimize();
+      EXPECT_FALSE(srv.linearSolverFailure);
+      EXPECT_NEAR(referenceSrv.JFinal, srv.JFinal, 1e-8*referenceSrv.JFinal);
+
+      // The first system is solved loosely, later ones more accurately as the gradient vanishes
+      ASSERT_FALSE(forcingTerms.empty());
+      EXPECT_DOUBLE_EQ(0.5, forcingTerms.front());
+      EXPECT_LT(*std::min_element(forcingTerms.begin(), forcingTerms.end()), 0.1);
+      for (double eta : forcingTerms) {
+        EXPECT_GT(eta, 0.0);
+        EXPECT_LE(eta, 0.5);
+      }
+    }
+
+    // Disabling the forcing terms asks the solver for full precision again
+    options.trustRegionPolicy->setForcingTerms(0.0);
+    EXPECT_EQ(0.0, options.linearSystemSolver->getForcingTerm());
+    EXPECT_ANY_THROW(options.trustRegionPolicy->setForcingTerms(1.0));
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(Optimizer2TestSuite, testVariableProjection)
+{
+  using namespace aslam::backend;
+  try {
+    const int N = 30;
+    std::vector<double> t, y;
+    for (int i = 0; i < N; ++i) {
+      t.push_back(0.1*i);
+      y.push_back(0.5 + 2.0*std::exp(-1.5*t.back()) + 0.01*std::sin(7.0*i));
+    }
+    auto buildProblem = [&](boost::shared_ptr<Point2d>& a, boost::shared_ptr<Scalar>& k) {
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      a.reset(new Point2d(Eigen::Vector2d::Zero()));
+      k.reset(new Scalar(Scalar::Vector1d::Constant(0.2)));
+      a->setActive(true);
+      k->setActive(true);
+      problem->addDesignVariable(a);
+      problem->addDesignVariable(k);
+      for (int i = 0; i < N; ++i) {
+        boost::shared_ptr<ExpDecayErr> err(new ExpDecayErr(a.get(), k.get(), t[i], y[i]));
+        if (i == 0) {
+          SCOPED_TRACE("");
+          testErrorTerm(err);
+        }
+        problem->addErrorTerm(err);
+      }
+      return problem;
+    };
+
+    for (int config = 0; config < 4; ++config) {
+      const bool denseQr = config / 2, gaussNewton = config % 2;
+      SCOPED_TRACE(::testing::Message() << "denseQr: " << denseQr << ", gaussNewton: " << gaussNewton);
+      boost::shared_ptr<Point2d> a[2];
+      boost::shared_ptr<Scalar> k[2];
+      Optimizer2::Status status[2];
+      std::size_t maxCols[2] = {0, 0};
+      for (int varpro = 0; varpro < 2; ++varpro) {
+        boost::shared_ptr<OptimizationProblem> problem = buildProblem(a[varpro], k[varpro]);
+        Optimizer2Options options;
+        options.maxIterations = 100;
+        options.convergenceDeltaX = 1e-10;
+        options.convergenceDeltaError = 0.0;
+        if (denseQr)
+          options.linearSystemSolver.reset(new DenseQrLinearSystemSolver());
+        if (gaussNewton)
+          options.trustRegionPolicy.reset(new GaussNewtonTrustRegionPolicy());
+        Optimizer2 optimizer(options);
+        optimizer.setProblem(problem);
+        if (varpro)
+          optimizer.setLinearDesignVariables({a[varpro].get()});
+        optimizer.callback().add<callback::event::LINEAR_SYSTEM_SOLVED>([&]() { maxCols[varpro] = std::max(maxCols[varpro], optimizer.getBaseSolver()->JCols()); });
+        optimizer.optimize();
+        status[varpro] = optimizer.getStatus();
+        // The linear system of the full problem is restored after the optimization
+        EXPECT_EQ(3u, optimizer.getBaseSolver()->JCols());
+        EXPECT_TRUE(a[varpro]->isActive());
+        if (varpro)
+          EXPECT_EQ(1u, optimizer.getLinearDesignVariables().size());
+      }
+      EXPECT_GT(status[1].convergence, ConvergenceStatus::FAILURE);
+      EXPECT_EQ(0u, status[0].numVariableProjections);
+      EXPECT_GT(status[1].numVariableProjections, 0u);
+      // The outer system only has the column of the decay rate and the reduced problem converges faster
+      EXPECT_EQ(3u, maxCols[0]);
+      EXPECT_EQ(1u, maxCols[1]);
+      EXPECT_LT(status[1].numIterations, status[0].numIterations);
+      EXPECT_NEAR(1.5, k[1]->_v[0], 0.05);
+      EXPECT_NEAR(k[0]->_v[0], k[1]->_v[0], 1e-6);
+      sm::eigen::assertNear(a[0]->_v, a[1]->_v, 1e-6, SM_SOURCE_FILE_POS);
+
+      // The linear parameters are the least-squares solution for the final decay rate
+      Eigen::MatrixXd A(N, 2);
+      Eigen::VectorXd b(N);
+      for (int i = 0; i < N; ++i) {
+        A.row(i) << 1.0, std::exp(-k[1]->_v[0]*t[i]);
+        b[i] = y[i];
+      }
+      const Eigen::Vector2d expected = A.colPivHouseholderQr().solve(b);
+      sm::eigen::assertNear(expected, a[1]->_v, 1e-8, SM_SOURCE_FILE_POS);
+    }
+
+    {
+      // The undamped Gauss-Newton step of the reduced system is Kaufman's step in the decay rate
+      boost::shared_ptr<Point2d> a;
+      boost::shared_ptr<Scalar> k;
+      boost::shared_ptr<OptimizationProblem> problem = buildProblem(a, k);
+      const double k0 = k->_v[0];
+      Eigen::MatrixXd A(N, 2);
+      Eigen::VectorXd b(N);
+      for (int i = 0; i < N; ++i) {
+        A.row(i) << 1.0, std::exp(-k0*t[i]);
+        b[i] = y[i];
+      }
+      const Eigen::Vector2d a0 = A.colPivHouseholderQr().solve(b);
+      const Eigen::VectorXd r = A*a0 - b;
+      Eigen::VectorXd Jk(N);
+      for (int i = 0; i < N; ++i)
+        Jk[i] = -a0[1]*t[i]*std::exp(-k0*t[i]);
+      // The Jacobian of the decay rate projected onto the orthogonal complement of the range of A
+      const Eigen::VectorXd Jr = Jk - A*(A.transpose()*A).ldlt().solve(A.transpose()*Jk);
+      const double expectedK = k0 - Jr.dot(r)/Jr.dot(Jr);
+
+      Optimizer2Options options;
+      options.maxIterations = 1;
+      options.trustRegionPolicy.reset(new GaussNewtonTrustRegionPolicy());
+      Optimizer2 optimizer(options);
+      optimizer.setProblem(problem);
+      optimizer.setLinearDesignVariables({a.get()});
+      optimizer.optimize();
+      EXPECT_EQ(1u, optimizer.getStatus().numIterations);
+      EXPECT_NEAR(expectedK, k->_v[0], 1e-10);
+    }
+
+    // Linear design variables must be unbounded and are not supported in block-coordinate mode or by solvers without error projection
+    boost::shared_ptr<Point2d> a;
+    boost::shared_ptr<Scalar> k;
+    boost::shared_ptr<OptimizationProblem> problem = buildProblem(a, k);
+    Optimizer2 optimizer;
+    optimizer.setProblem(problem);
+    optimizer.setLinearDesignVariables({a.get()});
+    optimizer.setBlockCoordinateGroups({{a.get()}, {k.get()}});
+    EXPECT_ANY_THROW(optimizer.initialize());
+    optimizer.clearBlockCoordinateGroups();
+    a->setBounds(Eigen::Vector2d::Constant(-10.0), Eigen::Vector2d::Constant(10.0));
+    EXPECT_ANY_THROW(optimizer.initialize());
+    a->clearBounds();
+    EXPECT_NO_THROW(optimizer.initialize());
+    optimizer.clearLinearDesignVariables();
+    EXPECT_TRUE(optimizer.getLinearDesignVariables().empty());
+    Optimizer2Options blockOptions;
+    blockOptions.linearSystemSolver.reset(new BlockCholeskyLinearSystemSolver());
+    Optimizer2 blockOptimizer(blockOptions);
+    blockOptimizer.setProblem(problem);
+    blockOptimizer.setLinearDesignVariables({a.get()});
+    EXPECT_ANY_THROW(blockOptimizer.initialize());
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -69,6 +69,8 @@ TEST(OptimizerBFGSTestSuite, testBFGS)
     EXPECT_LE(ret.gradientNorm, options.convergenceGradientNorm);
     EXPECT_GT(ret.numErrorEvaluations, 0);
     EXPECT_GT(ret.numJacobianEvaluations, 0);
+    EXPECT_GT(ret.numErrorAndGradientEvaluations, 0);
+    EXPECT_LE(ret.numErrorAndGradientEvaluations, std::min(ret.numErrorEvaluations, ret.numJacobianEvaluations));
     EXPECT_GE(ret.error, 0.0);
     EXPECT_LT(ret.deltaError, 1e-12);
     EXPECT_LT(ret.maxDeltaX, 1e-3);
@@ -79,3 +81,31 @@ TEST(OptimizerBFGSTestSuite, testBFGS)
     FAIL() << e.what();
   }
 }
+
+TEST(OptimizerBFGSTestSuite, testBFGSBoxBounds)
+{
+  try {
+    using namespace aslam::backend;
+    std::vector< boost::shared_ptr<Point2d> > points;
+    std::vector<Eigen::Vector2d> expected;
+    boost::shared_ptr<OptimizationProblem> problem = buildBoxBoundedProblem(points, expected);
+
+    OptimizerBFGS::Options options;
+    options.maxIterations = 200;
+    options.convergenceGradientNorm = 1e-10;
+    OptimizerBFGS optimizer(options);
+    optimizer.setProblem(problem);
+    optimizer.initialize();
+    optimizer.optimize();
+    const auto& ret = optimizer.getStatus();
+    EXPECT_GT(ret.convergence, ConvergenceStatus::FAILURE);
+    // the gradient is projected, the components pushing against active bounds do not count
+    EXPECT_LE(ret.gradientNorm, options.convergenceGradientNorm);
+    for (std::size_t p = 0; p < points.size(); ++p) {
+      EXPECT_NEAR(expected[p][0], points[p]->_v[0], 1e-8) << "point " << p;
+      EXPECT_NEAR(expected[p][1], points[p]->_v[1], 1e-8) << "point " << p;
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
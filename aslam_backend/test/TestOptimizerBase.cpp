@@ -96,6 +96,7 @@ TEST(OptimizerTestSuite, testOptimizerOptions)
     pt.setInt("maxIterations", 1);
     pt.setInt("numThreadsJacobian", 1);
     pt.setInt("numThreadsError", 4);
+    pt.setDouble("maxTimeMs", 5.0);
     EXPECT_ANY_THROW(OptimizerOptionsBase options(pt)); // invalid option convergenceGradientNorm
     pt.setDouble("convergenceGradientNorm", 1.0);
     OptimizerOptionsBase options(pt);
@@ -105,6 +106,7 @@ TEST(OptimizerTestSuite, testOptimizerOptions)
     EXPECT_EQ(pt.getInt("maxIterations"), options.maxIterations);
     EXPECT_EQ(pt.getInt("numThreadsJacobian"), options.numThreadsJacobian);
     EXPECT_EQ(pt.getInt("numThreadsError"), options.numThreadsError);
+    EXPECT_DOUBLE_EQ(pt.getDouble("maxTimeMs"), options.maxTimeMs);
   }
 }
 
@@ -0,0 +1,136 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/OptimizerLBFGS.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <sm/BoostPropertyTree.hpp>
+#include <sm/random.hpp>
+#include <aslam/backend/test/ErrorTermTester.hpp>
+#include "SampleDvAndError.hpp"
+
+TEST(OptimizerLBFGSTestSuite, testLBFGS)
+{
+  try {
+    using namespace aslam::backend;
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    OptimizationProblem& problem = *problem_ptr;
+
+    const int P = 2;
+    const int E = 3;
+    // Add some design variables.
+    std::vector< boost::shared_ptr<Point2d> > p2d;
+    p2d.reserve(P);
+    for (int p = 0; p < P; ++p) {
+      boost::shared_ptr<Point2d> point(new Point2d(Eigen::Vector2d::Random())); // random initialization of design variable
+      p2d.push_back(point);
+      problem.addDesignVariable(point);
+      point->setBlockIndex(p);
+      point->setActive(true);
+    }
+
+    // make a deep copy
+    std::vector< boost::shared_ptr<Point2d> > p2d0;
+    p2d0.reserve(p2d.size());
+    for (auto& dv : p2d) p2d0.emplace_back(new Point2d(*dv));
+
+    // Add some error terms.
+    std::vector< boost::shared_ptr<TestNonSquaredError> > e1;
+    e1.reserve(P*E);
+    for (int p = 0; p < P; ++p) {
+      for (int e = 0; e < E; ++e) {
+        TestNonSquaredError::grad_t g(p+1, e+1);
+        boost::shared_ptr<TestNonSquaredError> err(new TestNonSquaredError(p2d[p].get(), g));
+        err->_p = 1.0;
+        e1.push_back(err);
+        problem.addErrorTerm(err);
+        SCOPED_TRACE("");
+        testErrorTerm(err);
+      }
+    }
+    // Now let's optimize.
+    OptimizerLBFGS::Options options;
+    options.maxIterations = 500;
+    options.numThreadsJacobian = 8;
+    options.convergenceGradientNorm = 1e-15;
+    options.historySize = 0;
+    EXPECT_ANY_THROW(options.check());
+
+    // a history of one pair exercises the ring buffer wrap-around in every iteration
+    for (std::size_t historySize : {1, 2, 10}) {
+      options.historySize = historySize;
+      EXPECT_NO_THROW(options.check());
+      OptimizerLBFGS optimizer(options);
+      optimizer.setProblem(problem_ptr);
+
+      // Test that linesearch options are correctly forwarded
+      options.linesearch.initialStepLength = 1.1;
+      optimizer.setOptions(options);
+      EXPECT_DOUBLE_EQ(options.linesearch.initialStepLength, optimizer.getLineSearch().options().initialStepLength);
+
+      EXPECT_NO_THROW(optimizer.checkProblemSetup());
+
+      for (std::size_t i=0; i<p2d.size(); i++) p2d[i]->_v = p2d0[i]->_v;
+      optimizer.initialize();
+      SCOPED_TRACE("");
+      optimizer.optimize();
+      const auto& ret = optimizer.getStatus();
+
+      EXPECT_GT(ret.convergence, ConvergenceStatus::FAILURE);
+      EXPECT_LE(ret.gradientNorm, options.convergenceGradientNorm);
+      EXPECT_GT(ret.numErrorEvaluations, 0);
+      EXPECT_GT(ret.numJacobianEvaluations, 0);
+      EXPECT_GE(ret.error, 0.0);
+      EXPECT_LT(ret.deltaError, 1e-12);
+      EXPECT_LT(ret.maxDeltaX, 1e-3);
+      EXPECT_LT(ret.error, std::numeric_limits<double>::max());
+      EXPECT_GT(ret.numIterations, 0);
+      EXPECT_LE(optimizer.getHistoryLength(), historySize);
+    }
+
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizerLBFGSTestSuite, testLBFGSBoxBounds)
+{
+  try {
+    using namespace aslam::backend;
+    std::vector< boost::shared_ptr<Point2d> > points;
+    std::vector<Eigen::Vector2d> expected;
+    boost::shared_ptr<OptimizationProblem> problem = buildBoxBoundedProblem(points, expected);
+
+    OptimizerLBFGS::Options options;
+    options.maxIterations = 200;
+    options.convergenceGradientNorm = 1e-10;
+    OptimizerLBFGS optimizer(options);
+    optimizer.setProblem(problem);
+    optimizer.initialize();
+    optimizer.optimize();
+    const auto& ret = optimizer.getStatus();
+    EXPECT_GT(ret.convergence, ConvergenceStatus::FAILURE);
+    // the gradient is projected, the components pushing against active bounds do not count
+    EXPECT_LE(ret.gradientNorm, options.convergenceGradientNorm);
+    for (std::size_t p = 0; p < points.size(); ++p) {
+      EXPECT_NEAR(expected[p][0], points[p]->_v[0], 1e-8) << "point " << p;
+      EXPECT_NEAR(expected[p][1], points[p]->_v[1], 1e-8) << "point " << p;
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizerLBFGSTestSuite, testLBFGSOptions)
+{
+  using namespace aslam::backend;
+  sm::BoostPropertyTree pt;
+  pt.setInt("historySize", 0); // invalid
+  pt.setBool("useDenseJacobianContainer", false);
+  pt.setDouble("linesearch/initialStepLength", 0.5);
+  EXPECT_ANY_THROW(OptimizerOptionsLBFGS options(pt));
+  pt.setInt("historySize", 7);
+  OptimizerOptionsLBFGS options(pt);
+  EXPECT_EQ(7u, options.historySize);
+  EXPECT_FALSE(options.useDenseJacobianContainer);
+  EXPECT_DOUBLE_EQ(0.5, options.linesearch.initialStepLength);
+  EXPECT_NO_THROW(OptimizerLBFGS optimizer(pt));
+}
@@ -0,0 +1,197 @@
+#include <chrono>
+#include <iomanip>
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/OptimizerNCG.hpp>
+#include <aslam/backend/OptimizerBFGS.hpp>
+#include <aslam/backend/OptimizerRprop.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <sm/BoostPropertyTree.hpp>
+#include <sm/random.hpp>
+#include <aslam/backend/test/ErrorTermTester.hpp>
+#include "SampleDvAndError.hpp"
+
+namespace {
+
+/// \brief Test problem of \p P two-dimensional points with \p E squared or non-squared error terms each
+struct TestProblem {
+  boost::shared_ptr<aslam::backend::OptimizationProblem> problem { new aslam::backend::OptimizationProblem };
+  std::vector< boost::shared_ptr<Point2d> > p2d;
+  std::vector< boost::shared_ptr<Point2d> > p2d0; /// \brief Deep copy of the initial state
+  std::vector< boost::shared_ptr<TestNonSquaredError> > errNS;
+
+  TestProblem(const int P, const int E, const bool squared) {
+    using namespace aslam::backend;
+    p2d.reserve(P);
+    for (int p = 0; p < P; ++p) {
+      boost::shared_ptr<Point2d> point(new Point2d(Eigen::Vector2d::Random())); // random initialization of design variable
+      p2d.push_back(point);
+      problem->addDesignVariable(point);
+      point->setBlockIndex(p);
+      point->setActive(true);
+    }
+    for (int p = 0; p < P; ++p) {
+      for (int e = 0; e < E; ++e) {
+        if (squared) {
+          problem->addErrorTerm(boost::shared_ptr<LinearErr>(new LinearErr(p2d[p].get())));
+        } else {
+          TestNonSquaredError::grad_t g(p+1, e+1);
+          boost::shared_ptr<TestNonSquaredError> err(new TestNonSquaredError(p2d[p].get(), g));
+          err->_p = 1.0;
+          errNS.push_back(err);
+          problem->addErrorTerm(err);
+        }
+      }
+    }
+    p2d0.reserve(p2d.size());
+    for (auto& dv : p2d) p2d0.emplace_back(new Point2d(*dv));
+  }
+
+  void resetState() {
+    for (std::size_t i=0; i<p2d.size(); i++) p2d[i]->_v = p2d0[i]->_v;
+  }
+};
+
+/// \brief Run \p optimizer on \p problem from its initial state and print iterations, evaluations and wall time
+template <typename Optimizer>
+aslam::backend::OptimizerStatus runComparison(const std::string& name, Optimizer& optimizer, TestProblem& problem) {
+  optimizer.setProblem(problem.problem);
+  problem.resetState();
+  const auto start = std::chrono::steady_clock::now();
+  optimizer.initialize();
+  optimizer.optimize();
+  const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  const auto& status = optimizer.getStatus();
+  std::cout << std::left << std::setw(24) << name << std::right <<
+      " iterations: " << std::setw(5) << status.numIterations <<
+      " error evals: " << std::setw(5) << status.numErrorEvaluations <<
+      " gradient evals: " << std::setw(5) << status.numJacobianEvaluations <<
+      " gradient norm: " << std::setw(12) << status.gradientNorm <<
+      " time [ms]: " << std::setw(10) << ms <<
+      " (" << status.convergence << ")" << std::endl;
+  return status;
+}
+
+} // namespace
+
+TEST(OptimizerNCGTestSuite, testNCG)
+{
+  try {
+    using namespace aslam::backend;
+    TestProblem tp(2, 3, false);
+    for (auto& err : tp.errNS) {
+      SCOPED_TRACE("");
+      testErrorTerm(err);
+    }
+
+    // Now let's optimize.
+    OptimizerNCG::Options options;
+    options.maxIterations = 500;
+    options.numThreadsJacobian = 8;
+    options.convergenceGradientNorm = 1e-15;
+    options.restartThreshold = std::numeric_limits<double>::infinity();
+    EXPECT_ANY_THROW(options.check());
+    options.restartThreshold = 0.2;
+    EXPECT_NO_THROW(options.check());
+
+    for (OptimizerNCG::Options::Method method : {OptimizerNCG::Options::POLAK_RIBIERE_PLUS, OptimizerNCG::Options::HAGER_ZHANG}) {
+      for (std::size_t restartInterval : {0, 1, 3}) {
+        options.method = method;
+        options.restartInterval = restartInterval;
+        OptimizerNCG optimizer(options);
+        optimizer.setProblem(tp.problem);
+
+        // Test that linesearch options are correctly forwarded
+        options.linesearch.initialStepLength = 1.1;
+        optimizer.setOptions(options);
+        EXPECT_DOUBLE_EQ(options.linesearch.initialStepLength, optimizer.getLineSearch().options().initialStepLength);
+
+        EXPECT_NO_THROW(optimizer.checkProblemSetup());
+
+        tp.resetState();
+        optimizer.initialize();
+        SCOPED_TRACE(::testing::Message() << "method: " << method << ", restartInterval: " << restartInterval);
+        optimizer.optimize();
+        const auto& ret = optimizer.getStatus();
+
+        EXPECT_GT(ret.convergence, ConvergenceStatus::FAILURE);
+        EXPECT_LE(ret.gradientNorm, options.convergenceGradientNorm);
+        EXPECT_GT(ret.numErrorEvaluations, 0);
+        EXPECT_GT(ret.numJacobianEvaluations, 0);
+        EXPECT_GE(ret.error, 0.0);
+        EXPECT_LT(ret.deltaError, 1e-12);
+        EXPECT_LT(ret.maxDeltaX, 1e-3);
+        EXPECT_LT(ret.error, std::numeric_limits<double>::max());
+        EXPECT_GT(ret.numIterations, 0);
+        if (restartInterval == 1) { // every iteration is a steepest descent step
+          EXPECT_GE(optimizer.getNumRestarts(), ret.numIterations - 1);
+        }
+      }
+    }
+
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizerNCGTestSuite, testNCGOptions)
+{
+  using namespace aslam::backend;
+  sm::BoostPropertyTree pt;
+  pt.setString("method", "FLETCHER_REEVES"); // not supported
+  pt.setInt("restartInterval", 5);
+  pt.setDouble("restartThreshold", 0.0);
+  pt.setBool("useDenseJacobianContainer", false);
+  pt.setDouble("linesearch/c2WolfeCondition", 0.1);
+  EXPECT_ANY_THROW(OptimizerOptionsNCG options(pt));
+  pt.setString("method", "HAGER_ZHANG");
+  OptimizerOptionsNCG options(pt);
+  EXPECT_EQ(OptimizerOptionsNCG::HAGER_ZHANG, options.method);
+  EXPECT_EQ(5u, options.restartInterval);
+  EXPECT_DOUBLE_EQ(0.0, options.restartThreshold);
+  EXPECT_FALSE(options.useDenseJacobianContainer);
+  EXPECT_DOUBLE_EQ(0.1, options.linesearch.c2WolfeCondition);
+  EXPECT_NO_THROW(OptimizerNCG optimizer(pt));
+}
+
+/// Comparison harness: runs the first-order optimizers on the test problems of this package and reports
+/// iterations, evaluations and wall time. Only convergence is checked, the numbers are meant for inspection.
+TEST(OptimizerNCGTestSuite, compareFirstOrderOptimizers)
+{
+  try {
+    using namespace aslam::backend;
+    for (bool squared : {false, true}) {
+      TestProblem tp(20, 3, squared);
+      std::cout << "Problem with " << tp.p2d.size() << " design variables and " << (squared ? "squared" : "non-squared") << " error terms:" << std::endl;
+
+      OptimizerOptionsNCG optionsNcg;
+      optionsNcg.maxIterations = 2000;
+      optionsNcg.convergenceGradientNorm = 1e-8;
+      optionsNcg.linesearch.c2WolfeCondition = 0.1;
+      for (OptimizerNCG::Options::Method method : {OptimizerNCG::Options::POLAK_RIBIERE_PLUS, OptimizerNCG::Options::HAGER_ZHANG}) {
+        optionsNcg.method = method;
+        OptimizerNCG ncg(optionsNcg);
+        std::stringstream name;
+        name << "NCG " << method;
+        const auto status = runComparison(name.str(), ncg, tp);
+        EXPECT_TRUE(status.success()) << name.str();
+        EXPECT_LE(status.gradientNorm, optionsNcg.convergenceGradientNorm) << name.str();
+      }
+
+      OptimizerOptionsBFGS optionsBfgs;
+      optionsBfgs.maxIterations = optionsNcg.maxIterations;
+      optionsBfgs.convergenceGradientNorm = optionsNcg.convergenceGradientNorm;
+      OptimizerBFGS bfgs(optionsBfgs);
+      EXPECT_TRUE(runComparison("BFGS", bfgs, tp).success());
+
+      OptimizerOptionsRprop optionsRprop;
+      optionsRprop.maxIterations = optionsNcg.maxIterations;
+      optionsRprop.convergenceGradientNorm = optionsNcg.convergenceGradientNorm;
+      optionsRprop.method = OptimizerOptionsRprop::IRPROP_PLUS;
+      OptimizerRprop rprop(optionsRprop);
+      runComparison("Rprop IRPROP_PLUS", rprop, tp); // Rprop is not guaranteed to reach the tight tolerance within the iteration limit
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
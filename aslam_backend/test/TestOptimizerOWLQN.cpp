@@ -0,0 +1,136 @@
+#include <sm/eigen/gtest.hpp>
+#include <aslam/backend/OptimizerOWLQN.hpp>
+#include <aslam/backend/OptimizationProblem.hpp>
+#include <aslam/backend/ErrorTerm.hpp>
+#include <sm/BoostPropertyTree.hpp>
+#include <aslam/backend/test/ErrorTermTester.hpp>
+#include "SampleDvAndError.hpp"
+
+namespace {
+
+/// \brief Encodes the error \f$ w (|v_0| + |v_1|) \f$
+class TestL1Error : public aslam::backend::ScalarNonSquaredErrorTerm {
+public:
+  TestL1Error(Point2d* p2d, const double w) : _p2d(p2d) {
+    setDesignVariables(p2d);
+    setWeight(w);
+  }
+  bool isL1Norm() const override { return true; }
+private:
+  double evaluateErrorImplementation() override {
+    return _p2d->_v.cwiseAbs().sum();
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p2d, Eigen::RowVector2d(_p2d->_v.cwiseSign().transpose()));
+  }
+  Point2d* _p2d;
+};
+
+/// \brief Encodes the error \f$ (\mathbf v - \mathbf c)^T (\mathbf v - \mathbf c) \f$
+class TestQuadraticError : public aslam::backend::ScalarNonSquaredErrorTerm {
+public:
+  TestQuadraticError(Point2d* p2d, const Eigen::Vector2d& c) : _p2d(p2d), _c(c) {
+    setDesignVariables(p2d);
+  }
+private:
+  double evaluateErrorImplementation() override {
+    return (_p2d->_v - _c).squaredNorm();
+  }
+  void evaluateJacobiansImplementation(aslam::backend::JacobianContainer & outJ) override {
+    outJ.add(_p2d, Eigen::RowVector2d(2.0*(_p2d->_v - _c).transpose()));
+  }
+  Point2d* _p2d;
+  Eigen::Vector2d _c;
+};
+
+} // namespace
+
+TEST(OptimizerOWLQNTestSuite, testOWLQNLasso)
+{
+  try {
+    using namespace aslam::backend;
+    const int P = 10;
+    const double w = 0.6;
+
+    for (bool inProblem : {true, false}) {
+      SCOPED_TRACE(::testing::Message() << "inProblem: " << inProblem);
+      boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem);
+      std::vector< boost::shared_ptr<Point2d> > p2d;
+      std::vector<Eigen::Vector2d> c;
+      OptimizerOWLQN::Options options;
+      options.maxIterations = 200;
+      options.convergenceGradientNorm = 1e-10;
+      for (int p = 0; p < P; ++p) {
+        c.push_back(Eigen::Vector2d(std::sin(p + 1.0), 0.5*std::cos(2.0*p)));
+        p2d.emplace_back(new Point2d(Eigen::Vector2d::Constant(0.3)));
+        p2d.back()->setBlockIndex(p);
+        p2d.back()->setActive(true);
+        problem->addDesignVariable(p2d.back());
+        boost::shared_ptr<TestQuadraticError> err(new TestQuadraticError(p2d.back().get(), c.back()));
+        problem->addErrorTerm(err);
+        SCOPED_TRACE("");
+        testErrorTerm(err);
+        boost::shared_ptr<TestL1Error> l1(new TestL1Error(p2d.back().get(), w));
+        if (inProblem)
+          problem->addErrorTerm(l1);
+        else
+          options.regularizer = l1; // one point is enough for the regularizer
+      }
+
+      OptimizerOWLQN optimizer(options);
+      optimizer.setProblem(problem);
+      optimizer.initialize();
+      EXPECT_EQ(inProblem ? 2u*P : 2u, optimizer.getNumL1Parameters());
+      optimizer.optimize();
+      const auto& ret = optimizer.getStatus();
+      EXPECT_GT(ret.convergence, ConvergenceStatus::FAILURE);
+      EXPECT_GT(ret.numIterations, 0);
+
+      // The minimizer of (v - c)^2 + w |v| is the soft-thresholded c, the thresholded coordinates must be exactly zero
+      std::size_t numZero = 0;
+      for (int p = 0; p < P; ++p) {
+        const double wp = (inProblem || p == P - 1) ? w : 0.0;
+        for (int i = 0; i < 2; ++i) {
+          const double expected = std::copysign(std::max(std::abs(c[p][i]) - 0.5*wp, 0.0), c[p][i]);
+          if (expected == 0.0) {
+            EXPECT_EQ(0.0, p2d[p]->_v[i]) << "point " << p << ", coordinate " << i;
+            ++numZero;
+          } else {
+            EXPECT_NEAR(expected, p2d[p]->_v[i], 1e-8) << "point " << p << ", coordinate " << i;
+          }
+        }
+      }
+      EXPECT_EQ(numZero, optimizer.getNumZeroL1Parameters());
+      if (inProblem) {
+        EXPECT_GT(numZero, 0u);
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizerOWLQNTestSuite, testOWLQNOptions)
+{
+  using namespace aslam::backend;
+  sm::BoostPropertyTree pt;
+  pt.setInt("historySize", 5);
+  pt.setDouble("backtrackingFactor", 1.0); // not supported
+  pt.setBool("useDenseJacobianContainer", false);
+  pt.setDouble("linesearch/c1WolfeCondition", 0.01);
+  EXPECT_ANY_THROW(OptimizerOptionsOWLQN options(pt));
+  pt.setDouble("backtrackingFactor", 0.25);
+  OptimizerOptionsOWLQN options(pt);
+  EXPECT_EQ(5u, options.historySize);
+  EXPECT_DOUBLE_EQ(0.25, options.backtrackingFactor);
+  EXPECT_FALSE(options.useDenseJacobianContainer);
+  EXPECT_DOUBLE_EQ(0.01, options.linesearch.c1WolfeCondition);
+  EXPECT_NO_THROW(OptimizerOWLQN optimizer(pt));
+
+  // Only L1 regularizers are supported
+  Point2d point(Eigen::Vector2d::Zero());
+  options.regularizer.reset(new TestQuadraticError(&point, Eigen::Vector2d::Ones()));
+  EXPECT_ANY_THROW(options.check());
+  options.regularizer.reset(new TestL1Error(&point, 1.0));
+  EXPECT_NO_THROW(options.check());
+}
@@ -73,8 +73,13 @@ TEST(OptimizerRpropTestSuite, testRpropNonSquaredErrorTerms)
       EXPECT_LE(ret.gradientNorm, 1e-6);
       EXPECT_GE(ret.error, 0.0);
       EXPECT_LT(ret.maxDeltaX, 1e-3);
-      if (method == OptimizerRprop::Options::IRPROP_PLUS)
+      if (method == OptimizerRprop::Options::IRPROP_PLUS) {
         EXPECT_LT(ret.deltaError, 1e-12);
+        // error and gradient are always evaluated together
+        EXPECT_EQ(ret.numErrorEvaluations, ret.numErrorAndGradientEvaluations);
+      } else {
+        EXPECT_EQ(0u, ret.numErrorAndGradientEvaluations);
+      }
     }
 
   } catch (const std::exception& e) {
@@ -150,3 +155,91 @@ TEST(OptimizerRpropTestSuite, testRpropSquaredErrorTerms)
   }
 }
 
+
+TEST(OptimizerRpropTestSuite, testRpropMiniBatch)
+{
+  try {
+    using namespace aslam::backend;
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    OptimizationProblem& problem = *problem_ptr;
+    const int P = 10;
+    const int E = 3;
+    // Add some design variables.
+    std::vector< boost::shared_ptr<Point2d> > p2d;
+    p2d.reserve(P);
+    for (int p = 0; p < P; ++p) {
+      boost::shared_ptr<Point2d> point(new Point2d(Eigen::Vector2d::Random())); // random initialization of design variable
+      p2d.push_back(point);
+      problem.addDesignVariable(point);
+      point->setBlockIndex(p);
+      point->setActive(true);
+    }
+
+    // make a deep copy
+    std::vector< boost::shared_ptr<Point2d> > p2d0;
+    p2d0.reserve(p2d.size());
+    for (auto& dv : p2d) p2d0.emplace_back(new Point2d(*dv));
+
+    // Add some error terms.
+    for (int p = 0; p < P; ++p)
+      for (int e = 0; e < E; ++e)
+        problem.addErrorTerm(boost::shared_ptr<LinearErr>(new LinearErr(p2d[p].get())));
+
+    // Now let's optimize with mini-batches of 5 error terms, doubling the batch size every epoch.
+    OptimizerRprop::Options options;
+    options.maxIterations = 1000;
+    options.numThreadsJacobian = 2;
+    options.miniBatch.batchSize = 5;
+    options.miniBatch.growthFactor = 0.5;
+    EXPECT_ANY_THROW(options.check());
+    options.miniBatch.growthFactor = 2.0;
+    EXPECT_NO_THROW(options.check());
+    OptimizerRprop optimizer(options);
+    optimizer.setProblem(problem_ptr);
+
+    for (OptimizerRprop::Options::Method method : {OptimizerRprop::Options::RPROP_PLUS, OptimizerRprop::Options::RPROP_MINUS,
+      OptimizerRprop::Options::IRPROP_MINUS, OptimizerRprop::Options::IRPROP_PLUS}) {
+
+      optimizer.getOptions().method = method;
+      optimizer.initialize();
+      for (std::size_t i=0; i<p2d.size(); i++) p2d[i]->_v = p2d0[i]->_v;
+      SCOPED_TRACE(testing::Message() << "method: " << method);
+      optimizer.optimize();
+      auto ret = optimizer.getStatus();
+      // convergence on the gradient norm is only accepted for the full gradient
+      EXPECT_EQ(ConvergenceStatus::GRADIENT_NORM, ret.convergence);
+      EXPECT_LT(ret.gradientNorm, options.convergenceGradientNorm);
+      EXPECT_GE(ret.error, 0.0);
+    }
+
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
+
+TEST(OptimizerRpropTestSuite, testRpropBoxBounds)
+{
+  try {
+    using namespace aslam::backend;
+    std::vector< boost::shared_ptr<Point2d> > points;
+    std::vector<Eigen::Vector2d> expected;
+    boost::shared_ptr<OptimizationProblem> problem = buildBoxBoundedProblem(points, expected);
+
+    OptimizerRprop::Options options;
+    options.maxIterations = 1000;
+    OptimizerRprop optimizer(options);
+    optimizer.setProblem(problem);
+    optimizer.initialize();
+    optimizer.optimize();
+    EXPECT_TRUE(optimizer.getStatus().success());
+    for (std::size_t p = 0; p < points.size(); ++p) {
+      EXPECT_NEAR(expected[p][0], points[p]->_v[0], 1e-3) << "point " << p;
+      EXPECT_NEAR(expected[p][1], points[p]->_v[1], 1e-3) << "point " << p;
+      if (points[p]->hasBounds()) {
+        EXPECT_TRUE((points[p]->_v.array() >= 0.0).all() && (points[p]->_v.array() <= 1.0).all()) << "point " << p;
+      }
+    }
+  } catch (const std::exception& e) {
+    FAIL() << e.what();
+  }
+}
@@ -105,7 +105,7 @@ TEST(OptimizationProblemTestSuite, testProblemManager)
     RowVectorType grad_expected = RowVectorType::Zero(pm.numOptParameters());
     grad_expected.segment(0, 2) = grad0;
     pm.addGradientForErrorTerm(grad, &err0, useMEstimator, useDenseJacobianContainer);
-    sm::eigen::assertEqual(grad_expected, grad, SM_SOURCE_FILE_POS, optStr);
+    sm::eigen::assertNear(grad_expected, grad, 1e-12, SM_SOURCE_FILE_POS, optStr); // chain rule order may change the rounding
 
     // Full gradient should now contain all error terms
     grad.setZero();
@@ -113,6 +113,89 @@ TEST(OptimizationProblemTestSuite, testProblemManager)
     grad_expected.segment(0, 2) = grad0;
     grad_expected.segment(2, 2) = grad1 + grad2;
     pm.computeGradient(grad, 1, useMEstimator, applyDvScaling, useDenseJacobianContainer);
-    sm::eigen::assertEqual(grad_expected, grad, SM_SOURCE_FILE_POS, optStr);
+    sm::eigen::assertNear(grad_expected, grad, 1e-12, SM_SOURCE_FILE_POS, optStr);
+
+    // The per-thread gradient buffers have to add up to the same gradient, also with idle threads and repeated calls
+    for (size_t nThreads : {2, 3, 8, 2}) {
+      RowVectorType gradThreaded;
+      pm.computeGradient(gradThreaded, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer);
+      sm::eigen::assertNear(grad_expected, gradThreaded, 1e-12, SM_SOURCE_FILE_POS, optStr);
+    }
+
+    // The fused evaluation has to return the same gradient and error
+    for (size_t nThreads : {1, 2, 4}) {
+      RowVectorType gradFused;
+      const double errFused = pm.evaluateErrorAndGradient(gradFused, nThreads, useMEstimator, applyDvScaling, useDenseJacobianContainer);
+      sm::eigen::assertNear(grad_expected, gradFused, 1e-12, SM_SOURCE_FILE_POS, optStr);
+      EXPECT_NEAR(pm.evaluateError(nThreads), errFused, 1e-12) << optStr;
+    }
   }
 }
+
+TEST(OptimizationProblemTestSuite, testProblemManagerMiniBatch)
+{
+  // Three design variables with two squared error terms each
+  boost::shared_ptr<OptimizationProblem> problem(new OptimizationProblem());
+  std::vector< boost::shared_ptr<Point2d> > dvs;
+  for (int i = 0; i < 3; ++i) {
+    dvs.emplace_back(new Point2d(Eigen::Vector2d::Random()));
+    problem->addDesignVariable(dvs.back());
+    for (int j = 0; j < 2; ++j)
+      problem->addErrorTerm(boost::shared_ptr<LinearErr>(new LinearErr(dvs.back().get())));
+  }
+
+  ProblemManager pm(problem);
+  ASSERT_EQ(6u, pm.numErrorTerms());
+  RowVectorType gradFull;
+  const double errFull = pm.evaluateErrorAndGradient(gradFull, 1, false, false, true);
+
+  // Mini-batches disabled
+  EXPECT_TRUE(pm.isFullBatch());
+  RowVectorType grad;
+  EXPECT_NEAR(errFull, pm.computeMiniBatchGradient(grad, 2, false, false, true, true), 1e-10);
+  sm::eigen::assertNear(gradFull, grad, 1e-10, SM_SOURCE_FILE_POS);
+
+  MiniBatchOptions options;
+  options.growthFactor = 0.5;
+  EXPECT_ANY_THROW(options.check());
+  options.growthFactor = 2.0;
+  options.batchSize = 2;
+  options.seed = 42;
+  pm.setMiniBatchOptions(options);
+  EXPECT_FALSE(pm.isFullBatch());
+  EXPECT_EQ(2u, pm.getCurrentBatchSize());
+
+  for (bool useDenseJacobianContainer : {true, false}) {
+    SCOPED_TRACE(testing::Message() << "useDenseJacobianContainer: " << useDenseJacobianContainer);
+    pm.resetMiniBatches();
+
+    // The scaled batch gradients of one epoch add up to the full gradient
+    RowVectorType gradSum = RowVectorType::Zero(pm.numOptParameters());
+    double errSum = 0.0;
+    for (int i = 0; i < 3; ++i) {
+      errSum += pm.computeMiniBatchGradient(grad, 2, false, false, useDenseJacobianContainer, true);
+      gradSum += grad;
+      EXPECT_EQ(0u, pm.getEpoch());
+    }
+    sm::eigen::assertNear(gradFull, gradSum/3.0, 1e-10, SM_SOURCE_FILE_POS);
+    EXPECT_NEAR(errFull, errSum/3.0, 1e-10);
+
+    // The batch size doubles per epoch until the full gradient is used
+    pm.computeMiniBatchGradient(grad, 2, false, false, useDenseJacobianContainer);
+    EXPECT_EQ(1u, pm.getEpoch());
+    EXPECT_EQ(4u, pm.getCurrentBatchSize());
+    EXPECT_FALSE(pm.isFullBatch());
+    pm.computeMiniBatchGradient(grad, 2, false, false, useDenseJacobianContainer);
+    EXPECT_EQ(2u, pm.getEpoch());
+    EXPECT_TRUE(pm.isFullBatch());
+    sm::eigen::assertNear(gradFull, grad, 1e-10, SM_SOURCE_FILE_POS);
+  }
+
+  // Switch to the full gradient explicitly
+  pm.resetMiniBatches();
+  EXPECT_FALSE(pm.isFullBatch());
+  pm.switchToFullBatch();
+  EXPECT_TRUE(pm.isFullBatch());
+  pm.computeMiniBatchGradient(grad, 1, false, false, true);
+  sm::eigen::assertNear(gradFull, grad, 1e-10, SM_SOURCE_FILE_POS);
+}
@@ -114,22 +114,25 @@ class CacheExpressionNode< GenericMatrixExpressionNode<IRows, ICols, TScalar>, D
   friend Expression toCacheExpression(const Expression& expr);
   typedef GenericMatrixExpressionNode<IRows, ICols, TScalar> ExpressionNode;
 
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
  public:
   virtual ~CacheExpressionNode() { }
 
  protected:
 
-  void evaluateImplementation() const override
+  typename ExpressionNode::matrix_t evaluateImplementation() const override
   {
     if (!_isCacheValidV)
     {
       boost::mutex::scoped_lock lock(_mutexV);
       if (!_isCacheValidV) // could be updated by another thread in the meantime
       {
-        this->_currentValue = _node->evaluate();
+        _v = _node->evaluate();
         _isCacheValidV = true;
       }
     }
+    return _v;
   }
 
   void evaluateJacobiansImplementation(JacobianContainer & outJacobians, const typename ExpressionNode::differential_t & chainRuleDifferential) const override
@@ -166,6 +169,7 @@ class CacheExpressionNode< GenericMatrixExpressionNode<IRows, ICols, TScalar>, D
   }
 
  private:
+  mutable typename ExpressionNode::matrix_t _v; /// \brief Cache for error values
   mutable JacobianContainerSparse<IRows> _jc = JacobianContainerSparse<IRows>(IRows); /// \brief Cache for Jacobians
   boost::shared_ptr<ExpressionNode> _node; /// \brief Wrapped expression node, stored to delegate evaluation calls
   mutable boost::mutex _mutexV; /// \brief Mutex for error value write operations
@@ -18,30 +18,29 @@ class DesignVariableGenericVector : public DesignVariable, public GenericMatrixE
   SM_DEFINE_EXCEPTION(Exception, std::runtime_error);
 
   DesignVariableGenericVector(vector_t v = vector_t::Zero())
-      : base_t(v) {
+      : _currentValue(v) {
   }
   virtual ~DesignVariableGenericVector() {
   }
   const vector_t & value() const {
-    return base_t::evaluate();
+    return _currentValue;
   }
 
   using DesignVariable::setParameters;
   void setParameters(const Eigen::Matrix<Scalar_, D, 1>& value) {
-    this->_currentValue = value;
-    this->_valueDirty = false;
+    _currentValue = value;
     this->invalidateCache();
   }
  protected:
   /// \brief Revert the last state update.
   virtual void revertUpdateImplementation() {
-    this->_currentValue = _p_v;
+    _currentValue = _p_v;
   }
   /// \brief Update the design variable.
   virtual void updateImplementation(const double * dp, int size) {
     SM_ASSERT_EQ(std::runtime_error, size, D, "update size must match the vector dimension.")
-    _p_v = this->_currentValue;
-    this->_currentValue += Eigen::Map<const Eigen::Matrix<double, D, 1> >(dp).template cast<Scalar_>();
+    _p_v = _currentValue;
+    _currentValue += Eigen::Map<const Eigen::Matrix<double, D, 1> >(dp).template cast<Scalar_>();
   }
   /// \brief what is the number of dimensions of the perturbation variable.
   virtual int minimalDimensionsImplementation() const {
@@ -53,8 +52,7 @@ class DesignVariableGenericVector : public DesignVariable, public GenericMatrixE
   }
 
   virtual void setParametersImplementation(const Eigen::MatrixXd& value) {
-    this->_currentValue = value.template cast<Scalar_>();
-    this->_valueDirty = false;
+    _currentValue = value.template cast<Scalar_>();
   }
 
   virtual void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const {
@@ -65,7 +63,8 @@ class DesignVariableGenericVector : public DesignVariable, public GenericMatrixE
     diff.addToJacobianContainer(outJacobians, (const DesignVariable *) this);
   }
   ;
-  virtual void evaluateImplementation() const {
+  virtual vector_t evaluateImplementation() const {
+    return _currentValue;
   }
 
 	/// Computes the minimal distance in tangent space between the current value of the DV and xHat
@@ -75,6 +74,7 @@ class DesignVariableGenericVector : public DesignVariable, public GenericMatrixE
 	//TODO implement: virtual void minimalDifferenceAndJacobianImplementation(const Eigen::MatrixXd& xHat, Eigen::VectorXd& outDifference, Eigen::MatrixXd& outJacobian) const;
 
  protected:
+  vector_t _currentValue;
   vector_t _p_v;
 };
 
@@ -43,9 +43,7 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<RotationExpressionNode> _lhs;
-      mutable Eigen::Matrix3d _C_lhs;
       boost::shared_ptr<EuclideanExpressionNode> _rhs;
-      mutable Eigen::Vector3d _p_rhs;
     };
 
     // ## New Class for Multiplication with a MatrixExpression
@@ -69,9 +67,7 @@ namespace aslam {
        void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
        boost::shared_ptr<MatrixExpressionNode> _lhs;
-       mutable Eigen::Matrix3d _A_lhs;
        boost::shared_ptr<EuclideanExpressionNode> _rhs;
-       mutable Eigen::Vector3d _p_rhs;
 
      };
 
@@ -20,6 +20,7 @@ namespace backend {
 
 template <typename TScalar>
 class GenericScalarExpression;
+class ScalarExpressionTape;
 
 namespace internal {
 template<typename TExpression>
@@ -87,6 +88,10 @@ struct ExpressionToEigenVectorTraits<ScalarExpression>{
     return (Eigen::Matrix<double, 1, 1>() << error).finished();
   }
 };
+
+template <>
+struct ExpressionToEigenVectorTraits<ScalarExpressionTape> : public ExpressionToEigenVectorTraits<ScalarExpression> {
+};
 }
 
 template<typename TExpression, int IDimension = internal::ExpressionDimensionTraits<TExpression>::Dimension>
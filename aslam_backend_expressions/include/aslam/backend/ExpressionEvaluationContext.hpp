@@ -0,0 +1,178 @@
+/*
+ * ExpressionEvaluationContext.hpp
+ */
+
+#ifndef INCLUDE_ASLAM_BACKEND_EXPRESSIONEVALUATIONCONTEXT_HPP_
+#define INCLUDE_ASLAM_BACKEND_EXPRESSIONEVALUATIONCONTEXT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace aslam {
+namespace backend {
+
+/**
+ * \class ExpressionEvaluationContext
+ * \brief The values of the expression nodes during one Jacobian evaluation of the calling thread
+ *
+ * The Jacobian pass of a node like a product or an inverse needs the values of its operands, and evaluating an
+ * operand evaluates its whole subgraph. A chain of d such nodes thus evaluates O(d^2) nodes per Jacobian pass.
+ * The public evaluateJacobians() of the node classes open a Scope, while it is open the value accessors compute
+ * the value of each node once and look it up afterwards, which makes the pass O(d).
+ *
+ * The context belongs to the calling thread, the nodes stay immutable and a graph can be evaluated concurrently.
+ * While a scope is open, the design variables must not change and nodes must not be destroyed, the values are
+ * identified by the address of their node. Values with more than 16 entries or of other scalar types than double
+ * are not stored.
+ */
+class ExpressionEvaluationContext
+{
+ public:
+  /// \brief Opens the context of the calling thread for its lifetime. A nested scope uses the outermost one,
+  ///        which forgets all values when it is closed.
+  class Scope
+  {
+   public:
+    Scope() : _outermost(!storage().open) { storage().open = true; }
+    ~Scope() {
+      if (_outermost)
+        storage().close();
+    }
+    Scope(const Scope &) = delete;
+    Scope & operator=(const Scope &) = delete;
+   private:
+    bool _outermost;
+  };
+
+  /// \brief Whether a scope is open on the calling thread
+  static bool isOpen() { return storage().open; }
+
+  /// \brief The value of \p node. Returns \p compute() if no scope is open, otherwise the value stored for \p node,
+  ///        which \p compute() provides on the first call.
+  template <typename Value, typename Compute>
+  static Value value(const void * node, Compute compute) {
+    return value<Value>(node, compute, IsStorable<Value>());
+  }
+
+ private:
+  struct Entry
+  {
+    const void * node;
+    const std::type_info * type;
+    /// \brief The entry is empty unless this is the generation of the storage
+    unsigned generation;
+    std::array<double, 16> data;
+  };
+
+  /// \brief An open addressing table, closing a scope empties it by advancing the generation without freeing memory
+  struct Storage
+  {
+    bool open = false;
+    unsigned generation = 1;
+    std::size_t size = 0;
+    std::vector<Entry> entries = std::vector<Entry>(64);
+
+    /// \brief The entry of \p node or the empty one it belongs into
+    Entry & find(const void * node) {
+      const std::size_t mask = entries.size() - 1;
+      for (std::size_t i = (reinterpret_cast<std::uintptr_t>(node) >> 4) & mask; ; i = (i + 1) & mask) {
+        Entry & entry = entries[i];
+        if (entry.generation != generation || entry.node == node)
+          return entry;
+      }
+    }
+
+    /// \brief The entry of \p node, claims an empty one if there is none
+    Entry & insert(const void * node) {
+      Entry * entry = &find(node);
+      if (entry->generation != generation) {
+        if (2 * (size + 1) > entries.size()) {
+          std::vector<Entry> old(2 * entries.size());
+          old.swap(entries);
+          for (const Entry & e : old)
+            if (e.generation == generation)
+              find(e.node) = e;
+          entry = &find(node);
+        }
+        ++size;
+        entry->node = node;
+        entry->generation = generation;
+      }
+      return *entry;
+    }
+
+    void close() {
+      open = false;
+      size = 0;
+      if (++generation == 0) {
+        for (Entry & e : entries)
+          e.generation = 0;
+        generation = 1;
+      }
+    }
+  };
+
+  template <typename Value>
+  struct IsStorable : std::is_same<Value, double> {};
+
+  template <typename Scalar, int Rows, int Cols, int Options, int MaxRows, int MaxCols>
+  struct IsStorable<Eigen::Matrix<Scalar, Rows, Cols, Options, MaxRows, MaxCols> >
+      : std::integral_constant<bool, std::is_same<Scalar, double>::value && (Rows > 0) && (Cols > 0) && (Rows * Cols <= 16)> {};
+
+  static Storage & storage() {
+    static thread_local Storage s;
+    return s;
+  }
+
+  template <typename Value, typename Compute>
+  static Value value(const void * /* node */, Compute & compute, std::false_type) {
+    return compute();
+  }
+
+  template <typename Value, typename Compute>
+  static Value value(const void * node, Compute & compute, std::true_type) {
+    Storage & s = storage();
+    if (!s.open)
+      return compute();
+    const Entry & entry = s.find(node);
+    if (entry.generation == s.generation && *entry.type == typeid(Value))
+      return load<Value>(entry.data.data());
+    // compute() may store the values of the operands and grow the table, the entry is looked up again afterwards
+    const Value v = compute();
+    Entry & newEntry = s.insert(node);
+    newEntry.type = &typeid(Value);
+    store(v, newEntry.data.data());
+    return v;
+  }
+
+  template <typename Value>
+  static typename std::enable_if<std::is_same<Value, double>::value, Value>::type load(const double * data) {
+    return *data;
+  }
+
+  template <typename Value>
+  static typename std::enable_if<!std::is_same<Value, double>::value, Value>::type load(const double * data) {
+    return Eigen::Map<const Value>(data);
+  }
+
+  static void store(double v, double * data) {
+    *data = v;
+  }
+
+  template <typename Derived>
+  static void store(const Eigen::MatrixBase<Derived> & v, double * data) {
+    typename Derived::PlainObject::MapType map(data);
+    map = v;
+  }
+};
+
+} // namespace backend
+} // namespace aslam
+
+#endif /* INCLUDE_ASLAM_BACKEND_EXPRESSIONEVALUATIONCONTEXT_HPP_ */
@@ -21,6 +21,10 @@ class NodeI {
   virtual std::string computeValue() const = 0;
   virtual void accept(size_t argIndex, ExpressionNodeVisitor &) const = 0;
   virtual size_t getNumArgs() const = 0;
+  /// \brief The visited node as passed to ExpressionNodeVisitor::visit()
+  virtual const void * getNode() const = 0;
+  /// \brief The static type of the visited node, getNode() may be cast to a pointer to this type
+  virtual const std::type_info & getNodeType() const = 0;
 
   bool hasArgs() const { return getNumArgs(); }
 };
@@ -104,6 +108,14 @@ class NodeImpl : public NodeI {
   virtual size_t getNumArgs() const override {
     return numArgs();
   }
+
+  virtual const void * getNode() const override {
+    return &*n;
+  }
+
+  virtual const std::type_info & getNodeType() const override {
+    return typeid(decltype(*n));
+  }
  private:
 
   template <int I>
@@ -2,12 +2,20 @@
 #define ASLAM_BACKEND_GENERIC_MATRIX_EXPRESSION_NODE_HPP
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/Differential.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 
 namespace aslam {
 namespace backend {
 
 template<int IRows, int ICols, typename TScalar> class ConstantGenericMatrixExpressionNode;
 
+/**
+ * \brief Base class of the nodes of GenericMatrixExpression
+ *
+ * Nodes are immutable after construction, they do not store intermediate results, such that a graph can be evaluated
+ * concurrently from several threads. Only the leafs, e.g. design variables, own a value. During a Jacobian pass the
+ * values of the nodes are kept in the ExpressionEvaluationContext of the evaluating thread.
+ */
 template<int IRows, int ICols, typename TScalar>
 class GenericMatrixExpressionNode {
  public:
@@ -19,44 +27,22 @@ class GenericMatrixExpressionNode {
   typedef Differential<tangent_vector_t, TScalar> differential_t;
   typedef boost::shared_ptr<self_t> ptr_t;
 
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
- protected:
-  mutable matrix_t _currentValue;
-  mutable bool _valueDirty;
-
-  inline GenericMatrixExpressionNode(const matrix_t & value)
-      : _currentValue(value),
-        _valueDirty(false) {
-  }
- public:
-  GenericMatrixExpressionNode(int rows = IRows, int cols = ICols, bool valueDirty = true)
-      : _currentValue(rows, cols),
-        _valueDirty(valueDirty) {
+  GenericMatrixExpressionNode() {
   }
   virtual ~GenericMatrixExpressionNode() {
   }
 
-  inline matrix_t & getCurrentValue() {
-    return _currentValue;
-  }
-  inline const matrix_t & getCurrentValue() const {
-    return _currentValue;
-  }
-  inline const matrix_t & evaluate() const {
-    evaluateImplementation();
-    /* TODO activate value caching again.
-    if (!isConstant() && _valueDirty) {
-      evaluateImplementation();
-      _valueDirty = false;
-    };*/
-    return _currentValue;
+  inline matrix_t evaluate() const {
+    return ExpressionEvaluationContext::value<matrix_t>(this, [this]() { return evaluateImplementation(); });
   }
 
   void evaluateJacobians(JacobianContainer & outJacobians) const {
+    ExpressionEvaluationContext::Scope scope;
     evaluateJacobiansImplementation(outJacobians, IdentityDifferential<tangent_vector_t, TScalar>());
   }
 
   void evaluateJacobians(JacobianContainer & outJacobians, const differential_t & chainRuleDifferential) const {
+    ExpressionEvaluationContext::Scope scope;
     evaluateJacobiansImplementation(outJacobians, chainRuleDifferential);
   }
 
@@ -71,12 +57,8 @@ class GenericMatrixExpressionNode {
     return isConstantImplementation();
   }
 
-  void inline invalidate() {
-    _valueDirty = true;
-  }
-
  protected:
-  virtual void evaluateImplementation() const = 0;
+  virtual matrix_t evaluateImplementation() const = 0;
   virtual void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const = 0;
   virtual void evaluateJacobiansImplementation(JacobianContainer & outJacobians, const differential_t & chainRuleDifferentail) const = 0;
   virtual bool isConstantImplementation() const {
@@ -91,23 +73,30 @@ template<int IRows, int ICols, typename TScalar>
 class ConstantGenericMatrixExpressionNode : public GenericMatrixExpressionNode<IRows, ICols, TScalar> {
  public:
   typedef GenericMatrixExpressionNode<IRows, ICols, TScalar> base_t;
+  typedef typename base_t::matrix_t matrix_t;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
   template<typename DERIVED>
   ConstantGenericMatrixExpressionNode(const Eigen::MatrixBase<DERIVED> & value)
-      : base_t(value) {
+      : _value(value) {
   }
   ConstantGenericMatrixExpressionNode(int rows = IRows, int cols = ICols)
-      : base_t(rows, cols, false) {
+      : _value(rows, cols) {
   }
  protected:
   virtual bool isConstantImplementation() const {
     return true;
   }
-  virtual void evaluateImplementation() const {
+  virtual matrix_t evaluateImplementation() const {
+    return _value;
   }
   virtual void evaluateJacobiansImplementation(JacobianContainer & /* outJacobians */, const typename base_t::differential_t & /* chainRuleDifferentail */) const {
   }
   virtual void getDesignVariablesImplementation(DesignVariable::set_t & /* designVariables */) const {
   }
+ private:
+  matrix_t _value;
 };
 
 }  // namespace backend
@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_HOMOGENEOUS_EXPRESSION_NODE_HPP
 
 #include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 #include "TransformationExpressionNode.hpp"
 #include <boost/shared_ptr.hpp>
 #include <Eigen/Core>
@@ -67,9 +68,7 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<TransformationExpressionNode> _lhs;
-      mutable Eigen::Matrix4d _T_lhs;
       boost::shared_ptr<HomogeneousExpressionNode> _rhs;
-      mutable Eigen::Vector4d _p_rhs;
     };
 
 
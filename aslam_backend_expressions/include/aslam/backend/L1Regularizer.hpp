@@ -22,6 +22,8 @@ class L1Regularizer : public aslam::backend::ScalarNonSquaredErrorTerm {
 
   void setBeta(const double beta) { setWeight(beta); }
 
+  bool isL1Norm() const override { return true; }
+
  private:
   /// \brief evaluate the error term and return the scalar error \f$ e \f$
   double evaluateErrorImplementation() override;
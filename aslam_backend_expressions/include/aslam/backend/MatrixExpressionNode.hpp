@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_DV_MATRIX_HPP
 
 #include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
 
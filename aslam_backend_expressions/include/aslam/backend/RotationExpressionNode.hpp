@@ -3,6 +3,7 @@
 
 
 #include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 #include <sm/kinematics/quaternion_algebra.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
@@ -25,11 +26,16 @@ namespace aslam {
       virtual ~RotationExpressionNode();
 
       /// \brief Evaluate the rotation matrix.
-      EIGEN_ALWAYS_INLINE Eigen::Matrix3d evaluate() const { return toRotationMatrixImplementation(); }
-      EIGEN_ALWAYS_INLINE Eigen::Matrix3d toRotationMatrix() const { return toRotationMatrixImplementation(); }
+      EIGEN_ALWAYS_INLINE Eigen::Matrix3d evaluate() const { return toRotationMatrix(); }
+      EIGEN_ALWAYS_INLINE Eigen::Matrix3d toRotationMatrix() const {
+        return ExpressionEvaluationContext::value<Eigen::Matrix3d>(this, [this]() { return toRotationMatrixImplementation(); });
+      }
       
       /// \brief Evaluate the Jacobians
-      EIGEN_ALWAYS_INLINE void evaluateJacobians(JacobianContainer & outJacobians) const { evaluateJacobiansImplementation(outJacobians); }
+      EIGEN_ALWAYS_INLINE void evaluateJacobians(JacobianContainer & outJacobians) const {
+        ExpressionEvaluationContext::Scope scope;
+        evaluateJacobiansImplementation(outJacobians);
+      }
     
       /// \brief Evaluate the Jacobians and apply the chain rule.
       /** The chain rule matrix is assumed to be calculated in the left exponential chart centered at the current value (Phi(w)=Phi_R(w):= exp(w) R)),
@@ -104,9 +110,7 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<RotationExpressionNode> _lhs;
-      mutable Eigen::Matrix3d _C_lhs;
       boost::shared_ptr<RotationExpressionNode> _rhs;
-      mutable Eigen::Matrix3d _C_rhs;
     };
 
 
@@ -129,7 +133,6 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<RotationExpressionNode> _dvRotation;
-      mutable Eigen::Matrix3d _C;
     };
 
     class RotationExpressionNodeTransformation : public RotationExpressionNode
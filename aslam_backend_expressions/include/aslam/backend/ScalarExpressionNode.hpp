@@ -2,6 +2,7 @@
 #define ASLAM_BACKEND_SCALAR_EXPRESSION_NODE_HPP
 
 #include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 #include <boost/shared_ptr.hpp>
 #include <Eigen/Core>
 #include <aslam/backend/VectorExpressionNode.hpp>
@@ -9,6 +10,7 @@
 namespace aslam {
   namespace backend {
     class ExpressionNodeVisitor;
+    class ScalarExpressionTape;
 
     /**
      * \class ScalarExpressionNode
@@ -59,6 +61,7 @@ namespace aslam {
           ~ScalarExpressionNodeMultiply() override;
 
           void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
       protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -76,6 +79,7 @@ namespace aslam {
                                        boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeDivide() override;
           void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
       protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -93,6 +97,7 @@ namespace aslam {
           ScalarExpressionNodeNegated(boost::shared_ptr<ScalarExpressionNode> rhs);
           ~ScalarExpressionNodeNegated() override;
           void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
        protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -110,6 +115,7 @@ namespace aslam {
                                   double multiplyRhs = 1.0);
           ~ScalarExpressionNodeAdd() override;
           void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
        protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -128,6 +134,7 @@ namespace aslam {
           ScalarExpressionNodeConstant(double s);
           ~ScalarExpressionNodeConstant() override;
           void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
       protected:
           // These functions must be implemented by child classes.
           double evaluateImplementation() const override{return _s;}
@@ -143,6 +150,8 @@ namespace aslam {
           ScalarExpressionNodeSqrt(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeSqrt() override;
 
+          void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
        protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -158,6 +167,8 @@ namespace aslam {
           ScalarExpressionNodeLog(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeLog() override;
 
+          void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
        protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -173,6 +184,8 @@ namespace aslam {
           ScalarExpressionNodeExp(boost::shared_ptr<ScalarExpressionNode> lhs);
           ~ScalarExpressionNodeExp() override;
 
+          void accept(ExpressionNodeVisitor& visitor) override;
+          friend class ScalarExpressionTape;
        protected:
           // These functions must be implemented by child classes.
           inline double evaluateImplementation() const override;
@@ -0,0 +1,120 @@
+/*
+ * ScalarExpressionTape.hpp
+ */
+
+#ifndef INCLUDE_ASLAM_BACKEND_SCALAREXPRESSIONTAPE_HPP_
+#define INCLUDE_ASLAM_BACKEND_SCALAREXPRESSIONTAPE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Core>
+
+#include <aslam/backend/DesignVariable.hpp>
+#include <aslam/backend/JacobianContainer.hpp>
+
+namespace aslam {
+namespace backend {
+
+class ScalarExpression;
+class ScalarExpressionNode;
+
+/**
+ * \class ScalarExpressionTape
+ * \brief A scalar expression compiled to a flat tape of instructions
+ *
+ * The expression graph is linearized once with an ExpressionNodeVisitor into a contiguous array of opcodes
+ * with operand slots in evaluation order. Evaluating the tape is a loop over this array instead of virtual calls
+ * through the graph, shared subexpressions are evaluated once. The Jacobians are computed by one reverse sweep
+ * over the tape that accumulates the adjoint of each slot, also linear in the size of the tape.
+ *
+ * Only the scalar nodes with an opcode below are compiled. Every other node, e.g. the design variables or a scalar
+ * computed from a Euclidean, rotation or transformation expression, is one instruction calling the node through
+ * its interface, which evaluates its subgraph like the expression does.
+ *
+ * The value is bit-identical to that of the expression. So are the Jacobians if no node, including the design
+ * variables, is reached on more than one path and the caller applies no chain rule. Otherwise they agree up to
+ * rounding, because the contributions of the paths through a shared node are summed before its Jacobian is applied.
+ * The tape keeps the graph alive and works with ExpressionErrorTerm like the expression.
+ *
+ * The tape is immutable after construction. The slot values are stored in a Context, the overloads without
+ * a context use one per thread, such that a tape can be evaluated concurrently.
+ */
+class ScalarExpressionTape
+{
+ public:
+  enum { Dimension = 1 };
+  typedef double value_t;
+
+  /// \brief Scratch memory of an evaluation, the value of each slot followed by the adjoint of each slot for the Jacobians
+  typedef std::vector<double> Context;
+
+  /// \brief Compile \p expression
+  explicit ScalarExpressionTape(const ScalarExpression& expression);
+  ~ScalarExpressionTape();
+
+  /// \brief Evaluate the expression
+  double evaluate() const;
+  double toScalar() const { return evaluate(); }
+
+  /// \brief Evaluate the expression with the scratch memory \p context
+  double evaluate(Context & context) const;
+
+  /// \brief Evaluate the Jacobians
+  void evaluateJacobians(JacobianContainer & outJacobians) const;
+
+  /// \brief Evaluate the Jacobians with the scratch memory \p context
+  void evaluateJacobians(Context & context, JacobianContainer & outJacobians) const;
+
+  /// \brief Evaluate the Jacobians and apply the chain rule.
+  void evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const;
+
+  void getDesignVariables(DesignVariable::set_t & designVariables) const;
+
+  /// \brief Number of instructions
+  std::size_t size() const { return _tape.size(); }
+
+  /// \brief Number of instructions calling a node through its interface
+  std::size_t numNodeCalls() const;
+
+ private:
+  class Compiler;
+
+  enum class OpCode : std::uint8_t {
+    Constant, ///< parameter
+    Node, ///< node->toScalar()
+    Add, ///< lhs + parameter * rhs
+    Multiply, ///< lhs * rhs
+    Divide, ///< lhs / rhs
+    Negate, ///< -rhs
+    Sqrt, ///< sqrt(lhs)
+    Log, ///< log(lhs)
+    Exp ///< exp(lhs)
+  };
+
+  struct Instruction {
+    OpCode op;
+    int lhs = -1; ///< Operand slot
+    int rhs = -1; ///< Operand slot
+    double parameter = 0.0;
+    const ScalarExpressionNode * node = nullptr; ///< The node of OpCode::Node
+  };
+
+  /// \brief Evaluate all slots into \p context
+  void evaluateSlots(Context & context) const;
+
+  /// \brief The context of the calling thread
+  static Context & threadContext();
+
+  /// \brief The root of the compiled expression, keeps the nodes alive
+  boost::shared_ptr<ScalarExpressionNode> _root;
+
+  /// \brief The instructions, operands precede their users and the root is the last one
+  std::vector<Instruction> _tape;
+};
+
+} // namespace backend
+} // namespace aslam
+
+#endif /* INCLUDE_ASLAM_BACKEND_SCALAREXPRESSIONTAPE_HPP_ */
@@ -3,6 +3,7 @@
 
 #include <Eigen/Core>
 #include <aslam/backend/JacobianContainer.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 #include <boost/shared_ptr.hpp>
 #include <set>
 
@@ -18,8 +19,10 @@ namespace aslam {
       virtual ~TransformationExpressionNode();
 
       /// \brief Evaluate the transformation matrix.
-      Eigen::Matrix4d evaluate() { return toTransformationMatrixImplementation(); }
-      Eigen::Matrix4d toTransformationMatrix() { return toTransformationMatrixImplementation(); }
+      Eigen::Matrix4d evaluate() { return toTransformationMatrix(); }
+      Eigen::Matrix4d toTransformationMatrix() {
+        return ExpressionEvaluationContext::value<Eigen::Matrix4d>(this, [this]() { return toTransformationMatrixImplementation(); });
+      }
 
       /// \brief Evaluate the Jacobians
       void evaluateJacobians(JacobianContainer & outJacobians) const;
@@ -65,9 +68,7 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<TransformationExpressionNode> _lhs;
-      Eigen::Matrix4d _T_lhs;
       boost::shared_ptr<TransformationExpressionNode> _rhs;
-      Eigen::Matrix4d _T_rhs;
     };
 
 
@@ -93,7 +94,6 @@ namespace aslam {
       void getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const override;
 
       boost::shared_ptr<TransformationExpressionNode> _dvTransformation;
-      Eigen::Matrix4d _T;
     };
 
 
@@ -3,6 +3,7 @@
 #include <aslam/backend/JacobianContainer.hpp>
 #include <aslam/backend/Differential.hpp>
 #include <aslam/backend/ExpressionNodeVisitor.hpp>
+#include <aslam/backend/ExpressionEvaluationContext.hpp>
 
 namespace aslam {
   namespace backend {
@@ -18,7 +19,7 @@ namespace aslam {
       VectorExpressionNode() = default;
       virtual ~VectorExpressionNode() = default;
       
-      vector_t evaluate() const { return evaluateImplementation(); }
+      vector_t evaluate() const { return ExpressionEvaluationContext::value<vector_t>(this, [this]() { return evaluateImplementation(); }); }
       vector_t toVector() const { return evaluate(); }
       
       void evaluateJacobians(JacobianContainer & outJacobians) const;
@@ -44,8 +44,8 @@ _CLASS::GenericMatrixExpression(ScalarExpression v, dummy) : _root()
 
     virtual ~ResultNode() {}
 
-    void evaluateImplementation() const override {
-      this->_currentValue(0, 0) = this->getOperandNode().evaluate();
+    typename self_t::matrix_t evaluateImplementation() const override {
+      return self_t::matrix_t::Constant(1, 1, this->getOperandNode().evaluate());
     }
 
     inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_node_traits_t::tangent_vector_t & tangent_vector) const {
@@ -149,8 +149,8 @@ public:
 
   virtual ~ResultNode() {}
 
-  virtual void evaluateImplementation() const {
-    this->_currentValue = this->getOperandNode().evaluate();
+  virtual typename result_t::matrix_t evaluateImplementation() const {
+    return this->getOperandNode().evaluate();
   }
 
   inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_t::tangent_vector_t & tangent_vector) const {
@@ -169,8 +169,8 @@ _TEMPLATE GenericMatrixExpression<ICols, IRows, TScalar> _CLASS::transpose() con
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const override {
-      this->_currentValue = this->getOperandNode().evaluate().transpose();
+    virtual typename result_t::matrix_t evaluateImplementation() const override {
+      return this->getOperandNode().evaluate().transpose();
     }
 
     inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_t::tangent_vector_t & tangent_vector) const {
@@ -223,13 +223,13 @@ _TEMPLATE GenericMatrixExpression<ICols, IRows, TScalar> _CLASS::inverse() const
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getOperandNode().evaluate().inverse();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getOperandNode().evaluate().inverse();
     }
 
     inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_t::tangent_vector_t & tangent_vector) const {
-      evaluateImplementation();
-      return - this->_currentValue * tangent_vector * this->_currentValue;
+      const typename result_t::matrix_t inverse = evaluateImplementation();
+      return - inverse * tangent_vector * inverse;
     }
   };
 
@@ -247,8 +247,8 @@ GenericMatrixExpression<IRows, IColsOther, TScalar> _CLASS::operator*(const Gene
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getLhsNode().evaluate() * this->getRhsNode().evaluate();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getLhsNode().evaluate() * this->getRhsNode().evaluate();
     }
 
     inline typename base_t::apply_diff_return_t applyLhsDiff(const typename base_t::lhs_t::tangent_vector_t & tangent_vector) const {
@@ -273,8 +273,8 @@ typename _CLASS::default_self_t _CLASS::operator+(const GenericMatrixExpression<
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getLhsNode().evaluate() + this->getRhsNode().evaluate();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getLhsNode().evaluate() + this->getRhsNode().evaluate();
     }
 
     inline typename base_t::apply_diff_return_t applyLhsDiff(const typename base_t::lhs_t::tangent_vector_t & tangent_vector) const {
@@ -300,8 +300,8 @@ typename _CLASS::default_self_t _CLASS::operator-(const GenericMatrixExpression<
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getLhsNode().evaluate() - this->getRhsNode().evaluate();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getLhsNode().evaluate() - this->getRhsNode().evaluate();
     }
 
     inline typename base_t::apply_diff_return_t applyLhsDiff(const typename base_t::lhs_t::tangent_vector_t & tangent_vector) const {
@@ -325,8 +325,8 @@ typename _CLASS::default_self_t _CLASS::operator-() const {
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = -this->getOperandNode().evaluate();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return -this->getOperandNode().evaluate();
     }
 
     inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_t::tangent_vector_t & tangent_vector) const {
@@ -348,8 +348,8 @@ typename _CLASS::default_self_t _CLASS::operator*(const ScalarExpression & scala
     typedef BinaryOperationResultNode<ResultNode, self_t, other_t, result_t, typename result_t::tangent_vector_t, typename result_t::scalar_t> base_t _PSEUDO_UNUSED_FOR_CLANG;
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getLhsNode().evaluate() * this->getRhsNode().evaluate();
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getLhsNode().evaluate() * this->getRhsNode().evaluate();
     }
 
     inline typename base_t::apply_diff_return_t applyLhsDiff(const typename base_t::lhs_t::tangent_vector_t & tangent_vector) const {
@@ -374,8 +374,8 @@ typename _CLASS::default_self_t _CLASS::operator*(TScalar scalar) const {
     ResultNode(TScalar scalar) : _scalar(scalar) {}
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      this->_currentValue = this->getOperandNode().evaluate() * _scalar;
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return this->getOperandNode().evaluate() * _scalar;
     }
 
     inline typename base_t::apply_diff_return_t applyDiff(const typename base_t::operand_t::tangent_vector_t & tangent_vector) const {
@@ -443,8 +443,12 @@ GenericMatrixExpression<3, (ICols == 1 ? IColsOther : ICols), TScalar> _CLASS::c
 
     virtual ~ResultNode() {}
 
-    virtual void evaluateImplementation() const {
-      calculator_t::calcCrossInto(this->getLhsNode().evaluate(), this->getRhsNode().evaluate(), this->_currentValue);
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      auto lhs = this->getLhsNode().evaluate();
+      auto rhs = this->getRhsNode().evaluate();
+      typename result_t::matrix_t result(3, std::max(lhs.cols(), rhs.cols()));
+      calculator_t::calcCrossInto(lhs, rhs, result);
+      return result;
     }
 
     inline typename base_t::apply_diff_return_t applyLhsDiff(const typename base_t::lhs_t::tangent_vector_t & tangent_vector) const {
@@ -189,8 +189,8 @@ inline typename _CLASS::self_with_default_node_t _CLASS::operator * (const Quate
       return internal::EigenQuaternionCalculator<TScalar, EMode>::quatMult(this->getLhsNode().evaluate(), tangent_vector);
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = internal::EigenQuaternionCalculator<TScalar, EMode>::quatMult(this->getLhsNode().evaluate(), this->getRhsNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return internal::EigenQuaternionCalculator<TScalar, EMode>::quatMult(this->getLhsNode().evaluate(), this->getRhsNode().evaluate());
     }
   };
 
@@ -217,8 +217,8 @@ inline typename _CLASS::self_with_default_node_t _CLASS::inverse() const {
       return -calc_t::quatMult(operandValConj, calc_t::quatMult(tangentVector, operandValConj)) / (valSquared * valSquared);
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = calc_t::invert(this->getOperandNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return calc_t::invert(this->getOperandNode().evaluate());
     }
   };
 
@@ -237,8 +237,8 @@ typename _CLASS::self_with_default_node_t _CLASS::conjugate() const {
       return internal::EigenQuaternionCalculator<TScalar, EMode>::conjugate(tangentVector);
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = internal::EigenQuaternionCalculator<TScalar, EMode>::conjugate(this->getOperandNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return internal::EigenQuaternionCalculator<TScalar, EMode>::conjugate(this->getOperandNode().evaluate());
     }
   };
 
@@ -260,8 +260,8 @@ inline GenericMatrixExpression<3, 1, TScalar> _CLASS::imaginaryPart() const {
       return calc_t::getImagPart(tangentVector);
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = calc_t::getImagPart(this->getOperandNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return calc_t::getImagPart(this->getOperandNode().evaluate());
     }
   };
 
@@ -295,9 +295,9 @@ GenericMatrixExpression<3, 1,TScalar> _CLASS::rotate3Vector(const GenericMatrixE
       return calc_t::getImagPart(calc_t::quatMult(calc_t::quatMult(lhsVal, tangent_vector), calc_t::conjugate(lhsVal)));
     }
   private:
-    virtual void evaluateImplementation() const {
+    virtual typename result_t::matrix_t evaluateImplementation() const {
       auto lhsVal = this->getLhsNode().evaluate();
-      this->_currentValue = calc_t::getImagPart(calc_t::quatMult(calc_t::quatMult(lhsVal, this->getRhsNode().evaluate()), calc_t::conjugate(lhsVal)));
+      return calc_t::getImagPart(calc_t::quatMult(calc_t::quatMult(lhsVal, this->getRhsNode().evaluate()), calc_t::conjugate(lhsVal)));
     }
   };
 
@@ -320,8 +320,8 @@ typename _CLASS::tangent_vector_expression_t _CLASS::log(const UnitQuaternionExp
       this->getOperandNode().evaluateJacobians(outJacobians, ComposedMatrixDifferential<typename result_t::differential_t::domain_t, TScalar, decltype(M) &, 4>(M, diff));
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = calc_t::log(this->getOperandNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return calc_t::log(this->getOperandNode().evaluate());
     }
   };
 
@@ -343,8 +343,8 @@ typename _CLASS::self_with_default_node_t _CLASS::exp(const GenericMatrixExpress
       this->getOperandNode().evaluateJacobians(outJacobians, ComposedMatrixDifferential<typename result_t::differential_t::domain_t, TScalar, decltype(M) &, 3>(M, diff));
     }
   private:
-    virtual void evaluateImplementation() const {
-      this->_currentValue = calc_t::exp(this->getOperandNode().evaluate());
+    virtual typename result_t::matrix_t evaluateImplementation() const {
+      return calc_t::exp(this->getOperandNode().evaluate());
     }
   };
 
@@ -17,12 +17,13 @@ namespace backend {
 /// \brief Evaluate the scalar matrix.
 double ScalarExpressionNode::toScalar() const
 {
-  return evaluateImplementation();
+  return ExpressionEvaluationContext::value<double>(this, [this]() { return evaluateImplementation(); });
 }
 
 /// \brief Evaluate the Jacobians
 void ScalarExpressionNode::evaluateJacobians(JacobianContainer & outJacobians) const
 {
+  ExpressionEvaluationContext::Scope scope;
   evaluateJacobiansImplementation(outJacobians);
 }
 
@@ -4,11 +4,13 @@ namespace backend {
 
 template<int D>
 void VectorExpressionNode<D>::evaluateJacobians(JacobianContainer & outJacobians) const {
+  ExpressionEvaluationContext::Scope scope;
   evaluateJacobiansImplementation(outJacobians);
 }
 
 template<int D>
 void VectorExpressionNode<D>::evaluateJacobians(JacobianContainer & outJacobians, const differential_t & diff) const {
+  ExpressionEvaluationContext::Scope scope;
   evaluateJacobiansImplementationWithDifferential(outJacobians, diff);
 }
 
@@ -20,13 +20,14 @@ namespace aslam {
     /// \brief Evaluate the homogeneous matrix.
     Eigen::Vector4d HomogeneousExpressionNode::toHomogeneous() const
     {
-      return toHomogeneousImplementation();
+      return ExpressionEvaluationContext::value<Eigen::Vector4d>(this, [this]() { return toHomogeneousImplementation(); });
     }
 
       
     /// \brief Evaluate the Jacobians
     void HomogeneousExpressionNode::evaluateJacobians(JacobianContainer & outJacobians) const
     {
+      ExpressionEvaluationContext::Scope scope;
       evaluateJacobiansImplementation(outJacobians);
     }
    
@@ -42,8 +43,6 @@ namespace aslam {
 								     boost::shared_ptr<HomogeneousExpressionNode> rhs) :
       _lhs(lhs), _rhs(rhs)
     {
-      _T_lhs = _lhs->toTransformationMatrix();
-      _p_rhs = _rhs->toHomogeneous();
     }
 
     HomogeneousExpressionNodeMultiply::~HomogeneousExpressionNodeMultiply()
@@ -55,16 +54,14 @@ namespace aslam {
     
     Eigen::Vector4d HomogeneousExpressionNodeMultiply::toHomogeneousImplementation() const
     {
-      _T_lhs = _lhs->toTransformationMatrix();
-      _p_rhs = _rhs->toHomogeneous();
-
-      return _T_lhs * _p_rhs;
+      return _lhs->toTransformationMatrix() * _rhs->toHomogeneous();
     }
 
     void HomogeneousExpressionNodeMultiply::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const
     {
-      _lhs->evaluateJacobians(outJacobians, sm::kinematics::boxMinus(_T_lhs * _p_rhs));
-      _rhs->evaluateJacobians(outJacobians, _T_lhs);
+      const Eigen::Matrix4d T_lhs = _lhs->toTransformationMatrix();
+      _lhs->evaluateJacobians(outJacobians, sm::kinematics::boxMinus(T_lhs * _rhs->toHomogeneous()));
+      _rhs->evaluateJacobians(outJacobians, T_lhs);
     }
 
     void HomogeneousExpressionNodeMultiply::getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const
@@ -13,10 +13,11 @@ MatrixExpressionNode::~MatrixExpressionNode() {
 }
 
 Eigen::Matrix3d MatrixExpressionNode::evaluate() {
-  return evaluateImplementation();
+  return ExpressionEvaluationContext::value<Eigen::Matrix3d>(this, [this]() { return evaluateImplementation(); });
 }
 
 void MatrixExpressionNode::evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const {
+  ExpressionEvaluationContext::Scope scope;
   evaluateJacobiansImplementation(outJacobians, applyChainRule);
 }
 
@@ -51,21 +51,17 @@ namespace aslam {
     RotationExpressionNodeMultiply::RotationExpressionNodeMultiply(boost::shared_ptr<RotationExpressionNode> lhs, boost::shared_ptr<RotationExpressionNode> rhs)
         : _lhs(lhs),
           _rhs(rhs) {
-      _C_lhs = _lhs->toRotationMatrix();
-      _C_rhs = _rhs->toRotationMatrix();
     }
 
     RotationExpressionNodeMultiply::~RotationExpressionNodeMultiply(){
     }
 
     Eigen::Matrix3d RotationExpressionNodeMultiply::toRotationMatrixImplementation() const {
-      _C_lhs = _lhs->toRotationMatrix();
-      _C_rhs = _rhs->toRotationMatrix();
-      return _C_lhs * _C_rhs;
+      return _lhs->toRotationMatrix() * _rhs->toRotationMatrix();
     }
 
     void RotationExpressionNodeMultiply::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const {
-      _rhs->evaluateJacobians(outJacobians, _C_lhs);
+      _rhs->evaluateJacobians(outJacobians, _lhs->toRotationMatrix());
       _lhs->evaluateJacobians(outJacobians);
     }
 
@@ -81,20 +77,18 @@ namespace aslam {
     
     RotationExpressionNodeInverse::RotationExpressionNodeInverse(boost::shared_ptr<RotationExpressionNode> dvRotation) : _dvRotation(dvRotation)
       {
-	_C = _dvRotation->toRotationMatrix();
       }
     
     RotationExpressionNodeInverse::~RotationExpressionNodeInverse(){}
 
     Eigen::Matrix3d RotationExpressionNodeInverse::toRotationMatrixImplementation() const
     {
-      _C = _dvRotation->toRotationMatrix();
-      return  _C.transpose();
+      return  _dvRotation->toRotationMatrix().transpose();
     }
 
     void RotationExpressionNodeInverse::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const
     {
-      _dvRotation->evaluateJacobians(outJacobians, -_C.transpose());
+      _dvRotation->evaluateJacobians(outJacobians, -_dvRotation->toRotationMatrix().transpose());
     }
 
     void RotationExpressionNodeInverse::getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const
@@ -19,7 +19,8 @@ class ScalarExpressionNodeNamedConstant : public ScalarExpressionNodeConstant
  public:
   ScalarExpressionNodeNamedConstant(const char *name, double s) : ScalarExpressionNodeConstant(s), _name(name){}
   void accept(ExpressionNodeVisitor& visitor) override {
-    visitor.visit(_name.c_str(), this);
+    // Visited as a constant, only the name differs
+    visitor.visit(_name.c_str(), static_cast<ScalarExpressionNodeConstant*>(this));
   }
  protected:
   std::string _name;
@@ -313,6 +313,18 @@ namespace aslam {
         void ScalarExpressionNodeConstant::accept(ExpressionNodeVisitor& visitor) {
           visitor.visit("#", this);
         }
+
+        void ScalarExpressionNodeSqrt::accept(ExpressionNodeVisitor& visitor) {
+          visitor.visit("sqrt", this, _lhs);
+        }
+
+        void ScalarExpressionNodeLog::accept(ExpressionNodeVisitor& visitor) {
+          visitor.visit("log", this, _lhs);
+        }
+
+        void ScalarExpressionNodeExp::accept(ExpressionNodeVisitor& visitor) {
+          visitor.visit("exp", this, _lhs);
+        }
     } // namespace backend
 }  // namespace aslam
 
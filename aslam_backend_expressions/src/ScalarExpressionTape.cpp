@@ -0,0 +1,265 @@
+#include <aslam/backend/ScalarExpressionTape.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include <sm/assert_macros.hpp>
+
+#include <aslam/Exceptions.hpp>
+#include <aslam/backend/ExpressionNodeVisitor.hpp>
+#include <aslam/backend/ScalarExpression.hpp>
+#include <aslam/backend/ScalarExpressionNode.hpp>
+
+namespace aslam {
+namespace backend {
+
+/// \brief Appends the instructions of a scalar expression graph to a tape, operands first
+class ScalarExpressionTape::Compiler : public ExpressionNodeVisitor {
+ public:
+  Compiler(std::vector<Instruction> & tape) : _tape(tape) {}
+
+  void compile(const ScalarExpression & expression) {
+    expression.accept(*this);
+  }
+
+ private:
+  /// \brief Nodes with a dedicated opcode, identified by the type they pass to ExpressionNodeVisitor::visit()
+  void visitV(NodeI & node) override {
+    const void * key = node.getNode();
+    if (lookup(key))
+      return;
+    const std::type_info & type = node.getNodeType();
+    Instruction in;
+    if (type == typeid(ScalarExpressionNodeConstant)) {
+      in.op = OpCode::Constant;
+      in.parameter = static_cast<const ScalarExpressionNodeConstant *>(key)->_s;
+    } else if (type == typeid(ScalarExpressionNodeAdd)) {
+      in.op = OpCode::Add;
+      in.lhs = operand(node, 0);
+      in.rhs = operand(node, 1);
+      in.parameter = static_cast<const ScalarExpressionNodeAdd *>(key)->_multiplyRhs;
+    } else if (type == typeid(ScalarExpressionNodeMultiply)) {
+      in.op = OpCode::Multiply;
+      in.lhs = operand(node, 0);
+      in.rhs = operand(node, 1);
+    } else if (type == typeid(ScalarExpressionNodeDivide)) {
+      in.op = OpCode::Divide;
+      in.lhs = operand(node, 0);
+      in.rhs = operand(node, 1);
+    } else if (type == typeid(ScalarExpressionNodeNegated)) {
+      in.op = OpCode::Negate;
+      in.rhs = operand(node, 0);
+    } else if (type == typeid(ScalarExpressionNodeSqrt)) {
+      in.op = OpCode::Sqrt;
+      in.lhs = operand(node, 0);
+    } else if (type == typeid(ScalarExpressionNodeLog)) {
+      in.op = OpCode::Log;
+      in.lhs = operand(node, 0);
+    } else if (type == typeid(ScalarExpressionNodeExp)) {
+      in.op = OpCode::Exp;
+      in.lhs = operand(node, 0);
+    } else {
+      SM_THROW(Exception, "The scalar expression node " << node.getName() << " of type " << type.name() << " is not supported by the tape");
+    }
+    append(key, in);
+  }
+
+  /// \brief Nodes without a dedicated opcode visit themselves as ScalarExpressionNode, see ScalarExpressionNode::accept()
+  void visitTypeInfo(const std::type_info & /* type_info */, void * ptr) override {
+    if (lookup(ptr))
+      return;
+    Instruction in;
+    in.op = OpCode::Node;
+    in.node = static_cast<const ScalarExpressionNode *>(ptr);
+    append(ptr, in);
+  }
+
+  void visitString(const char * text) override {
+    SM_THROW(Exception, "Unexpected node " << text << " in a scalar expression");
+  }
+
+  void nullNodeV() override {
+    SM_THROW(Exception, "Null node in a scalar expression");
+  }
+
+  /// \brief Compile operand \p i of \p node and return its slot
+  int operand(NodeI & node, size_t i) {
+    node.accept(i, *this);
+    return _slot;
+  }
+
+  /// \brief Shared subexpressions are compiled once
+  bool lookup(const void * key) {
+    auto it = _slots.find(key);
+    if (it == _slots.end())
+      return false;
+    _slot = it->second;
+    return true;
+  }
+
+  void append(const void * key, const Instruction & in) {
+    _slot = static_cast<int>(_tape.size());
+    _slots.emplace(key, _slot);
+    _tape.push_back(in);
+  }
+
+  std::vector<Instruction> & _tape;
+  std::unordered_map<const void *, int> _slots;
+  /// \brief The slot of the last visited node
+  int _slot = -1;
+};
+
+ScalarExpressionTape::ScalarExpressionTape(const ScalarExpression& expression)
+    : _root(expression.root())
+{
+  Compiler compiler(_tape);
+  compiler.compile(expression);
+  SM_ASSERT_FALSE(Exception, _tape.empty(), "");
+}
+
+ScalarExpressionTape::~ScalarExpressionTape()
+{
+}
+
+std::size_t ScalarExpressionTape::numNodeCalls() const
+{
+  std::size_t n = 0;
+  for (const Instruction & in : _tape) {
+    if (in.op == OpCode::Node)
+      ++n;
+  }
+  return n;
+}
+
+ScalarExpressionTape::Context & ScalarExpressionTape::threadContext()
+{
+  static thread_local Context context;
+  return context;
+}
+
+void ScalarExpressionTape::evaluateSlots(Context & context) const
+{
+  // Same operations as the evaluateImplementation() of the nodes
+  context.resize(_tape.size());
+  const Instruction * in = _tape.data();
+  double * v = context.data();
+  for (std::size_t i = 0; i < _tape.size(); ++i, ++in) {
+    switch (in->op) {
+      case OpCode::Constant:
+        v[i] = in->parameter;
+        break;
+      case OpCode::Node:
+        v[i] = in->node->toScalar();
+        break;
+      case OpCode::Add:
+        v[i] = v[in->lhs] + in->parameter * v[in->rhs];
+        break;
+      case OpCode::Multiply:
+        v[i] = v[in->lhs] * v[in->rhs];
+        break;
+      case OpCode::Divide:
+        v[i] = v[in->lhs] / v[in->rhs];
+        break;
+      case OpCode::Negate:
+        v[i] = -v[in->rhs];
+        break;
+      case OpCode::Sqrt:
+        SM_ASSERT_GT(std::runtime_error, v[in->lhs], 0.0, "");
+        v[i] = std::sqrt(v[in->lhs]);
+        break;
+      case OpCode::Log:
+        SM_ASSERT_GT(std::runtime_error, v[in->lhs], 0.0, "");
+        v[i] = std::log(v[in->lhs]);
+        break;
+      case OpCode::Exp:
+        v[i] = std::exp(v[in->lhs]);
+        break;
+    }
+  }
+}
+
+double ScalarExpressionTape::evaluate() const
+{
+  return evaluate(threadContext());
+}
+
+double ScalarExpressionTape::evaluate(Context & context) const
+{
+  evaluateSlots(context);
+  return context.back();
+}
+
+void ScalarExpressionTape::evaluateJacobians(JacobianContainer & outJacobians) const
+{
+  evaluateJacobians(threadContext(), outJacobians);
+}
+
+void ScalarExpressionTape::evaluateJacobians(Context & context, JacobianContainer & outJacobians) const
+{
+  evaluateSlots(context);
+  const std::size_t n = _tape.size();
+  context.resize(2 * n);
+  const double * v = context.data();
+  double * adjoint = context.data() + n;
+  std::fill(adjoint, adjoint + n, 0.0);
+  adjoint[n - 1] = 1.0;
+
+  // One reverse sweep, the users of a slot follow it on the tape and have added to its adjoint when it is reached.
+  // The chain rule factors are those of the evaluateJacobiansImplementation() of the nodes, multiplied from the root.
+  for (std::size_t i = n; i-- > 0; ) {
+    const Instruction & in = _tape[i];
+    const double a = adjoint[i];
+    switch (in.op) {
+      case OpCode::Constant:
+      case OpCode::Node:
+        break;
+      case OpCode::Add:
+        adjoint[in.lhs] += a;
+        adjoint[in.rhs] += a * in.parameter;
+        break;
+      case OpCode::Multiply:
+        adjoint[in.lhs] += a * v[in.rhs];
+        adjoint[in.rhs] += a * v[in.lhs];
+        break;
+      case OpCode::Divide: {
+        const double rhs_rec = 1./v[in.rhs];
+        const double R = -v[in.lhs] * rhs_rec * rhs_rec;
+        adjoint[in.lhs] += a * rhs_rec;
+        adjoint[in.rhs] += a * R;
+        break;
+      }
+      case OpCode::Negate:
+        adjoint[in.rhs] += a * -1.0;
+        break;
+      case OpCode::Sqrt:
+        adjoint[in.lhs] += a * (1./(2.*std::sqrt(v[in.lhs])));
+        break;
+      case OpCode::Log:
+        adjoint[in.lhs] += a * (1./(v[in.lhs]));
+        break;
+      case OpCode::Exp:
+        adjoint[in.lhs] += a * v[i];
+        break;
+    }
+  }
+
+  // The nodes in tape order, which is the order the expression reaches them in
+  for (std::size_t i = 0; i < n; ++i) {
+    if (_tape[i].op == OpCode::Node)
+      _tape[i].node->evaluateJacobians(outJacobians.apply(adjoint[i]));
+  }
+}
+
+void ScalarExpressionTape::evaluateJacobians(JacobianContainer & outJacobians, const Eigen::MatrixXd & applyChainRule) const
+{
+  evaluateJacobians(outJacobians.apply(applyChainRule));
+}
+
+void ScalarExpressionTape::getDesignVariables(DesignVariable::set_t & designVariables) const
+{
+  _root->getDesignVariables(designVariables);
+}
+
+} // namespace backend
+} // namespace aslam
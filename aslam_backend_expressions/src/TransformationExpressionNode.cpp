@@ -19,6 +19,7 @@ namespace aslam {
 
     void TransformationExpressionNode::evaluateJacobians(JacobianContainer & outJacobians) const
     {
+      ExpressionEvaluationContext::Scope scope;
       evaluateJacobiansImplementation(outJacobians);
     }      
       
@@ -51,14 +52,12 @@ namespace aslam {
 
     Eigen::Matrix4d TransformationExpressionNodeMultiply::toTransformationMatrixImplementation()
     {
-      _T_lhs = _lhs->toTransformationMatrix();
-      _T_rhs = _rhs->toTransformationMatrix();
-      return  _T_lhs * _T_rhs;
+      return  _lhs->toTransformationMatrix() * _rhs->toTransformationMatrix();
     }
 
     void TransformationExpressionNodeMultiply::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const
     {	
-      _rhs->evaluateJacobians(outJacobians,sm::kinematics::boxTimes(_T_lhs));
+      _rhs->evaluateJacobians(outJacobians,sm::kinematics::boxTimes(_lhs->toTransformationMatrix()));
       _lhs->evaluateJacobians(outJacobians);
     }
 
@@ -74,13 +73,12 @@ namespace aslam {
 
     Eigen::Matrix4d TransformationExpressionNodeInverse::toTransformationMatrixImplementation()
     {
-      _T = _dvTransformation->toTransformationMatrix().inverse();
-      return  _T;
+      return  _dvTransformation->toTransformationMatrix().inverse();
     }
 
     void TransformationExpressionNodeInverse::evaluateJacobiansImplementation(JacobianContainer & outJacobians) const
     {
-      _dvTransformation->evaluateJacobians(outJacobians, -sm::kinematics::boxTimes(_T));
+      _dvTransformation->evaluateJacobians(outJacobians, -sm::kinematics::boxTimes(_dvTransformation->toTransformationMatrix().inverse()));
     }
 
     void TransformationExpressionNodeInverse::getDesignVariablesImplementation(DesignVariable::set_t & designVariables) const
@@ -2,6 +2,7 @@
 
 #include <aslam/backend/JacobianContainerSparse.hpp>
 #include <aslam/backend/OptimizerRprop.hpp>
+#include <aslam/backend/OptimizerOWLQN.hpp>
 #include <aslam/backend/OptimizationProblem.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
 #include <aslam/backend/test/ErrorTermTester.hpp>
@@ -130,3 +131,55 @@ TEST(AslamVChargeBackendTestSuite, testL1RegularizerRprop)
     FAIL() << e.what();
   }
 }
+
+TEST(AslamVChargeBackendTestSuite, testL1RegularizerOWLQN)
+{
+  try {
+    using namespace aslam::backend;
+
+    boost::shared_ptr<OptimizationProblem> problem_ptr(new OptimizationProblem);
+    OptimizationProblem& problem = *problem_ptr;
+    vector<aslam::backend::Scalar*> dvs;
+
+    aslam::backend::Scalar dv1(1.0);
+    dv1.setBlockIndex(0);
+    dv1.setActive(true);
+    problem.addDesignVariable(&dv1, false);
+    dvs.push_back(&dv1);
+
+    // The irrelevant design variable must end up exactly at zero
+    aslam::backend::Scalar dv2(10.0);
+    dv2.setBlockIndex(1);
+    dv2.setActive(true);
+    problem.addDesignVariable(&dv2, false);
+    dvs.push_back(&dv2);
+
+    const size_t numErrorTerms = 100;
+    vector< boost::shared_ptr<TestError> > errorTerms;
+    errorTerms.reserve(numErrorTerms);
+    for (size_t i = 0; i < numErrorTerms; ++i) {
+      errorTerms.emplace_back(new TestError(&dv1, (double)i/numErrorTerms));
+      problem.addErrorTerm(errorTerms.back());
+    }
+    boost::shared_ptr<L1Regularizer> reg(new L1Regularizer(dvs, 1.0));
+    EXPECT_TRUE(reg->isL1Norm());
+    problem.addErrorTerm(reg);
+
+    OptimizerOptionsOWLQN options;
+    options.maxIterations = 100;
+    options.convergenceGradientNorm = 1e-9;
+    OptimizerOWLQN optimizer(options);
+    optimizer.setProblem(problem_ptr);
+    optimizer.optimize();
+
+    // sum_i 0.5 (v_i - dv1)^2 + |dv1| is minimized at mean(v_i) - 1/numErrorTerms
+    EXPECT_GT(optimizer.getStatus().convergence, ConvergenceStatus::FAILURE);
+    EXPECT_EQ(2u, optimizer.getNumL1Parameters());
+    EXPECT_EQ(1u, optimizer.getNumZeroL1Parameters());
+    EXPECT_EQ(0.0, dv2.getParameters()(0,0));
+    EXPECT_NEAR(0.495 - 1.0/numErrorTerms, dv1.getParameters()(0,0), 1e-6);
+
+  } catch(const std::exception & e) {
+    FAIL() << e.what();
+  }
+}
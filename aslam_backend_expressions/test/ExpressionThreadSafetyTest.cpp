@@ -0,0 +1,134 @@
+#include <sm/eigen/gtest.hpp>
+#include <sm/kinematics/quaternion_algebra.hpp>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/HomogeneousPoint.hpp>
+#include <aslam/backend/RotationExpression.hpp>
+#include <aslam/backend/EuclideanExpression.hpp>
+#include <aslam/backend/HomogeneousExpression.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/DesignVariableGenericVector.hpp>
+#include <aslam/backend/GenericMatrixExpression.hpp>
+#include <aslam/backend/Scalar.hpp>
+#include <aslam/backend/ScalarExpression.hpp>
+#include <aslam/backend/ScalarExpressionTape.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+
+using namespace aslam::backend;
+
+namespace {
+
+const int numThreads = 8;
+const int numIterations = 200;
+
+/// \brief Value and Jacobians of an expression, flattened for an exact comparison
+struct Evaluation {
+  Eigen::VectorXd value;
+  Eigen::MatrixXd J;
+
+  bool operator==(const Evaluation & other) const {
+    return value.size() == other.value.size() && J.rows() == other.J.rows() && J.cols() == other.J.cols()
+        && (value.array() == other.value.array()).all() && (J.array() == other.J.array()).all();
+  }
+};
+
+template <int Dimension, typename TExpression, typename TToValue>
+boost::function<Evaluation ()> evaluation(const TExpression & expression, TToValue toValue) {
+  return [expression, toValue]() {
+    Evaluation result;
+    result.value = toValue(expression);
+    JacobianContainerSparse<Dimension> J(Dimension);
+    expression.evaluateJacobians(J);
+    result.J = J.asDenseMatrix();
+    return result;
+  };
+}
+
+/// \brief Evaluates all \p evaluations concurrently from many threads and counts the deviations from the serial results
+int countConcurrentDeviations(const std::vector<boost::function<Evaluation ()> > & evaluations) {
+  std::vector<Evaluation> serial;
+  for (auto & e : evaluations)
+    serial.push_back(e());
+
+  std::vector<int> deviations(numThreads, 0);
+  boost::thread_group threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.create_thread([&, t]() {
+      for (int i = 0; i < numIterations; ++i) {
+        // Each thread starts with a different expression to interleave the shared subgraphs
+        for (std::size_t k = 0; k < evaluations.size(); ++k) {
+          const std::size_t n = (k + t + i) % evaluations.size();
+          if (!(evaluations[n]() == serial[n]))
+            ++deviations[t];
+        }
+      }
+    });
+  }
+  threads.join_all();
+
+  int sum = 0;
+  for (int d : deviations)
+    sum += d;
+  return sum;
+}
+
+} // namespace
+
+TEST(ExpressionThreadSafetyTestSuite, testConcurrentEvaluationOfSharedSubgraphs)
+{
+  try {
+    RotationQuaternion C(sm::kinematics::quatRandom());
+    EuclideanPoint p(Eigen::Vector3d::Random());
+    HomogeneousPoint hp(Eigen::Vector4d::Random());
+    DesignVariableGenericVector<3> v(Eigen::Vector3d::Random());
+    Scalar a(0.7), b(1.3);
+    int blockIndex = 0, columnBase = 0;
+    for (DesignVariable * dv : std::vector<DesignVariable *>{&C, &p, &hp, &v, &a, &b}) {
+      dv->setActive(true);
+      dv->setBlockIndex(blockIndex++);
+      dv->setColumnBase(columnBase);
+      columnBase += dv->minimalDimensions();
+    }
+
+    RotationExpression Ce = C.toExpression();
+    EuclideanExpression pe = p.toExpression();
+    // Subgraphs shared by all expressions below
+    RotationExpression CC = Ce * Ce.inverse() * Ce;
+    EuclideanExpression Cp = CC * pe;
+    TransformationExpression T(CC, Cp);
+
+    typedef GenericMatrixExpression<3, 1> GV;
+    GV ve(&v);
+    GV vv = (GenericMatrixExpression<3, 3>(Eigen::Matrix3d::Random()) * ve).cross(ve) - ve;
+
+    ScalarExpression ae = a.toExpression(), be = b.toExpression();
+    ScalarExpression shared = ae * be + 0.5;
+    ScalarExpression s = sqrt(shared * shared + 1.0) / be - log(shared) * exp(ae);
+    ScalarExpressionTape tape(s);
+
+    auto toEuclidean = [](const EuclideanExpression & e) -> Eigen::VectorXd { return e.evaluate(); };
+    auto toHomogeneous = [](const HomogeneousExpression & e) -> Eigen::VectorXd { return e.toHomogeneous(); };
+    auto toGeneric = [](const GV & e) -> Eigen::VectorXd { return e.evaluate(); };
+    auto toScalar = [](const ScalarExpression & e) -> Eigen::VectorXd { return Eigen::VectorXd::Constant(1, e.toScalar()); };
+    auto toTape = [](const ScalarExpressionTape & e) -> Eigen::VectorXd { return Eigen::VectorXd::Constant(1, e.toScalar()); };
+
+    std::vector<boost::function<Evaluation ()> > evaluations;
+    evaluations.push_back(evaluation<3>(Cp, toEuclidean));
+    evaluations.push_back(evaluation<3>(CC.inverse() * Cp, toEuclidean));
+    evaluations.push_back(evaluation<3>(Cp.cross(CC * Cp), toEuclidean));
+    evaluations.push_back(evaluation<4>(T * hp.toExpression(), toHomogeneous));
+    evaluations.push_back(evaluation<4>(T.inverse() * (T * hp.toExpression()), toHomogeneous));
+    evaluations.push_back(evaluation<3>(vv, toGeneric));
+    evaluations.push_back(evaluation<3>(vv.cross(ve), toGeneric));
+    evaluations.push_back(evaluation<1>(s, toScalar));
+    evaluations.push_back(evaluation<1>(tape, toTape));
+
+    EXPECT_EQ(0, countConcurrentDeviations(evaluations));
+  }
+  catch(std::exception const & e)
+  {
+    FAIL() << e.what();
+  }
+}
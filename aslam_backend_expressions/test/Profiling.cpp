@@ -6,10 +6,16 @@
  */
 
 // standard includes
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <utility>
+
+// Eigen includes
+#include <Eigen/Geometry>
 
 // boost includes
+#include <boost/make_shared.hpp>
 #include <boost/program_options.hpp>
 
 // Schweizer Messer includes
@@ -20,12 +26,17 @@
 #include <aslam/backend/JacobianContainerSparse.hpp>
 #include <aslam/backend/JacobianContainerDense.hpp>
 #include <aslam/backend/Scalar.hpp>
+#include <aslam/backend/ScalarExpressionTape.hpp>
 #include <aslam/backend/GenericMatrixExpression.hpp>
 #include <aslam/backend/DesignVariableGenericVector.hpp>
 #include <aslam/backend/VectorExpression.hpp>
 #include <aslam/backend/DesignVariableVector.hpp>
 #include <aslam/backend/VectorExpressionToGenericMatrixTraits.hpp>
 #include <aslam/backend/CacheExpression.hpp>
+#include <aslam/backend/RotationQuaternion.hpp>
+#include <aslam/backend/EuclideanPoint.hpp>
+#include <aslam/backend/TransformationExpression.hpp>
+#include <aslam/backend/HomogeneousExpression.hpp>
 
 
 using namespace std;
@@ -36,6 +47,121 @@ void evaluateJacobian(const Expression& expr, JacobianContainer& jc) {
   expr.evaluateJacobians(jc);
 }
 
+/// \brief Time the error and Jacobian evaluation of the expression graph \p expr and of its tape with the timer
+///        names "<name> -- NoCache/Tape...". The names of the timers to compare are added to \p speedups.
+void profileTape(const string& name, const ScalarExpression& expr, Scalar& dv, size_t nIterations, size_t updateDvEach,
+                 bool noUpdateDv, bool noError, bool noJacobian, bool noSparse, bool noDense, bool noNonCached,
+                 vector< pair<string, string> >& speedups)
+{
+  const ScalarExpressionTape tape(expr);
+  Eigen::MatrixXd J = Eigen::MatrixXd::Zero(ScalarExpression::Dimension, dv.minimalDimensions());
+  JacobianContainerDense<Eigen::MatrixXd&, ScalarExpression::Dimension> jcDense(J);
+  JacobianContainerSparse<ScalarExpression::Dimension> jcSparse(ScalarExpression::Dimension);
+  const double dx = 1e-3;
+
+  // The loops are not shared to keep indirect calls out of the timings
+  auto updateDv = [&](size_t i) {
+    if (!noUpdateDv && i % updateDvEach == 0) dv.update(&dx, 1);
+  };
+  const string noCache = name + " -- NoCache", tapeName = name + " -- Tape";
+
+  if (!noError) {
+    if (!noNonCached) {
+      sm::timing::Timer timer(noCache + ": Error", false);
+      for (size_t i=0; i<nIterations; ++i) { expr.evaluate(); updateDv(i); }
+    }
+    {
+      sm::timing::Timer timer(tapeName + ": Error", false);
+      for (size_t i=0; i<nIterations; ++i) { tape.evaluate(); updateDv(i); }
+    }
+    if (!noNonCached) speedups.emplace_back(noCache + ": Error", tapeName + ": Error");
+  }
+
+  if (!noJacobian && !noSparse) {
+    if (!noNonCached) {
+      sm::timing::Timer timer(noCache + "/Sparse: Jacobian", false);
+      for (size_t i=0; i<nIterations; ++i) { evaluateJacobian(expr, jcSparse); updateDv(i); }
+    }
+    {
+      sm::timing::Timer timer(tapeName + "/Sparse: Jacobian", false);
+      for (size_t i=0; i<nIterations; ++i) { evaluateJacobian(tape, jcSparse); updateDv(i); }
+    }
+    if (!noNonCached) speedups.emplace_back(noCache + "/Sparse: Jacobian", tapeName + "/Sparse: Jacobian");
+  }
+
+  if (!noJacobian && !noDense) {
+    if (!noNonCached) {
+      sm::timing::Timer timer(noCache + "/Dense: Jacobian", false);
+      for (size_t i=0; i<nIterations; ++i) { evaluateJacobian(expr, jcDense); updateDv(i); }
+    }
+    {
+      sm::timing::Timer timer(tapeName + "/Dense: Jacobian", false);
+      for (size_t i=0; i<nIterations; ++i) { evaluateJacobian(tape, jcDense); updateDv(i); }
+    }
+    if (!noNonCached) speedups.emplace_back(noCache + "/Dense: Jacobian", tapeName + "/Dense: Jacobian");
+  }
+}
+
+/// \brief Time the error and Jacobian evaluation of a point rotated by \p depth rotations, C_1 * (C_2 * (... * p)), and
+///        transformed by the product of \p depth transformations, every other one inverted, with the timer names
+///        "RotationChain/<depth>" and "TransformationChain/<depth>". The Jacobian passes of the product nodes need the
+///        values of their operands. Each chain is evaluated nIterations / depth times, such that equal totals for
+///        different depths mean that the cost grows linearly with the depth.
+void profileChains(int depth, size_t nIterations, bool noError, bool noJacobian)
+{
+  vector< boost::shared_ptr<RotationQuaternion> > rotations;
+  vector< boost::shared_ptr<EuclideanPoint> > translations;
+  EuclideanPoint point(Eigen::Vector3d(1.0, 2.0, 3.0));
+  int block = 0, column = 0;
+  auto activate = [&](DesignVariable& dv) {
+    dv.setActive(true);
+    dv.setBlockIndex(block++);
+    dv.setColumnBase(column);
+    column += dv.minimalDimensions();
+  };
+  activate(point);
+
+  EuclideanExpression rotated = point.toExpression();
+  TransformationExpression transformation;
+  for (int k = 0; k < depth; ++k) {
+    rotations.push_back(boost::make_shared<RotationQuaternion>(Eigen::AngleAxisd(0.1 * (k + 1), Eigen::Vector3d::UnitZ()).toRotationMatrix()));
+    translations.push_back(boost::make_shared<EuclideanPoint>(Eigen::Vector3d::Constant(0.1 * k)));
+    activate(*rotations.back());
+    activate(*translations.back());
+    rotated = rotations.back()->toExpression() * rotated;
+    const TransformationExpression link(rotations.back()->toExpression(), translations.back()->toExpression());
+    transformation = k == 0 ? link : transformation * (k % 2 ? link.inverse() : link);
+  }
+  const HomogeneousExpression transformed = transformation * point.toHomogeneousExpression();
+
+  JacobianContainerSparse<3> jcRotated(3);
+  JacobianContainerSparse<4> jcTransformed(4);
+  const size_t n = std::max<size_t>(nIterations / depth, 1);
+  const string rotationName = "RotationChain/" + to_string(depth), transformationName = "TransformationChain/" + to_string(depth);
+
+  if (!noError) {
+    {
+      sm::timing::Timer timer(rotationName + ": Error", false);
+      for (size_t i=0; i<n; ++i) rotated.evaluate();
+    }
+    {
+      sm::timing::Timer timer(transformationName + ": Error", false);
+      for (size_t i=0; i<n; ++i) transformed.evaluate();
+    }
+  }
+
+  if (!noJacobian) {
+    {
+      sm::timing::Timer timer(rotationName + "/Sparse: Jacobian", false);
+      for (size_t i=0; i<n; ++i) evaluateJacobian(rotated, jcRotated);
+    }
+    {
+      sm::timing::Timer timer(transformationName + "/Sparse: Jacobian", false);
+      for (size_t i=0; i<n; ++i) evaluateJacobian(transformed, jcTransformed);
+    }
+  }
+}
+
 int main(int argc, char** argv)
 {
   try
@@ -49,7 +175,9 @@ int main(int argc, char** argv)
     bool useCaching = false, noUpdateDv = false;
     bool noDense = false, noSparse = false, noScalar = false,
          noMatrix = false, noError = false, noJacobian = false,
-         noCached = false, noNonCached = false;
+         noCached = false, noNonCached = false, noTape = false,
+         noChain = false;
+    vector<int> chainDepths = {1, 4, 16, 64};
 
     namespace po = boost::program_options;
     po::options_description desc("local_planner options");
@@ -70,7 +198,10 @@ int main(int argc, char** argv)
       ("no-jacobian", po::bool_switch(&noJacobian), "Don't profile Jacobian evaluation")
       ("no-cached", po::bool_switch(&noCached), "Don't profile cached expressions")
       ("no-noncached", po::bool_switch(&noNonCached), "Don't profile non-cached expressions")
+      ("no-tape", po::bool_switch(&noTape), "Don't profile expressions compiled to a tape")
       ("no-update-dv", po::bool_switch(&noUpdateDv), "Don't update the design variables after each call")
+      ("no-chain", po::bool_switch(&noChain), "Don't profile chains of rotations and transformations")
+      ("chain-depths", po::value< vector<int> >(&chainDepths)->multitoken(), "Depths of the profiled chains")
     ;
     po::variables_map vm;
     po::store(po::command_line_parser(argc, argv).options(desc).run(), vm);
@@ -158,6 +289,31 @@ int main(int argc, char** argv)
       }
     } // ScalarExpression
 
+    // ****************************** //
+    //    ScalarExpressionTape        //
+    // ****************************** //
+
+    // The speedup of the tapes over the expression graphs, pairs of timer names
+    vector< pair<string, string> > speedups;
+    if (!noScalar && !noTape) {
+      Scalar dv(1.0);
+      dv.setBlockIndex(0);
+      dv.setColumnBase(0);
+      dv.setActive(true);
+      ScalarExpression expr = dv.toExpression();
+      profileTape("LogScalarExpression", log(expr*expr), dv, nIterations, updateDvEach, noUpdateDv,
+                  noError, noJacobian, noSparse, noDense, noNonCached, speedups);
+
+      // A residual with a few dozen nodes and shared subexpressions
+      ScalarExpression large = expr;
+      for (int k = 1; k <= 8; ++k) {
+        ScalarExpression shared = large * expr + double(k);
+        large = shared / (expr*expr + 1.0) - sqrt(shared*shared + 1.0) * (-expr);
+      }
+      profileTape("LargeScalarExpression", large, dv, nIterations, updateDvEach, noUpdateDv,
+                  noError, noJacobian, noSparse, noDense, noNonCached, speedups);
+    } // ScalarExpressionTape
+
     // ***************************** //
     //    GenericMatrixExpression    //
     // ***************************** //
@@ -236,8 +392,21 @@ int main(int argc, char** argv)
       }
     } // GenericMatrixExpression
 
+    // ******************************************** //
+    //    Rotation and transformation chains        //
+    // ******************************************** //
+    if (!noChain) {
+      for (int depth : chainDepths)
+        if (depth > 0)
+          profileChains(depth, nIterations, noError, noJacobian);
+    }
+
     sm::timing::Timing::print(cout, sm::timing::SortType::SORT_BY_TOTAL);
 
+    for (auto& speedup : speedups) {
+      cout << speedup.second << ": speedup " << sm::timing::Timing::getTotalSeconds(speedup.first) / sm::timing::Timing::getTotalSeconds(speedup.second) << endl;
+    }
+
   }
   catch (exception& e)
   {
@@ -0,0 +1,136 @@
+#include <sm/eigen/gtest.hpp>
+#include <algorithm>
+#include <cmath>
+#include <aslam/backend/ScalarExpression.hpp>
+#include <aslam/backend/ScalarExpressionTape.hpp>
+#include <aslam/backend/Scalar.hpp>
+#include <aslam/backend/ExpressionErrorTerm.hpp>
+#include <aslam/backend/JacobianContainerSparse.hpp>
+
+using namespace aslam::backend;
+
+namespace {
+
+/// \brief The Jacobians of expressions with shared subexpressions agree up to rounding, all others are bit-identical
+void expectMatches(const ScalarExpression& expression, const ScalarExpressionTape& tape, bool bitIdentical) {
+  EXPECT_EQ(expression.evaluate(), tape.evaluate());
+  JacobianContainerSparse<1> J(1), JTape(1);
+  expression.evaluateJacobians(J);
+  tape.evaluateJacobians(JTape);
+  const Eigen::MatrixXd Jd = J.asDenseMatrix(), JTaped = JTape.asDenseMatrix();
+  ASSERT_EQ(Jd.rows(), JTaped.rows());
+  ASSERT_EQ(Jd.cols(), JTaped.cols());
+  for (int c = 0; c < Jd.cols(); ++c) {
+    if (bitIdentical)
+      EXPECT_EQ(Jd(0, c), JTaped(0, c)) << "column " << c;
+    else
+      EXPECT_NEAR(Jd(0, c), JTaped(0, c), 1e-12 * std::max(1.0, std::fabs(Jd(0, c)))) << "column " << c;
+  }
+}
+
+} // namespace
+
+TEST(ScalarExpressionTapeTestSuite, testMatchesExpression)
+{
+  try {
+    Scalar a(0.7), b(-1.3), c(2.1), d(1.7), f(0.4);
+    int columnBase = 0;
+    for (Scalar* dv : {&a, &b, &c, &d, &f}) {
+      dv->setActive(true);
+      dv->setBlockIndex(columnBase);
+      dv->setColumnBase(columnBase++);
+    }
+    ScalarExpression ea = a.toExpression(), eb = b.toExpression(), ec = c.toExpression();
+
+    // The shared subexpression is compiled once, sin and atan2 are called through the node interface
+    ScalarExpression shared = ea * eb + ScalarExpression("offset", 0.3);
+    ScalarExpression e = exp(shared / ec) - sqrt(ec * ec + 1.0) * log(ec) + sin(shared) * 2.5 - (-atan2(ea, eb)) / shared;
+    ScalarExpressionTape tape(e);
+    EXPECT_LT(tape.numNodeCalls(), tape.size());
+    EXPECT_EQ(5u, tape.numNodeCalls()); // a, b, c, sin, atan2
+
+    // Without shared nodes, including the design variables, every node is reached on a single path
+    ScalarExpression tree = exp(ea / ec) - sqrt(eb * 2.0 + 3.0) * log(d.toExpression()) - (-sin(f.toExpression())) / 1.5;
+    ScalarExpressionTape treeTape(tree);
+
+    const double dx = 0.05;
+    for (int i = 0; i < 10; ++i) {
+      SCOPED_TRACE(::testing::Message() << "iteration " << i);
+      expectMatches(e, tape, false);
+      expectMatches(tree, treeTape, true);
+      a.update(&dx, 1);
+      c.update(&dx, 1);
+    }
+
+    // Chain rule applied by the caller
+    JacobianContainerSparse<1> J(1), JTape(1);
+    e.evaluateJacobians(J, Eigen::MatrixXd::Constant(1, 1, -0.5));
+    tape.evaluateJacobians(JTape, Eigen::MatrixXd::Constant(1, 1, -0.5));
+    EXPECT_TRUE(J.asDenseMatrix().isApprox(JTape.asDenseMatrix(), 1e-12));
+
+    // A single design variable
+    ScalarExpressionTape leaf(ea);
+    EXPECT_EQ(1u, leaf.size());
+    expectMatches(ea, leaf, true);
+
+    DesignVariable::set_t dvs;
+    tape.getDesignVariables(dvs);
+    EXPECT_EQ(3u, dvs.size());
+  }
+  catch(std::exception const & e)
+  {
+    FAIL() << e.what();
+  }
+}
+
+TEST(ScalarExpressionTapeTestSuite, testDeeplySharedExpression)
+{
+  try {
+    Scalar a(0.7);
+    a.setActive(true);
+    a.setBlockIndex(0);
+    a.setColumnBase(0);
+    // Every level uses the previous one twice, the expression has 2^60 paths to the design variable but the tape is linear
+    ScalarExpression e = a.toExpression();
+    for (int i = 0; i < 60; ++i)
+      e = (e + e) * 0.5;
+    ScalarExpressionTape tape(e);
+    EXPECT_LE(tape.size(), 3u * 60u + 1u);
+    EXPECT_EQ(0.7, tape.evaluate());
+    JacobianContainerSparse<1> J(1);
+    tape.evaluateJacobians(J);
+    EXPECT_EQ(1.0, J.asDenseMatrix()(0, 0));
+  }
+  catch(std::exception const & e)
+  {
+    FAIL() << e.what();
+  }
+}
+
+TEST(ScalarExpressionTapeTestSuite, testExpressionErrorTerm)
+{
+  try {
+    Scalar a(0.7), b(-1.3);
+    a.setActive(true);
+    a.setBlockIndex(0);
+    a.setColumnBase(0);
+    b.setActive(true);
+    b.setBlockIndex(1);
+    b.setColumnBase(1);
+    ScalarExpression e = a.toExpression() * b.toExpression() - 0.5;
+    auto errorTerm = toErrorTerm(e, 2.0);
+    auto tapeErrorTerm = toErrorTerm(ScalarExpressionTape(e));
+    tapeErrorTerm->setInvR(Eigen::Matrix<double, 1, 1>::Constant(2.0));
+    EXPECT_EQ(errorTerm->evaluateError(), tapeErrorTerm->evaluateError());
+    EXPECT_EQ(2u, tapeErrorTerm->numDesignVariables());
+
+    JacobianContainerSparse<1> J(1), JTape(1);
+    errorTerm->getWeightedJacobians(J, false);
+    tapeErrorTerm->getWeightedJacobians(JTape, false);
+    EXPECT_TRUE((J.asDenseMatrix().array() == JTape.asDenseMatrix().array()).all());
+  }
+  catch(std::exception const & e)
+  {
+    FAIL() << e.what();
+  }
+}
@@ -9,6 +9,8 @@ from libaslam_backend_python import *
 # typedefs
 class OptimizerStatusRprop(OptimizerStatus): pass
 class OptimizerStatusBFGS(OptimizerStatus): pass
+class OptimizerStatusLBFGS(OptimizerStatus): pass
+class OptimizerStatusNCG(OptimizerStatus): pass
 
 class TransformationDv(object):
     def __init__(self, transformation, rotationActive=True, translationActive=True ):
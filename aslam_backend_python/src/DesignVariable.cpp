@@ -19,6 +19,14 @@ Eigen::MatrixXd getParameters(const DesignVariable& dv) {
   return p;
 }
 
+Eigen::VectorXd lowerBound(const DesignVariable& dv) {
+  return dv.lowerBound();
+}
+
+Eigen::VectorXd upperBound(const DesignVariable& dv) {
+  return dv.upperBound();
+}
+
 void exportDesignVariable()
 {
 
@@ -60,6 +68,27 @@ void exportDesignVariable()
 
     .def("scaling", &DesignVariable::scaling)
 
+    /// \brief the fill-reducing ordering eliminates lower groups before higher ones
+    .def("orderingGroup", &DesignVariable::orderingGroup)
+
+    /// \brief set the ordering group of this design variable
+    .def("setOrderingGroup", &DesignVariable::setOrderingGroup)
+
+    /// \brief set box bounds on the parameters of a vector space design variable
+    .def("setBounds", &DesignVariable::setBounds)
+
+    /// \brief remove the box bounds
+    .def("clearBounds", &DesignVariable::clearBounds)
+
+    /// \brief whether this design variable has box bounds
+    .def("hasBounds", &DesignVariable::hasBounds)
+
+    /// \brief the lower bounds of the parameters, empty without bounds
+    .def("lowerBound", &lowerBound)
+
+    /// \brief the upper bounds of the parameters, empty without bounds
+    .def("upperBound", &upperBound)
+
     /// Returns the content of the design variable
     .def("getParameters", &getParameters)
 
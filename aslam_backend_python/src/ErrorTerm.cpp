@@ -1,5 +1,6 @@
 #include <numpy_eigen/boost_python_headers.hpp>
 #include <aslam/backend/ErrorTerm.hpp>
+#include <aslam/backend/EqualityConstraint.hpp>
 #include <aslam/backend/DesignVariable.hpp>
 #include <boost/shared_ptr.hpp>
 using namespace boost::python;
@@ -72,5 +73,14 @@ void exportErrorTerm()
   exportErrorTermFs<2>();
   exportErrorTermFs<3>();
   exportErrorTermFs<4>();
+
+  class_<EqualityConstraint, boost::shared_ptr<EqualityConstraint>, boost::noncopyable>("EqualityConstraint", no_init)
+    /// \brief Evaluate the constraint at the current state.
+    .def("evaluateConstraint", &EqualityConstraint::evaluateConstraint)
+    .def("getMultipliers", &EqualityConstraint::getMultipliers)
+    .def("setMultipliers", &EqualityConstraint::setMultipliers)
+    .def("getPenalty", &EqualityConstraint::getPenalty)
+    .def("setPenalty", &EqualityConstraint::setPenalty)
+  ;
   
 }
@@ -65,6 +65,18 @@ void exportLinearSystemSolver()
         // helper function for dog leg implementation / steepest descent solution
         .def("rhsJtJrhs", &LinearSystemSolver::rhsJtJrhs )
 
+        /// \brief Equilibrate the Jacobian columns before solving, takes effect with the next buildSystem() call
+        .def("setColumnScaling", &LinearSystemSolver::setColumnScaling )
+        .def("isColumnScaling", &LinearSystemSolver::isColumnScaling )
+
+        /// \brief The column scale factors computed by the last buildSystem() call
+        .def("getColumnScale", &LinearSystemSolver::getColumnScale, return_value_policy<copy_const_reference>())
+
+        /// \brief The relative residual tolerance of iterative solvers
+        .def("setForcingTerm", &LinearSystemSolver::setForcingTerm )
+        .def("getForcingTerm", &LinearSystemSolver::getForcingTerm )
+        .def("isIterative", &LinearSystemSolver::isIterative )
+
         ;
 
     SparseQRLinearSolverOptions& (SparseQrLinearSystemSolver::*getOptions)() = &SparseQrLinearSystemSolver::getOptions;
@@ -78,7 +90,11 @@ void exportLinearSystemSolver()
 
 
     class_<DenseQrLinearSystemSolver, boost::shared_ptr<DenseQrLinearSystemSolver>, bases<LinearSystemSolver> >("DenseQrLinearSystemSolver", init<>());
-    class_<BlockCholeskyLinearSystemSolver, boost::shared_ptr<BlockCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("BlockCholeskyLinearSystemSolver", init<>());
+    class_<BlockCholeskyLinearSystemSolver, boost::shared_ptr<BlockCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("BlockCholeskyLinearSystemSolver", init<>())
+        .def(init<std::string>())
+        .def("getPcgTolerance", &BlockCholeskyLinearSystemSolver::getPcgTolerance)
+        .def("setPcgTolerance", &BlockCholeskyLinearSystemSolver::setPcgTolerance)
+        ;
     class_<SparseCholeskyLinearSystemSolver, boost::shared_ptr<SparseCholeskyLinearSystemSolver>, bases<LinearSystemSolver> >("SparseCholeskyLinearSystemSolver", init<>());
     class_<SparseQrLinearSystemSolver, boost::shared_ptr<SparseQrLinearSystemSolver>, bases<LinearSystemSolver> >("SparseQrLinearSystemSolver", init<>())
         .def("getJacobianTranspose", &SparseQrLinearSystemSolver::getJacobianTranspose, return_internal_reference<>())
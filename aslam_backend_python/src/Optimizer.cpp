@@ -4,8 +4,12 @@
 #include <aslam/backend/OptimizerCallbackManager.hpp>
 #include <aslam/backend/Optimizer.hpp>
 #include <aslam/backend/Optimizer2.hpp>
+#include <aslam/backend/BatchOptimizer.hpp>
 #include <aslam/backend/OptimizerRprop.hpp>
 #include <aslam/backend/OptimizerBFGS.hpp>
+#include <aslam/backend/OptimizerLBFGS.hpp>
+#include <aslam/backend/OptimizerOWLQN.hpp>
+#include <aslam/backend/OptimizerNCG.hpp>
 #include <aslam/backend/ScalarNonSquaredErrorTerm.hpp>
 #include <aslam/python/ExportOptimizerCallbackEvent.hpp>
 #include <boost/shared_ptr.hpp>
@@ -25,6 +29,57 @@ Eigen::VectorXd rhs(const aslam::backend::Optimizer * o)
 	return o->rhs();
 }
 
+void setBlockCoordinateGroups(aslam::backend::Optimizer2 & o, const boost::python::list & groups)
+{
+  using namespace boost::python;
+  std::vector< std::vector<aslam::backend::DesignVariable*> > g(len(groups));
+  for (size_t i = 0; i < g.size(); ++i) {
+    const list group = extract<list>(groups[i]);
+    for (int j = 0; j < len(group); ++j)
+      g[i].push_back(extract<aslam::backend::DesignVariable*>(group[j]));
+  }
+  o.setBlockCoordinateGroups(g);
+}
+
+void setLinearDesignVariables(aslam::backend::Optimizer2 & o, const boost::python::list & dvs)
+{
+  using namespace boost::python;
+  std::vector<aslam::backend::DesignVariable*> linear;
+  for (int i = 0; i < len(dvs); ++i)
+    linear.push_back(extract<aslam::backend::DesignVariable*>(dvs[i]));
+  o.setLinearDesignVariables(linear);
+}
+
+void setGaugeDirections(aslam::backend::Optimizer2 & o, const Eigen::MatrixXd & directions)
+{
+  o.setGaugeDirections(directions);
+}
+
+aslam::backend::BatchOptimizerStatus batchOptimize(aslam::backend::BatchOptimizer & o, const boost::python::list & problems)
+{
+  using namespace boost::python;
+  std::vector< boost::shared_ptr<aslam::backend::OptimizationProblemBase> > p;
+  for (int i = 0; i < len(problems); ++i)
+    p.push_back(extract< boost::shared_ptr<aslam::backend::OptimizationProblemBase> >(problems[i]));
+  return o.optimize(p);
+}
+
+boost::python::list batchResults(const aslam::backend::BatchOptimizerStatus & s)
+{
+  boost::python::list l;
+  for (const auto& r : s.results)
+    l.append(r);
+  return l;
+}
+
+boost::python::list batchConvergence(const aslam::backend::BatchOptimizerStatus & s)
+{
+  boost::python::list l;
+  for (const auto& c : s.convergence)
+    l.append(c);
+  return l;
+}
+
 template <typename T>
 std::string toString(const T& t) {
   std::ostringstream os;
@@ -180,9 +235,47 @@ void exportOptimizer()
 
         .def("printTiming", &Optimizer2::printTiming)
         .def("computeHessian", &Optimizer2::computeHessian)
+
+        /// \brief Optimize one group of design variables at a time, given as a list of lists of design variables
+        .def("setBlockCoordinateGroups", &setBlockCoordinateGroups)
+        .def("clearBlockCoordinateGroups", &Optimizer2::clearBlockCoordinateGroups)
+
+        /// \brief Eliminate the design variables in the list, which enter the residuals linearly, by variable projection
+        .def("setLinearDesignVariables", &setLinearDesignVariables)
+        .def("clearLinearDesignVariables", &Optimizer2::clearLinearDesignVariables)
+
+        /// \brief Project the constant gauge directions, one per column, out of the steps
+        .def("setGaugeDirections", &setGaugeDirections)
+        .def("clearGaugeDirections", &Optimizer2::clearGaugeDirections)
+        .def("hasGaugeDirections", &Optimizer2::hasGaugeDirections)
    
         ;
 
+    class_<BatchOptimizerOptions>("BatchOptimizerOptions", init<>())
+        .def_readwrite("optimizer", &BatchOptimizerOptions::optimizer)
+        .def_readwrite("numThreads", &BatchOptimizerOptions::numThreads)
+        .def("__str__", &toString<BatchOptimizerOptions>)
+        ;
+
+    class_<BatchOptimizerStatus>("BatchOptimizerStatus", init<>())
+        .add_property("results", &batchResults)
+        .add_property("convergence", &batchConvergence)
+        .def_readonly("numExceptions", &BatchOptimizerStatus::numExceptions)
+        .def_readonly("numThreads", &BatchOptimizerStatus::numThreads)
+        .def_readonly("wallTime", &BatchOptimizerStatus::wallTime)
+        .def_readonly("problemsPerSecond", &BatchOptimizerStatus::problemsPerSecond)
+        .def("__str__", &toString<BatchOptimizerStatus>)
+        ;
+
+    class_<BatchOptimizer, boost::shared_ptr<BatchOptimizer>, boost::noncopyable>("BatchOptimizer", init<>())
+        .def(init<BatchOptimizerOptions>())
+        /// \brief Optimize a list of independent problems concurrently
+        .def("optimize", &batchOptimize)
+        .def("setOptions", &BatchOptimizer::setOptions)
+        .add_property("options", make_function(&BatchOptimizer::getOptions, return_internal_reference<>()))
+        .add_property("status", make_function(&BatchOptimizer::getStatus, return_internal_reference<>()))
+        ;
+
     class_<OptimizerOptionsBase, boost::shared_ptr<OptimizerOptionsBase> >("OptimizerOptionsBase", init<>("OptimizerOptionsBase(): Constructor"))
         .def(init<const sm::PropertyTree&>("OptimizerOptionsBase(sm::PropertyTree pt): Constructor"))
         .def_readwrite("convergenceGradientNorm", &OptimizerOptionsBase::convergenceGradientNorm)
@@ -191,6 +284,7 @@ void exportOptimizer()
         .def_readwrite("maxIterations",&OptimizerOptionsBase::maxIterations)
         .def_readwrite("numThreadsJacobian", &OptimizerOptionsBase::numThreadsJacobian)
         .def_readwrite("numThreadsError", &OptimizerOptionsBase::numThreadsError)
+        .def_readwrite("maxTimeMs", &OptimizerOptionsBase::maxTimeMs)
         .def("__str__", &toString<OptimizerOptionsBase>)
         ;
 
@@ -200,6 +294,9 @@ void exportOptimizer()
         .value("GRADIENT_NORM", ConvergenceStatus::GRADIENT_NORM)
         .value("DX", ConvergenceStatus::DX)
         .value("DOBJECTIVE", ConvergenceStatus::DOBJECTIVE)
+        .value("MAX_ITERATIONS", ConvergenceStatus::MAX_ITERATIONS)
+        .value("TIME_LIMIT", ConvergenceStatus::TIME_LIMIT)
+        .value("CALLBACK_STOP", ConvergenceStatus::CALLBACK_STOP)
         ;
 
     class_<OptimizerStatus, boost::shared_ptr<OptimizerStatus> >("OptimizerStatus")
@@ -207,6 +304,7 @@ void exportOptimizer()
         .def_readwrite("numIterations",&OptimizerStatus::numIterations)
         .def_readwrite("numJacobianEvaluations",&OptimizerStatus::numJacobianEvaluations)
         .def_readwrite("numErrorEvaluations",&OptimizerStatus::numErrorEvaluations)
+        .def_readwrite("numErrorAndGradientEvaluations",&OptimizerStatus::numErrorAndGradientEvaluations)
         .def_readwrite("gradientNorm",&OptimizerStatus::gradientNorm)
         .def_readwrite("maxDeltaX",&OptimizerStatus::maxDeltaX)
         .def_readwrite("error",&OptimizerStatus::error)
@@ -266,6 +364,13 @@ void exportOptimizer()
         .value("IRPROP_PLUS", OptimizerOptionsRprop::Method::IRPROP_PLUS)
         ;
 
+    class_<MiniBatchOptions, boost::shared_ptr<MiniBatchOptions> >("MiniBatchOptions", init<>())
+        .def_readwrite("batchSize", &MiniBatchOptions::batchSize)
+        .def_readwrite("growthFactor", &MiniBatchOptions::growthFactor)
+        .def_readwrite("seed", &MiniBatchOptions::seed)
+        .def("__str__", &toString<MiniBatchOptions>)
+        ;
+
     class_<OptimizerOptionsRprop, boost::shared_ptr<OptimizerOptionsRprop>, bases<OptimizerOptionsBase> >("OptimizerOptionsRprop", init<>())
         .def_readwrite("etaMinus",&OptimizerOptionsRprop::etaMinus)
         .def_readwrite("etaPlus",&OptimizerOptionsRprop::etaPlus)
@@ -274,6 +379,7 @@ void exportOptimizer()
         .def_readwrite("maxDelta",&OptimizerOptionsRprop::maxDelta)
         .def_readwrite("regularizer", &OptimizerOptionsRprop::regularizer)
         .def_readwrite("method", &OptimizerOptionsRprop::method)
+        .def_readwrite("miniBatch", &OptimizerOptionsRprop::miniBatch)
         .def_readwrite("useDenseJacobianContainer", &OptimizerOptionsRprop::useDenseJacobianContainer)
         .def("__str__", &toString<OptimizerOptionsRprop>)
         ;
@@ -313,5 +419,58 @@ void exportOptimizer()
         ;
     implicitly_convertible< boost::shared_ptr<OptimizerBFGS>, boost::shared_ptr<const OptimizerBFGS> >();
 
+    class_<OptimizerOptionsLBFGS, boost::shared_ptr<OptimizerOptionsLBFGS>, bases<OptimizerOptionsBase> >("OptimizerOptionsLBFGS", init<>())
+        .def_readwrite("linesearch", &OptimizerOptionsLBFGS::linesearch)
+        .def_readwrite("historySize", &OptimizerOptionsLBFGS::historySize)
+        .def_readwrite("useDenseJacobianContainer", &OptimizerOptionsLBFGS::useDenseJacobianContainer)
+        .def("__str__", &toString<OptimizerOptionsLBFGS>)
+        ;
+
+    class_<OptimizerLBFGS, boost::shared_ptr<OptimizerLBFGS>, bases<OptimizerProblemManagerBase> >("OptimizerLBFGS", init<>("OptimizerLBFGS(): Constructor with default options"))
+        .def(init<const OptimizerOptionsLBFGS&>("OptimizerLBFGS(OptimizerOptionsLBFGS options): Constructor with custom options"))
+        .def(init<const sm::PropertyTree&>("OptimizerLBFGS(PropertyTree propertyTree): Constructor from sm::PropertyTree"))
+        .def("getHistoryLength", &OptimizerLBFGS::getHistoryLength, "Number of correction pairs currently stored")
+        ;
+    implicitly_convertible< boost::shared_ptr<OptimizerLBFGS>, boost::shared_ptr<const OptimizerLBFGS> >();
+
+    class_<OptimizerOptionsOWLQN, boost::shared_ptr<OptimizerOptionsOWLQN>, bases<OptimizerOptionsBase> >("OptimizerOptionsOWLQN", init<>())
+        .def_readwrite("linesearch", &OptimizerOptionsOWLQN::linesearch)
+        .def_readwrite("historySize", &OptimizerOptionsOWLQN::historySize)
+        .def_readwrite("backtrackingFactor", &OptimizerOptionsOWLQN::backtrackingFactor)
+        .def_readwrite("useDenseJacobianContainer", &OptimizerOptionsOWLQN::useDenseJacobianContainer)
+        .def_readwrite("regularizer", &OptimizerOptionsOWLQN::regularizer)
+        .def("__str__", &toString<OptimizerOptionsOWLQN>)
+        ;
+
+    class_<OptimizerOWLQN, boost::shared_ptr<OptimizerOWLQN>, bases<OptimizerProblemManagerBase> >("OptimizerOWLQN", init<>("OptimizerOWLQN(): Constructor with default options"))
+        .def(init<const OptimizerOptionsOWLQN&>("OptimizerOWLQN(OptimizerOptionsOWLQN options): Constructor with custom options"))
+        .def(init<const sm::PropertyTree&>("OptimizerOWLQN(PropertyTree propertyTree): Constructor from sm::PropertyTree"))
+        .def("getHistoryLength", &OptimizerOWLQN::getHistoryLength, "Number of correction pairs currently stored")
+        .def("getNumL1Parameters", &OptimizerOWLQN::getNumL1Parameters, "Number of parameters with an L1 penalty")
+        .def("getNumZeroL1Parameters", &OptimizerOWLQN::getNumZeroL1Parameters, "Number of parameters with an L1 penalty that are exactly zero")
+        ;
+    implicitly_convertible< boost::shared_ptr<OptimizerOWLQN>, boost::shared_ptr<const OptimizerOWLQN> >();
+
+    enum_<OptimizerOptionsNCG::Method>("NCGMethod")
+        .value("POLAK_RIBIERE_PLUS", OptimizerOptionsNCG::Method::POLAK_RIBIERE_PLUS)
+        .value("HAGER_ZHANG", OptimizerOptionsNCG::Method::HAGER_ZHANG)
+        ;
+
+    class_<OptimizerOptionsNCG, boost::shared_ptr<OptimizerOptionsNCG>, bases<OptimizerOptionsBase> >("OptimizerOptionsNCG", init<>())
+        .def_readwrite("linesearch", &OptimizerOptionsNCG::linesearch)
+        .def_readwrite("method", &OptimizerOptionsNCG::method)
+        .def_readwrite("restartInterval", &OptimizerOptionsNCG::restartInterval)
+        .def_readwrite("restartThreshold", &OptimizerOptionsNCG::restartThreshold)
+        .def_readwrite("useDenseJacobianContainer", &OptimizerOptionsNCG::useDenseJacobianContainer)
+        .def("__str__", &toString<OptimizerOptionsNCG>)
+        ;
+
+    class_<OptimizerNCG, boost::shared_ptr<OptimizerNCG>, bases<OptimizerProblemManagerBase> >("OptimizerNCG", init<>("OptimizerNCG(): Constructor with default options"))
+        .def(init<const OptimizerOptionsNCG&>("OptimizerNCG(OptimizerOptionsNCG options): Constructor with custom options"))
+        .def(init<const sm::PropertyTree&>("OptimizerNCG(PropertyTree propertyTree): Constructor from sm::PropertyTree"))
+        .def("getNumRestarts", &OptimizerNCG::getNumRestarts, "Number of restarts with the steepest descent direction since the last reset")
+        ;
+    implicitly_convertible< boost::shared_ptr<OptimizerNCG>, boost::shared_ptr<const OptimizerNCG> >();
+
 }
 
@@ -33,9 +33,20 @@ void exportOptimizerOptions()
     .def_readwrite("maxIterations",&Optimizer2Options::maxIterations)
     .def_readwrite("verbose",&Optimizer2Options::verbose)
     .def_readwrite("numThreadsError", &Optimizer2Options::numThreadsError)
+    .def_readwrite("maxTimeMs", &Optimizer2Options::maxTimeMs)
     .def_readwrite("numThreadsJacobian", &Optimizer2Options::numThreadsJacobian)
     .def_readwrite("linearSolver",&Optimizer2Options::linearSystemSolver)
     .def_readwrite("trustRegionPolicy", &Optimizer2Options::trustRegionPolicy)
+    .def_readwrite("blockCoordinateInnerIterations", &Optimizer2Options::blockCoordinateInnerIterations)
+    .def_readwrite("warmStartTrustRegion", &Optimizer2Options::warmStartTrustRegion)
+    .def_readwrite("warmStartDecay", &Optimizer2Options::warmStartDecay)
+    .def_readwrite("maxAugmentedLagrangianIterations", &Optimizer2Options::maxAugmentedLagrangianIterations)
+    .def_readwrite("constraintTolerance", &Optimizer2Options::constraintTolerance)
+    .def_readwrite("penaltyIncreaseFactor", &Optimizer2Options::penaltyIncreaseFactor)
+    .def_readwrite("maxPenalty", &Optimizer2Options::maxPenalty)
+    .def_readwrite("gaugeRegularization", &Optimizer2Options::gaugeRegularization)
+    .def_readwrite("irlsJacobianReuse", &Optimizer2Options::irlsJacobianReuse)
+    .def_readwrite("maxForcingTerm", &Optimizer2Options::maxForcingTerm)
     ;
 
 }
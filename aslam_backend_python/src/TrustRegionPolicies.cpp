@@ -4,6 +4,7 @@
 #include <aslam/backend/GaussNewtonTrustRegionPolicy.hpp>
 #include <aslam/backend/LevenbergMarquardtTrustRegionPolicy.hpp>
 #include <aslam/backend/DogLegTrustRegionPolicy.hpp>
+#include <aslam/backend/SubspaceTrustRegionPolicy.hpp>
 #include <aslam/backend/LineSearchTrustRegionPolicy.hpp>
 
 
@@ -15,6 +16,11 @@ void exportTrustRegionPolicies() {
   class_<TrustRegionPolicy, boost::shared_ptr<TrustRegionPolicy>, boost::noncopyable>("TrustRegionPolicy", no_init)
       .def("name", &TrustRegionPolicy::name)
       .def("requiresAugmentedDiagonal", &TrustRegionPolicy::requiresAugmentedDiagonal)
+      .def("getWarmStart", &TrustRegionPolicy::getWarmStart)
+      .def("getWarmStartDecay", &TrustRegionPolicy::getWarmStartDecay)
+      .def("resetWarmStart", &TrustRegionPolicy::resetWarmStart)
+      .def("setForcingTerms", &TrustRegionPolicy::setForcingTerms, (arg("maxForcingTerm"), arg("gamma") = 0.9, arg("alpha") = 2.0))
+      .def("getMaxForcingTerm", &TrustRegionPolicy::getMaxForcingTerm)
       ;
 
   // GN
@@ -24,10 +30,23 @@ void exportTrustRegionPolicies() {
   // LM
   class_<LevenbergMarquardtTrustRegionPolicy, boost::shared_ptr<LevenbergMarquardtTrustRegionPolicy>, bases< TrustRegionPolicy >, boost::noncopyable >("LevenbergMarquardtTrustRegionPolicy", init<>() )
       .def(init<double>("LevenbergMarquardtTrustRegionPolicy( double initalLambda )"))
+      .def("getLambda", &LevenbergMarquardtTrustRegionPolicy::getLambda)
+      .def("setGeodesicAcceleration", &LevenbergMarquardtTrustRegionPolicy::setGeodesicAcceleration, (arg("enable"), arg("alpha") = 0.75, arg("h") = 0.1))
+      .def("getGeodesicAcceleration", &LevenbergMarquardtTrustRegionPolicy::getGeodesicAcceleration)
+      .def("getNumAcceleratedSteps", &LevenbergMarquardtTrustRegionPolicy::getNumAcceleratedSteps)
+      .def("setNonmonotoneWindow", &LevenbergMarquardtTrustRegionPolicy::setNonmonotoneWindow)
+      .def("getNonmonotoneWindow", &LevenbergMarquardtTrustRegionPolicy::getNonmonotoneWindow)
       ;
 
   // DL
   class_<DogLegTrustRegionPolicy, boost::shared_ptr<DogLegTrustRegionPolicy>, bases< TrustRegionPolicy >, boost::noncopyable >("DogLegTrustRegionPolicy", init<>() )
+      .def("getDelta", &DogLegTrustRegionPolicy::getDelta)
+      ;
+
+  // 2D subspace
+  class_<SubspaceTrustRegionPolicy, boost::shared_ptr<SubspaceTrustRegionPolicy>, bases< TrustRegionPolicy >, boost::noncopyable >("SubspaceTrustRegionPolicy", init<>() )
+      .def("getDelta", &SubspaceTrustRegionPolicy::getDelta)
+      .def("getSubspaceDimension", &SubspaceTrustRegionPolicy::getSubspaceDimension)
       ;
   
   // LS
@@ -14,9 +14,11 @@
 // You should have received a copy of the GNU Lesser General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+namespace sparse_block_matrix {
+
 // helpers for doing fixed or variable size operations on the matrices
 
-namespace sparse_block_matrix {
+namespace internal {
   template<typename MatrixType>
   inline void pcg_axy(const MatrixType& A, const Eigen::VectorXd& x, int xoff, Eigen::VectorXd& y, int yoff)
   {
@@ -97,9 +99,9 @@ bool LinearSolverPCG<MatrixType>::solve(const SparseBlockMatrix<MatrixType>& A,
   r = bvec;
   multDiag(A.colBlockIndices(), _J, r, d);
   double dn = r.dot(d);
-  double d0 = _tolerance * dn;
+  double d0 = _tolerance * (_euclideanTolerance ? bvec.squaredNorm() : dn);
 
-  if (_absoluteTolerance) {
+  if (_absoluteTolerance && !_euclideanTolerance) {
     if (_residual > 0.0 && _residual > d0)
       d0 = _residual;
   }
@@ -110,7 +112,18 @@ bool LinearSolverPCG<MatrixType>::solve(const SparseBlockMatrix<MatrixType>& A,
   for (iteration = 0; iteration < maxIter; ++iteration) {
     if (_verbose)
       std::cerr << "residual[" << iteration << "]: " << dn << std::endl;
-    if (dn <= d0)
+    if (_euclideanTolerance && r.squaredNorm() <= d0) {
+      // the updated residual drifts from the true one, stop only if the true one meets the tolerance as well
+      mult(A.colBlockIndices(), xvec, q);
+      r = bvec - q;
+      if (r.squaredNorm() <= d0)
+        break;	// done
+      // restart from the true residual
+      multDiag(A.colBlockIndices(), _J, r, d);
+      dn = r.dot(d);
+      continue;
+    }
+    if (!_euclideanTolerance && dn <= d0)
       break;	// done
     mult(A.colBlockIndices(), d, q);
     double a = dn / d.dot(q);
@@ -134,7 +147,7 @@ void LinearSolverPCG<MatrixType>::multDiag(const std::vector<int>& colBlockIndic
 {
   int row = 0;
   for (size_t i = 0; i < A.size(); ++i) {
-    pcg_axy(A[i], src, row, dest, row);
+    internal::pcg_axy(A[i], src, row, dest, row);
     row = colBlockIndices[i];
   }
 }
@@ -144,7 +157,7 @@ void LinearSolverPCG<MatrixType>::multDiag(const std::vector<int>& colBlockIndic
 {
   int row = 0;
   for (size_t i = 0; i < A.size(); ++i) {
-    pcg_axy(*A[i], src, row, dest, row);
+    internal::pcg_axy(*A[i], src, row, dest, row);
     row = colBlockIndices[i];
   }
 }
@@ -164,8 +177,10 @@ void LinearSolverPCG<MatrixType>::mult(const std::vector<int>& colBlockIndices,
 
     const typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = _sparseMat[i];
     // destVec += *a * srcVec (according to the sub-vector parts)
-    pcg_axpy(*a, src, srcOffset, dest, destOffset);
+    internal::pcg_axpy(*a, src, srcOffset, dest, destOffset);
     // destVec += *a.transpose() * srcVec (according to the sub-vector parts)
-    pcg_atxpy(*a, src, srcOffsetT, dest, destOffsetT);
+    internal::pcg_atxpy(*a, src, srcOffsetT, dest, destOffsetT);
   }
 }
+
+} // end namespace
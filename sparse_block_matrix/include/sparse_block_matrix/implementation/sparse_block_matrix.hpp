@@ -518,6 +518,20 @@ void SparseBlockMatrix<MatrixType>::scale(double a_) {
   }
 }
 
+template<class MatrixType>
+void SparseBlockMatrix<MatrixType>::scale(const Eigen::VectorXd & rowScale, const Eigen::VectorXd & colScale) {
+  SM_ASSERT_EQ(Exception, rowScale.size(), rows(), "The row scale vector is the wrong size");
+  SM_ASSERT_EQ(Exception, colScale.size(), cols(), "The column scale vector is the wrong size");
+  for (size_t i = 0; i < _blockCols.size(); i++) {
+    const int colBase = colBaseOfBlock(i);
+    for (typename SparseBlockMatrix<MatrixType>::IntBlockMap::const_iterator it = _blockCols[i].begin(); it != _blockCols[i].end(); ++it) {
+      typename SparseBlockMatrix<MatrixType>::SparseMatrixBlock* a = it->second;
+      const int rowBase = rowBaseOfBlock(it->first);
+      *a = rowScale.segment(rowBase, a->rows()).asDiagonal() * (*a) * colScale.segment(colBase, a->cols()).asDiagonal();
+    }
+  }
+}
+
 template<class MatrixType>
 void SparseBlockMatrix<MatrixType>::sliceInto(int rmin, int rmax, int cmin, int cmax, SparseBlockMatrix & outMatrix) const {
   outMatrix.clear();
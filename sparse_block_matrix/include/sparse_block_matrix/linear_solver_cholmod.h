@@ -21,6 +21,7 @@
 #include <sparse_block_matrix/marginal_covariance_cholesky.h>
 #include <sparse_block_matrix/sparse_helper.h>
 #include <cholmod.h>
+#include <algorithm>
 
 namespace sparse_block_matrix {
 
@@ -36,6 +37,7 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
       _blockOrdering = false;
       _cholmodSparse = new CholmodExt<int>();
       _cholmodFactor = 0;
+      _covarianceFactor = 0;
       cholmod_start(&_cholmodCommon);
 
       // setup ordering strategy
@@ -49,6 +51,7 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     ~LinearSolverCholmod() override
     {
       delete _cholmodSparse;
+      freeCovarianceFactor();
       if (_cholmodFactor) {
         cholmod_free_factor(&_cholmodFactor, &_cholmodCommon);
         _cholmodFactor = 0;
@@ -60,6 +63,7 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     {
         //std::cout << "this init!" << std::endl;
          
+      freeCovarianceFactor();
       if (_cholmodFactor) {
         cholmod_free_factor(&_cholmodFactor, &_cholmodCommon);
         _cholmodFactor = 0;
@@ -87,6 +91,7 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
       bcholmod.xtype = CHOLMOD_REAL;
       bcholmod.dtype = CHOLMOD_DOUBLE;  
             
+      freeCovarianceFactor();
       cholmod_factorize(_cholmodSparse, _cholmodFactor, &_cholmodCommon);
       if (_cholmodCommon.status == CHOLMOD_NOT_POSDEF) {
         if (_cholmodFactor) {
@@ -131,27 +136,25 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
         }
       }
 
+      freeCovarianceFactor();
       cholmod_factorize(_cholmodSparse, _cholmodFactor, &_cholmodCommon);
       if (_cholmodCommon.status == CHOLMOD_NOT_POSDEF)
         return false;
 
-      // convert the factorization to LL, simplical, packed, monotonic
-      int change_status = cholmod_change_factor(CHOLMOD_REAL, 1, 0, 1, 1, _cholmodFactor, &_cholmodCommon);
-      if (! change_status) {
+      cholmod_factor* L = covarianceFactor();
+      if (! L)
         return false;
-      }
-      assert(_cholmodFactor->is_ll && !_cholmodFactor->is_super && _cholmodFactor->is_monotonic && "Cholesky factor has wrong format");
 
       // invert the permutation
-      int* p = (int*)_cholmodFactor->Perm;
+      int* p = (int*)L->Perm;
       VectorXi pinv; pinv.resize(_cholmodSparse->ncol);
       for (size_t i = 0; i < _cholmodSparse->ncol; ++i)
         pinv(p[i]) = i;
 
       // compute the marginal covariance
       MarginalCovarianceCholesky mcc;
-      mcc.setCholeskyFactor(_cholmodSparse->ncol, (int*)_cholmodFactor->p, (int*)_cholmodFactor->i,
-          (double*)_cholmodFactor->x, pinv.data());
+      mcc.setCholeskyFactor(_cholmodSparse->ncol, (int*)L->p, (int*)L->i,
+          (double*)L->x, pinv.data());
       mcc.computeCovariance(blocks, A.rowBlockIndices());
 
       //if (globalStats) {
@@ -164,6 +167,20 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     bool solvePattern(SparseBlockMatrix<MatrixXd>& spinv, const std::vector<std::pair<int, int> >& blockIndices, const SparseBlockMatrix<MatrixType>& A) override
     {
       //cerr << __PRETTY_FUNCTION__ << " using cholmod" << endl;
+      if (! factorize(A))
+        return false;
+      return solvePatternFromFactor(spinv, blockIndices, A);
+    }
+
+    /**
+     * Computes the numeric factorization of A and keeps it for later queries
+     * through solvePatternFromFactor(). The symbolic factorization is reused if
+     * one exists, so A must have the same non-zero pattern as before (call
+     * init() otherwise).
+     * @returns false if A is not positive definite.
+     */
+    bool factorize(const SparseBlockMatrix<MatrixType>& A)
+    {
       fillCholmodExt(A, _cholmodFactor); // _cholmodFactor used as bool, if not existing will copy the whole structure, otherwise only the values
 
       if (! _cholmodFactor) {
@@ -171,27 +188,45 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
         assert(_cholmodFactor && "Symbolic cholesky failed");
       }
 
+      freeCovarianceFactor();
       cholmod_factorize(_cholmodSparse, _cholmodFactor, &_cholmodCommon);
-      if (_cholmodCommon.status == CHOLMOD_NOT_POSDEF)
+      if (_cholmodCommon.status == CHOLMOD_NOT_POSDEF) {
+        cholmod_free_factor(&_cholmodFactor, &_cholmodCommon);
+        _cholmodFactor = 0;
         return false;
+      }
+      return true;
+    }
 
-      // convert the factorization to LL, simplical, packed, monotonic
-      int change_status = cholmod_change_factor(CHOLMOD_REAL, 1, 0, 1, 1, _cholmodFactor, &_cholmodCommon);
-      if (! change_status) {
+    //! true if a numeric factorization from the last solve() or factorize() call is available
+    bool hasNumericFactor() const { return _cholmodFactor && _cholmodFactor->xtype != CHOLMOD_PATTERN; }
+
+    /**
+     * Inverts a block pattern of A in spinv using the numeric factorization
+     * computed by the last call to solve() or factorize() on A.
+     * A is only used for its block layout; it is not refactored. The factor
+     * itself is not modified, further solve() calls are not affected.
+     * @returns false if no numeric factorization is available.
+     */
+    bool solvePatternFromFactor(SparseBlockMatrix<MatrixXd>& spinv, const std::vector<std::pair<int, int> >& blockIndices, const SparseBlockMatrix<MatrixType>& A)
+    {
+      if (! hasNumericFactor())
+        return false;
+
+      cholmod_factor* L = covarianceFactor();
+      if (! L)
         return false;
-      }
-      assert(_cholmodFactor->is_ll && !_cholmodFactor->is_super && _cholmodFactor->is_monotonic && "Cholesky factor has wrong format");
 
       // invert the permutation
-      int* p = (int*)_cholmodFactor->Perm;
+      int* p = (int*)L->Perm;
       VectorXi pinv; pinv.resize(_cholmodSparse->ncol);
       for (size_t i = 0; i < _cholmodSparse->ncol; ++i)
         pinv(p[i]) = i;
 
       // compute the marginal covariance
       MarginalCovarianceCholesky mcc;
-      mcc.setCholeskyFactor(_cholmodSparse->ncol, (int*)_cholmodFactor->p, (int*)_cholmodFactor->i,
-          (double*)_cholmodFactor->x, pinv.data());
+      mcc.setCholeskyFactor(_cholmodSparse->ncol, (int*)L->p, (int*)L->i,
+          (double*)L->x, pinv.data());
       mcc.computeCovariance(spinv, A.rowBlockIndices(), blockIndices);
 
       //if (globalStats) {
@@ -205,19 +240,76 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
     bool blockOrdering() const { return _blockOrdering;}
     void setBlockOrdering(bool blockOrdering) { _blockOrdering = blockOrdering;}
 
+    /**
+     * Constrains the block ordering (CAMD): blocks with a higher constraint group
+     * are eliminated after all blocks with a lower one, e.g. to keep the most recent
+     * states in the bottom-right corner of the factor. One entry per block column of A,
+     * an empty vector removes the constraints. Constraints imply block ordering.
+     * The symbolic factorization is dropped if the constraints changed.
+     */
+    void setBlockOrderingConstraints(const std::vector<int>& blockConstraints)
+    {
+      // CAMD expects the constraint sets to be numbered 0..k-1
+      std::vector<int> groups(blockConstraints);
+      std::sort(groups.begin(), groups.end());
+      groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+      std::vector<int> constraints(blockConstraints.size());
+      for (size_t i = 0; i < blockConstraints.size(); ++i)
+        constraints[i] = std::lower_bound(groups.begin(), groups.end(), blockConstraints[i]) - groups.begin();
+      if (groups.size() <= 1) // a single group does not constrain anything
+        constraints.clear();
+      if (constraints != _blockConstraints) {
+        _blockConstraints.swap(constraints);
+        init();
+      }
+    }
+    const std::vector<int>& blockOrderingConstraints() const { return _blockConstraints;}
+
   protected:
     // temp used for cholesky with cholmod
     cholmod_common _cholmodCommon;
     CholmodExt<int>* _cholmodSparse;
     cholmod_factor* _cholmodFactor;
+    //! LL, simplicial copy of the numeric factorization for the covariance recovery, 0 if not converted yet
+    cholmod_factor* _covarianceFactor;
     bool _blockOrdering;
     MatrixStructure _matrixStructure;
     VectorXi _scalarPermutation, _blockPermutation;
+    std::vector<int> _blockConstraints;
+
+    /**
+     * returns the numeric factorization converted to LL, simplical, packed, monotonic.
+     * The conversion works on a copy, _cholmodFactor keeps its format for the next solve.
+     * returns 0 if the conversion failed.
+     */
+    cholmod_factor* covarianceFactor()
+    {
+      if (! _covarianceFactor) {
+        _covarianceFactor = cholmod_copy_factor(_cholmodFactor, &_cholmodCommon);
+        if (! _covarianceFactor)
+          return 0;
+        int change_status = cholmod_change_factor(CHOLMOD_REAL, 1, 0, 1, 1, _covarianceFactor, &_cholmodCommon);
+        if (! change_status) {
+          freeCovarianceFactor();
+          return 0;
+        }
+      }
+      assert(_covarianceFactor->is_ll && !_covarianceFactor->is_super && _covarianceFactor->is_monotonic && "Cholesky factor has wrong format");
+      return _covarianceFactor;
+    }
+
+    void freeCovarianceFactor()
+    {
+      if (_covarianceFactor) {
+        cholmod_free_factor(&_covarianceFactor, &_cholmodCommon);
+        _covarianceFactor = 0;
+      }
+    }
 
     void computeSymbolicDecomposition(const SparseBlockMatrix<MatrixType>& A)
     {
       // double t = get_time();
-      if (! _blockOrdering) {
+      if (! _blockOrdering && _blockConstraints.empty()) {
         // setup ordering strategy
         _cholmodCommon.nmethods = 1;
         _cholmodCommon.method[0].ordering = CHOLMOD_AMD; //CHOLMOD_COLAMD
@@ -247,7 +339,13 @@ class LinearSolverCholmod : public LinearSolver<MatrixType>
         auxCholmodSparse.dtype = CHOLMOD_DOUBLE;
         auxCholmodSparse.sorted = 1;
         auxCholmodSparse.packed = 1;
-        int amdStatus = cholmod_amd(&auxCholmodSparse, NULL, 0, _blockPermutation.data(), &_cholmodCommon);
+        int amdStatus;
+        if (_blockConstraints.size() == (size_t)_matrixStructure.n) {
+          amdStatus = cholmod_camd(&auxCholmodSparse, NULL, 0, &_blockConstraints[0], _blockPermutation.data(), &_cholmodCommon);
+        } else {
+          assert(_blockConstraints.empty() && "The ordering constraints do not match the number of blocks");
+          amdStatus = cholmod_amd(&auxCholmodSparse, NULL, 0, _blockPermutation.data(), &_cholmodCommon);
+        }
         if (! amdStatus) {
           return;
         }
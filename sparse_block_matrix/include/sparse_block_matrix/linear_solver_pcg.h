@@ -42,6 +42,7 @@ namespace sparse_block_matrix {
         _tolerance = 1e-6;
         _verbose = false;
         _absoluteTolerance = true;
+        _euclideanTolerance = false;
         _residual = -1.0;
         _maxIter = -1;
       }
@@ -70,6 +71,11 @@ namespace sparse_block_matrix {
       bool absoluteTolerance() const { return _absoluteTolerance;}
       void setAbsoluteTolerance(bool absoluteTolerance) { _absoluteTolerance = absoluteTolerance;}
 
+      //! compare the squared Euclidean norms ||b - A x||^2 <= tolerance * ||b||^2 of the true residual instead of the
+      //! norms in the metric of the preconditioner, absoluteTolerance() is ignored then
+      bool euclideanTolerance() const { return _euclideanTolerance;}
+      void setEuclideanTolerance(bool euclideanTolerance) { _euclideanTolerance = euclideanTolerance;}
+
       bool verbose() const { return _verbose;}
       void setVerbose(bool verbose) { _verbose = verbose;}
 
@@ -80,6 +86,7 @@ namespace sparse_block_matrix {
       double _tolerance;
       double _residual;
       bool _absoluteTolerance;
+      bool _euclideanTolerance;
       bool _verbose;
       int _maxIter;
 
@@ -94,8 +101,8 @@ namespace sparse_block_matrix {
       void mult(const std::vector<int>& colBlockIndices, const Eigen::VectorXd& src, Eigen::VectorXd& dest);
   };
 
-#include "implementation/linear_solver_pcg.hpp"
-
 }// end namespace
 
+#include "implementation/linear_solver_pcg.hpp"
+
 #endif
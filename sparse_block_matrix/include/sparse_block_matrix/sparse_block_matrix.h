@@ -191,6 +191,9 @@ class SparseBlockMatrix {
 
   //! *this *= a
   void scale( double a);
+
+  //! *this = diag(rowScale) * (*this) * diag(colScale)
+  void scale(const Eigen::VectorXd & rowScale, const Eigen::VectorXd & colScale);
   //scale inplace operator
   inline SparseBlockMatrix & operator *= (double a) { scale(a); return *this; }
   //copy and scale as operator
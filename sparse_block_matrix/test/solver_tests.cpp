@@ -126,3 +126,74 @@ TEST(g2oTestSuite, testCholmod)
 
 
 }
+
+// Check that covariance blocks can be recovered from a kept factorization
+TEST(g2oTestSuite, testCholmodPatternFromFactor)
+{
+  int rows[] = {3,6,11};
+  int cols[] = {3,6,11};
+  typedef sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> Solver;
+  sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd> A(rows,cols,3,3);
+  Eigen::MatrixXd Adense(11,11);
+  Adense.setZero();
+  randomSparseBlockMatrix<Solver>(&A, Adense);
+  Eigen::MatrixXd Ainv = Adense.selfadjointView<Eigen::Upper>().ldlt().solve(Eigen::MatrixXd::Identity(11, 11));
+
+  std::vector<std::pair<int, int> > blockIndices;
+  blockIndices.push_back(std::make_pair(0, 0));
+  blockIndices.push_back(std::make_pair(1, 2));
+  blockIndices.push_back(std::make_pair(2, 2));
+
+  Solver solver;
+  ASSERT_TRUE(solver.init());
+  sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd> spinv;
+  ASSERT_FALSE(solver.hasNumericFactor());
+  ASSERT_FALSE(solver.solvePatternFromFactor(spinv, blockIndices, A));
+
+  ASSERT_TRUE(solver.factorize(A));
+  ASSERT_TRUE(solver.hasNumericFactor());
+  // query twice to make sure the factor survives the first query
+  for (int k = 0; k < 2; ++k) {
+    ASSERT_TRUE(solver.solvePatternFromFactor(spinv, blockIndices, A));
+    sm::eigen::assertNear(*spinv.block(0, 0), Ainv.block(0, 0, 3, 3), 1e-8, SM_SOURCE_FILE_POS);
+    sm::eigen::assertNear(*spinv.block(1, 2), Ainv.block(3, 6, 3, 5), 1e-8, SM_SOURCE_FILE_POS);
+    sm::eigen::assertNear(*spinv.block(2, 2), Ainv.block(6, 6, 5, 5), 1e-8, SM_SOURCE_FILE_POS);
+  }
+}
+
+// Check that a constrained (CAMD) block ordering still yields the dense solution
+TEST(g2oTestSuite, testCholmodOrderingConstraints)
+{
+  int rows[] = {3,6,11};
+  int cols[] = {3,6,11};
+  typedef sparse_block_matrix::LinearSolverCholmod<Eigen::MatrixXd> Solver;
+  sparse_block_matrix::SparseBlockMatrix<Eigen::MatrixXd> A(rows,cols,3,3);
+  Eigen::MatrixXd Adense(11,11);
+  Adense.setZero();
+  randomSparseBlockMatrix<Solver>(&A, Adense);
+  Eigen::VectorXd bb = Eigen::VectorXd::Random(11);
+  Eigen::VectorXd xx(11);
+  Eigen::VectorXd dx = Adense.selfadjointView<Eigen::Upper>().ldlt().solve(bb);
+
+  std::vector<int> constraints;
+  constraints.push_back(3);
+  constraints.push_back(1);
+  constraints.push_back(1);
+
+  Solver solver;
+  ASSERT_TRUE(solver.init());
+  solver.setBlockOrdering(true);
+  solver.setBlockOrderingConstraints(constraints);
+  ASSERT_EQ(3u, solver.blockOrderingConstraints().size());
+  // groups are renumbered to 0..k-1
+  ASSERT_EQ(1, solver.blockOrderingConstraints()[0]);
+  ASSERT_EQ(0, solver.blockOrderingConstraints()[1]);
+  ASSERT_TRUE(solver.solve(A, &xx[0], &bb[0]));
+  sm::eigen::assertNear(dx, xx, 1e-10, SM_SOURCE_FILE_POS);
+
+  // a single group is the same as no constraint
+  solver.setBlockOrderingConstraints(std::vector<int>(3, 2));
+  ASSERT_TRUE(solver.blockOrderingConstraints().empty());
+  ASSERT_TRUE(solver.solve(A, &xx[0], &bb[0]));
+  sm::eigen::assertNear(dx, xx, 1e-10, SM_SOURCE_FILE_POS);
+}
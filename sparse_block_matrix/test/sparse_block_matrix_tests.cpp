@@ -374,6 +374,32 @@ TEST(sparse_block_matrixTestSuite, testScaleMatrix) {
   }
 }
 
+TEST(sparse_block_matrixTestSuite, testScaleRowsAndColumns) {
+
+  using namespace Eigen;
+  using namespace sparse_block_matrix;
+  VectorXi rows(4);
+  rows << 2, 4, 14, 15;
+  VectorXi cols(3);
+  cols << 3, 5, 7;
+
+  // Create an not empty matrix.
+  sparse_block_matrix::SparseBlockMatrix<MatrixXd> M1 = buildRandomMatrix<MatrixXd>(rows, cols, 0.5);
+  const MatrixXd M1Dense = M1.toDense();
+
+  const VectorXd rowScale = VectorXd::Random(M1.rows());
+  const VectorXd colScale = VectorXd::Random(M1.cols());
+  M1.scale(rowScale, colScale);
+
+  try{
+    sm::eigen::assertNear(M1.toDense(), (rowScale.asDiagonal() * M1Dense * colScale.asDiagonal()).eval(), 1e-6, SM_SOURCE_FILE_POS);
+  }catch(const std::exception & e)
+  {
+    FAIL() << e.what();
+  }
+  EXPECT_ANY_THROW(M1.scale(colScale, colScale));
+}
+
 TEST(sparse_block_matrixTestSuite, testMatrixMatrixMultiplication) {
 
   using namespace Eigen;